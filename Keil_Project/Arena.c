@@ -0,0 +1,29 @@
+/**
+ * @file Arena.c
+ *
+ * @brief Source code for the Arena allocator.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Arena.h"
+#include <stddef.h>
+
+void *Arena_Alloc(Arena *arena, uint32_t size, uint32_t align)
+{
+    uint32_t offset = (arena->used + (align - 1)) & ~(align - 1);
+
+    if (offset > arena->capacity || size > arena->capacity - offset)
+    {
+        arena->failures++;
+        return NULL;
+    }
+
+    arena->used = offset + size;
+    if (arena->used > arena->high_water)
+    {
+        arena->high_water = arena->used;
+    }
+
+    return arena->base + offset;
+}
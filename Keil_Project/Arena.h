@@ -0,0 +1,94 @@
+/**
+ * @file Arena.h
+ *
+ * @brief Header file for the Arena allocator.
+ *
+ * An arena is a bump allocator over a fixed, statically allocated buffer.
+ * The project has no heap (Heap_Size is 0 in the startup file), and an
+ * arena gives the calculator engine dynamic-looking allocation without
+ * one:
+ *  - Allocation is O(1): align the fill level, then advance it.
+ *  - There is no per-object free; the whole arena is released in O(1) with
+ *    Arena_Reset (e.g. at each new calculation), or back to a mark with
+ *    Arena_Release, so there is no fragmentation.
+ *  - Each arena records its high-water mark and the number of failed
+ *    allocations, so the capacities can be sized from measurements.
+ *
+ * ARENA_DEFINE declares an arena together with its storage, typed by the
+ * kind of object it holds, so that the storage is aligned for that type
+ * and its size is known at compile time.
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <stdint.h>
+
+typedef struct {
+    uint8_t *base;
+    uint32_t capacity;      // bytes
+    uint32_t used;          // bytes
+    uint32_t high_water;    // bytes
+    uint32_t failures;
+} Arena;
+
+// Define an arena with storage for count objects of the given type
+#define ARENA_DEFINE(name, type, count)                                                 \
+    static type name##_storage[count];                                                  \
+    Arena name = { (uint8_t *)name##_storage, sizeof(name##_storage), 0, 0, 0 }
+
+// Allocate one object or an array of objects (NULL if the arena is full)
+#define ARENA_NEW(arena, type)              ((type *)Arena_Alloc((arena), sizeof(type), _Alignof(type)))
+#define ARENA_NEW_ARRAY(arena, type, count) ((type *)Arena_Alloc((arena), sizeof(type) * (count), _Alignof(type)))
+
+/**
+ * @brief Allocate memory from an arena.
+ *
+ * @param arena The arena.
+ * @param size  The size in bytes.
+ * @param align The alignment in bytes, a power of two.
+ *
+ * @return void* The memory, or NULL if the arena does not have enough room.
+ */
+void *Arena_Alloc(Arena *arena, uint32_t size, uint32_t align);
+
+/**
+ * @brief Release everything allocated from an arena.
+ *
+ * @param arena The arena.
+ *
+ * @return None
+ */
+static inline void Arena_Reset(Arena *arena)
+{
+    arena->used = 0;
+}
+
+/**
+ * @brief Get the current fill level, to release back to it later.
+ *
+ * @param arena The arena.
+ *
+ * @return uint32_t The mark.
+ */
+static inline uint32_t Arena_Mark(const Arena *arena)
+{
+    return arena->used;
+}
+
+/**
+ * @brief Release everything allocated since a mark.
+ *
+ * @param arena The arena.
+ * @param mark  The value returned by Arena_Mark.
+ *
+ * @return None
+ */
+static inline void Arena_Release(Arena *arena, uint32_t mark)
+{
+    arena->used = mark;
+}
+
+#endif // ARENA_H_
@@ -0,0 +1,287 @@
+/**
+ * @file Atomic.h
+ *
+ * @brief Header file for the Atomic primitives.
+ *
+ * It provides the primitives used to share state between interrupt
+ * handlers and the main loop without disabling interrupts:
+ *  - Atomic read-modify-write operations on 32-bit words, built on the
+ *    LDREX/STREX exclusive access instructions. The Cortex-M4 clears the
+ *    exclusive monitor on every exception entry and return, so if an
+ *    interrupt runs between LDREX and STREX, STREX fails and the operation
+ *    is retried.
+ *  - Flag sets: up to 32 event flags in a word, which interrupt handlers
+ *    set and the main loop takes (reads and clears) atomically.
+ *  - Seqlocks, for consistent snapshots of data larger than a word
+ *    (e.g. 64-bit counters or statistics records). The writer increments
+ *    a sequence number before and after the update; the reader retries
+ *    if the number was odd or changed while it copied the data.
+ *
+ * Aligned 32-bit loads and stores are already atomic on the Cortex-M4, so
+ * plain volatile accesses are enough for single-word values that have only
+ * one writer. The words that order other data (the seqlock sequence, the
+ * queue indices) go through Atomic_Load / Atomic_Store and their acquire
+ * and release forms instead: they compile to the same LDR/STR and DMB, and
+ * also tell the host build (ThreadSanitizer, make -C tests tsan) which
+ * accesses are synchronized.
+ *
+ * @note A seqlock writer must not be interrupted by one of its readers
+ * (e.g. the writer is an interrupt handler and the reader is the main
+ * loop); otherwise the reader would retry until the writer resumes, which
+ * it never does.
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef ATOMIC_H_
+#define ATOMIC_H_
+
+#include "TM4C123GH6PM.h"
+#include <stdint.h>
+
+/**
+ * @brief Read a shared word.
+ *
+ * @param target The word.
+ *
+ * @return uint32_t The value of the word.
+ */
+static inline uint32_t Atomic_Load(const volatile uint32_t *target)
+{
+    return __atomic_load_n(target, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Write a shared word.
+ *
+ * @param target The word.
+ * @param value  The new value.
+ *
+ * @return None
+ */
+static inline void Atomic_Store(volatile uint32_t *target, uint32_t value)
+{
+    __atomic_store_n(target, value, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Read a word that publishes other data (LDR, then DMB): the data
+ * is read after the word.
+ *
+ * @param target The word.
+ *
+ * @return uint32_t The value of the word.
+ */
+static inline uint32_t Atomic_Load_Acquire(const volatile uint32_t *target)
+{
+    return __atomic_load_n(target, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Write a word that publishes other data (DMB, then STR): the data
+ * accessed before is visible to whoever sees the new value.
+ *
+ * @param target The word.
+ * @param value  The new value.
+ *
+ * @return None
+ */
+static inline void Atomic_Store_Release(volatile uint32_t *target, uint32_t value)
+{
+    __atomic_store_n(target, value, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Atomically add to a word.
+ *
+ * @param target The word.
+ * @param value  The value to add.
+ *
+ * @return uint32_t The value of the word before the addition.
+ */
+static inline uint32_t Atomic_Fetch_Add(volatile uint32_t *target, uint32_t value)
+{
+    uint32_t old;
+    do
+    {
+        old = __LDREXW(target);
+    } while (__STREXW(old + value, target) != 0);
+    return old;
+}
+
+/**
+ * @brief Atomically OR a mask into a word.
+ *
+ * @param target The word.
+ * @param mask   The bits to set.
+ *
+ * @return uint32_t The value of the word before the operation.
+ */
+static inline uint32_t Atomic_Fetch_Or(volatile uint32_t *target, uint32_t mask)
+{
+    uint32_t old;
+    do
+    {
+        old = __LDREXW(target);
+    } while (__STREXW(old | mask, target) != 0);
+    return old;
+}
+
+/**
+ * @brief Atomically AND a mask into a word.
+ *
+ * @param target The word.
+ * @param mask   The bits to keep.
+ *
+ * @return uint32_t The value of the word before the operation.
+ */
+static inline uint32_t Atomic_Fetch_And(volatile uint32_t *target, uint32_t mask)
+{
+    uint32_t old;
+    do
+    {
+        old = __LDREXW(target);
+    } while (__STREXW(old & mask, target) != 0);
+    return old;
+}
+
+/**
+ * @brief Atomically replace a word.
+ *
+ * @param target The word.
+ * @param value  The new value.
+ *
+ * @return uint32_t The previous value.
+ */
+static inline uint32_t Atomic_Exchange(volatile uint32_t *target, uint32_t value)
+{
+    uint32_t old;
+    do
+    {
+        old = __LDREXW(target);
+    } while (__STREXW(value, target) != 0);
+    return old;
+}
+
+/**
+ * @brief Atomically replace a word if it holds an expected value.
+ *
+ * @param target   The word.
+ * @param expected The value the word must hold.
+ * @param value    The new value.
+ *
+ * @return uint8_t 1 if the word was replaced, 0 if it did not hold the expected value.
+ */
+static inline uint8_t Atomic_Compare_Exchange(volatile uint32_t *target, uint32_t expected, uint32_t value)
+{
+    do
+    {
+        if (__LDREXW(target) != expected)
+        {
+            __CLREX();
+            return 0;
+        }
+    } while (__STREXW(value, target) != 0);
+    return 1;
+}
+
+// A set of up to 32 event flags
+typedef volatile uint32_t Atomic_Flags;
+
+/**
+ * @brief Set flags (e.g. from an interrupt handler).
+ *
+ * @param flags The flag set.
+ * @param mask  The flags to set.
+ *
+ * @return None
+ */
+static inline void Atomic_Flags_Set(Atomic_Flags *flags, uint32_t mask)
+{
+    (void)Atomic_Fetch_Or(flags, mask);
+}
+
+/**
+ * @brief Clear flags.
+ *
+ * @param flags The flag set.
+ * @param mask  The flags to clear.
+ *
+ * @return None
+ */
+static inline void Atomic_Flags_Clear(Atomic_Flags *flags, uint32_t mask)
+{
+    (void)Atomic_Fetch_And(flags, ~mask);
+}
+
+/**
+ * @brief Read and clear flags in one step, so that no flag set in between is lost.
+ *
+ * @param flags The flag set.
+ * @param mask  The flags to take.
+ *
+ * @return uint32_t The flags of mask that were set.
+ */
+static inline uint32_t Atomic_Flags_Take(Atomic_Flags *flags, uint32_t mask)
+{
+    return Atomic_Fetch_And(flags, ~mask) & mask;
+}
+
+typedef struct {
+    volatile uint32_t sequence;
+} Seqlock;
+
+#define SEQLOCK_INIT    { 0 }
+
+/**
+ * @brief Start updating the data protected by a seqlock.
+ *
+ * @param lock The seqlock.
+ *
+ * @return None
+ */
+static inline void Seqlock_Write_Begin(Seqlock *lock)
+{
+    Atomic_Store(&lock->sequence, Atomic_Load(&lock->sequence) + 1);
+    __DMB();
+}
+
+/**
+ * @brief Finish updating the data protected by a seqlock.
+ *
+ * @param lock The seqlock.
+ *
+ * @return None
+ */
+static inline void Seqlock_Write_End(Seqlock *lock)
+{
+    Atomic_Store_Release(&lock->sequence, Atomic_Load(&lock->sequence) + 1);
+}
+
+/**
+ * @brief Start reading the data protected by a seqlock.
+ *
+ * @param lock The seqlock.
+ *
+ * @return uint32_t The sequence number, to pass to Seqlock_Read_Retry.
+ */
+static inline uint32_t Seqlock_Read_Begin(const Seqlock *lock)
+{
+    return Atomic_Load_Acquire(&lock->sequence);
+}
+
+/**
+ * @brief Check whether the data read since Seqlock_Read_Begin may be inconsistent.
+ *
+ * @param lock     The seqlock.
+ * @param sequence The value returned by Seqlock_Read_Begin.
+ *
+ * @return uint8_t 1 if the data must be read again, 0 if it is consistent.
+ */
+static inline uint8_t Seqlock_Read_Retry(const Seqlock *lock, uint32_t sequence)
+{
+    __DMB();
+    return ((sequence & 1U) != 0) || (Atomic_Load(&lock->sequence) != sequence);
+}
+
+#endif // ATOMIC_H_
@@ -0,0 +1,137 @@
+/**
+ * @file BCD.c
+ *
+ * @brief Source code for the packed-BCD digit kernels.
+ *
+ * Addition uses the bias-and-correct method: every digit of one operand is
+ * biased by 6 so that a binary carry out of a nibble happens exactly when
+ * the decimal digit sum reaches 10. After one native add, the nibbles that
+ * did not carry are corrected by subtracting the 6 back out.
+ *
+ * @note See D. W. Jones, "BCD Arithmetic, a tutorial".
+ * Link: https://homepage.cs.uiowa.edu/~dwjones/bcd/bcd.html
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "BCD.h"
+#include <string.h>
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+
+#include "TM4C123GH6PM.h"
+
+#define BCD_UADD8(x, y)     __UADD8((x), (y))
+#define BCD_REV(x)          __REV(x)
+
+#else
+
+// Portable UADD8: four independent byte additions, carries discarded
+static inline uint32_t BCD_UADD8(uint32_t x, uint32_t y)
+{
+    return ((x & 0x7F7F7F7FU) + (y & 0x7F7F7F7FU)) ^ ((x ^ y) & 0x80808080U);
+}
+
+#define BCD_REV(x)          __builtin_bswap32(x)
+
+#endif
+
+// a + b + carry_in for 8 digits; the carry out lands in bit 32
+static inline uint64_t BCD_Add_With_Carry(uint32_t a, uint32_t b, uint32_t carry_in)
+{
+    uint64_t t1 = (uint64_t)a + 0x66666666U;
+    uint64_t t2 = t1 + b + carry_in;
+
+    // Carry into each bit position of the binary sum
+    uint64_t carries = t2 ^ t1 ^ b;
+
+    // Nibbles that did not carry out still hold the +6 bias
+    uint64_t no_carry = ~carries & 0x111111110ULL;
+    uint64_t correction = (no_carry >> 2) | (no_carry >> 3);
+
+    return t2 - correction;
+}
+
+uint32_t BCD_Add(uint32_t a, uint32_t b, uint32_t *carry)
+{
+    uint64_t sum = BCD_Add_With_Carry(a, b, 0);
+
+    if (carry != NULL)
+    {
+        *carry = (uint32_t)(sum >> 32);
+    }
+    return (uint32_t)sum;
+}
+
+uint32_t BCD_Sub(uint32_t a, uint32_t b, uint32_t *borrow)
+{
+    // a - b = a + (nine's complement of b) + 1
+    uint64_t difference = BCD_Add_With_Carry(a, 0x99999999U - b, 1);
+
+    if (borrow != NULL)
+    {
+        *borrow = (uint32_t)((difference >> 32) ^ 1U);
+    }
+    return (uint32_t)difference;
+}
+
+int BCD_Compare(uint32_t a, uint32_t b)
+{
+    return (a > b) - (a < b);
+}
+
+uint32_t BCD_Shift_Left(uint32_t a, uint32_t digits)
+{
+    return (digits >= BCD_DIGITS_PER_WORD) ? 0 : (a << (4 * digits));
+}
+
+uint32_t BCD_Shift_Right(uint32_t a, uint32_t digits)
+{
+    return (digits >= BCD_DIGITS_PER_WORD) ? 0 : (a >> (4 * digits));
+}
+
+uint32_t BCD_Digit_Count(uint32_t a)
+{
+    if (a == 0)
+    {
+        return 1;
+    }
+    return (uint32_t)(35 - __builtin_clz(a)) / 4;
+}
+
+// Two digits (value < 100): v / 10 as a multiply and shift
+static inline uint32_t BCD_From_Binary_2(uint32_t value)
+{
+    uint32_t tens = (value * 205U) >> 11;
+    return (tens << 4) | (value - (tens * 10U));
+}
+
+// Four digits (value < 10000): v / 100 as a multiply and shift
+static inline uint32_t BCD_From_Binary_4(uint32_t value)
+{
+    uint32_t hundreds = (value * 5243U) >> 19;
+    return (BCD_From_Binary_2(hundreds) << 8) | BCD_From_Binary_2(value - (hundreds * 100U));
+}
+
+uint32_t BCD_From_Binary(uint32_t value)
+{
+    uint32_t high = value / 10000U;
+    return (BCD_From_Binary_4(high) << 16) | BCD_From_Binary_4(value - (high * 10000U));
+}
+
+// Spread four BCD digits (16 bits) into four bytes, most significant digit first in memory
+static inline uint32_t BCD_Unpack_4(uint32_t digits)
+{
+    uint32_t x = ((digits & 0xFF00U) << 8) | (digits & 0x00FFU);
+    x = ((x & 0x00F000F0U) << 4) | (x & 0x000F000FU);
+    return BCD_REV(x);
+}
+
+void BCD_To_Ascii(uint32_t a, char *out)
+{
+    uint32_t high = BCD_UADD8(BCD_Unpack_4(a >> 16), 0x30303030U);
+    uint32_t low = BCD_UADD8(BCD_Unpack_4(a & 0xFFFFU), 0x30303030U);
+
+    memcpy(out, &high, sizeof(high));
+    memcpy(out + 4, &low, sizeof(low));
+}
@@ -0,0 +1,98 @@
+/**
+ * @file BCD.h
+ *
+ * @brief Header file for the packed-BCD digit kernels.
+ *
+ * A packed-BCD word holds 8 decimal digits, one per nibble, with the least
+ * significant digit in bits 3:0. All kernels operate on a whole word at a
+ * time (SIMD within a register) instead of looping over the digits:
+ *  - addition and subtraction apply the decimal correction to all 8 digits
+ *    with a handful of 32-bit operations, letting the native adder ripple
+ *    the carries between digits
+ *  - comparison is a single unsigned compare, since packed BCD orders the
+ *    same way as binary
+ *  - digit shifts are 4-bit shifts
+ *  - conversion to ASCII adds '0' to four digits at once with UADD8
+ *
+ * On the Cortex-M4 the DSP instructions are used through the CMSIS
+ * intrinsics. Portable C fallbacks are used when __ARM_FEATURE_DSP is
+ * not available (for example, in host builds).
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef BCD_H_
+#define BCD_H_
+
+#include <stdint.h>
+
+// Number of decimal digits in one packed-BCD word
+#define BCD_DIGITS_PER_WORD     8
+
+/**
+ * @brief Add two packed-BCD words.
+ *
+ * @param a     First operand (8 BCD digits).
+ * @param b     Second operand (8 BCD digits).
+ * @param carry Set to 1 if the sum exceeds 99999999, 0 otherwise. May be NULL.
+ *
+ * @return uint32_t The low 8 digits of a + b.
+ */
+uint32_t BCD_Add(uint32_t a, uint32_t b, uint32_t *carry);
+
+/**
+ * @brief Subtract two packed-BCD words.
+ *
+ * @param a      Minuend (8 BCD digits).
+ * @param b      Subtrahend (8 BCD digits).
+ * @param borrow Set to 1 if b > a (the result is then the ten's complement), 0 otherwise. May be NULL.
+ *
+ * @return uint32_t The low 8 digits of a - b.
+ */
+uint32_t BCD_Sub(uint32_t a, uint32_t b, uint32_t *borrow);
+
+/**
+ * @brief Compare two packed-BCD words.
+ *
+ * @return int -1 if a < b, 0 if a == b, 1 if a > b.
+ */
+int BCD_Compare(uint32_t a, uint32_t b);
+
+/**
+ * @brief Shift a packed-BCD word by whole digits (multiply or divide by 10^n).
+ *
+ * @param a      The packed-BCD word.
+ * @param digits Number of digits to shift (0 - 8).
+ *
+ * @return uint32_t The shifted word. Digits shifted out are lost; zeros are shifted in.
+ */
+uint32_t BCD_Shift_Left(uint32_t a, uint32_t digits);
+uint32_t BCD_Shift_Right(uint32_t a, uint32_t digits);
+
+/**
+ * @brief Number of significant digits in a packed-BCD word.
+ *
+ * @return uint32_t 1 - 8 (zero has one digit).
+ */
+uint32_t BCD_Digit_Count(uint32_t a);
+
+/**
+ * @brief Convert a binary value below 10^8 to packed BCD.
+ *
+ * @param value The value to convert (0 - 99999999).
+ *
+ * @return uint32_t The packed-BCD representation.
+ */
+uint32_t BCD_From_Binary(uint32_t value);
+
+/**
+ * @brief Convert a packed-BCD word to 8 ASCII digits (with leading zeros, no terminator).
+ *
+ * @param a   The packed-BCD word.
+ * @param out Output buffer of at least 8 characters.
+ *
+ * @return None
+ */
+void BCD_To_Ascii(uint32_t a, char *out);
+
+#endif // BCD_H_
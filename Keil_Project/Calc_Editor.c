@@ -0,0 +1,149 @@
+/**
+ * @file Calc_Editor.c
+ *
+ * @brief Source code for the Calc_Editor module.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Calc_Editor.h"
+#include "Calc_Memory.h"
+#include "Cycle_Counter.h"
+#include "EduBase_LCD.h"
+#include "LCD_Frame.h"
+#include "Keypad.h"
+#include <string.h>
+
+static Calc_Editor_Stats editor_stats;
+
+// Draw the expression around the cursor and its value
+static void Calc_Editor_Draw(const Calc_Expr *expr, const char *prompt, uint8_t *offset)
+{
+    char line[LCD_FRAME_COLUMNS + 1];
+
+    // Scroll to keep the cursor on the top line
+    if (expr->cursor < *offset)
+    {
+        *offset = expr->cursor;
+    }
+    else if (expr->cursor >= *offset + LCD_FRAME_COLUMNS)
+    {
+        *offset = (uint8_t)(expr->cursor - (LCD_FRAME_COLUMNS - 1U));
+    }
+
+    LCD_Frame_Clear();
+    LCD_Frame_Set_Cursor(0, 0);
+    strncpy(line, &expr->text[*offset], LCD_FRAME_COLUMNS);
+    line[LCD_FRAME_COLUMNS] = '\0';
+    LCD_Frame_Print(line);
+
+    LCD_Frame_Set_Cursor(0, 1);
+    LCD_Frame_Print(prompt);
+    if (!expr->complete)
+    {
+        LCD_Frame_Print("Incomplete");
+    }
+    else if (expr->error != CALC_ERROR_NONE)
+    {
+        LCD_Frame_Print(Calc_Error_Message(expr->error));
+    }
+    else
+    {
+        Calc_Number_Format(expr->value, line, sizeof(line));
+        LCD_Frame_Print(line);
+    }
+
+    LCD_Frame_Flush();
+
+    // The LCD cursor marks the insertion point
+    EduBase_LCD_Set_Cursor((uint8_t)(expr->cursor - *offset), 0);
+}
+
+uint8_t Calc_Editor_Run(const char *prompt, const Calc_Number *variable, char *text, Calc_Number *value)
+{
+    // Everything the editor allocates is released on exit
+    uint32_t tokens_mark = Arena_Mark(&Calc_Memory_Tokens);
+    uint32_t nodes_mark = Arena_Mark(&Calc_Memory_Nodes);
+
+    Calc_Expr *expr = Calc_Expr_Create(text, variable);
+    uint8_t accepted = 0;
+    uint8_t offset = 0;
+
+    if (expr != NULL)
+    {
+        EduBase_LCD_Enable_Cursor();
+
+        while (1)
+        {
+            Calc_Editor_Draw(expr, prompt, &offset);
+
+            char key = Keypad_WaitForChar();
+            uint8_t held = (Keypad_Get_Timing()->hold_us >= CALC_EDITOR_HOLD_US);
+
+            if (key == '=')
+            {
+                if (held)
+                {
+                    break;
+                }
+                if (expr->complete && expr->error == CALC_ERROR_NONE)
+                {
+                    accepted = 1;
+                    break;
+                }
+                continue;
+            }
+
+            uint32_t start = Cycle_Counter_Read();
+
+            if (held && key == '*')
+            {
+                Calc_Expr_Move(expr, -1);
+            }
+            else if (held && key == '/')
+            {
+                Calc_Expr_Move(expr, 1);
+            }
+            else if (held && key == '.')
+            {
+                Calc_Expr_Delete(expr);
+            }
+            else if (held && key == '+')
+            {
+                Calc_Expr_Insert(expr, CALC_EXPR_VARIABLE);
+            }
+            else
+            {
+                Calc_Expr_Insert(expr, key);
+            }
+
+            uint32_t cycles = Cycle_Counter_Read() - start;
+
+            editor_stats.edits++;
+            editor_stats.cycles_last = cycles;
+            if (cycles > editor_stats.cycles_max)
+            {
+                editor_stats.cycles_max = cycles;
+            }
+            Calc_Expr_Get_Stats(expr, &editor_stats.expr);
+        }
+
+        EduBase_LCD_Disable_Cursor();
+
+        if (accepted)
+        {
+            strcpy(text, expr->text);
+            *value = expr->value;
+        }
+    }
+
+    Arena_Release(&Calc_Memory_Tokens, tokens_mark);
+    Arena_Release(&Calc_Memory_Nodes, nodes_mark);
+
+    return accepted;
+}
+
+void Calc_Editor_Get_Stats(Calc_Editor_Stats *stats)
+{
+    *stats = editor_stats;
+}
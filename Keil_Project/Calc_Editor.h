@@ -0,0 +1,77 @@
+/**
+ * @file Calc_Editor.h
+ *
+ * @brief Header file for the Calc_Editor module.
+ *
+ * It is the on-device editor of an expression line (see Calc_Expr.h),
+ * opened by holding '*' for CALC_EDITOR_OPEN_HOLD_US. It starts from the
+ * calculation in progress, e.g. "12+34", so a digit in the middle can be
+ * fixed without typing everything again.
+ *
+ * The numeric modes use it too, to enter their numbers and functions of x.
+ *
+ * Display:
+ *  - Top line:    16 characters of the expression, scrolled to keep the
+ *                 cursor (shown by the LCD) in view
+ *  - Bottom line: a prompt (e.g. "a="), then the value of the expression,
+ *                 updated after every edit, "Incomplete" or the error
+ *
+ * Editor keys (held means at least CALC_EDITOR_HOLD_US):
+ *  - Digits, '.', '+', '-', '*', '/': insert at the cursor
+ *  - '*' / '/' held: move the cursor left / right
+ *  - '.' held:       delete the character before the cursor
+ *  - '+' held:       insert x (functions of x only)
+ *  - '=':            accept the value and exit (ignored while there is none)
+ *  - '=' held:       cancel and exit
+ *
+ * The expression lives in the engine pools only while the editor runs.
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef CALC_EDITOR_H_
+#define CALC_EDITOR_H_
+
+#include "Calc_Expr.h"
+#include <stdint.h>
+
+// Hold time of the '*' key that opens the editor
+#define CALC_EDITOR_OPEN_HOLD_US    1000000U
+
+// Hold time of the editing keys
+#define CALC_EDITOR_HOLD_US         400000U
+
+typedef struct {
+    uint32_t edits;
+    uint32_t cycles_last;       // CPU cycles of the last edit (without the display)
+    uint32_t cycles_max;
+    Calc_Expr_Stats expr;       // work done by the last edit
+} Calc_Editor_Stats;
+
+/**
+ * @brief Run the editor until the user accepts or cancels.
+ *
+ * The editor draws through the LCD framebuffer (see LCD_Frame.h); the
+ * caller redraws its own display on exit.
+ *
+ * @param prompt   Shown before the value on the bottom line ("" for none).
+ * @param variable The value of x used for the value shown, or NULL if the
+ *                 expression may not use x.
+ * @param text     The expression to start from (CALC_EXPR_MAX_CHARS + 1
+ *                 bytes); receives the accepted expression.
+ * @param value    Receives the accepted value.
+ *
+ * @return uint8_t 1 if accepted, 0 if canceled.
+ */
+uint8_t Calc_Editor_Run(const char *prompt, const Calc_Number *variable, char *text, Calc_Number *value);
+
+/**
+ * @brief Get the cost of the edits made in the editor since startup.
+ *
+ * @param stats Receives the statistics.
+ *
+ * @return None
+ */
+void Calc_Editor_Get_Stats(Calc_Editor_Stats *stats);
+
+#endif // CALC_EDITOR_H_
@@ -0,0 +1,88 @@
+/**
+ * @file Calc_Error.c
+ *
+ * @brief Source code for the Calc_Error module.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Calc_Error.h"
+#include <float.h>
+
+#if defined(__ARM_FP)
+#include "TM4C123GH6PM.h"
+
+// FPSCR cumulative exception flags IOC, DZC, OFC, UFC (IXC and IDC are ignored)
+#define FPSCR_EXCEPTION_MASK    0x0FU
+#endif
+
+static const char *const Calc_Error_Messages[] = {
+    "               ",  // CALC_ERROR_NONE
+    "Err: Invalid   ",  // CALC_ERROR_INVALID
+    "Err: Div by 0  ",  // CALC_ERROR_DIV_BY_ZERO
+    "Err: Overflow  ",  // CALC_ERROR_OVERFLOW
+    "Err: Underflow "   // CALC_ERROR_UNDERFLOW
+};
+
+void Calc_Error_Begin(void)
+{
+#if defined(__ARM_FP)
+    __set_FPSCR(__get_FPSCR() & ~FPSCR_EXCEPTION_MASK);
+#endif
+    Calc_Number_Clear_Flags();
+}
+
+Calc_Error Calc_Error_End(Calc_Number result)
+{
+    uint32_t flags = Calc_Number_Get_Flags();
+
+#if defined(__ARM_FP)
+    flags |= __get_FPSCR() & FPSCR_EXCEPTION_MASK;
+#endif
+
+#if (CALC_NUMBER_BACKEND == CALC_BACKEND_DOUBLE)
+    if (result.type == CALC_NUMBER_FLOAT)
+    {
+        double value = result.value.f;
+        double magnitude = (value < 0.0) ? -value : value;
+
+        if (value != value)
+        {
+            flags |= CALC_NUMBER_FLAG_INVALID;
+        }
+        else if (magnitude > DBL_MAX)
+        {
+            flags |= CALC_NUMBER_FLAG_OVERFLOW;
+        }
+        else if (magnitude != 0.0 && magnitude < DBL_MIN)
+        {
+            flags |= CALC_NUMBER_FLAG_UNDERFLOW;
+        }
+    }
+#else
+    (void)result;
+#endif
+
+    if (flags & CALC_NUMBER_FLAG_INVALID)
+    {
+        return CALC_ERROR_INVALID;
+    }
+    if (flags & CALC_NUMBER_FLAG_DIVIDE_BY_ZERO)
+    {
+        return CALC_ERROR_DIV_BY_ZERO;
+    }
+    if (flags & CALC_NUMBER_FLAG_OVERFLOW)
+    {
+        return CALC_ERROR_OVERFLOW;
+    }
+    if (flags & CALC_NUMBER_FLAG_UNDERFLOW)
+    {
+        return CALC_ERROR_UNDERFLOW;
+    }
+    return CALC_ERROR_NONE;
+}
+
+const char *Calc_Error_Message(Calc_Error error)
+{
+    return Calc_Error_Messages[error];
+}
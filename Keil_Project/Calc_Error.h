@@ -0,0 +1,70 @@
+/**
+ * @file Calc_Error.h
+ *
+ * @brief Header file for the Calc_Error module.
+ *
+ * Arithmetic errors are detected once per evaluation instead of being
+ * checked around every operation. Calc_Error_Begin clears the cumulative
+ * exception flags (the FPSCR flags for work done on the FPU and the
+ * Calc_Number flags for the software backends) before an evaluation, and
+ * Calc_Error_End reads them back afterwards and maps them to an error.
+ * The arithmetic itself is unchanged, so there is no overhead on the
+ * happy path.
+ *
+ * Flag to error mapping (in order of precedence):
+ *  - Invalid operation (IOC), e.g. 0 / 0      -> CALC_ERROR_INVALID
+ *  - Division by zero (DZC)                   -> CALC_ERROR_DIV_BY_ZERO
+ *  - Overflow (OFC), result is infinite       -> CALC_ERROR_OVERFLOW
+ *  - Underflow (UFC), result lost precision   -> CALC_ERROR_UNDERFLOW
+ *
+ * The inexact flag (IXC) is ignored.
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef CALC_ERROR_H_
+#define CALC_ERROR_H_
+
+#include <stdint.h>
+#include "Calc_Number.h"
+
+typedef enum {
+    CALC_ERROR_NONE,
+    CALC_ERROR_INVALID,
+    CALC_ERROR_DIV_BY_ZERO,
+    CALC_ERROR_OVERFLOW,
+    CALC_ERROR_UNDERFLOW
+} Calc_Error;
+
+/**
+ * @brief Clear the cumulative exception flags before an evaluation.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Calc_Error_Begin(void);
+
+/**
+ * @brief Read the cumulative exception flags after an evaluation.
+ *
+ * For the IEEE double runtime backend, which does not report exceptions,
+ * the result is classified instead (NaN -> invalid, infinity -> overflow,
+ * subnormal -> underflow).
+ *
+ * @param result The result of the evaluation.
+ *
+ * @return Calc_Error The error raised by the evaluation, or CALC_ERROR_NONE.
+ */
+Calc_Error Calc_Error_End(Calc_Number result);
+
+/**
+ * @brief Get the LCD message for an error.
+ *
+ * @param error The error.
+ *
+ * @return const char* A message padded to 15 characters, e.g. "Err: Overflow  ".
+ */
+const char *Calc_Error_Message(Calc_Error error);
+
+#endif // CALC_ERROR_H_
@@ -0,0 +1,468 @@
+/**
+ * @file Calc_Expr.c
+ *
+ * @brief Source code for the Calc_Expr module.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Calc_Expr.h"
+#include "Calc_Memory.h"
+#include <string.h>
+
+static const Calc_Number zero = { CALC_NUMBER_INT, { .i = 0 } };
+
+static uint8_t Calc_Expr_Is_Number_Char(char c)
+{
+    return (c >= '0' && c <= '9') || c == '.';
+}
+
+static uint8_t Calc_Expr_Is_Operator(char c)
+{
+    return c == '+' || c == '-' || c == '*' || c == '/';
+}
+
+// + and - separate the terms
+static uint8_t Calc_Expr_Is_Separator(char kind)
+{
+    return kind == '+' || kind == '-';
+}
+
+static uint8_t Calc_Expr_Is_Allowed(const Calc_Expr *expr, char c)
+{
+    return Calc_Expr_Is_Number_Char(c) || Calc_Expr_Is_Operator(c) ||
+           (c == CALC_EXPR_VARIABLE && expr->has_variable);
+}
+
+// Lex text[from, to) into tokens, or only count them if tokens is NULL
+static uint32_t Calc_Expr_Lex(const char *text, uint32_t from, uint32_t to, Calc_Expr_Token *tokens)
+{
+    uint32_t count = 0;
+    uint32_t i = from;
+
+    while (i < to)
+    {
+        uint32_t start = i;
+        char kind;
+
+        if (Calc_Expr_Is_Number_Char(text[i]))
+        {
+            while (i < to && Calc_Expr_Is_Number_Char(text[i]))
+            {
+                i++;
+            }
+            kind = CALC_EXPR_NUMBER;
+        }
+        else
+        {
+            // An operator, or the variable
+            kind = text[i];
+            i++;
+        }
+
+        if (tokens != NULL)
+        {
+            tokens[count].start = (uint8_t)start;
+            tokens[count].length = (uint8_t)(i - start);
+            tokens[count].kind = kind;
+        }
+        count++;
+    }
+
+    return count;
+}
+
+// Index of the token that holds a character position (the last token at the end)
+static uint32_t Calc_Expr_Find_Token(const Calc_Expr *expr, uint32_t position)
+{
+    uint32_t low = 0;
+    uint32_t high = expr->token_count;
+
+    // Last token that starts at or before the position
+    while (high - low > 1)
+    {
+        uint32_t middle = (low + high) / 2;
+
+        if (expr->tokens[middle].start <= position)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+// Index of the last term whose first token is at or before a token index
+static uint32_t Calc_Expr_Find_Term(const Calc_Expr *expr, uint32_t token)
+{
+    uint32_t low = 0;
+    uint32_t high = expr->term_count;
+
+    while (high - low > 1)
+    {
+        uint32_t middle = (low + high) / 2;
+
+        if (expr->terms[middle].first <= token)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+static Calc_Number Calc_Expr_Operand(const Calc_Expr *expr, const Calc_Expr_Token *token, uint8_t *complete)
+{
+    char buf[CALC_EXPR_MAX_CHARS + 1];
+
+    if (token->kind == CALC_EXPR_VARIABLE)
+    {
+        return expr->variable;
+    }
+
+    memcpy(buf, &expr->text[token->start], token->length);
+    buf[token->length] = '\0';
+
+    // Two points in one number, e.g. after deleting the operator in "1.5*2.5"
+    const char *point = strchr(buf, '.');
+    if (point != NULL && strchr(point + 1, '.') != NULL)
+    {
+        *complete = 0;
+    }
+
+    return Calc_Number_Parse(buf);
+}
+
+// Evaluate a term: operand (('*' | '/') operand)*, where an operand is a number or x
+static void Calc_Expr_Evaluate_Term(Calc_Expr *expr, uint32_t index)
+{
+    Calc_Expr_Term *term = &expr->terms[index];
+    const Calc_Expr_Token *tokens = &expr->tokens[term->first];
+
+    term->valid = 1;
+    term->complete = 1;
+    term->error = CALC_ERROR_NONE;
+    term->value = zero;
+
+    if (term->count == 0)
+    {
+        // Only the first term may be empty, before a leading sign (or in an empty expression)
+        term->complete = (index == 0);
+        return;
+    }
+
+    // Operands and operators must alternate, starting and ending with an operand
+    for (uint32_t i = 0; i < term->count; i++)
+    {
+        uint8_t is_operand = (tokens[i].kind == CALC_EXPR_NUMBER || tokens[i].kind == CALC_EXPR_VARIABLE);
+
+        if (is_operand != ((i % 2U) == 0U) || (term->count % 2U) == 0U)
+        {
+            term->complete = 0;
+            return;
+        }
+    }
+
+    Calc_Error_Begin();
+
+    Calc_Number value = Calc_Expr_Operand(expr, &tokens[0], &term->complete);
+
+    for (uint32_t i = 1; i < term->count; i += 2)
+    {
+        Calc_Number operand = Calc_Expr_Operand(expr, &tokens[i + 1], &term->complete);
+
+        if (tokens[i].kind == '*')
+        {
+            value = Calc_Number_Mul(value, operand);
+        }
+        else
+        {
+            value = Calc_Number_Div(value, operand);
+        }
+    }
+
+    term->error = Calc_Error_End(value);
+    term->value = value;
+}
+
+// Evaluate the terms that are not up to date, then add up the cached term values
+static void Calc_Expr_Evaluate(Calc_Expr *expr)
+{
+    expr->stats.terms_evaluated = 0;
+    expr->stats.terms = expr->term_count;
+    expr->complete = 1;
+    expr->error = CALC_ERROR_NONE;
+    expr->value = zero;
+
+    for (uint32_t k = 0; k < expr->term_count; k++)
+    {
+        Calc_Expr_Term *term = &expr->terms[k];
+
+        if (!term->valid)
+        {
+            Calc_Expr_Evaluate_Term(expr, k);
+            expr->stats.terms_evaluated++;
+        }
+
+        if (!term->complete)
+        {
+            expr->complete = 0;
+        }
+        else if (term->error != CALC_ERROR_NONE && expr->error == CALC_ERROR_NONE)
+        {
+            expr->error = term->error;
+        }
+    }
+
+    if (!expr->complete || expr->error != CALC_ERROR_NONE)
+    {
+        return;
+    }
+
+    Calc_Error_Begin();
+
+    Calc_Number value = expr->terms[0].value;
+
+    for (uint32_t k = 1; k < expr->term_count; k++)
+    {
+        const Calc_Expr_Term *term = &expr->terms[k];
+
+        // The separator is the token before the term
+        if (expr->tokens[term->first - 1].kind == '+')
+        {
+            value = Calc_Number_Add(value, term->value);
+        }
+        else
+        {
+            value = Calc_Number_Sub(value, term->value);
+        }
+    }
+
+    expr->error = Calc_Error_End(value);
+    expr->value = value;
+}
+
+// Rebuild the terms over the tokens [lo, lo + old_count) replaced by [lo, lo + new_count)
+static void Calc_Expr_Reparse(Calc_Expr *expr, uint32_t lo, uint32_t old_count, uint32_t new_count)
+{
+    int32_t shift = (int32_t)new_count - (int32_t)old_count;
+
+    // Terms a to b hold (or are separated by) the replaced tokens
+    uint32_t a = Calc_Expr_Find_Term(expr, lo);
+    uint32_t b = Calc_Expr_Find_Term(expr, lo + old_count);
+
+    uint32_t region_start = expr->terms[a].first;
+    uint32_t region_end = (uint32_t)((int32_t)(expr->terms[b].first + expr->terms[b].count) + shift);
+
+    uint32_t region_terms = 1;
+    for (uint32_t i = region_start; i < region_end; i++)
+    {
+        if (Calc_Expr_Is_Separator(expr->tokens[i].kind))
+        {
+            region_terms++;
+        }
+    }
+
+    // Move the terms after the region, with their cached values
+    uint32_t tail = expr->term_count - (b + 1);
+    memmove(&expr->terms[a + region_terms], &expr->terms[b + 1], tail * sizeof(Calc_Expr_Term));
+
+    for (uint32_t k = a + region_terms; k < a + region_terms + tail; k++)
+    {
+        expr->terms[k].first = (uint8_t)((int32_t)expr->terms[k].first + shift);
+    }
+
+    // New terms of the region, to be evaluated
+    uint32_t k = a;
+    uint32_t start = region_start;
+
+    for (uint32_t i = region_start; i <= region_end; i++)
+    {
+        if (i == region_end || Calc_Expr_Is_Separator(expr->tokens[i].kind))
+        {
+            expr->terms[k].first = (uint8_t)start;
+            expr->terms[k].count = (uint8_t)(i - start);
+            expr->terms[k].valid = 0;
+            k++;
+            start = i + 1;
+        }
+    }
+
+    expr->term_count = (uint8_t)(a + region_terms + tail);
+}
+
+// Lex again the tokens around an edit of delta characters at a position,
+// then update the terms and the value
+static void Calc_Expr_Relex(Calc_Expr *expr, uint32_t position, int32_t delta)
+{
+    // The edited token and its neighbours, which the edit may split or merge
+    uint32_t t = Calc_Expr_Find_Token(expr, position);
+    uint32_t lo = (t > 0) ? t - 1 : 0;
+    uint32_t hi = (t + 2 < expr->token_count) ? t + 2 : expr->token_count;
+    uint32_t old_count = hi - lo;
+
+    uint32_t from = 0;
+    uint32_t to = 0;
+
+    if (old_count > 0)
+    {
+        from = expr->tokens[lo].start;
+        to = expr->tokens[hi - 1].start + expr->tokens[hi - 1].length;
+    }
+    to = (uint32_t)((int32_t)to + delta);
+
+    uint32_t new_count = Calc_Expr_Lex(expr->text, from, to, NULL);
+
+    // Move the tokens after the window
+    uint32_t tail = expr->token_count - hi;
+    memmove(&expr->tokens[lo + new_count], &expr->tokens[hi], tail * sizeof(Calc_Expr_Token));
+
+    for (uint32_t i = lo + new_count; i < lo + new_count + tail; i++)
+    {
+        expr->tokens[i].start = (uint8_t)((int32_t)expr->tokens[i].start + delta);
+    }
+
+    Calc_Expr_Lex(expr->text, from, to, &expr->tokens[lo]);
+    expr->token_count = (uint8_t)(lo + new_count + tail);
+    expr->stats.tokens_lexed = new_count;
+
+    Calc_Expr_Reparse(expr, lo, old_count, new_count);
+    Calc_Expr_Evaluate(expr);
+}
+
+// Lex the whole text, split it into terms and evaluate them all
+static void Calc_Expr_Parse(Calc_Expr *expr)
+{
+    expr->token_count = (uint8_t)Calc_Expr_Lex(expr->text, 0, expr->length, expr->tokens);
+    expr->stats.tokens_lexed = expr->token_count;
+
+    uint32_t k = 0;
+    uint32_t start = 0;
+
+    for (uint32_t i = 0; i <= expr->token_count; i++)
+    {
+        if (i == expr->token_count || Calc_Expr_Is_Separator(expr->tokens[i].kind))
+        {
+            expr->terms[k].first = (uint8_t)start;
+            expr->terms[k].count = (uint8_t)(i - start);
+            expr->terms[k].valid = 0;
+            k++;
+            start = i + 1;
+        }
+    }
+
+    expr->term_count = (uint8_t)k;
+    Calc_Expr_Evaluate(expr);
+}
+
+Calc_Expr *Calc_Expr_Create(const char *initial, const Calc_Number *variable)
+{
+    Calc_Expr *expr = ARENA_NEW(&Calc_Memory_Tokens, Calc_Expr);
+    Calc_Expr_Token *tokens = ARENA_NEW_ARRAY(&Calc_Memory_Tokens, Calc_Expr_Token, CALC_EXPR_MAX_CHARS);
+    Calc_Expr_Term *terms = ARENA_NEW_ARRAY(&Calc_Memory_Nodes, Calc_Expr_Term, CALC_EXPR_MAX_TERMS);
+
+    if (expr == NULL || tokens == NULL || terms == NULL)
+    {
+        return NULL;
+    }
+
+    memset(expr, 0, sizeof(Calc_Expr));
+    expr->tokens = tokens;
+    expr->terms = terms;
+
+    if (variable != NULL)
+    {
+        expr->has_variable = 1;
+        expr->variable = *variable;
+    }
+
+    // Keep the characters that Calc_Expr_Insert would accept, then parse once
+    uint32_t term_count = 1;
+
+    for (; *initial != '\0' && expr->length < CALC_EXPR_MAX_CHARS; initial++)
+    {
+        if (!Calc_Expr_Is_Allowed(expr, *initial) ||
+            (Calc_Expr_Is_Separator(*initial) && term_count >= CALC_EXPR_MAX_TERMS))
+        {
+            continue;
+        }
+
+        term_count += Calc_Expr_Is_Separator(*initial);
+        expr->text[expr->length++] = *initial;
+    }
+    expr->text[expr->length] = '\0';
+    expr->cursor = expr->length;
+
+    Calc_Expr_Parse(expr);
+    return expr;
+}
+
+uint8_t Calc_Expr_Insert(Calc_Expr *expr, char c)
+{
+    uint32_t position = expr->cursor;
+
+    if (!Calc_Expr_Is_Allowed(expr, c))
+    {
+        return 0;
+    }
+
+    if (expr->length >= CALC_EXPR_MAX_CHARS ||
+        (Calc_Expr_Is_Separator(c) && expr->term_count >= CALC_EXPR_MAX_TERMS))
+    {
+        return 0;
+    }
+
+    memmove(&expr->text[position + 1], &expr->text[position], expr->length - position + 1U);
+    expr->text[position] = c;
+    expr->length++;
+    expr->cursor++;
+
+    Calc_Expr_Relex(expr, position, 1);
+    return 1;
+}
+
+uint8_t Calc_Expr_Delete(Calc_Expr *expr)
+{
+    if (expr->cursor == 0)
+    {
+        return 0;
+    }
+
+    uint32_t position = expr->cursor - 1U;
+
+    memmove(&expr->text[position], &expr->text[position + 1], expr->length - position);
+    expr->length--;
+    expr->cursor--;
+
+    Calc_Expr_Relex(expr, position, -1);
+    return 1;
+}
+
+void Calc_Expr_Move(Calc_Expr *expr, int32_t delta)
+{
+    int32_t cursor = (int32_t)expr->cursor + delta;
+
+    if (cursor < 0)
+    {
+        cursor = 0;
+    }
+    else if (cursor > (int32_t)expr->length)
+    {
+        cursor = expr->length;
+    }
+
+    expr->cursor = (uint8_t)cursor;
+}
+
+void Calc_Expr_Get_Stats(const Calc_Expr *expr, Calc_Expr_Stats *stats)
+{
+    *stats = expr->stats;
+}
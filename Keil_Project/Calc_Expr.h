@@ -0,0 +1,165 @@
+/**
+ * @file Calc_Expr.h
+ *
+ * @brief Header file for the Calc_Expr module.
+ *
+ * It is the editing model of a full expression line, e.g. "12.5*4-7/2+1",
+ * with a cursor, insert and delete, and a value that is kept up to date
+ * after every edit.
+ *
+ * The expression is held three ways:
+ *  - The text, which the cursor moves over.
+ *  - The token stream: numbers (runs of digits and '.') and the operators
+ *    + - * /. The tokens tile the text.
+ *  - The terms: the runs of tokens between the + and - operators, e.g.
+ *    "12.5*4", "7/2" and "1" above. This is the parse tree of the
+ *    expression (a sum of products), and each term caches its value.
+ *
+ * An edit only changes a few characters, so the work is kept local:
+ *  - Re-tokenization: only the token under the cursor and its two
+ *    neighbours are lexed again (an edit can split or merge them), the
+ *    other tokens are moved as they are.
+ *  - Re-evaluation: only the terms that hold a re-lexed token are
+ *    evaluated again (numbers parsed, products and quotients computed,
+ *    errors checked); the other terms keep their cached values.
+ * The lexing and the parsing of an edit therefore depend on the size of
+ * the term being edited, not on the length of the expression. The rest of
+ * the work still grows with the expression: the text, the tokens and the
+ * terms after the edit are moved (memmove, and their positions shifted),
+ * which is O(n) in the length, and the cached term values are added up
+ * again, which is O(terms). These are plain copies and additions, far
+ * cheaper per item than lexing and parsing (tests/bench_calc_expr.c
+ * measures an edit against a full parse of the longest expression). Calc_Expr_Get_Stats reports the
+ * tokens lexed and terms evaluated by the last edit.
+ *
+ * An expression may also be a function of x (see Calc_Expr_Create). The
+ * variable is a token of its own, an operand like a number, e.g. "x*x-2".
+ *
+ * Operators are evaluated left to right, * and / before + and -. A leading
+ * + or - applies to the first term (e.g. "-3*2" is -6). An operand that is
+ * missing (e.g. "12+" or "3**4") or a number with two points makes the
+ * expression incomplete; it has no value until it is fixed.
+ *
+ * The expression and its caches are allocated from the engine pools
+ * (Calc_Memory_Tokens and Calc_Memory_Nodes, see Calc_Memory.h).
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef CALC_EXPR_H_
+#define CALC_EXPR_H_
+
+#include "Calc_Number.h"
+#include "Calc_Error.h"
+#include <stdint.h>
+
+// Longest expression (three LCD lines)
+#define CALC_EXPR_MAX_CHARS     48U
+
+// Most terms in an expression ("+1+1..." of CALC_EXPR_MAX_CHARS); a + or -
+// that would make more is refused
+#define CALC_EXPR_MAX_TERMS     (CALC_EXPR_MAX_CHARS / 2U + 1U)
+
+// Kinds of the operand tokens (operator tokens use the operator character)
+#define CALC_EXPR_NUMBER        'n'
+#define CALC_EXPR_VARIABLE      'x'
+
+typedef struct {
+    uint8_t start;          // first character in the text
+    uint8_t length;         // characters
+    char kind;              // CALC_EXPR_NUMBER, CALC_EXPR_VARIABLE or the operator
+} Calc_Expr_Token;
+
+typedef struct {
+    Calc_Number value;      // cached value (when valid)
+    uint8_t first;          // first token
+    uint8_t count;          // tokens
+    uint8_t valid;          // 1 if value and error are up to date
+    uint8_t complete;       // 1 if the term has all its operands
+    Calc_Error error;
+} Calc_Expr_Term;
+
+typedef struct {
+    uint32_t tokens_lexed;      // by the last edit
+    uint32_t terms_evaluated;   // by the last edit
+    uint32_t terms;             // in the expression
+} Calc_Expr_Stats;
+
+typedef struct {
+    char text[CALC_EXPR_MAX_CHARS + 1];
+    uint8_t length;
+    uint8_t cursor;             // 0 (before the first character) to length
+
+    Calc_Expr_Token *tokens;
+    uint8_t token_count;
+
+    Calc_Expr_Term *terms;
+    uint8_t term_count;
+
+    // Value of x, if the expression may use it
+    uint8_t has_variable;
+    Calc_Number variable;
+
+    // Value of the whole expression after the last edit
+    Calc_Number value;
+    Calc_Error error;
+    uint8_t complete;
+
+    Calc_Expr_Stats stats;
+} Calc_Expr;
+
+/**
+ * @brief Create an expression from the engine pools.
+ *
+ * The initial text is lexed and parsed in one pass.
+ *
+ * @param initial  The initial text (characters that cannot be inserted are
+ *                 skipped). The cursor is placed at its end.
+ * @param variable The value of x, whose value is shown while editing a
+ *                 function of x, or NULL if the expression may not use x.
+ *
+ * @return Calc_Expr* The expression, or NULL if the pools are full.
+ */
+Calc_Expr *Calc_Expr_Create(const char *initial, const Calc_Number *variable);
+
+/**
+ * @brief Insert a character at the cursor, and move the cursor after it.
+ *
+ * @param expr The expression.
+ * @param c    A digit, '.', '+', '-', '*', '/' or 'x' (if allowed).
+ *
+ * @return uint8_t 1 if inserted, 0 if the character is not allowed or the
+ *         expression is full.
+ */
+uint8_t Calc_Expr_Insert(Calc_Expr *expr, char c);
+
+/**
+ * @brief Delete the character before the cursor.
+ *
+ * @param expr The expression.
+ *
+ * @return uint8_t 1 if deleted, 0 if the cursor is at the start.
+ */
+uint8_t Calc_Expr_Delete(Calc_Expr *expr);
+
+/**
+ * @brief Move the cursor by a number of characters (clamped to the text).
+ *
+ * @param expr  The expression.
+ * @param delta Characters to move, negative to the left.
+ *
+ * @return None
+ */
+void Calc_Expr_Move(Calc_Expr *expr, int32_t delta);
+
+/**
+ * @brief Get the work done by the last edit.
+ *
+ * @param expr  The expression.
+ * @param stats Receives the statistics.
+ *
+ * @return None
+ */
+void Calc_Expr_Get_Stats(const Calc_Expr *expr, Calc_Expr_Stats *stats);
+
+#endif // CALC_EXPR_H_
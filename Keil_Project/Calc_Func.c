@@ -0,0 +1,454 @@
+/**
+ * @file Calc_Func.c
+ *
+ * @brief Source code for the Calc_Func module.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Calc_Func.h"
+#include "Calc_Expr.h"
+#include "Calc_Memory.h"
+#include <string.h>
+
+#ifdef CALC_FUNC_JIT
+#include "TM4C123GH6PM.h"
+#endif
+
+// Every token becomes one instruction, plus the 0 before a leading sign
+#define CALC_FUNC_MAX_LENGTH    (CALC_EXPR_MAX_CHARS + 1U)
+
+#ifdef CALC_FUNC_JIT
+
+// Most operands in the code (they alternate with the operators)
+#define CALC_FUNC_MAX_OPERANDS  ((CALC_FUNC_MAX_LENGTH + 1U) / 2U)
+
+// Largest machine code: a load per operand, an operation per operator, the
+// result and argument moves, then BX LR with its padding and the literal
+// pool
+#define CALC_FUNC_JIT_MAX_BYTES ((3U * CALC_FUNC_MAX_OPERANDS + 2U) * 4U + 4U)
+
+_Static_assert(CALC_FUNC_JIT_MAX_BYTES <= CALC_MEMORY_CODE_BYTES, "A function does not fit in the code pool");
+
+// Registers for the stack slots: s1 to s15 (s0 holds x)
+#define CALC_FUNC_JIT_REGISTERS 0xFFFEU
+
+// Thumb-2 FPU encodings (first halfword, second halfword), single precision
+#define THUMB_VADD              0xEE30U, 0x0A00U
+#define THUMB_VSUB              0xEE30U, 0x0A40U
+#define THUMB_VMUL              0xEE20U, 0x0A00U
+#define THUMB_VDIV              0xEE80U, 0x0A00U
+#define THUMB_VMOV              0xEEB0U, 0x0A40U
+#define THUMB_VLDR_PC           0xED9FU, 0x0A00U
+#define THUMB_VMOV_TO_CORE      0xEE10U, 0x0A10U
+#define THUMB_VMOV_FROM_CORE    0xEE00U, 0x0A10U
+#define THUMB_BX_LR             0x4770U
+
+// A stack slot during compilation: a register, or a constant not loaded yet
+typedef struct {
+    uint8_t is_constant;
+    uint8_t index;          // register number, or literal pool entry
+} Calc_Func_Slot;
+
+typedef struct {
+    uint16_t *code;
+    uint32_t length;        // halfwords
+    uint32_t free_registers;
+
+    float constants[CALC_FUNC_MAX_OPERANDS];
+    uint32_t constant_count;
+
+    // VLDR instructions to point at the literal pool
+    struct {
+        uint8_t at;         // halfword of the instruction
+        uint8_t constant;
+    } loads[CALC_FUNC_MAX_OPERANDS];
+    uint32_t load_count;
+} Calc_Func_Jit;
+
+#endif
+
+static uint8_t Calc_Func_Is_Number_Char(char c)
+{
+    return (c >= '0' && c <= '9') || c == '.';
+}
+
+// Compile an operand (a number or x) at *text, or return 0 if there is none
+static uint8_t Calc_Func_Operand(const char **text, Calc_Func_Instruction *instruction)
+{
+    const char *p = *text;
+
+    if (*p == CALC_EXPR_VARIABLE)
+    {
+        instruction->opcode = CALC_FUNC_VARIABLE;
+        instruction->constant = 0.0f;
+        *text = p + 1;
+        return 1;
+    }
+
+    char buf[CALC_EXPR_MAX_CHARS + 1];
+    uint32_t length = 0;
+    uint32_t points = 0;
+
+    while (Calc_Func_Is_Number_Char(p[length]) && length < CALC_EXPR_MAX_CHARS)
+    {
+        buf[length] = p[length];
+        points += (p[length] == '.');
+        length++;
+    }
+    buf[length] = '\0';
+
+    if (length == 0 || points > 1)
+    {
+        return 0;
+    }
+
+    instruction->opcode = CALC_FUNC_CONSTANT;
+    instruction->constant = (float)Calc_Number_To_Double(Calc_Number_Parse(buf));
+    *text = p + length;
+    return 1;
+}
+
+#ifdef CALC_FUNC_JIT
+
+// Emit a data-processing instruction on single registers sd, sn and sm
+static void Calc_Func_Jit_Emit(Calc_Func_Jit *jit, uint16_t first, uint16_t second,
+                               uint32_t d, uint32_t n, uint32_t m)
+{
+    jit->code[jit->length++] = (uint16_t)(first | ((d & 1U) << 6) | (n >> 1));
+    jit->code[jit->length++] = (uint16_t)(second | ((d >> 1) << 12) | ((n & 1U) << 7) | ((m & 1U) << 5) | (m >> 1));
+}
+
+// Allocate the lowest free register, or return 0 if there is none
+static uint32_t Calc_Func_Jit_Allocate(Calc_Func_Jit *jit)
+{
+    for (uint32_t r = 1; r < 16U; r++)
+    {
+        if (jit->free_registers & (1U << r))
+        {
+            jit->free_registers &= ~(1U << r);
+            return r;
+        }
+    }
+    return 0;
+}
+
+static void Calc_Func_Jit_Free(Calc_Func_Jit *jit, uint32_t r)
+{
+    if (r != 0)
+    {
+        jit->free_registers |= (1U << r);
+    }
+}
+
+// Get the literal pool entry of a constant, shared by equal constants
+static uint8_t Calc_Func_Jit_Constant(Calc_Func_Jit *jit, float constant)
+{
+    for (uint32_t i = 0; i < jit->constant_count; i++)
+    {
+        if (memcmp(&jit->constants[i], &constant, sizeof(constant)) == 0)
+        {
+            return (uint8_t)i;
+        }
+    }
+    jit->constants[jit->constant_count] = constant;
+    return (uint8_t)jit->constant_count++;
+}
+
+// Load a constant into sd (the offset is filled in with the literal pool)
+static void Calc_Func_Jit_Load(Calc_Func_Jit *jit, uint8_t constant, uint32_t d)
+{
+    jit->loads[jit->load_count].at = (uint8_t)jit->length;
+    jit->loads[jit->load_count].constant = constant;
+    jit->load_count++;
+    Calc_Func_Jit_Emit(jit, THUMB_VLDR_PC, d, 0, 0);
+}
+
+// Put a slot in a register; return 0 if there is none left
+static uint8_t Calc_Func_Jit_Register(Calc_Func_Jit *jit, Calc_Func_Slot *slot)
+{
+    if (slot->is_constant)
+    {
+        uint32_t r = Calc_Func_Jit_Allocate(jit);
+
+        if (r == 0)
+        {
+            return 0;
+        }
+        Calc_Func_Jit_Load(jit, slot->index, r);
+        slot->is_constant = 0;
+        slot->index = (uint8_t)r;
+    }
+    return 1;
+}
+
+// Compile the postfix code of a function to machine code; the function is
+// left interpreted if the code pool is full
+static void Calc_Func_Jit_Compile(Calc_Func *func)
+{
+    static Calc_Func_Jit jit;       // off the stack
+    Calc_Func_Slot stack[CALC_FUNC_STACK_SIZE];
+    uint32_t top = 0;
+    uint32_t mark = Arena_Mark(&Calc_Memory_Code);
+    uint8_t *buffer = Arena_Alloc(&Calc_Memory_Code, CALC_FUNC_JIT_MAX_BYTES, 4U);
+
+    if (buffer == NULL)
+    {
+        return;
+    }
+
+    jit.code = (uint16_t *)buffer;
+    jit.length = 0;
+    jit.free_registers = CALC_FUNC_JIT_REGISTERS;
+    jit.constant_count = 0;
+    jit.load_count = 0;
+
+#ifndef __ARM_PCS_VFP
+    // Soft-float calling convention: x arrives in r0
+    Calc_Func_Jit_Emit(&jit, THUMB_VMOV_FROM_CORE, 0, 0, 0);
+#endif
+
+    // Operands are only loaded when an operation needs them, so x is used
+    // in s0 and a constant is loaded straight into its operand register
+    for (uint32_t i = 0; i < func->length; i++)
+    {
+        const Calc_Func_Instruction *instruction = &func->code[i];
+
+        if (instruction->opcode == CALC_FUNC_CONSTANT)
+        {
+            stack[top].is_constant = 1;
+            stack[top].index = Calc_Func_Jit_Constant(&jit, instruction->constant);
+            top++;
+            continue;
+        }
+        if (instruction->opcode == CALC_FUNC_VARIABLE)
+        {
+            stack[top].is_constant = 0;
+            stack[top].index = 0;
+            top++;
+            continue;
+        }
+
+        Calc_Func_Slot *left = &stack[top - 2];
+        Calc_Func_Slot *right = &stack[top - 1];
+
+        if (!Calc_Func_Jit_Register(&jit, left) || !Calc_Func_Jit_Register(&jit, right))
+        {
+            Arena_Release(&Calc_Memory_Code, mark);
+            return;
+        }
+
+        // The result replaces the left operand, or the right one if the
+        // left is x, or takes a new register if both are x
+        uint32_t d = (left->index != 0) ? left->index : right->index;
+
+        if (d == 0)
+        {
+            d = Calc_Func_Jit_Allocate(&jit);
+            if (d == 0)
+            {
+                Arena_Release(&Calc_Memory_Code, mark);
+                return;
+            }
+        }
+
+        switch (instruction->opcode)
+        {
+            case CALC_FUNC_ADD:
+                Calc_Func_Jit_Emit(&jit, THUMB_VADD, d, left->index, right->index);
+                break;
+
+            case CALC_FUNC_SUB:
+                Calc_Func_Jit_Emit(&jit, THUMB_VSUB, d, left->index, right->index);
+                break;
+
+            case CALC_FUNC_MUL:
+                Calc_Func_Jit_Emit(&jit, THUMB_VMUL, d, left->index, right->index);
+                break;
+
+            default:
+                Calc_Func_Jit_Emit(&jit, THUMB_VDIV, d, left->index, right->index);
+                break;
+        }
+
+        if (right->index != d)
+        {
+            Calc_Func_Jit_Free(&jit, right->index);
+        }
+        top--;
+        left->index = (uint8_t)d;
+    }
+
+    // The result goes in s0
+    if (stack[0].is_constant)
+    {
+        Calc_Func_Jit_Load(&jit, stack[0].index, 0);
+    }
+    else if (stack[0].index != 0)
+    {
+        Calc_Func_Jit_Emit(&jit, THUMB_VMOV, 0, 0, stack[0].index);
+    }
+
+#ifndef __ARM_PCS_VFP
+    Calc_Func_Jit_Emit(&jit, THUMB_VMOV_TO_CORE, 0, 0, 0);
+#endif
+
+    jit.code[jit.length++] = THUMB_BX_LR;
+    if (jit.length & 1U)
+    {
+        jit.code[jit.length++] = 0;
+    }
+
+    // Literal pool; VLDR addresses it from the instruction's PC + 4, aligned
+    // down to a word
+    uint32_t pool = jit.length * 2U;
+
+    memcpy(buffer + pool, jit.constants, jit.constant_count * sizeof(float));
+    for (uint32_t i = 0; i < jit.load_count; i++)
+    {
+        uint32_t pc = (jit.loads[i].at * 2U + 4U) & ~3U;
+
+        jit.code[jit.loads[i].at + 1U] |= (uint16_t)((pool + jit.loads[i].constant * 4U - pc) / 4U);
+    }
+
+    // Finish the writes before the code is fetched
+    __DSB();
+    __ISB();
+
+    func->native = (Calc_Func_Native)((uintptr_t)buffer | 1U);
+    func->native_bytes = pool + jit.constant_count * 4U;
+}
+
+#endif
+
+Calc_Func *Calc_Func_Compile(const char *text)
+{
+    uint32_t mark = Arena_Mark(&Calc_Memory_Nodes);
+    Calc_Func *func = ARENA_NEW(&Calc_Memory_Nodes, Calc_Func);
+    Calc_Func_Instruction *code = ARENA_NEW_ARRAY(&Calc_Memory_Nodes, Calc_Func_Instruction, CALC_FUNC_MAX_LENGTH);
+    uint32_t length = 0;
+    uint8_t first_term = 1;
+    char separator = '+';
+
+    if (func == NULL || code == NULL || strlen(text) > CALC_EXPR_MAX_CHARS)
+    {
+        Arena_Release(&Calc_Memory_Nodes, mark);
+        return NULL;
+    }
+
+    // A leading sign applies to the first term: "-x" is "0-x"
+    if (*text == '+' || *text == '-')
+    {
+        code[length].opcode = CALC_FUNC_CONSTANT;
+        code[length].constant = 0.0f;
+        length++;
+        first_term = 0;
+        separator = *text;
+        text++;
+    }
+
+    // expression: term (('+' | '-') term)*, term: operand (('*' | '/') operand)*
+    while (1)
+    {
+        if (!Calc_Func_Operand(&text, &code[length]))
+        {
+            break;
+        }
+        length++;
+
+        while (*text == '*' || *text == '/')
+        {
+            Calc_Func_Opcode opcode = (*text == '*') ? CALC_FUNC_MUL : CALC_FUNC_DIV;
+
+            text++;
+            if (!Calc_Func_Operand(&text, &code[length]))
+            {
+                Arena_Release(&Calc_Memory_Nodes, mark);
+                return NULL;
+            }
+            code[length + 1].opcode = opcode;
+            code[length + 1].constant = 0.0f;
+            length += 2;
+        }
+
+        if (!first_term)
+        {
+            code[length].opcode = (separator == '+') ? CALC_FUNC_ADD : CALC_FUNC_SUB;
+            code[length].constant = 0.0f;
+            length++;
+        }
+        first_term = 0;
+
+        if (*text == '\0')
+        {
+            func->code = code;
+            func->length = length;
+            func->native = NULL;
+            func->native_bytes = 0;
+#ifdef CALC_FUNC_JIT
+            Calc_Func_Jit_Compile(func);
+#endif
+            return func;
+        }
+
+        if (*text != '+' && *text != '-')
+        {
+            break;
+        }
+        separator = *text;
+        text++;
+    }
+
+    // Missing operand
+    Arena_Release(&Calc_Memory_Nodes, mark);
+    return NULL;
+}
+
+float Calc_Func_Eval(const Calc_Func *func, float x)
+{
+    if (func->native != NULL)
+    {
+        return func->native(x);
+    }
+
+    float stack[CALC_FUNC_STACK_SIZE];
+    uint32_t top = 0;
+
+    for (uint32_t i = 0; i < func->length; i++)
+    {
+        const Calc_Func_Instruction *instruction = &func->code[i];
+
+        switch (instruction->opcode)
+        {
+            case CALC_FUNC_CONSTANT:
+                stack[top++] = instruction->constant;
+                break;
+
+            case CALC_FUNC_VARIABLE:
+                stack[top++] = x;
+                break;
+
+            case CALC_FUNC_ADD:
+                top--;
+                stack[top - 1] += stack[top];
+                break;
+
+            case CALC_FUNC_SUB:
+                top--;
+                stack[top - 1] -= stack[top];
+                break;
+
+            case CALC_FUNC_MUL:
+                top--;
+                stack[top - 1] *= stack[top];
+                break;
+
+            default:
+                top--;
+                stack[top - 1] /= stack[top];
+                break;
+        }
+    }
+
+    return stack[0];
+}
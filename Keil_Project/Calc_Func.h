@@ -0,0 +1,102 @@
+/**
+ * @file Calc_Func.h
+ *
+ * @brief Header file for the Calc_Func module.
+ *
+ * It compiles a function of x, entered as an expression (see Calc_Expr.h),
+ * e.g. "x*x-2", for the numeric modes, which evaluate the same function
+ * hundreds or thousands of times. The expression is parsed once into
+ * postfix code, e.g. "x x * 2 -", and Calc_Func_Eval runs the code on a
+ * small stack.
+ *
+ * On the target, the postfix code is also compiled to machine code (a
+ * small JIT), so that an evaluation does not pay the interpreter's
+ * dispatch on every instruction. The code is straight-line Thumb-2 FPU
+ * instructions in an SRAM buffer, called like a C function:
+ *  - x stays in s0, where the calling convention passes it, and is used
+ *    in place.
+ *  - The stack slots are allocated to the caller-saved registers s1-s15,
+ *    so the code saves nothing; a sum of products needs four at most.
+ *  - The constants are in a literal pool after the code, one entry per
+ *    distinct value, loaded with VLDR when used.
+ * e.g. "x*x-2" becomes:
+ *      vmul.f32 s1, s0, s0
+ *      vldr     s2, [pc, #12]
+ *      vsub.f32 s1, s1, s2
+ *      vmov.f32 s0, s1
+ *      bx       lr
+ *      .float   2.0
+ * If the code does not fit in its pool, or on a host build, the function
+ * is interpreted instead, with the same results (tests/test_calc_func_jit.c
+ * runs the code on an emulator against the interpreter). Define
+ * CALC_FUNC_JIT_DISABLE to always interpret.
+ *
+ * The numeric modes work in single precision on the FPU (about 7
+ * significant digits), so that an evaluation costs a few cycles per
+ * operation instead of a call into the double-precision runtime. A
+ * division by zero or an overflow gives an infinity or a NaN, which the
+ * modes check for.
+ *
+ * The code is allocated from the engine pools (Calc_Memory_Nodes, and
+ * Calc_Memory_Code for the machine code, see Calc_Memory.h).
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef CALC_FUNC_H_
+#define CALC_FUNC_H_
+
+#include <stdint.h>
+
+#if !defined(CALC_FUNC_JIT_DISABLE) && defined(__ARM_ARCH_7EM__) && defined(__ARM_FP)
+#define CALC_FUNC_JIT
+#endif
+
+// Deepest stack of a sum of products: the sum, the product, and an operand
+#define CALC_FUNC_STACK_SIZE    3U
+
+typedef enum {
+    CALC_FUNC_CONSTANT,
+    CALC_FUNC_VARIABLE,
+    CALC_FUNC_ADD,
+    CALC_FUNC_SUB,
+    CALC_FUNC_MUL,
+    CALC_FUNC_DIV
+} Calc_Func_Opcode;
+
+typedef struct {
+    Calc_Func_Opcode opcode;
+    float constant;             // CALC_FUNC_CONSTANT only
+} Calc_Func_Instruction;
+
+// Machine code of a function (the address has the Thumb bit set)
+typedef float (*Calc_Func_Native)(float x);
+
+typedef struct {
+    const Calc_Func_Instruction *code;
+    uint32_t length;            // instructions
+    Calc_Func_Native native;    // NULL if interpreted
+    uint32_t native_bytes;      // size of the machine code and its constants
+} Calc_Func;
+
+/**
+ * @brief Compile a function of x.
+ *
+ * @param text The expression, e.g. "x*x-2".
+ *
+ * @return Calc_Func* The function, or NULL if the expression is incomplete
+ *         or the pools are full.
+ */
+Calc_Func *Calc_Func_Compile(const char *text);
+
+/**
+ * @brief Evaluate a function, with its machine code if it has some.
+ *
+ * @param func The function.
+ * @param x    The value of x.
+ *
+ * @return float The value of the function at x.
+ */
+float Calc_Func_Eval(const Calc_Func *func, float x);
+
+#endif // CALC_FUNC_H_
@@ -0,0 +1,295 @@
+/**
+ * @file Calc_Integrate.c
+ *
+ * @brief Source code for the Calc_Integrate module.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Calc_Integrate.h"
+#include "Calc_Editor.h"
+#include "Calc_Memory.h"
+#include "Clock_Governor.h"
+#include "Cycle_Counter.h"
+#include "Keypad.h"
+#include "LCD_Frame.h"
+#include "TM4C123GH6PM.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// An interval still to be refined
+typedef struct {
+    float a;
+    float b;
+    float fa;
+    float fm;
+    float fb;
+    float whole;        // Simpson estimate over [a, b]
+    float tolerance;
+    float error;        // last known error, used if the interval is not refined
+} Calc_Integrate_Interval;
+
+_Static_assert(sizeof(Calc_Integrate_Interval) * CALC_INTEGRATE_STACK_SIZE <= CALC_MEMORY_SCRATCH_BYTES,
+               "The interval stack does not fit in the scratch pool");
+
+static Calc_Integrate_Result last_result;
+
+static float Calc_Integrate_Simpson(float a, float b, float fa, float fm, float fb)
+{
+    return (b - a) * (1.0f / 6.0f) * (fa + 4.0f * fm + fb);
+}
+
+void Calc_Integrate(const Calc_Func *func, float a, float b, const Calc_Integrate_Budget *budget,
+                    Calc_Integrate_Result *result)
+{
+    uint32_t start = Cycle_Counter_Read();
+    uint32_t mark = Arena_Mark(&Calc_Memory_Scratch);
+    Calc_Integrate_Interval *stack = ARENA_NEW_ARRAY(&Calc_Memory_Scratch, Calc_Integrate_Interval, CALC_INTEGRATE_STACK_SIZE);
+    uint32_t top = 0;
+    uint8_t depth_limited = 0;
+    double sum = 0.0;
+    double error = 0.0;
+
+    memset(result, 0, sizeof(Calc_Integrate_Result));
+    result->status = CALC_INTEGRATE_OK;
+    result->native = (func->native != NULL);
+
+    if (stack == NULL)
+    {
+        result->status = CALC_INTEGRATE_DEPTH;
+        return;
+    }
+
+    float m = 0.5f * (a + b);
+    float fa = Calc_Func_Eval(func, a);
+    float fm = Calc_Func_Eval(func, m);
+    float fb = Calc_Func_Eval(func, b);
+    float whole = Calc_Integrate_Simpson(a, b, fa, fm, fb);
+
+    result->evaluations = 3;
+
+    if (!isfinite(whole))
+    {
+        result->status = CALC_INTEGRATE_INVALID;
+    }
+    else
+    {
+        stack[0] = (Calc_Integrate_Interval){ a, b, fa, fm, fb, whole,
+                                              budget->tolerance * (1.0f + fabsf(whole)), 0.0f };
+        top = 1;
+        result->max_stack = 1;
+    }
+
+    while (top > 0)
+    {
+        if (result->status == CALC_INTEGRATE_OK)
+        {
+            if (result->evaluations + 2U > budget->max_evaluations)
+            {
+                result->status = CALC_INTEGRATE_EVALUATIONS;
+            }
+            else if (Cycle_Counter_Read() - start > budget->max_cycles)
+            {
+                result->status = CALC_INTEGRATE_CYCLES;
+            }
+        }
+
+        Calc_Integrate_Interval interval = stack[--top];
+
+        // Out of budget: accept the intervals left as they are
+        if (result->status != CALC_INTEGRATE_OK)
+        {
+            sum += interval.whole;
+            error += interval.error;
+            result->intervals++;
+            continue;
+        }
+
+        m = 0.5f * (interval.a + interval.b);
+        float left_m = 0.5f * (interval.a + m);
+        float right_m = 0.5f * (m + interval.b);
+        float f_left_m = Calc_Func_Eval(func, left_m);
+        float f_right_m = Calc_Func_Eval(func, right_m);
+
+        result->evaluations += 2;
+
+        float left = Calc_Integrate_Simpson(interval.a, m, interval.fa, f_left_m, interval.fm);
+        float right = Calc_Integrate_Simpson(m, interval.b, interval.fm, f_right_m, interval.fb);
+        float delta = left + right - interval.whole;
+
+        if (!isfinite(delta))
+        {
+            result->status = CALC_INTEGRATE_INVALID;
+            break;
+        }
+
+        // Too narrow to split in single precision, or no room for the halves
+        uint8_t cannot_split = (left_m == interval.a || right_m == m || top + 2U > CALC_INTEGRATE_STACK_SIZE);
+
+        if (fabsf(delta) <= 15.0f * interval.tolerance || cannot_split)
+        {
+            if (fabsf(delta) > 15.0f * interval.tolerance)
+            {
+                depth_limited = 1;
+            }
+
+            sum += (double)(left + right) + (double)delta / 15.0;
+            error += fabsf(delta) / 15.0f;
+            result->intervals++;
+        }
+        else
+        {
+            float half_error = fabsf(delta) / 30.0f;
+
+            stack[top++] = (Calc_Integrate_Interval){ m, interval.b, interval.fm, f_right_m, interval.fb, right,
+                                                      0.5f * interval.tolerance, half_error };
+            stack[top++] = (Calc_Integrate_Interval){ interval.a, m, interval.fa, f_left_m, interval.fm, left,
+                                                      0.5f * interval.tolerance, half_error };
+
+            if (top > result->max_stack)
+            {
+                result->max_stack = top;
+            }
+        }
+    }
+
+    if (result->status == CALC_INTEGRATE_OK && depth_limited)
+    {
+        result->status = CALC_INTEGRATE_DEPTH;
+    }
+
+    if (result->status != CALC_INTEGRATE_INVALID)
+    {
+        result->value = sum;
+        result->error_estimate = error;
+    }
+
+    result->cycles = Cycle_Counter_Read() - start;
+
+    // Converted now, the clock may have changed by the time it is shown
+    result->time_us = result->cycles / (SystemCoreClock / 1000000U);
+    Arena_Release(&Calc_Memory_Scratch, mark);
+}
+
+static const char *const status_labels[] = {
+    "",         // CALC_INTEGRATE_OK
+    " evals",   // CALC_INTEGRATE_EVALUATIONS
+    " time",    // CALC_INTEGRATE_CYCLES
+    " depth",   // CALC_INTEGRATE_DEPTH
+    ""          // CALC_INTEGRATE_INVALID
+};
+
+// Page 0: the integral and its error estimate, page 1: evaluations and time
+static void Calc_Integrate_Draw(const Calc_Integrate_Result *result, uint8_t page)
+{
+    char line[LCD_FRAME_COLUMNS + 1];
+
+    LCD_Frame_Clear();
+
+    if (result->status == CALC_INTEGRATE_INVALID)
+    {
+        LCD_Frame_Print("Err: Invalid");
+        LCD_Frame_Set_Cursor(0, 1);
+        LCD_Frame_Print("f not finite");
+    }
+    else if (page == 0)
+    {
+        LCD_Frame_Print("I=");
+        Calc_Number_Format(Calc_Number_From_Double(result->value), line, sizeof(line) - 2U);
+        LCD_Frame_Print(line);
+
+        LCD_Frame_Set_Cursor(0, 1);
+        snprintf(line, sizeof(line), "+-%.2e%s", result->error_estimate, status_labels[result->status]);
+        LCD_Frame_Print(line);
+    }
+    else
+    {
+        snprintf(line, sizeof(line), "n=%u", (unsigned)result->evaluations);
+        LCD_Frame_Print(line);
+
+        LCD_Frame_Set_Cursor(0, 1);
+        snprintf(line, sizeof(line), "%u us", (unsigned)result->time_us);
+        LCD_Frame_Print(line);
+    }
+
+    LCD_Frame_Flush();
+}
+
+uint8_t Calc_Integrate_Mode(Calc_Number *value)
+{
+    char text[CALC_EXPR_MAX_CHARS + 1];
+    Calc_Number a;
+    Calc_Number b;
+    Calc_Number f_m;
+    uint8_t accepted = 0;
+    uint8_t page = 0;
+
+    strcpy(text, "0");
+    if (!Calc_Editor_Run("a=", NULL, text, &a))
+    {
+        return 0;
+    }
+
+    strcpy(text, "1");
+    if (!Calc_Editor_Run("b=", NULL, text, &b))
+    {
+        return 0;
+    }
+
+    // The value shown while f is entered is f at the midpoint
+    Calc_Number m = Calc_Number_From_Double(0.5 * (Calc_Number_To_Double(a) + Calc_Number_To_Double(b)));
+
+    strcpy(text, "x");
+    if (!Calc_Editor_Run("f(m)=", &m, text, &f_m))
+    {
+        return 0;
+    }
+
+    uint32_t mark = Arena_Mark(&Calc_Memory_Nodes);
+    uint32_t code_mark = Arena_Mark(&Calc_Memory_Code);
+    const Calc_Func *func = Calc_Func_Compile(text);
+
+    if (func != NULL)
+    {
+        Calc_Integrate_Budget budget = {
+            CALC_INTEGRATE_TOLERANCE, CALC_INTEGRATE_MAX_EVALUATIONS, CALC_INTEGRATE_MAX_CYCLES
+        };
+
+        // The editor may have let the clock drop to idle speed
+        Clock_Governor_Request_Fast();
+
+        Calc_Integrate(func, (float)Calc_Number_To_Double(a), (float)Calc_Number_To_Double(b), &budget, &last_result);
+
+        while (1)
+        {
+            Calc_Integrate_Draw(&last_result, page);
+
+            char key = Keypad_WaitForChar();
+
+            if (key == '=' && last_result.status != CALC_INTEGRATE_INVALID)
+            {
+                *value = Calc_Number_From_Double(last_result.value);
+                accepted = 1;
+                break;
+            }
+            else if (key == '/')
+            {
+                page ^= 1U;
+            }
+            else if (key == '.')
+            {
+                break;
+            }
+        }
+    }
+
+    Arena_Release(&Calc_Memory_Nodes, mark);
+    Arena_Release(&Calc_Memory_Code, code_mark);
+    return accepted;
+}
+
+void Calc_Integrate_Get_Last(Calc_Integrate_Result *result)
+{
+    *result = last_result;
+}
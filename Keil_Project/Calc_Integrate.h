@@ -0,0 +1,115 @@
+/**
+ * @file Calc_Integrate.h
+ *
+ * @brief Header file for the Calc_Integrate module.
+ *
+ * It is the integration mode of the calculator: the user enters the bounds
+ * a and b and a function f(x) (see Calc_Editor.h), and the integral of f
+ * from a to b is computed with adaptive Simpson quadrature.
+ *
+ * The quadrature is iterative. The intervals still to be refined are kept
+ * on an explicit stack in the scratch pool (Calc_Memory_Scratch), so its
+ * memory is bounded and known at compile time, and it cannot overflow the
+ * call stack:
+ *  1. Pop an interval, evaluate f at the midpoints of its two halves, and
+ *     compare the Simpson estimates of the halves with the one of the
+ *     whole interval.
+ *  2. If they agree within 15 times the tolerance of the interval, accept
+ *     the halves (with Richardson's correction); the difference divided by
+ *     15 is added to the error estimate.
+ *  3. Otherwise push the two halves, each with half the tolerance.
+ *
+ * The computation is bounded by a budget of evaluations of f and of CPU
+ * cycles. When the budget runs out, or the stack is full, the intervals
+ * left are accepted as they are, and the status says so: the error
+ * estimate then includes the last known differences of those intervals
+ * and is less reliable.
+ *
+ * The result reports the error estimate, the number of evaluations, and
+ * the time taken.
+ *
+ * Mode keys, after the integral is shown:
+ *  - '=': accept the integral as a result and exit
+ *  - '/': show the other page (value and error / evaluations and time)
+ *  - '.': exit
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef CALC_INTEGRATE_H_
+#define CALC_INTEGRATE_H_
+
+#include "Calc_Func.h"
+#include "Calc_Number.h"
+#include <stdint.h>
+
+// Hold time of the '/' key that opens the mode
+#define CALC_INTEGRATE_HOLD_US          1000000U
+
+// Intervals on the stack (the deepest refinement is about as many halvings)
+#define CALC_INTEGRATE_STACK_SIZE       24U
+
+// Default budget
+#define CALC_INTEGRATE_TOLERANCE        1.0e-5f
+#define CALC_INTEGRATE_MAX_EVALUATIONS  4000U
+#define CALC_INTEGRATE_MAX_CYCLES       40000000U   // 0.5 s at 80 MHz
+
+typedef enum {
+    CALC_INTEGRATE_OK,
+    CALC_INTEGRATE_EVALUATIONS,     // evaluation budget used up
+    CALC_INTEGRATE_CYCLES,          // cycle budget used up
+    CALC_INTEGRATE_DEPTH,           // stack full, intervals accepted unrefined
+    CALC_INTEGRATE_INVALID          // f is not finite somewhere
+} Calc_Integrate_Status;
+
+typedef struct {
+    float tolerance;                // relative to 1 + |integral|
+    uint32_t max_evaluations;
+    uint32_t max_cycles;
+} Calc_Integrate_Budget;
+
+typedef struct {
+    double value;
+    double error_estimate;
+    uint32_t evaluations;
+    uint32_t cycles;
+    uint32_t time_us;               // cycles at the clock they were counted at
+    uint32_t intervals;             // accepted
+    uint32_t max_stack;             // deepest use of the stack
+    uint8_t native;                 // 1 if f ran as machine code (see Calc_Func.h)
+    Calc_Integrate_Status status;
+} Calc_Integrate_Result;
+
+/**
+ * @brief Integrate a function with adaptive Simpson quadrature.
+ *
+ * @param func   The function.
+ * @param a      The lower bound.
+ * @param b      The upper bound.
+ * @param budget The tolerance and the budget.
+ * @param result Receives the integral and the statistics.
+ *
+ * @return None
+ */
+void Calc_Integrate(const Calc_Func *func, float a, float b, const Calc_Integrate_Budget *budget,
+                    Calc_Integrate_Result *result);
+
+/**
+ * @brief Run the integration mode until the user exits.
+ *
+ * @param value Receives the integral, if accepted.
+ *
+ * @return uint8_t 1 if the integral was accepted, 0 otherwise.
+ */
+uint8_t Calc_Integrate_Mode(Calc_Number *value);
+
+/**
+ * @brief Get the result of the last integration of the mode.
+ *
+ * @param result Receives the result.
+ *
+ * @return None
+ */
+void Calc_Integrate_Get_Last(Calc_Integrate_Result *result);
+
+#endif // CALC_INTEGRATE_H_
@@ -0,0 +1,59 @@
+/**
+ * @file Calc_Memory.c
+ *
+ * @brief Source code for the Calc_Memory module.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Calc_Memory.h"
+#include "Memory_Map.h"
+
+// The rest of the SRAM data (drivers, buffers, C library) is left to the linker
+_Static_assert(CALC_MEMORY_BYTES + MEMORY_STACK_SIZE + MEMORY_HEAP_SIZE + MEMORY_NOINIT_SIZE <= MEMORY_SRAM_SIZE,
+               "The engine pools, the stack, the heap and the watchdog record do not fit in the SRAM");
+
+// 8-byte storage, aligned for double and int64_t
+ARENA_DEFINE(Calc_Memory_Tokens, uint64_t, CALC_MEMORY_TOKEN_BYTES / 8U);
+ARENA_DEFINE(Calc_Memory_Nodes, uint64_t, CALC_MEMORY_NODE_BYTES / 8U);
+ARENA_DEFINE(Calc_Memory_Scratch, uint64_t, CALC_MEMORY_SCRATCH_BYTES / 8U);
+ARENA_DEFINE(Calc_Memory_Code, uint32_t, CALC_MEMORY_CODE_BYTES / 4U);
+
+static Arena *const pools[] = {
+    &Calc_Memory_Tokens,
+    &Calc_Memory_Nodes,
+    &Calc_Memory_Scratch,
+    &Calc_Memory_Code
+};
+
+#define POOL_COUNT                  (sizeof(pools) / sizeof(pools[0]))
+
+void Calc_Memory_Reset(void)
+{
+    for (uint32_t i = 0; i < POOL_COUNT; i++)
+    {
+        Arena_Reset(pools[i]);
+    }
+}
+
+uint32_t Calc_Memory_High_Water(void)
+{
+    uint32_t total = 0;
+
+    for (uint32_t i = 0; i < POOL_COUNT; i++)
+    {
+        total += pools[i]->high_water;
+    }
+    return total;
+}
+
+uint32_t Calc_Memory_Failures(void)
+{
+    uint32_t total = 0;
+
+    for (uint32_t i = 0; i < POOL_COUNT; i++)
+    {
+        total += pools[i]->failures;
+    }
+    return total;
+}
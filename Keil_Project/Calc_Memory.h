@@ -0,0 +1,75 @@
+/**
+ * @file Calc_Memory.h
+ *
+ * @brief Header file for the Calc_Memory module.
+ *
+ * It holds all the transient memory of the calculator engine, in one
+ * arena (see Arena.h) per kind of object:
+ *  - Calc_Memory_Tokens:  tokens of the expression being entered
+ *  - Calc_Memory_Nodes:   parse tree nodes
+ *  - Calc_Memory_Scratch: work areas of the numeric modes
+ *  - Calc_Memory_Code:    machine code compiled from functions of x
+ *
+ * Calc_Memory_Reset releases all of them in O(1) when a new calculation
+ * starts, so the memory used by the engine is deterministic: it never
+ * grows beyond the capacities below, and it cannot fragment.
+ *
+ * The pools are ordinary static arrays, placed by the linker with the rest
+ * of the SRAM data in the RW_IRAM1 region of the scatter file, which stops
+ * below the watchdog record (MEMORY_RAM_SIZE, see Memory_Map.h): data that
+ * does not fit fails the link (L6220E), and the map file
+ * (Listings/ECE425_Final_SibCal.map) shows the size of each pool. The
+ * pools, the stack, the heap and the watchdog record are also checked
+ * against the 32 KB SRAM at compile time (Calc_Memory.c).
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef CALC_MEMORY_H_
+#define CALC_MEMORY_H_
+
+#include "Arena.h"
+#include <stdint.h>
+
+// Capacities of the engine pools (bytes)
+#define CALC_MEMORY_TOKEN_BYTES     512U
+#define CALC_MEMORY_NODE_BYTES      1024U
+#define CALC_MEMORY_SCRATCH_BYTES   1024U
+#define CALC_MEMORY_CODE_BYTES      320U
+
+#define CALC_MEMORY_BYTES           (CALC_MEMORY_TOKEN_BYTES + CALC_MEMORY_NODE_BYTES + \
+                                     CALC_MEMORY_SCRATCH_BYTES + CALC_MEMORY_CODE_BYTES)
+
+extern Arena Calc_Memory_Tokens;
+extern Arena Calc_Memory_Nodes;
+extern Arena Calc_Memory_Scratch;
+extern Arena Calc_Memory_Code;
+
+/**
+ * @brief Release all engine memory, at the start of a new calculation.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Calc_Memory_Reset(void);
+
+/**
+ * @brief Get the highest total use of the engine pools since startup.
+ *
+ * @param None
+ *
+ * @return uint32_t The sum of the high-water marks of the pools, in bytes.
+ */
+uint32_t Calc_Memory_High_Water(void);
+
+/**
+ * @brief Get the number of allocations that failed because a pool was full.
+ *
+ * @param None
+ *
+ * @return uint32_t The number of failed allocations.
+ */
+uint32_t Calc_Memory_Failures(void);
+
+#endif // CALC_MEMORY_H_
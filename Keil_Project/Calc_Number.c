@@ -0,0 +1,361 @@
+/**
+ * @file Calc_Number.c
+ *
+ * @brief Source code for the Calc_Number numeric engine.
+ *
+ * Integer values are kept as int64_t and combined with overflow-checked
+ * integer arithmetic. Values are promoted to the floating-point backend
+ * (double, Double_Float, or Soft_Double) only on a decimal point, an inexact division,
+ * or an overflow.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Calc_Number.h"
+#include "Soft_Double.h"
+#include "BCD.h"
+#include <stdio.h>
+#include <stdlib.h>   // for strtod
+#include <string.h>
+
+// ----- Floating-point backend -----
+
+#if (CALC_NUMBER_BACKEND == CALC_BACKEND_DOUBLE_FLOAT)
+
+#define Calc_Float_From_Double  Double_Float_From_Double
+#define Calc_Float_From_Int     Double_Float_From_Int
+#define Calc_Float_To_Double    Double_Float_To_Double
+#define Calc_Float_Add          Double_Float_Add
+#define Calc_Float_Sub          Double_Float_Sub
+#define Calc_Float_Mul          Double_Float_Mul
+#define Calc_Float_Div          Double_Float_Div
+#define Calc_Float_Is_Zero(x)   ((x).hi == 0.0f)
+
+#elif (CALC_NUMBER_BACKEND == CALC_BACKEND_SOFT_DOUBLE)
+
+#define Calc_Float_From_Double(x)   (x)
+#define Calc_Float_From_Int         Soft_Double_From_Int64
+#define Calc_Float_To_Double(x)     (x)
+#define Calc_Float_Add              Soft_Double_Add
+#define Calc_Float_Sub              Soft_Double_Sub
+#define Calc_Float_Mul              Soft_Double_Mul
+#define Calc_Float_Div              Soft_Double_Div
+#define Calc_Float_Is_Zero(x)       (Soft_Double_Compare((x), 0.0) == 0)
+
+#else
+
+// The runtime helpers do not report exceptions. Overflow and invalid
+// results are classified from the result once per evaluation (Calc_Error),
+// but a division by zero cannot be told apart from an overflow afterwards,
+// so it is recorded here.
+static uint32_t calc_number_flags = 0;
+
+static inline double Calc_Double_Div(double a, double b)
+{
+    if (b == 0.0)
+    {
+        calc_number_flags |= CALC_NUMBER_FLAG_DIVIDE_BY_ZERO;
+    }
+    return a / b;
+}
+
+#define Calc_Float_From_Double(x)   (x)
+#define Calc_Float_From_Int(x)      ((double)(x))
+#define Calc_Float_To_Double(x)     (x)
+#define Calc_Float_Add(a, b)        ((a) + (b))
+#define Calc_Float_Sub(a, b)        ((a) - (b))
+#define Calc_Float_Mul(a, b)        ((a) * (b))
+#define Calc_Float_Div              Calc_Double_Div
+#define Calc_Float_Is_Zero(x)       ((x) == 0.0)
+
+#endif
+
+// Promote an integer to the floating-point backend (no-op for floats)
+static Calc_Number Calc_Number_Promote(Calc_Number x)
+{
+    if (x.type == CALC_NUMBER_INT)
+    {
+        x.type = CALC_NUMBER_FLOAT;
+        x.value.f = Calc_Float_From_Int(x.value.i);
+    }
+    return x;
+}
+
+static Calc_Number Calc_Number_From_Float(Calc_Float value)
+{
+    Calc_Number x;
+    x.type = CALC_NUMBER_FLOAT;
+    x.value.f = value;
+    return x;
+}
+
+Calc_Number Calc_Number_From_Int(int64_t value)
+{
+    Calc_Number x;
+    x.type = CALC_NUMBER_INT;
+    x.value.i = value;
+    return x;
+}
+
+Calc_Number Calc_Number_From_Double(double value)
+{
+    return Calc_Number_From_Float(Calc_Float_From_Double(value));
+}
+
+Calc_Number Calc_Number_Parse(const char *entry)
+{
+    int64_t value = 0;
+
+    for (const char *p = entry; *p != '\0'; p++)
+    {
+        if (*p < '0' || *p > '9')
+        {
+            // Decimal point (or anything else): use the floating-point backend
+            return Calc_Number_From_Float(Calc_Float_From_Double(strtod(entry, NULL)));
+        }
+
+        int64_t digit = *p - '0';
+        if (value > (INT64_MAX - digit) / 10)
+        {
+            return Calc_Number_From_Float(Calc_Float_From_Double(strtod(entry, NULL)));
+        }
+
+        value = (value * 10) + digit;
+    }
+
+    return Calc_Number_From_Int(value);
+}
+
+Calc_Number Calc_Number_Add(Calc_Number a, Calc_Number b)
+{
+    if (a.type == CALC_NUMBER_INT && b.type == CALC_NUMBER_INT)
+    {
+        int64_t sum;
+        if (!__builtin_add_overflow(a.value.i, b.value.i, &sum))
+        {
+            return Calc_Number_From_Int(sum);
+        }
+    }
+
+    a = Calc_Number_Promote(a);
+    b = Calc_Number_Promote(b);
+    return Calc_Number_From_Float(Calc_Float_Add(a.value.f, b.value.f));
+}
+
+Calc_Number Calc_Number_Sub(Calc_Number a, Calc_Number b)
+{
+    if (a.type == CALC_NUMBER_INT && b.type == CALC_NUMBER_INT)
+    {
+        int64_t difference;
+        if (!__builtin_sub_overflow(a.value.i, b.value.i, &difference))
+        {
+            return Calc_Number_From_Int(difference);
+        }
+    }
+
+    a = Calc_Number_Promote(a);
+    b = Calc_Number_Promote(b);
+    return Calc_Number_From_Float(Calc_Float_Sub(a.value.f, b.value.f));
+}
+
+// Overflow-checked 64-bit multiply. Operands that both fit in 32 bits
+// compile to a single SMULL; wider operands are checked with 32x64
+// partial products so no runtime helper is pulled in.
+static uint8_t Calc_Number_Mul_Int(int64_t a, int64_t b, int64_t *product)
+{
+    if (a == (int32_t)a && b == (int32_t)b)
+    {
+        *product = (int64_t)(int32_t)a * (int32_t)b;
+        return 1;
+    }
+
+    uint8_t negative = (uint8_t)((a < 0) != (b < 0));
+    uint64_t u = (a < 0) ? (0 - (uint64_t)a) : (uint64_t)a;
+    uint64_t v = (b < 0) ? (0 - (uint64_t)b) : (uint64_t)b;
+
+    // Ensure v is the narrower operand
+    if (v > u)
+    {
+        uint64_t t = u;
+        u = v;
+        v = t;
+    }
+
+    if ((v >> 32) != 0)
+    {
+        return 0;
+    }
+
+    uint64_t low = (u & 0xFFFFFFFFU) * v;
+    uint64_t high = (u >> 32) * v;
+
+    if ((high >> 32) != 0)
+    {
+        return 0;
+    }
+
+    uint64_t magnitude = low + (high << 32);
+    if (magnitude < low)
+    {
+        return 0;
+    }
+
+    uint64_t limit = negative ? ((uint64_t)INT64_MAX + 1U) : (uint64_t)INT64_MAX;
+    if (magnitude > limit)
+    {
+        return 0;
+    }
+
+    *product = negative ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+    return 1;
+}
+
+Calc_Number Calc_Number_Mul(Calc_Number a, Calc_Number b)
+{
+    if (a.type == CALC_NUMBER_INT && b.type == CALC_NUMBER_INT)
+    {
+        int64_t product;
+        if (Calc_Number_Mul_Int(a.value.i, b.value.i, &product))
+        {
+            return Calc_Number_From_Int(product);
+        }
+    }
+
+    a = Calc_Number_Promote(a);
+    b = Calc_Number_Promote(b);
+    return Calc_Number_From_Float(Calc_Float_Mul(a.value.f, b.value.f));
+}
+
+Calc_Number Calc_Number_Div(Calc_Number a, Calc_Number b)
+{
+    if (a.type == CALC_NUMBER_INT && b.type == CALC_NUMBER_INT &&
+        b.value.i != 0 && !(a.value.i == INT64_MIN && b.value.i == -1))
+    {
+        // Stay integral only when the quotient is exact
+        if ((a.value.i % b.value.i) == 0)
+        {
+            return Calc_Number_From_Int(a.value.i / b.value.i);
+        }
+    }
+
+    a = Calc_Number_Promote(a);
+    b = Calc_Number_Promote(b);
+    return Calc_Number_From_Float(Calc_Float_Div(a.value.f, b.value.f));
+}
+
+uint8_t Calc_Number_Is_Zero(Calc_Number x)
+{
+    if (x.type == CALC_NUMBER_INT)
+    {
+        return (uint8_t)(x.value.i == 0);
+    }
+    return (uint8_t)Calc_Float_Is_Zero(x.value.f);
+}
+
+uint32_t Calc_Number_Get_Flags(void)
+{
+#if (CALC_NUMBER_BACKEND == CALC_BACKEND_SOFT_DOUBLE)
+    return Soft_Double_Get_Flags() & (CALC_NUMBER_FLAG_INVALID | CALC_NUMBER_FLAG_DIVIDE_BY_ZERO |
+                                      CALC_NUMBER_FLAG_OVERFLOW | CALC_NUMBER_FLAG_UNDERFLOW);
+#elif (CALC_NUMBER_BACKEND == CALC_BACKEND_DOUBLE)
+    return calc_number_flags;
+#else
+    return 0;
+#endif
+}
+
+void Calc_Number_Clear_Flags(void)
+{
+#if (CALC_NUMBER_BACKEND == CALC_BACKEND_SOFT_DOUBLE)
+    Soft_Double_Clear_Flags();
+#elif (CALC_NUMBER_BACKEND == CALC_BACKEND_DOUBLE)
+    calc_number_flags = 0;
+#endif
+}
+
+double Calc_Number_To_Double(Calc_Number x)
+{
+    return Calc_Float_To_Double(Calc_Number_Promote(x).value.f);
+}
+
+// Integer to decimal string without going through snprintf. The value is
+// split into base-10^8 chunks and each chunk is converted with the
+// packed-BCD kernels, 8 digits at a time.
+// Returns the number of characters written, or 0 if it does not fit.
+static size_t Calc_Number_Format_Int(int64_t value, char *buf, size_t size)
+{
+    uint32_t chunks[3];
+    size_t count = 0;
+    uint64_t magnitude = (value < 0) ? (0 - (uint64_t)value) : (uint64_t)value;
+
+    while (magnitude > UINT32_MAX)
+    {
+        chunks[count++] = (uint32_t)(magnitude % 100000000U);
+        magnitude /= 100000000U;
+    }
+
+    // Remaining value fits in 32 bits: use UDIV instead of the 64-bit helper
+    uint32_t remaining = (uint32_t)magnitude;
+    if (remaining >= 100000000U)
+    {
+        chunks[count++] = remaining % 100000000U;
+        remaining /= 100000000U;
+    }
+    chunks[count++] = remaining;
+
+    uint32_t top = BCD_From_Binary(chunks[count - 1]);
+    uint32_t top_digits = BCD_Digit_Count(top);
+
+    size_t length = top_digits + (BCD_DIGITS_PER_WORD * (count - 1)) + ((value < 0) ? 1U : 0U);
+    if (length + 1 > size)
+    {
+        return 0;
+    }
+
+    char digits[BCD_DIGITS_PER_WORD];
+    size_t pos = 0;
+
+    if (value < 0)
+    {
+        buf[pos++] = '-';
+    }
+
+    BCD_To_Ascii(top, digits);
+    memcpy(&buf[pos], &digits[BCD_DIGITS_PER_WORD - top_digits], top_digits);
+    pos += top_digits;
+
+    while (--count > 0)
+    {
+        BCD_To_Ascii(BCD_From_Binary(chunks[count - 1]), &buf[pos]);
+        pos += BCD_DIGITS_PER_WORD;
+    }
+    buf[pos] = '\0';
+
+    return pos;
+}
+
+void Calc_Number_Format(Calc_Number x, char *buf, size_t size)
+{
+    if (size == 0)
+    {
+        return;
+    }
+
+    if (x.type == CALC_NUMBER_INT && Calc_Number_Format_Int(x.value.i, buf, size) != 0)
+    {
+        return;
+    }
+
+    // Up to 10 significant digits, fewer if that does not fit (cutting the
+    // text would lose the exponent)
+    double value = Calc_Number_To_Double(x);
+
+    for (int precision = 10; precision > 1; precision--)
+    {
+        if ((size_t)snprintf(buf, size, "%.*g", precision, value) < size)
+        {
+            return;
+        }
+    }
+    snprintf(buf, size, "%.1g", value);
+}
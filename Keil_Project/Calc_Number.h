@@ -0,0 +1,165 @@
+/**
+ * @file Calc_Number.h
+ *
+ * @brief Header file for the Calc_Number numeric engine.
+ *
+ * The calculator keeps every operand as a tagged number. While a value is
+ * integral and fits in a signed 64-bit integer it is stored and computed as
+ * an integer, which keeps the common integer-only sessions (counts, part
+ * numbers) on the native integer ALU instead of the soft-double runtime.
+ *
+ * A value is promoted to the floating-point backend only when:
+ *  - the entry contains a decimal point
+ *  - a division does not produce an exact integer quotient
+ *  - an addition, subtraction, or multiplication overflows 64 bits
+ *
+ * Once promoted, a value stays floating-point for the rest of the calculation.
+ *
+ * The floating-point backend is selected at compile time with
+ * CALC_NUMBER_BACKEND:
+ *  - CALC_BACKEND_DOUBLE:       IEEE double through the compiler runtime
+ *  - CALC_BACKEND_DOUBLE_FLOAT: float-float pairs on the M4F FPU (Double_Float.h)
+ *  - CALC_BACKEND_SOFT_DOUBLE:  IEEE double through Soft_Double.h
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef CALC_NUMBER_H_
+#define CALC_NUMBER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "Double_Float.h"
+
+#define CALC_BACKEND_DOUBLE         0
+#define CALC_BACKEND_DOUBLE_FLOAT   1
+#define CALC_BACKEND_SOFT_DOUBLE    2
+
+#ifndef CALC_NUMBER_BACKEND
+#define CALC_NUMBER_BACKEND         CALC_BACKEND_DOUBLE
+#endif
+
+#if (CALC_NUMBER_BACKEND == CALC_BACKEND_DOUBLE_FLOAT)
+typedef Double_Float Calc_Float;
+#else
+typedef double Calc_Float;
+#endif
+
+// Exception flags raised by the floating-point backend (FPSCR IOC..UFC bit layout)
+#define CALC_NUMBER_FLAG_INVALID        0x01U
+#define CALC_NUMBER_FLAG_DIVIDE_BY_ZERO 0x02U
+#define CALC_NUMBER_FLAG_OVERFLOW       0x04U
+#define CALC_NUMBER_FLAG_UNDERFLOW      0x08U
+
+typedef enum {
+    CALC_NUMBER_INT,
+    CALC_NUMBER_FLOAT
+} Calc_Number_Type;
+
+typedef struct {
+    Calc_Number_Type type;
+    union {
+        int64_t    i;
+        Calc_Float f;
+    } value;
+} Calc_Number;
+
+/**
+ * @brief Create an integer Calc_Number.
+ *
+ * @param value The integer value.
+ *
+ * @return Calc_Number The tagged integer.
+ */
+Calc_Number Calc_Number_From_Int(int64_t value);
+
+/**
+ * @brief Create a floating-point Calc_Number, e.g. from a numeric mode.
+ *
+ * @param value The value.
+ *
+ * @return Calc_Number The value in the floating-point backend.
+ */
+Calc_Number Calc_Number_From_Double(double value);
+
+/**
+ * @brief Convert the keypad entry string into a Calc_Number.
+ *
+ * Entries without a decimal point are accumulated digit by digit into an
+ * integer. Entries with a decimal point (or integers too large for 64 bits)
+ * are converted with strtod() and stored in the floating-point backend.
+ *
+ * @param entry Null-terminated entry string (digits and at most one '.').
+ *
+ * @return Calc_Number The parsed value.
+ */
+Calc_Number Calc_Number_Parse(const char *entry);
+
+/**
+ * @brief Arithmetic on two Calc_Numbers.
+ *
+ * Integer operands are combined with overflow-checked integer arithmetic.
+ * If the result cannot be represented exactly as an integer, both operands
+ * are promoted and the operation is repeated in floating point.
+ *
+ * A zero divisor is not trapped: Calc_Number_Div returns an IEEE infinity
+ * or NaN and raises the divide-by-zero or invalid flag (see Calc_Error.h).
+ *
+ * @param a Left operand.
+ * @param b Right operand.
+ *
+ * @return Calc_Number The result.
+ */
+Calc_Number Calc_Number_Add(Calc_Number a, Calc_Number b);
+Calc_Number Calc_Number_Sub(Calc_Number a, Calc_Number b);
+Calc_Number Calc_Number_Mul(Calc_Number a, Calc_Number b);
+Calc_Number Calc_Number_Div(Calc_Number a, Calc_Number b);
+
+/**
+ * @brief Check whether a Calc_Number is zero.
+ *
+ * @param x The value to check.
+ *
+ * @return uint8_t 1 if x is zero, 0 otherwise.
+ */
+uint8_t Calc_Number_Is_Zero(Calc_Number x);
+
+/**
+ * @brief Convert a Calc_Number to double.
+ *
+ * @param x The value to convert.
+ *
+ * @return double The value as a double.
+ */
+double Calc_Number_To_Double(Calc_Number x);
+
+/**
+ * @brief Read or clear the exception flags accumulated by the software
+ *        floating-point backends since the last clear.
+ *
+ * Only backends that do not run on the FPU record flags here
+ * (divide-by-zero for CALC_BACKEND_DOUBLE, all flags for
+ * CALC_BACKEND_SOFT_DOUBLE). Hardware flags are read from the FPSCR by
+ * the Calc_Error module.
+ *
+ * @return uint32_t CALC_NUMBER_FLAG_* bits.
+ */
+uint32_t Calc_Number_Get_Flags(void);
+void Calc_Number_Clear_Flags(void);
+
+/**
+ * @brief Format a Calc_Number for the LCD.
+ *
+ * Integers are printed exactly when they fit in the buffer. Floating-point
+ * values (and integers too wide for the buffer) use up to 10 significant
+ * digits ("%.10g"), fewer if needed for the value to fit in the buffer.
+ *
+ * @param x    The value to format.
+ * @param buf  Output buffer.
+ * @param size Size of the output buffer, including the null terminator.
+ *
+ * @return None
+ */
+void Calc_Number_Format(Calc_Number x, char *buf, size_t size);
+
+#endif // CALC_NUMBER_H_
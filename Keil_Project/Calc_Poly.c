@@ -0,0 +1,457 @@
+/**
+ * @file Calc_Poly.c
+ *
+ * @brief Source code for the Calc_Poly module.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Calc_Poly.h"
+#include "Calc_Editor.h"
+#include "Clock_Governor.h"
+#include "Cycle_Counter.h"
+#include "Keypad.h"
+#include "LCD_Frame.h"
+#include "TM4C123GH6PM.h"
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define CALC_POLY_PI                3.14159265358979323846
+
+// Imaginary parts this small (relative to the root) are rounding noise
+#define CALC_POLY_REAL_TOLERANCE    1.0e-9
+
+// |p(z)| this small, next to the sizes of the terms of Horner's rule, is rounding noise
+#define CALC_POLY_ROUNDING          (8.0 * DBL_EPSILON)
+
+static Calc_Poly_Result last_result;
+static double mode_coefficients[CALC_POLY_MAX_DEGREE + 1];
+
+// ----- Complex arithmetic -----
+
+static Calc_Poly_Complex Calc_Poly_Make(double re, double im)
+{
+    Calc_Poly_Complex z = { re, im };
+    return z;
+}
+
+static Calc_Poly_Complex Calc_Poly_Sub(Calc_Poly_Complex a, Calc_Poly_Complex b)
+{
+    return Calc_Poly_Make(a.re - b.re, a.im - b.im);
+}
+
+static Calc_Poly_Complex Calc_Poly_Mul(Calc_Poly_Complex a, Calc_Poly_Complex b)
+{
+    return Calc_Poly_Make(a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re);
+}
+
+static Calc_Poly_Complex Calc_Poly_Div(Calc_Poly_Complex a, Calc_Poly_Complex b)
+{
+    double d = b.re * b.re + b.im * b.im;
+    return Calc_Poly_Make((a.re * b.re + a.im * b.im) / d, (a.im * b.re - a.re * b.im) / d);
+}
+
+static double Calc_Poly_Abs(Calc_Poly_Complex a)
+{
+    return hypot(a.re, a.im);
+}
+
+// ----- Closed forms -----
+
+static void Calc_Poly_Quadratic(double a, double b, double c, Calc_Poly_Complex *roots)
+{
+    double disc = b * b - 4.0 * a * c;
+
+    if (disc >= 0.0)
+    {
+        // q has the sign of b, so b and the square root are added, not subtracted
+        double q = -0.5 * (b + copysign(sqrt(disc), b));
+
+        if (q == 0.0)
+        {
+            roots[0] = Calc_Poly_Make(0.0, 0.0);
+            roots[1] = Calc_Poly_Make(0.0, 0.0);
+        }
+        else
+        {
+            roots[0] = Calc_Poly_Make(q / a, 0.0);
+            roots[1] = Calc_Poly_Make(c / q, 0.0);
+        }
+    }
+    else
+    {
+        double re = -b / (2.0 * a);
+        double im = fabs(sqrt(-disc) / (2.0 * a));
+
+        roots[0] = Calc_Poly_Make(re, im);
+        roots[1] = Calc_Poly_Make(re, -im);
+    }
+}
+
+// One Newton step on a real root of the cubic, against the rounding of the
+// closed form. Near a double root p and p' are both rounding noise and the
+// step can jump far, so the step is kept only if it makes |p| smaller.
+static double Calc_Poly_Polish(const double *c, double x)
+{
+    double p = ((c[0] * x + c[1]) * x + c[2]) * x + c[3];
+    double dp = (3.0 * c[0] * x + 2.0 * c[1]) * x + c[2];
+
+    if (dp == 0.0)
+    {
+        return x;
+    }
+
+    double polished = x - p / dp;
+    double polished_p = ((c[0] * polished + c[1]) * polished + c[2]) * polished + c[3];
+
+    return (fabs(polished_p) < fabs(p)) ? polished : x;
+}
+
+static void Calc_Poly_Cubic(const double *c, Calc_Poly_Complex *roots)
+{
+    // x^3 + B x^2 + C x + D, and with x = t - B/3: t^3 + p t + q
+    double B = c[1] / c[0];
+    double C = c[2] / c[0];
+    double D = c[3] / c[0];
+    double shift = B / 3.0;
+    double p = C - B * B / 3.0;
+    double q = 2.0 * B * B * B / 27.0 - B * C / 3.0 + D;
+    double disc = q * q / 4.0 + p * p * p / 27.0;
+
+    if (disc > 0.0)
+    {
+        // One real root and a complex pair (Cardano)
+        double s = sqrt(disc);
+        double u = cbrt(-q / 2.0 + s);
+        double v = cbrt(-q / 2.0 - s);
+
+        roots[0] = Calc_Poly_Make(Calc_Poly_Polish(c, u + v - shift), 0.0);
+        roots[1] = Calc_Poly_Make(-(u + v) / 2.0 - shift, sqrt(3.0) / 2.0 * fabs(u - v));
+        roots[2] = Calc_Poly_Make(roots[1].re, -roots[1].im);
+    }
+    else if (p == 0.0)
+    {
+        // Triple root
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            roots[k] = Calc_Poly_Make(-shift, 0.0);
+        }
+    }
+    else
+    {
+        // Three real roots (trigonometric form): t = 2 r cos(theta), cos(3 theta) = -q / (2 r^3)
+        double r = sqrt(-p / 3.0);
+        double cos_3theta = -q / (2.0 * r * r * r);
+
+        if (cos_3theta > 1.0)
+        {
+            cos_3theta = 1.0;
+        }
+        else if (cos_3theta < -1.0)
+        {
+            cos_3theta = -1.0;
+        }
+
+        double phi = acos(cos_3theta);
+
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            double t = 2.0 * r * cos((phi - 2.0 * CALC_POLY_PI * (double)k) / 3.0);
+            roots[k] = Calc_Poly_Make(Calc_Poly_Polish(c, t - shift), 0.0);
+        }
+    }
+}
+
+// ----- Durand-Kerner -----
+
+static uint32_t Calc_Poly_Durand_Kerner(const double *c, uint32_t degree, Calc_Poly_Complex *roots, uint8_t *converged)
+{
+    double monic[CALC_POLY_MAX_DEGREE + 1];
+    double radius = 0.0;
+
+    // Monic polynomial, and the Cauchy bound 1 + max |a_i / a_0| on the roots
+    for (uint32_t i = 1; i <= degree; i++)
+    {
+        monic[i] = c[i] / c[0];
+        if (fabs(monic[i]) > radius)
+        {
+            radius = fabs(monic[i]);
+        }
+    }
+    radius += 1.0;
+
+    // Starting points on the circle, turned so that none is real
+    for (uint32_t k = 0; k < degree; k++)
+    {
+        double angle = 2.0 * CALC_POLY_PI * (double)k / (double)degree + 0.4;
+        roots[k] = Calc_Poly_Make(radius * cos(angle), radius * sin(angle));
+    }
+
+    *converged = 0;
+
+    uint32_t iteration = 0;
+    while (iteration < CALC_POLY_MAX_ITERATIONS)
+    {
+        double largest_step = 0.0;
+        uint8_t all_noise = 1;
+
+        iteration++;
+
+        for (uint32_t k = 0; k < degree; k++)
+        {
+            Calc_Poly_Complex z = roots[k];
+
+            // p(z) by Horner's rule, and the sizes of its terms
+            Calc_Poly_Complex value = Calc_Poly_Make(1.0, 0.0);
+            double modulus = sqrt(z.re * z.re + z.im * z.im);
+            double size = 1.0;
+            for (uint32_t i = 1; i <= degree; i++)
+            {
+                value = Calc_Poly_Mul(value, z);
+                value.re += monic[i];
+                size = size * modulus + fabs(monic[i]);
+            }
+
+            // Squared, to keep hypot() out of the loop
+            double noise = CALC_POLY_ROUNDING * (double)degree * size;
+            if (value.re * value.re + value.im * value.im > noise * noise)
+            {
+                all_noise = 0;
+            }
+
+            // Product of the distances to the other roots
+            Calc_Poly_Complex product = Calc_Poly_Make(1.0, 0.0);
+            for (uint32_t j = 0; j < degree; j++)
+            {
+                if (j != k)
+                {
+                    product = Calc_Poly_Mul(product, Calc_Poly_Sub(z, roots[j]));
+                }
+            }
+
+            if (product.re == 0.0 && product.im == 0.0)
+            {
+                // Two estimates met, move this one apart
+                product = Calc_Poly_Make(CALC_POLY_TOLERANCE, 0.0);
+            }
+
+            Calc_Poly_Complex step = Calc_Poly_Div(value, product);
+            roots[k] = Calc_Poly_Sub(z, step);
+
+            double relative_step = Calc_Poly_Abs(step) / (1.0 + Calc_Poly_Abs(roots[k]));
+            if (relative_step > largest_step)
+            {
+                largest_step = relative_step;
+            }
+        }
+
+        // Close roots are only as accurate as the rounding allows, and their
+        // steps stay above the tolerance once p is rounding noise at all of them
+        if (largest_step <= CALC_POLY_TOLERANCE || all_noise)
+        {
+            *converged = 1;
+            break;
+        }
+    }
+
+    return iteration;
+}
+
+void Calc_Poly_Solve(const double *coefficients, uint32_t degree, Calc_Poly_Result *result)
+{
+    uint32_t start = Cycle_Counter_Read();
+
+    // Drop the leading zero coefficients
+    while (degree > 0 && coefficients[0] == 0.0)
+    {
+        coefficients++;
+        degree--;
+    }
+
+    memset(result, 0, sizeof(Calc_Poly_Result));
+    result->degree = degree;
+    result->method = CALC_POLY_CLOSED_FORM;
+    result->converged = 1;
+
+    if (degree == 1)
+    {
+        result->roots[0] = Calc_Poly_Make(-coefficients[1] / coefficients[0], 0.0);
+    }
+    else if (degree == 2)
+    {
+        Calc_Poly_Quadratic(coefficients[0], coefficients[1], coefficients[2], result->roots);
+    }
+    else if (degree == 3)
+    {
+        Calc_Poly_Cubic(coefficients, result->roots);
+    }
+    else if (degree > 3)
+    {
+        result->method = CALC_POLY_DURAND_KERNER;
+        result->iterations = Calc_Poly_Durand_Kerner(coefficients, degree, result->roots, &result->converged);
+    }
+
+    // Real roots first, then by real part
+    for (uint32_t i = 0; i < degree; i++)
+    {
+        Calc_Poly_Complex root = result->roots[i];
+
+        if (fabs(root.im) <= CALC_POLY_REAL_TOLERANCE * (1.0 + fabs(root.re)))
+        {
+            root.im = 0.0;
+        }
+        if (root.re == 0.0)
+        {
+            root.re = 0.0;      // not -0
+        }
+
+        uint32_t j = i;
+        while (j > 0)
+        {
+            Calc_Poly_Complex previous = result->roots[j - 1];
+            uint8_t root_first = ((root.im == 0.0) && (previous.im != 0.0)) ||
+                                 (((root.im == 0.0) == (previous.im == 0.0)) && root.re < previous.re);
+
+            if (!root_first)
+            {
+                break;
+            }
+            result->roots[j] = previous;
+            j--;
+        }
+        result->roots[j] = root;
+    }
+
+    result->cycles = Cycle_Counter_Read() - start;
+
+    // Converted now, the clock may have changed by the time it is shown
+    result->time_us = result->cycles / (SystemCoreClock / 1000000U);
+}
+
+// ----- Mode -----
+
+// Root pages, then the statistics page
+static void Calc_Poly_Draw(const Calc_Poly_Result *result, uint32_t page)
+{
+    char line[LCD_FRAME_COLUMNS + 1];
+
+    LCD_Frame_Clear();
+
+    if (result->degree == 0)
+    {
+        LCD_Frame_Print("No roots");
+    }
+    else if (page < result->degree)
+    {
+        const Calc_Poly_Complex *root = &result->roots[page];
+
+        // Top line: real part, e.g. "x1=-0.5", in the columns after "x1="
+        size_t prefix = (size_t)snprintf(line, sizeof(line), "x%u=", (unsigned)(page + 1U));
+
+        Calc_Number_Format(Calc_Number_From_Double(root->re), line + prefix, sizeof(line) - prefix);
+        LCD_Frame_Print(line);
+
+        // Bottom line: imaginary part, e.g. "+0.866025404i", in the columns
+        // between the sign and the 'i'
+        if (root->im != 0.0)
+        {
+            line[0] = (root->im < 0.0) ? '-' : '+';
+            Calc_Number_Format(Calc_Number_From_Double(fabs(root->im)), line + 1, sizeof(line) - 2U);
+            strcat(line, "i");
+            LCD_Frame_Set_Cursor(0, 1);
+            LCD_Frame_Print(line);
+        }
+    }
+    else
+    {
+        if (result->method == CALC_POLY_CLOSED_FORM)
+        {
+            LCD_Frame_Print("Closed form");
+        }
+        else
+        {
+            snprintf(line, sizeof(line), "DK n=%u", (unsigned)result->iterations);
+            LCD_Frame_Print(line);
+        }
+
+        snprintf(line, sizeof(line), "%u us%s", (unsigned)result->time_us, result->converged ? "" : " no conv");
+        LCD_Frame_Set_Cursor(0, 1);
+        LCD_Frame_Print(line);
+    }
+
+    LCD_Frame_Flush();
+}
+
+uint8_t Calc_Poly_Mode(Calc_Number *value)
+{
+    char text[CALC_EXPR_MAX_CHARS + 1];
+    char prompt[8];
+    Calc_Number number;
+    uint32_t degree;
+    uint32_t page = 0;
+
+    // Degree, until it is an integer from 1 to CALC_POLY_MAX_DEGREE
+    strcpy(text, "2");
+    while (1)
+    {
+        if (!Calc_Editor_Run("deg=", NULL, text, &number))
+        {
+            return 0;
+        }
+        if (number.type == CALC_NUMBER_INT && number.value.i >= 1 && number.value.i <= (int64_t)CALC_POLY_MAX_DEGREE)
+        {
+            degree = (uint32_t)number.value.i;
+            break;
+        }
+    }
+
+    // Coefficients, highest degree first, e.g. "a2=", "a1=", "a0="
+    for (uint32_t i = 0; i <= degree; i++)
+    {
+        snprintf(prompt, sizeof(prompt), "a%u=", (unsigned)(degree - i));
+        strcpy(text, (i == 0) ? "1" : "0");
+
+        if (!Calc_Editor_Run(prompt, NULL, text, &number))
+        {
+            return 0;
+        }
+        mode_coefficients[i] = Calc_Number_To_Double(number);
+    }
+
+    // The editor may have let the clock drop to idle speed
+    Clock_Governor_Request_Fast();
+    Calc_Poly_Solve(mode_coefficients, degree, &last_result);
+
+    while (1)
+    {
+        Calc_Poly_Draw(&last_result, page);
+
+        char key = Keypad_WaitForChar();
+        uint32_t pages = last_result.degree + 1U;
+
+        if (key == '*')
+        {
+            page = (page + 1U) % pages;
+        }
+        else if (key == '/')
+        {
+            page = (page + pages - 1U) % pages;
+        }
+        else if (key == '=' && page < last_result.degree && last_result.roots[page].im == 0.0)
+        {
+            *value = Calc_Number_From_Double(last_result.roots[page].re);
+            return 1;
+        }
+        else if (key == '.')
+        {
+            return 0;
+        }
+    }
+}
+
+void Calc_Poly_Get_Last(Calc_Poly_Result *result)
+{
+    *result = last_result;
+}
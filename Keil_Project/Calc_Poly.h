@@ -0,0 +1,96 @@
+/**
+ * @file Calc_Poly.h
+ *
+ * @brief Header file for the Calc_Poly module.
+ *
+ * It is the polynomial mode of the calculator: the user enters the degree
+ * and the coefficients (see Calc_Editor.h), and all the roots, real and
+ * complex, are found:
+ *  - Degree 1 and 2: closed forms (the quadratic formula in its stable
+ *    form, which does not subtract nearly equal numbers).
+ *  - Degree 3: Cardano's formula for one real root, or the trigonometric
+ *    form for three real roots.
+ *  - Degree 4 to CALC_POLY_MAX_DEGREE: Durand-Kerner simultaneous
+ *    iteration, which refines all the roots at once from starting points
+ *    on a circle that holds them, and stops when no root moves by more
+ *    than a relative CALC_POLY_TOLERANCE or the polynomial is rounding
+ *    noise at every root, or after CALC_POLY_MAX_ITERATIONS.
+ *
+ * The coefficients come from the numeric engine (Calc_Number) and the
+ * roots are computed in double precision. All the storage is static and
+ * sized by CALC_POLY_MAX_DEGREE. The result reports the iterations, the
+ * time taken, and whether the iteration converged.
+ *
+ * Mode keys, after the roots are shown (one root per page, then a page
+ * with the iterations and the time):
+ *  - '*' / '/': next / previous page
+ *  - '=':       accept the real root on the page as a result and exit
+ *  - '.':       exit
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef CALC_POLY_H_
+#define CALC_POLY_H_
+
+#include "Calc_Number.h"
+#include <stdint.h>
+
+// Hold time of the '.' key that opens the mode
+#define CALC_POLY_HOLD_US           1000000U
+
+#define CALC_POLY_MAX_DEGREE        6U
+#define CALC_POLY_MAX_ITERATIONS    500U
+#define CALC_POLY_TOLERANCE         1.0e-12
+
+typedef enum {
+    CALC_POLY_CLOSED_FORM,
+    CALC_POLY_DURAND_KERNER
+} Calc_Poly_Method;
+
+typedef struct {
+    double re;
+    double im;
+} Calc_Poly_Complex;
+
+typedef struct {
+    uint32_t degree;            // after leading zero coefficients are dropped
+    Calc_Poly_Complex roots[CALC_POLY_MAX_DEGREE];
+    Calc_Poly_Method method;
+    uint32_t iterations;
+    uint32_t cycles;
+    uint32_t time_us;           // cycles at the clock they were counted at
+    uint8_t converged;
+} Calc_Poly_Result;
+
+/**
+ * @brief Find the roots of a polynomial.
+ *
+ * @param coefficients The coefficients, highest degree first (degree + 1 values).
+ * @param degree       The degree, up to CALC_POLY_MAX_DEGREE.
+ * @param result       Receives the roots and the statistics (degree 0 if
+ *                     all the coefficients but the constant are zero).
+ *
+ * @return None
+ */
+void Calc_Poly_Solve(const double *coefficients, uint32_t degree, Calc_Poly_Result *result);
+
+/**
+ * @brief Run the polynomial mode until the user exits.
+ *
+ * @param value Receives the root, if one was accepted.
+ *
+ * @return uint8_t 1 if a root was accepted, 0 otherwise.
+ */
+uint8_t Calc_Poly_Mode(Calc_Number *value);
+
+/**
+ * @brief Get the result of the last polynomial of the mode.
+ *
+ * @param result Receives the result.
+ *
+ * @return None
+ */
+void Calc_Poly_Get_Last(Calc_Poly_Result *result);
+
+#endif // CALC_POLY_H_
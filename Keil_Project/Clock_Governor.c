@@ -0,0 +1,222 @@
+/**
+ * @file Clock_Governor.c
+ *
+ * @brief Source code for the Clock_Governor module.
+ *
+ * @note For the clock configuration sequence, refer to the System Control
+ * section of the TM4C123GH6PM Microcontroller Datasheet.
+ * Link: https://www.ti.com/lit/ds/symlink/tm4c123gh6pm.pdf
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Clock_Governor.h"
+#include "SysTick_Delay.h"
+#include "Trace.h"
+
+// RCC register fields
+#define RCC_USESYSDIV       (1U << 22)
+#define RCC_IOSCDIS         (1U << 1)
+
+// RCC2 register fields
+#define RCC2_USERCC2        (1U << 31)
+#define RCC2_DIV400         (1U << 30)
+#define RCC2_SYSDIV2_M      (0x3FU << 23)
+#define RCC2_SYSDIV2LSB     (1U << 22)
+#define RCC2_PWRDN2         (1U << 13)
+#define RCC2_BYPASS2        (1U << 11)
+#define RCC2_OSCSRC2_M      (0x7U << 4)
+#define RCC2_OSCSRC2_MOSC   (0x0U << 4)
+#define RCC2_OSCSRC2_PIOSC  (0x1U << 4)
+
+// 400 MHz / ((SYSDIV2 << 1 | SYSDIV2LSB) + 1) = 400 MHz / 5 = 80 MHz
+#define RCC2_SYSDIV2_80MHZ  (2U << 23)
+
+// RIS / MISC: PLL Lock
+#define SYSCTL_PLLLRIS      (1U << 6)
+
+static Clock_Governor_Listener_Fn listeners[CLOCK_GOVERNOR_MAX_LISTENERS];
+static uint32_t listener_count = 0;
+
+static Clock_Governor_Profile clock_profile = CLOCK_GOVERNOR_PROFILE_AUTO;
+static uint8_t clock_fast = 0;
+static uint64_t idle_deadline_us = 0;
+
+// Start of the interval not yet counted in the statistics
+static uint64_t account_start_us = 0;
+
+static Clock_Governor_Stats governor_stats;
+
+// Add the time since the last call to the current speed
+static void Clock_Governor_Account(uint64_t now_us)
+{
+    uint64_t elapsed_us = now_us - account_start_us;
+    uint32_t current_ua = clock_fast ? CLOCK_GOVERNOR_CURRENT_FAST_UA : CLOCK_GOVERNOR_CURRENT_SLOW_UA;
+
+    if (clock_fast)
+    {
+        governor_stats.fast_us += elapsed_us;
+    }
+    else
+    {
+        governor_stats.slow_us += elapsed_us;
+    }
+
+    // mV * uA = nW, and nW * us / 10^6 = nJ
+    governor_stats.energy_nj += (elapsed_us * CLOCK_GOVERNOR_SUPPLY_MV * current_ua) / 1000000U;
+    account_start_us = now_us;
+}
+
+static void Clock_Governor_Set_Slow(void)
+{
+    uint32_t rcc2 = SYSCTL->RCC2 | RCC2_USERCC2 | RCC2_BYPASS2;
+
+    // Bypass the PLL, with the PIOSC as the oscillator
+    rcc2 = (rcc2 & ~RCC2_OSCSRC2_M) | RCC2_OSCSRC2_PIOSC;
+    SYSCTL->RCC2 = rcc2;
+
+    // Undivided 16 MHz
+    SYSCTL->RCC &= ~RCC_USESYSDIV;
+
+    // Power down the PLL
+    SYSCTL->RCC2 = rcc2 | RCC2_PWRDN2;
+
+    SystemCoreClock = CLOCK_GOVERNOR_SLOW_HZ;
+}
+
+// Returns 0 if the PLL did not lock in time; the clock is then left on the PIOSC
+static uint8_t Clock_Governor_Set_Fast(void)
+{
+    uint32_t rcc2 = SYSCTL->RCC2 | RCC2_USERCC2 | RCC2_BYPASS2;
+
+    // Run from the raw oscillator while the PLL is reconfigured
+    SYSCTL->RCC2 = rcc2;
+
+    // Main oscillator as the PLL input, power up the PLL
+    rcc2 = (rcc2 & ~(RCC2_OSCSRC2_M | RCC2_PWRDN2)) | RCC2_OSCSRC2_MOSC;
+
+    // 400 MHz PLL output divided by 5
+    rcc2 = (rcc2 & ~(RCC2_SYSDIV2_M | RCC2_SYSDIV2LSB)) | RCC2_DIV400 | RCC2_SYSDIV2_80MHZ;
+
+    // Clear the PLL lock status before powering it up
+    SYSCTL->MISC = SYSCTL_PLLLRIS;
+    SYSCTL->RCC |= RCC_USESYSDIV;
+    SYSCTL->RCC2 = rcc2;
+
+    // Wait until the PLL is locked, then use it. If it does not lock in
+    // time, go back to the PIOSC instead of hanging here
+    uint64_t deadline = SysTick_Get_Ticks() + ((uint64_t)CLOCK_GOVERNOR_PLL_TIMEOUT_US * SYSTICK_TICKS_PER_US);
+
+    while ((SYSCTL->RIS & SYSCTL_PLLLRIS) == 0)
+    {
+        if (SysTick_Get_Ticks() >= deadline)
+        {
+            governor_stats.pll_timeouts++;
+            Clock_Governor_Set_Slow();
+            return 0;
+        }
+        SYSTICK_DELAY_SPIN(deadline);
+    }
+    SYSCTL->RCC2 = rcc2 & ~RCC2_BYPASS2;
+
+    SystemCoreClock = CLOCK_GOVERNOR_FAST_HZ;
+    return 1;
+}
+
+static void Clock_Governor_Switch(uint8_t fast)
+{
+    uint64_t start_us = SysTick_Get_Time_us();
+
+    Clock_Governor_Account(start_us);
+
+    if (fast)
+    {
+        fast = Clock_Governor_Set_Fast();
+    }
+    else
+    {
+        Clock_Governor_Set_Slow();
+    }
+    clock_fast = fast;
+
+    for (uint32_t i = 0; i < listener_count; i++)
+    {
+        listeners[i]();
+    }
+
+    // The trace timestamps count CPU cycles, so mark the new rate (MHz)
+    Trace_Mark(TRACE_ZONE_CLOCK, (uint16_t)(SystemCoreClock / 1000000U));
+
+    uint32_t switch_us = (uint32_t)(SysTick_Get_Time_us() - start_us);
+    governor_stats.switches++;
+    governor_stats.switch_us_last = switch_us;
+    if (switch_us > governor_stats.switch_us_max)
+    {
+        governor_stats.switch_us_max = switch_us;
+    }
+}
+
+void Clock_Governor_Init(void)
+{
+    // The PIOSC is the idle clock, make sure it is running
+    SYSCTL->RCC &= ~RCC_IOSCDIS;
+
+    account_start_us = SysTick_Get_Time_us();
+    clock_fast = 1;
+    Clock_Governor_Switch(0);
+}
+
+uint8_t Clock_Governor_Register_Listener(Clock_Governor_Listener_Fn listener)
+{
+    if (listener_count >= CLOCK_GOVERNOR_MAX_LISTENERS)
+    {
+        return 0;
+    }
+
+    listeners[listener_count++] = listener;
+    return 1;
+}
+
+void Clock_Governor_Set_Profile(Clock_Governor_Profile profile)
+{
+    clock_profile = profile;
+
+    if (profile == CLOCK_GOVERNOR_PROFILE_SLOW && clock_fast)
+    {
+        Clock_Governor_Switch(0);
+    }
+    else if (profile != CLOCK_GOVERNOR_PROFILE_SLOW)
+    {
+        // The auto profile drops back after the idle timeout
+        Clock_Governor_Request_Fast();
+    }
+}
+
+void Clock_Governor_Request_Fast(void)
+{
+    if (!clock_fast && clock_profile != CLOCK_GOVERNOR_PROFILE_SLOW)
+    {
+        Clock_Governor_Switch(1);
+    }
+
+    idle_deadline_us = SysTick_Get_Time_us() + (CLOCK_GOVERNOR_IDLE_TIMEOUT_MS * 1000U);
+}
+
+void Clock_Governor_Poll(void)
+{
+    if (clock_fast && clock_profile == CLOCK_GOVERNOR_PROFILE_AUTO && SysTick_Get_Time_us() >= idle_deadline_us)
+    {
+        Clock_Governor_Switch(0);
+    }
+}
+
+uint8_t Clock_Governor_Is_Idle(void)
+{
+    return SysTick_Get_Time_us() >= idle_deadline_us;
+}
+
+void Clock_Governor_Get_Stats(Clock_Governor_Stats *stats)
+{
+    Clock_Governor_Account(SysTick_Get_Time_us());
+    *stats = governor_stats;
+}
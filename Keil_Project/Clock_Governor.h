@@ -0,0 +1,150 @@
+/**
+ * @file Clock_Governor.h
+ *
+ * @brief Header file for the Clock_Governor module.
+ *
+ * It scales the system clock with the load. While the calculator waits for
+ * a key, it idles on the 16 MHz Precision Internal Oscillator (PIOSC) with
+ * the PLL powered down. When a key is pressed (Clock_Governor_Request_Fast),
+ * it switches to 80 MHz from the PLL, so that parsing, the arithmetic, and
+ * formatting run at full speed, and it switches back to the PIOSC after
+ * CLOCK_GOVERNOR_IDLE_TIMEOUT_MS without a request (Clock_Governor_Poll).
+ *
+ * The switch uses the RCC2 register, which overrides the clock settings
+ * made by SystemInit in the RCC register:
+ *  - Fast: main oscillator (16 MHz crystal) -> PLL (400 MHz) / 5 = 80 MHz
+ *  - Slow: PIOSC (16 MHz), PLL bypassed and powered down
+ *
+ * The profile can pin the clock to one speed instead
+ * (Clock_Governor_Set_Profile), e.g. from the settings menu.
+ *
+ * SystemCoreClock is updated on every switch, and the registered listeners
+ * are called so that the drivers that depend on the system clock (UART0
+ * baud rate, watchdog budget, profiler sample rate) can rescale. The
+ * SysTick timebase runs from PIOSC / 4 and is not affected, so the delays
+ * used by the LCD and keypad drivers stay correct.
+ *
+ * If the PLL does not lock within CLOCK_GOVERNOR_PLL_TIMEOUT_US, the clock
+ * goes back to the PIOSC with SystemCoreClock at 16 MHz and the request
+ * is counted in pll_timeouts; the next request tries again.
+ *
+ * The governor also reports:
+ *  - the number of switches and the duration of the last and the longest
+ *    switch (including the PLL lock time)
+ *  - the time spent at each speed, and an energy estimate based on
+ *    approximate MCU run currents (CLOCK_GOVERNOR_CURRENT_FAST_UA and
+ *    CLOCK_GOVERNOR_CURRENT_SLOW_UA, adjust to the measured board)
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef CLOCK_GOVERNOR_H_
+#define CLOCK_GOVERNOR_H_
+
+#include "TM4C123GH6PM.h"
+#include <stdint.h>
+
+#define CLOCK_GOVERNOR_FAST_HZ          80000000U
+#define CLOCK_GOVERNOR_SLOW_HZ          16000000U
+
+// Time at full speed after the last request
+#define CLOCK_GOVERNOR_IDLE_TIMEOUT_MS  500
+
+// Longest wait for the PLL to lock (it takes well under 1 ms)
+#define CLOCK_GOVERNOR_PLL_TIMEOUT_US   2000U
+
+// Energy model: supply voltage and approximate run current at each speed
+#define CLOCK_GOVERNOR_SUPPLY_MV        3300U
+#define CLOCK_GOVERNOR_CURRENT_FAST_UA  32000U
+#define CLOCK_GOVERNOR_CURRENT_SLOW_UA  10000U
+
+// Maximum number of clock change listeners
+#define CLOCK_GOVERNOR_MAX_LISTENERS    4
+
+typedef void (*Clock_Governor_Listener_Fn)(void);
+
+typedef enum {
+    CLOCK_GOVERNOR_PROFILE_AUTO,    // slow while idle, fast per key
+    CLOCK_GOVERNOR_PROFILE_FAST,    // always 80 MHz
+    CLOCK_GOVERNOR_PROFILE_SLOW     // always 16 MHz
+} Clock_Governor_Profile;
+
+typedef struct {
+    uint32_t switches;
+    uint32_t switch_us_last;
+    uint32_t switch_us_max;
+    uint64_t fast_us;
+    uint64_t slow_us;
+    uint64_t energy_nj;
+    uint32_t pll_timeouts;          // Fast requests left at 16 MHz
+} Clock_Governor_Stats;
+
+/**
+ * @brief Take over the clock configuration and switch to the slow clock.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Clock_Governor_Init(void);
+
+/**
+ * @brief Register a function to call after every change of the system clock.
+ *
+ * @param listener The function; it can read the new frequency from SystemCoreClock.
+ *
+ * @return uint8_t 1 if registered, 0 if there is no room.
+ */
+uint8_t Clock_Governor_Register_Listener(Clock_Governor_Listener_Fn listener);
+
+/**
+ * @brief Select the clock profile and switch to the matching speed.
+ *
+ * @param profile The profile.
+ *
+ * @return None
+ */
+void Clock_Governor_Set_Profile(Clock_Governor_Profile profile);
+
+/**
+ * @brief Switch to the fast clock (if needed) and restart the idle timeout.
+ *
+ * Called when a key is pressed or a computation starts.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Clock_Governor_Request_Fast(void);
+
+/**
+ * @brief Switch back to the slow clock once the idle timeout has expired.
+ *
+ * Called from the idle (key wait) loop.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Clock_Governor_Poll(void);
+
+/**
+ * @brief Tell whether the governor is idle: no fast request within
+ * CLOCK_GOVERNOR_IDLE_TIMEOUT_MS (with the auto profile, the clock is slow).
+ *
+ * @param None
+ *
+ * @return uint8_t 1 if idle, 0 otherwise.
+ */
+uint8_t Clock_Governor_Is_Idle(void);
+
+/**
+ * @brief Get the switch and energy statistics, up to date.
+ *
+ * @param stats Receives the statistics.
+ *
+ * @return None
+ */
+void Clock_Governor_Get_Stats(Clock_Governor_Stats *stats);
+
+#endif // CLOCK_GOVERNOR_H_
@@ -0,0 +1,73 @@
+/**
+ * @file Cycle_Counter.c
+ *
+ * @brief Source code for the Cycle_Counter driver.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Cycle_Counter.h"
+#include <string.h>
+
+// Keypad characters, in the order of the statistics table
+static const char Cycle_Counter_Keys[] = "0123456789.+-*/=";
+
+// Per-keystroke statistics (visible in the debugger watch window)
+static Cycle_Counter_Stats key_stats[sizeof(Cycle_Counter_Keys) - 1];
+
+void Cycle_Counter_Init(void)
+{
+    // Enable the DWT unit (TRCENA) and start the cycle counter
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    memset(key_stats, 0, sizeof(key_stats));
+}
+
+void Cycle_Counter_Stats_Add(Cycle_Counter_Stats *stats, uint32_t cycles)
+{
+    // Samples taken at another clock are not comparable with this one
+    if (stats->count != 0 && stats->clock_hz != SystemCoreClock)
+    {
+        memset(stats, 0, sizeof(*stats));
+    }
+    stats->clock_hz = SystemCoreClock;
+
+    if (stats->count == 0 || cycles < stats->min)
+    {
+        stats->min = cycles;
+    }
+    if (cycles > stats->max)
+    {
+        stats->max = cycles;
+    }
+
+    stats->last = cycles;
+    stats->total += cycles;
+    stats->count++;
+}
+
+static Cycle_Counter_Stats *Cycle_Counter_Find_Key(char key)
+{
+    const char *p = (key != '\0') ? strchr(Cycle_Counter_Keys, key) : NULL;
+    if (p == NULL)
+    {
+        return NULL;
+    }
+    return &key_stats[p - Cycle_Counter_Keys];
+}
+
+void Cycle_Counter_Record_Key(char key, uint32_t cycles)
+{
+    Cycle_Counter_Stats *stats = Cycle_Counter_Find_Key(key);
+    if (stats != NULL)
+    {
+        Cycle_Counter_Stats_Add(stats, cycles);
+    }
+}
+
+const Cycle_Counter_Stats *Cycle_Counter_Get_Key_Stats(char key)
+{
+    return Cycle_Counter_Find_Key(key);
+}
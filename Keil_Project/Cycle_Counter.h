@@ -0,0 +1,100 @@
+/**
+ * @file Cycle_Counter.h
+ *
+ * @brief Header file for the Cycle_Counter driver.
+ *
+ * It uses the Data Watchpoint and Trace (DWT) cycle counter of the
+ * Cortex-M4 to measure execution time in CPU cycles. Because the
+ * measurement runs on the Keil-built image, it includes the effects of
+ * the compiler, the soft-float runtime, and flash wait states.
+ *
+ * On top of the raw counter, it keeps per-keystroke statistics
+ * (count, last, minimum, maximum, and total cycles) for each of the
+ * 16 keypad characters. The statistics can be inspected in the debugger
+ * watch window or read through Cycle_Counter_Get_Key_Stats.
+ *
+ * The counter runs at SystemCoreClock, which the clock governor switches
+ * between 80 MHz and 16 MHz. The delays and the flash wait states do not
+ * scale the same way with the clock, so cycles taken at different clocks
+ * are not comparable: each statistics record keeps the clock of its
+ * samples and starts over when a sample is taken at another clock.
+ *
+ * On the host simulator (tests/sim) the counter follows the virtual
+ * clock, so measurements run without the board; there they count the
+ * waits and register accesses, not the computation.
+ *
+ * @note The 32-bit counter wraps after 2^32 cycles (~53 s at 80 MHz,
+ * ~268 s at 16 MHz), so single measurements must be shorter than that.
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef CYCLE_COUNTER_H_
+#define CYCLE_COUNTER_H_
+
+#include "TM4C123GH6PM.h"
+#include <stdint.h>
+
+typedef struct {
+    uint32_t count;
+    uint32_t last;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    uint32_t clock_hz;      // SystemCoreClock of the samples
+} Cycle_Counter_Stats;
+
+/**
+ * @brief Enable the DWT cycle counter and clear the per-key statistics.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Cycle_Counter_Init(void);
+
+/**
+ * @brief Read the current value of the DWT cycle counter.
+ *
+ * @param None
+ *
+ * @return uint32_t The cycle count.
+ */
+static inline uint32_t Cycle_Counter_Read(void)
+{
+    return DWT->CYCCNT;
+}
+
+/**
+ * @brief Add a measurement to a statistics record.
+ *
+ * The measurement is taken at the current SystemCoreClock; a record that
+ * holds samples taken at another clock is cleared first.
+ *
+ * @param stats  The statistics record to update.
+ * @param cycles The measured number of cycles.
+ *
+ * @return None
+ */
+void Cycle_Counter_Stats_Add(Cycle_Counter_Stats *stats, uint32_t cycles);
+
+/**
+ * @brief Record the number of cycles spent handling a keystroke.
+ *
+ * @param key    The keypad character (e.g. '1', '+', '=').
+ * @param cycles The cycles from key detection to the end of its handling.
+ *
+ * @return None
+ */
+void Cycle_Counter_Record_Key(char key, uint32_t cycles);
+
+/**
+ * @brief Get the statistics for a keypad character.
+ *
+ * @param key The keypad character.
+ *
+ * @return const Cycle_Counter_Stats* The statistics, or NULL if key is not a keypad character.
+ */
+const Cycle_Counter_Stats *Cycle_Counter_Get_Key_Stats(char key);
+
+#endif // CYCLE_COUNTER_H_
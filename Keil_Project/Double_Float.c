@@ -0,0 +1,225 @@
+/**
+ * @file Double_Float.c
+ *
+ * @brief Source code for the Double_Float arithmetic library.
+ *
+ * All arithmetic is performed with single-precision FPU instructions.
+ * __builtin_fmaf compiles to VFMA.F32 on the Cortex-M4F, which gives
+ * the exact rounding error of a product in one instruction.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Double_Float.h"
+
+#if defined(__ARM_FP)
+#include "TM4C123GH6PM.h"
+
+// FPSCR cumulative underflow flag (UFC)
+#define FPSCR_UFC   0x08U
+#endif
+
+// Error-free sum: s + e == a + b exactly
+static inline Double_Float Two_Sum(float a, float b)
+{
+    Double_Float r;
+    float s = a + b;
+    float bb = s - a;
+    r.hi = s;
+    r.lo = (a - (s - bb)) + (b - bb);
+    return r;
+}
+
+// Error-free sum, requires |a| >= |b|
+static inline Double_Float Quick_Two_Sum(float a, float b)
+{
+    Double_Float r;
+    float s = a + b;
+    r.hi = s;
+    r.lo = b - (s - a);
+    return r;
+}
+
+// Error-free product: p + e == a * b exactly (one VMUL + one VFMA)
+static inline Double_Float Two_Prod(float a, float b)
+{
+    Double_Float r;
+    float p = a * b;
+    r.hi = p;
+    r.lo = __builtin_fmaf(a, b, -p);
+    return r;
+}
+
+// Exponent field of a float, read without an FPU compare that could raise
+// an exception on a NaN
+static inline uint32_t Double_Float_Exponent(float x)
+{
+    union { float f; uint32_t u; } bits = { x };
+
+    return (bits.u >> 23) & 0xFFU;
+}
+
+// Infinity or NaN
+static inline int Double_Float_Is_Special(float x)
+{
+    return Double_Float_Exponent(x) == 0xFFU;
+}
+
+// The lo word of a result with a normal hi word is often subnormal; that
+// loses nothing the format promises, so its underflow is not reported.
+// Returns the UFC flag as it was before the operation.
+static inline uint32_t Double_Float_Underflow_Save(void)
+{
+#if defined(__ARM_FP)
+    return __get_FPSCR() & FPSCR_UFC;
+#else
+    return 0;
+#endif
+}
+
+// Drop an underflow raised by the lo word when the hi word is normal
+static inline void Double_Float_Underflow_Restore(uint32_t saved, float hi)
+{
+#if defined(__ARM_FP)
+    if (saved == 0U && Double_Float_Exponent(hi) != 0U)
+    {
+        uint32_t fpscr = __get_FPSCR();
+
+        if (fpscr & FPSCR_UFC)
+        {
+            __set_FPSCR(fpscr & ~FPSCR_UFC);
+        }
+    }
+#else
+    (void)saved;
+    (void)hi;
+#endif
+}
+
+Double_Float Double_Float_From_Double(double value)
+{
+    uint32_t underflow = Double_Float_Underflow_Save();
+    Double_Float r;
+    r.hi = (float)value;
+    r.lo = (float)(value - (double)r.hi);
+    Double_Float_Underflow_Restore(underflow, r.hi);
+    return r;
+}
+
+// Exact conversion of a 32-bit integer into hi + lo
+static Double_Float Double_Float_From_Int32(int32_t value)
+{
+    Double_Float r;
+    r.hi = (float)value;
+    r.lo = (float)((int64_t)value - (int64_t)r.hi);
+    return r;
+}
+
+Double_Float Double_Float_From_Int(int64_t value)
+{
+    // value = upper * 2^32 + middle * 2^16 + lower, each part converted exactly
+    Double_Float upper = Double_Float_From_Int32((int32_t)(value >> 32));
+    Double_Float middle = Double_Float_From_Int32((int32_t)(((uint32_t)value) >> 16));
+    Double_Float lower = Double_Float_From_Int32((int32_t)(value & 0xFFFF));
+
+    upper.hi *= 4294967296.0f;
+    upper.lo *= 4294967296.0f;
+    middle.hi *= 65536.0f;
+    middle.lo *= 65536.0f;
+
+    return Double_Float_Add(Double_Float_Add(upper, middle), lower);
+}
+
+double Double_Float_To_Double(Double_Float x)
+{
+    return (double)x.hi + (double)x.lo;
+}
+
+Double_Float Double_Float_Add(Double_Float a, Double_Float b)
+{
+    uint32_t underflow = Double_Float_Underflow_Save();
+    float sum = a.hi + b.hi;
+
+    // Overflow (or an infinite operand): the error terms would compute
+    // inf - inf, so return the hi word alone with only its own exception
+    if (Double_Float_Is_Special(sum))
+    {
+        return (Double_Float){ sum, 0.0f };
+    }
+
+    Double_Float s = Two_Sum(a.hi, b.hi);
+    Double_Float t = Two_Sum(a.lo, b.lo);
+
+    s.lo += t.hi;
+    s = Quick_Two_Sum(s.hi, s.lo);
+    s.lo += t.lo;
+    s = Quick_Two_Sum(s.hi, s.lo);
+
+    Double_Float_Underflow_Restore(underflow, s.hi);
+    return s;
+}
+
+Double_Float Double_Float_Sub(Double_Float a, Double_Float b)
+{
+    b.hi = -b.hi;
+    b.lo = -b.lo;
+    return Double_Float_Add(a, b);
+}
+
+Double_Float Double_Float_Mul(Double_Float a, Double_Float b)
+{
+    uint32_t underflow = Double_Float_Underflow_Save();
+    float product = a.hi * b.hi;
+
+    // Overflow, an infinite operand or inf * 0: as in Double_Float_Add
+    if (Double_Float_Is_Special(product))
+    {
+        return (Double_Float){ product, 0.0f };
+    }
+
+    Double_Float p = Two_Prod(a.hi, b.hi);
+
+    p.lo = __builtin_fmaf(a.hi, b.lo, p.lo);
+    p.lo = __builtin_fmaf(a.lo, b.hi, p.lo);
+    p = Quick_Two_Sum(p.hi, p.lo);
+
+    Double_Float_Underflow_Restore(underflow, p.hi);
+    return p;
+}
+
+Double_Float Double_Float_Div(Double_Float a, Double_Float b)
+{
+    // Division by zero: +-inf (or NaN for 0/0) with only its own exception;
+    // the remainder below would compute 0 * inf and also raise invalid
+    if (b.hi == 0.0f)
+    {
+        return (Double_Float){ a.hi / b.hi, 0.0f };
+    }
+
+    uint32_t underflow = Double_Float_Underflow_Save();
+
+    // First quotient digit from the high parts
+    float q1 = a.hi / b.hi;
+
+    // Overflow or an infinite operand, as in Double_Float_Add
+    if (Double_Float_Is_Special(q1))
+    {
+        return (Double_Float){ q1, 0.0f };
+    }
+
+    // Remainder r = a - q1 * b, computed with an exact product
+    Double_Float r = Double_Float_Sub(a, Double_Float_Mul(b, (Double_Float){ q1, 0.0f }));
+
+    // Second quotient digit corrects the first
+    float q2 = r.hi / b.hi;
+    r = Double_Float_Sub(r, Double_Float_Mul(b, (Double_Float){ q2, 0.0f }));
+
+    // Third digit rounds the result
+    float q3 = r.hi / b.hi;
+
+    Double_Float q = Quick_Two_Sum(q1, q2);
+    q = Double_Float_Add(q, (Double_Float){ q3, 0.0f });
+
+    Double_Float_Underflow_Restore(underflow, q.hi);
+    return q;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file Double_Float.h
+ *
+ * @brief Header file for the Double_Float arithmetic library.
+ *
+ * A Double_Float represents a value as the unevaluated sum of two
+ * single-precision floats (hi + lo) with |lo| <= ulp(hi) / 2. Using the
+ * Cortex-M4F single-precision FPU and error-free transformations
+ * (TwoSum, and TwoProd built on the fused multiply-add instruction VFMA),
+ * it provides about 48 bits (14 decimal digits) of precision at hardware
+ * float speed, which is enough for the 10 significant digits shown on the LCD.
+ *
+ * The exponent range is that of a float (about 1e-38 to 3e38). The FPU
+ * exception flags describe the hi word: an overflow leaves an infinite hi
+ * word (not the NaN the error terms would compute from it), and underflow
+ * is only raised when the hi word underflows, not when the lo word of a
+ * normal result is subnormal.
+ *
+ * @note Algorithms follow T. J. Dekker, "A floating-point technique for
+ * extending the available precision", Numer. Math. 18 (1971), and the
+ * "double-double" formulations of Hida, Li, and Bailey.
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef DOUBLE_FLOAT_H_
+#define DOUBLE_FLOAT_H_
+
+#include <stdint.h>
+
+typedef struct {
+    float hi;
+    float lo;
+} Double_Float;
+
+/**
+ * @brief Convert a double to the nearest Double_Float.
+ *
+ * @param value The value to convert.
+ *
+ * @return Double_Float The converted value.
+ */
+Double_Float Double_Float_From_Double(double value);
+
+/**
+ * @brief Convert a 64-bit integer to a Double_Float.
+ *
+ * Integers with up to 48 significant bits are converted exactly.
+ *
+ * @param value The value to convert.
+ *
+ * @return Double_Float The converted value.
+ */
+Double_Float Double_Float_From_Int(int64_t value);
+
+/**
+ * @brief Convert a Double_Float to double.
+ *
+ * @param x The value to convert.
+ *
+ * @return double hi + lo evaluated in double precision.
+ */
+double Double_Float_To_Double(Double_Float x);
+
+/**
+ * @brief Double_Float arithmetic.
+ *
+ * @param a Left operand.
+ * @param b Right operand.
+ *
+ * @return Double_Float The normalized result.
+ */
+Double_Float Double_Float_Add(Double_Float a, Double_Float b);
+Double_Float Double_Float_Sub(Double_Float a, Double_Float b);
+Double_Float Double_Float_Mul(Double_Float a, Double_Float b);
+Double_Float Double_Float_Div(Double_Float a, Double_Float b);
+
+#endif // DOUBLE_FLOAT_H_
@@ -0,0 +1,90 @@
+/**
+ * @file EEPROM.c
+ *
+ * @brief Source code for the EEPROM driver.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "EEPROM.h"
+
+// EEDONE register fields
+#define EEDONE_WORKING      (1U << 0)
+#define EEDONE_ERRORS       0x3CU       // WKERASE, WKCOPY, NOPERM, WRBUSY
+
+// EESUPP register fields
+#define EESUPP_ERRORS       0x0CU       // ERETRY, PRETRY
+
+static void EEPROM_Wait_Done(void)
+{
+    while (EEPROM->EEDONE & EEDONE_WORKING);
+}
+
+// At least 6 clock cycles after enabling or resetting the module
+static void EEPROM_Settle(void)
+{
+    for (volatile uint32_t i = 0; i < 6; i++);
+}
+
+uint8_t EEPROM_Init(void)
+{
+    // Enable the clock to the EEPROM module
+    SYSCTL->RCGCEEPROM |= 0x01;
+    while ((SYSCTL->PREEPROM & 0x01) == 0);
+    EEPROM_Settle();
+
+    // Wait for the power-on recovery, then check that it succeeded
+    EEPROM_Wait_Done();
+    if (EEPROM->EESUPP & EESUPP_ERRORS)
+    {
+        return 0;
+    }
+
+    // Reset the module, as required before first use
+    SYSCTL->SREEPROM |= 0x01;
+    EEPROM_Settle();
+    SYSCTL->SREEPROM &= ~0x01;
+    EEPROM_Settle();
+
+    EEPROM_Wait_Done();
+    return (EEPROM->EESUPP & EESUPP_ERRORS) == 0;
+}
+
+void EEPROM_Read(uint32_t address, uint32_t *data, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t word = address + i;
+
+        EEPROM->EEBLOCK = word / EEPROM_BLOCK_WORDS;
+        EEPROM->EEOFFSET = word % EEPROM_BLOCK_WORDS;
+        data[i] = EEPROM->EERDWR;
+    }
+}
+
+uint8_t EEPROM_Write(uint32_t address, const uint32_t *data, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t word = address + i;
+
+        EEPROM->EEBLOCK = word / EEPROM_BLOCK_WORDS;
+        EEPROM->EEOFFSET = word % EEPROM_BLOCK_WORDS;
+
+        // Save the wear (and the time) of rewriting an unchanged word
+        if (EEPROM->EERDWR == data[i])
+        {
+            continue;
+        }
+
+        EEPROM->EERDWR = data[i];
+        EEPROM_Wait_Done();
+
+        if (EEPROM->EEDONE & EEDONE_ERRORS)
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
@@ -0,0 +1,61 @@
+/**
+ * @file EEPROM.h
+ *
+ * @brief Header file for the EEPROM driver.
+ *
+ * It gives word access to the 2 KB on-chip EEPROM of the TM4C123GH6PM,
+ * which keeps data across resets and power cycles. The EEPROM is organized
+ * in 32 blocks of 16 words; addresses used by this driver are word offsets
+ * from the start of the EEPROM (0 to EEPROM_SIZE_WORDS - 1).
+ *
+ * Writes are blocking: each word takes up to a few milliseconds to
+ * program, so they must not be used in time-critical paths.
+ *
+ * @note For more information, refer to the Internal Memory section of the
+ * TM4C123GH6PM Microcontroller Datasheet.
+ * Link: https://www.ti.com/lit/ds/symlink/tm4c123gh6pm.pdf
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef EEPROM_H_
+#define EEPROM_H_
+
+#include "TM4C123GH6PM.h"
+#include <stdint.h>
+
+#define EEPROM_SIZE_WORDS       512U
+#define EEPROM_BLOCK_WORDS      16U
+
+/**
+ * @brief Enable the EEPROM module and wait until it is ready.
+ *
+ * @param None
+ *
+ * @return uint8_t 1 if the EEPROM is usable, 0 if it reported an error.
+ */
+uint8_t EEPROM_Init(void);
+
+/**
+ * @brief Read consecutive words.
+ *
+ * @param address The word offset of the first word.
+ * @param data    Receives the words.
+ * @param count   The number of words.
+ *
+ * @return None
+ */
+void EEPROM_Read(uint32_t address, uint32_t *data, uint32_t count);
+
+/**
+ * @brief Write consecutive words. Words that already hold the value are skipped.
+ *
+ * @param address The word offset of the first word.
+ * @param data    The words.
+ * @param count   The number of words.
+ *
+ * @return uint8_t 1 if all words were written, 0 on error.
+ */
+uint8_t EEPROM_Write(uint32_t address, const uint32_t *data, uint32_t count);
+
+#endif // EEPROM_H_
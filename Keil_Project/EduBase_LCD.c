@@ -20,10 +20,15 @@
  */
  
 #include "EduBase_LCD.h"
+#include "Trace.h"
 
 static uint8_t display_control = 0x00;
 static uint8_t display_mode = 0x00;
 
+// Delays after each 4-bit write and after a command (see EduBase_LCD_Set_Timing)
+static uint32_t nibble_delay_us = EDUBASE_LCD_NIBBLE_DELAY_US;
+static uint32_t command_delay_us = EDUBASE_LCD_COMMAND_DELAY_US;
+
 void EduBase_LCD_Ports_Init(void)
 {
     // Enable the clock to Port A by setting the
@@ -120,13 +125,15 @@ void EduBase_LCD_Write_4_Bits(uint8_t data, uint8_t control_flag)
     // Output a short pulse on the PC6 pin to enable the LCD
     EduBase_LCD_Pulse_Enable();
 
-    // Clear the LCD data lines (PA2 - PA5) and provide a 1 ms delay
+    // Clear the LCD data lines (PA2 - PA5) and provide a delay (1 ms by default)
     GPIOA->DATA &= ~0x3C;
-    SysTick_Delay1us(1000);
+    SysTick_Delay1us(nibble_delay_us);
 }
 
 void EduBase_LCD_Send_Command(uint8_t command)
 {
+	Trace_Begin(TRACE_ZONE_LCD_COMMAND, command);
+
 	// Transmit the upper nibble of the data byte
 	EduBase_LCD_Write_4_Bits(command & 0xF0, SEND_COMMAND_FLAG);
 	
@@ -142,17 +149,29 @@ void EduBase_LCD_Send_Command(uint8_t command)
 		
 		
 		{
-				SysTick_Delay1us(37);
+				SysTick_Delay1us(command_delay_us);
 		}
+
+	Trace_End(TRACE_ZONE_LCD_COMMAND);
 }
 
 void EduBase_LCD_Send_Data(uint8_t data)
 {
+    Trace_Begin(TRACE_ZONE_LCD_DATA, data);
+
     // Transmit the upper nibble of the data byte
     EduBase_LCD_Write_4_Bits(data & 0xF0, SEND_DATA_FLAG);
 
     // Transmit the lower nibble of the data byte
     EduBase_LCD_Write_4_Bits(data << 0x4, SEND_DATA_FLAG);
+
+    Trace_End(TRACE_ZONE_LCD_DATA);
+}
+
+void EduBase_LCD_Set_Timing(uint32_t nibble_us, uint32_t command_us)
+{
+    nibble_delay_us = nibble_us;
+    command_delay_us = command_us;
 }
 
 void EduBase_LCD_Init(void)
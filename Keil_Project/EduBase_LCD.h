@@ -56,6 +56,11 @@
 #include <string.h>
 #include <stdio.h>
 
+// Default delays after each 4-bit write and after a command (see EduBase_LCD_Set_Timing);
+// the command delay is the execution time given in the datasheet
+#define EDUBASE_LCD_NIBBLE_DELAY_US     1000U
+#define EDUBASE_LCD_COMMAND_DELAY_US    37U
+
 static uint8_t up_arrow[8] =
 {
 	0x00,
@@ -258,6 +263,20 @@ void EduBase_LCD_Send_Command(uint8_t command);
  */
 void EduBase_LCD_Send_Data(uint8_t data);
 
+/**
+ * @brief Sets the delays used after each write to the LCD.
+ *
+ * This function changes the delay after each 4-bit write (1 ms by default) and the extra
+ * delay after a command (37 us by default, the execution time given in the datasheet).
+ * The Clear Display and Return Home commands always wait 1.52 ms.
+ *
+ * @param nibble_delay_us  The delay after each 4-bit write in microseconds.
+ * @param command_delay_us The delay after a command in microseconds.
+ *
+ * @return None
+ */
+void EduBase_LCD_Set_Timing(uint32_t nibble_delay_us, uint32_t command_delay_us);
+
 /**
  * @brief Initializes the LCD module connected to the EduBase board.
  *
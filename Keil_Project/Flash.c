@@ -0,0 +1,51 @@
+/**
+ * @file Flash.c
+ *
+ * @brief Source code for the Flash driver.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Flash.h"
+
+// FMC register fields
+#define FMC_WRITE           (1U << 0)
+#define FMC_ERASE           (1U << 1)
+#define FMC_WRKEY_SHIFT     16
+
+// Write key, selected by the KEY bit of the BOOTCFG register
+#define FLASH_KEY_BOOTCFG   (1U << 4)
+#define FLASH_KEY_A442      0xA442U
+#define FLASH_KEY_71D5      0x71D5U
+
+// FCRIS / FCMISC: access, pump voltage, invalid data, erase and program verify errors
+#define FLASH_ERRORS        0x2E01U
+
+static uint32_t Flash_Key(void)
+{
+    uint32_t key = (FLASH_CTRL->BOOTCFG & FLASH_KEY_BOOTCFG) ? FLASH_KEY_A442 : FLASH_KEY_71D5;
+    return key << FMC_WRKEY_SHIFT;
+}
+
+// Start an operation and wait until the controller clears its bit
+static uint8_t Flash_Execute(uint32_t address, uint32_t command)
+{
+    FLASH_CTRL->FCMISC = FLASH_ERRORS;
+    FLASH_CTRL->FMA = address;
+    FLASH_CTRL->FMC = Flash_Key() | command;
+
+    while (FLASH_CTRL->FMC & command);
+
+    return (FLASH_CTRL->FCRIS & FLASH_ERRORS) == 0;
+}
+
+uint8_t Flash_Program_Word(uint32_t address, uint32_t value)
+{
+    FLASH_CTRL->FMD = value;
+    return Flash_Execute(address, FMC_WRITE);
+}
+
+uint8_t Flash_Erase_Page(uint32_t address)
+{
+    return Flash_Execute(address, FMC_ERASE);
+}
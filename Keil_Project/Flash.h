@@ -0,0 +1,64 @@
+/**
+ * @file Flash.h
+ *
+ * @brief Header file for the Flash driver.
+ *
+ * It programs and erases the on-chip flash memory of the TM4C123GH6PM
+ * through the flash memory controller. The flash is erased in 1 KB pages
+ * (all bits set to 1) and programmed one 32-bit word at a time (bits can
+ * only be cleared until the next erase).
+ *
+ * While the controller programs or erases, instruction fetches from the
+ * flash stall, so the CPU (and every interrupt handler) waits until the
+ * operation is done: about 50 us for a word, and up to several
+ * milliseconds for a page. These functions must not be used in
+ * time-critical paths.
+ *
+ * @note For more information, refer to the Internal Memory section of the
+ * TM4C123GH6PM Microcontroller Datasheet.
+ * Link: https://www.ti.com/lit/ds/symlink/tm4c123gh6pm.pdf
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef FLASH_H_
+#define FLASH_H_
+
+#include "TM4C123GH6PM.h"
+#include <stdint.h>
+
+#define FLASH_PAGE_SIZE         1024U
+#define FLASH_ERASED_WORD       0xFFFFFFFFU
+
+/**
+ * @brief Program a word.
+ *
+ * @param address The address, aligned to 4 bytes.
+ * @param value   The value.
+ *
+ * @return uint8_t 1 on success, 0 if the controller reported an error.
+ */
+uint8_t Flash_Program_Word(uint32_t address, uint32_t value);
+
+/**
+ * @brief Erase a page.
+ *
+ * @param address The address of the page, aligned to FLASH_PAGE_SIZE.
+ *
+ * @return uint8_t 1 on success, 0 if the controller reported an error.
+ */
+uint8_t Flash_Erase_Page(uint32_t address);
+
+/**
+ * @brief Read a word.
+ *
+ * @param address The address, aligned to 4 bytes.
+ *
+ * @return uint32_t The value.
+ */
+static inline uint32_t Flash_Read_Word(uint32_t address)
+{
+    return *(const volatile uint32_t *)(uintptr_t)address;
+}
+
+#endif // FLASH_H_
@@ -0,0 +1,89 @@
+/**
+ * @file Interrupts.c
+ *
+ * @brief Source code for the Interrupts module.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Interrupts.h"
+#include "Atomic.h"
+#include <string.h>
+
+// Per-source statistics (visible in the debugger watch window)
+static Interrupts_Stats irq_stats[IRQ_SOURCE_COUNT];
+static Seqlock irq_stats_lock[IRQ_SOURCE_COUNT];
+
+static volatile uint32_t critical_max = 0;
+
+void Interrupts_Init(void)
+{
+    NVIC_SetPriorityGrouping(IRQ_PRIORITY_GROUPING);
+    NVIC_SetPriority(SysTick_IRQn, IRQ_PRIORITY_SYSTICK);
+
+    Interrupts_Reset_Stats();
+}
+
+uint32_t Interrupts_Handler_Enter(Interrupts_Source source, uint32_t latency)
+{
+    Interrupts_Stats *stats = &irq_stats[source];
+
+    if (latency > stats->latency_max)
+    {
+        Seqlock_Write_Begin(&irq_stats_lock[source]);
+        stats->latency_max = latency;
+        Seqlock_Write_End(&irq_stats_lock[source]);
+    }
+    return DWT->CYCCNT;
+}
+
+void Interrupts_Handler_Exit(Interrupts_Source source, uint32_t start)
+{
+    Interrupts_Stats *stats = &irq_stats[source];
+    uint32_t duration = DWT->CYCCNT - start;
+
+    // Each source has a single priority, so its handler does not preempt itself
+    Seqlock_Write_Begin(&irq_stats_lock[source]);
+    if (duration > stats->duration_max)
+    {
+        stats->duration_max = duration;
+    }
+    stats->duration_total += duration;
+    stats->count++;
+    Seqlock_Write_End(&irq_stats_lock[source]);
+}
+
+void Interrupts_Get_Stats(Interrupts_Source source, Interrupts_Stats *stats)
+{
+    uint32_t sequence;
+
+    do
+    {
+        sequence = Seqlock_Read_Begin(&irq_stats_lock[source]);
+        *stats = irq_stats[source];
+    } while (Seqlock_Read_Retry(&irq_stats_lock[source], sequence));
+}
+
+uint32_t Interrupts_Get_Critical_Max(void)
+{
+    return critical_max;
+}
+
+void Interrupts_Reset_Stats(void)
+{
+    Interrupts_Critical critical = Interrupts_Enter_Critical();
+
+    memset(irq_stats, 0, sizeof(irq_stats));
+
+    __set_BASEPRI(critical.basepri);
+    critical_max = 0;
+}
+
+void Interrupts_Record_Critical(uint32_t cycles)
+{
+    // Only the outermost section of a nest matters; the inner ones are shorter
+    if (cycles > critical_max)
+    {
+        critical_max = cycles;
+    }
+}
@@ -0,0 +1,184 @@
+/**
+ * @file Interrupts.h
+ *
+ * @brief Header file for the Interrupts module.
+ *
+ * It holds the interrupt priority plan of the firmware in one place, and
+ * measures how well the plan is kept.
+ *
+ * The TM4C123GH6PM implements 3 priority bits (0 = highest, 7 = lowest).
+ * All 3 bits are used for preemption (no subpriority), so a higher
+ * priority interrupt always preempts a lower priority handler.
+ *
+ * Priority plan:
+ *  - 0: Profiler (Timer 1A), must be able to sample every other handler
+ *  - 1: Watchdog early warning, must run even when a handler is stuck
+ *  - 2: SysTick timebase, one short handler every ~4.2 s
+ *  - 3: Keypad (GPIO Port D row wake-up, Timer 2A scan timer)
+ *  - 4: UART0
+ *
+ * Critical sections mask interrupts with BASEPRI instead of PRIMASK, so
+ * that interrupts at IRQ_PRIORITY_CRITICAL or higher (the profiler and
+ * the watchdog) still run and can observe a critical section that takes
+ * too long.
+ *
+ * For every source, the handlers report their latency and duration in CPU
+ * cycles through Interrupts_Handler_Enter/Exit. The latency is measured
+ * from the hardware event to the handler entry, for sources whose timer
+ * shows when the event happened (SysTick and Timer 1A); for the other
+ * sources only the duration is measured. The longest critical section is
+ * recorded as well, since it adds directly to the latency of every masked
+ * interrupt. The statistics of each source are protected by a seqlock, so
+ * Interrupts_Get_Stats returns a consistent copy.
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef INTERRUPTS_H_
+#define INTERRUPTS_H_
+
+#include "TM4C123GH6PM.h"
+#include <stdint.h>
+
+// Priority plan (0 = highest)
+#define IRQ_PRIORITY_PROFILER       0
+#define IRQ_PRIORITY_WATCHDOG       1
+#define IRQ_PRIORITY_SYSTICK        2
+#define IRQ_PRIORITY_KEYPAD         3
+#define IRQ_PRIORITY_UART           4
+
+// Critical sections mask this priority and lower
+#define IRQ_PRIORITY_CRITICAL       IRQ_PRIORITY_SYSTICK
+
+// PRIGROUP: group (preemption) priority in bits 7:5, no subpriority
+#define IRQ_PRIORITY_GROUPING       4
+
+typedef enum {
+    IRQ_SOURCE_PROFILER,
+    IRQ_SOURCE_WATCHDOG,
+    IRQ_SOURCE_SYSTICK,
+    IRQ_SOURCE_KEYPAD,
+    IRQ_SOURCE_UART,
+    IRQ_SOURCE_COUNT
+} Interrupts_Source;
+
+typedef struct {
+    uint32_t count;
+    uint32_t latency_max;
+    uint32_t duration_max;
+    uint64_t duration_total;
+} Interrupts_Stats;
+
+/**
+ * @brief Set the priority grouping and the SysTick priority, and clear the statistics.
+ *
+ * The other sources set their priority from the plan when they are initialized.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Interrupts_Init(void);
+
+/**
+ * @brief Record the entry into a handler.
+ *
+ * @param source  The interrupt source.
+ * @param latency The cycles from the hardware event to this call, or 0 if unknown.
+ *
+ * @return uint32_t The cycle count at entry, to pass to Interrupts_Handler_Exit.
+ */
+uint32_t Interrupts_Handler_Enter(Interrupts_Source source, uint32_t latency);
+
+/**
+ * @brief Record the exit from a handler.
+ *
+ * @param source The interrupt source.
+ * @param start  The value returned by Interrupts_Handler_Enter.
+ *
+ * @return None
+ */
+void Interrupts_Handler_Exit(Interrupts_Source source, uint32_t start);
+
+/**
+ * @brief Get a consistent copy of the statistics of an interrupt source.
+ *
+ * Must not be called from an interrupt handler of higher priority than the source.
+ *
+ * @param source The interrupt source.
+ * @param stats  Receives the statistics (cycles).
+ *
+ * @return None
+ */
+void Interrupts_Get_Stats(Interrupts_Source source, Interrupts_Stats *stats);
+
+/**
+ * @brief Get the longest critical section measured.
+ *
+ * @param None
+ *
+ * @return uint32_t The duration in cycles.
+ */
+uint32_t Interrupts_Get_Critical_Max(void);
+
+/**
+ * @brief Clear the statistics of all sources and of the critical sections.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Interrupts_Reset_Stats(void);
+
+/**
+ * @brief Record the duration of a critical section (called by Interrupts_Exit_Critical).
+ *
+ * @param cycles The duration in cycles.
+ *
+ * @return None
+ */
+void Interrupts_Record_Critical(uint32_t cycles);
+
+typedef struct {
+    uint32_t basepri;
+    uint32_t start;
+} Interrupts_Critical;
+
+/**
+ * @brief Enter a critical section, masking IRQ_PRIORITY_CRITICAL and lower.
+ *
+ * Critical sections can be nested.
+ *
+ * @param None
+ *
+ * @return Interrupts_Critical The state to pass to Interrupts_Exit_Critical.
+ */
+static inline Interrupts_Critical Interrupts_Enter_Critical(void)
+{
+    Interrupts_Critical critical;
+
+    critical.basepri = __get_BASEPRI();
+
+    // BASEPRI_MAX only raises the masking level, so nesting keeps the outer level
+    __set_BASEPRI_MAX(IRQ_PRIORITY_CRITICAL << (8 - __NVIC_PRIO_BITS));
+    critical.start = DWT->CYCCNT;
+
+    return critical;
+}
+
+/**
+ * @brief Leave a critical section.
+ *
+ * @param critical The value returned by Interrupts_Enter_Critical.
+ *
+ * @return None
+ */
+static inline void Interrupts_Exit_Critical(Interrupts_Critical critical)
+{
+    uint32_t cycles = DWT->CYCCNT - critical.start;
+
+    __set_BASEPRI(critical.basepri);
+    Interrupts_Record_Critical(cycles);
+}
+
+#endif // INTERRUPTS_H_
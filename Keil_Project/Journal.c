@@ -0,0 +1,512 @@
+/**
+ * @file Journal.c
+ *
+ * @brief Source code for the Journal module.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Journal.h"
+#include "Flash.h"
+#include "SysTick_Delay.h"
+#include <string.h>
+
+#define JOURNAL_MAGIC               0x314E524AU     // "JRN1"
+
+// Page header words (the magic is programmed last)
+#define HEADER_FIRST_SEQUENCE       0
+#define HEADER_MAGIC                1
+
+// Record words (the sequence number is programmed last)
+#define RECORD_SEQUENCE             0
+#define RECORD_INFO                 1
+#define RECORD_OP1                  2
+#define RECORD_OP2                  4
+#define RECORD_RESULT               6
+
+// RECORD_INFO fields
+#define INFO_OP_SHIFT               0
+#define INFO_ERROR_SHIFT            8
+#define INFO_FLOAT_OP1              (1U << 16)
+#define INFO_FLOAT_OP2              (1U << 17)
+#define INFO_FLOAT_RESULT           (1U << 18)
+#define INFO_TYPE_SHIFT             24      // 0 (calculation) in records written before the types
+
+// Slot 0 of a page is the header, slots 1 to JOURNAL_RECORDS_PER_PAGE are records
+#define JOURNAL_SLOT_ADDRESS(page, slot) \
+    (JOURNAL_FLASH_START + ((page) * FLASH_PAGE_SIZE) + ((slot) * JOURNAL_RECORD_WORDS * 4U))
+
+_Static_assert(sizeof(((Calc_Number *)0)->value) == 8, "A journal record stores 2 words per number");
+_Static_assert(JOURNAL_PAGE_COUNT * FLASH_PAGE_SIZE <= MEMORY_JOURNAL_SIZE,
+               "The journal must fit in the flash reserved by the scatter file");
+
+typedef enum {
+    PAGE_ERASED,
+    PAGE_USED,
+    PAGE_RETIRED
+} Journal_Page_State;
+
+typedef struct {
+    uint32_t first_sequence;
+    uint32_t page;
+} Journal_Index_Entry;
+
+static uint8_t page_state[JOURNAL_PAGE_COUNT];
+
+// Sparse index: one entry per used page, oldest first
+static Journal_Index_Entry journal_index[JOURNAL_PAGE_COUNT];
+static uint32_t index_count = 0;
+
+// Write position; write_open is 0 until write_page has its header
+static uint32_t write_page = 0;
+static uint32_t write_slot = 1;
+static uint8_t write_open = 0;
+
+// Records waiting to be programmed
+static Journal_Entry queue[JOURNAL_QUEUE_SIZE];
+static uint32_t queue_head = 0;
+static uint32_t queue_tail = 0;
+
+static Journal_Stats journal_stats;
+static uint8_t journal_paused = 0;
+
+static uint32_t Journal_Read(uint32_t page, uint32_t slot, uint32_t word)
+{
+    return Flash_Read_Word(JOURNAL_SLOT_ADDRESS(page, slot) + (word * 4U));
+}
+
+static uint8_t Journal_Slot_Blank(uint32_t page, uint32_t slot)
+{
+    for (uint32_t word = 0; word < JOURNAL_RECORD_WORDS; word++)
+    {
+        if (Journal_Read(page, slot, word) != FLASH_ERASED_WORD)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static uint8_t Journal_Page_Blank(uint32_t page)
+{
+    for (uint32_t slot = 0; slot <= JOURNAL_RECORDS_PER_PAGE; slot++)
+    {
+        if (!Journal_Slot_Blank(page, slot))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void Journal_Put_Number(uint32_t *words, Calc_Number x)
+{
+    memcpy(words, &x.value, sizeof(x.value));
+}
+
+static Calc_Number Journal_Get_Number(uint32_t page, uint32_t slot, uint32_t word, uint8_t is_float)
+{
+    uint32_t words[2];
+    Calc_Number x;
+
+    words[0] = Journal_Read(page, slot, word);
+    words[1] = Journal_Read(page, slot, word + 1);
+
+    x.type = is_float ? CALC_NUMBER_FLOAT : CALC_NUMBER_INT;
+    memcpy(&x.value, words, sizeof(x.value));
+    return x;
+}
+
+static void Journal_Decode(uint32_t page, uint32_t slot, Journal_Entry *entry)
+{
+    uint32_t info = Journal_Read(page, slot, RECORD_INFO);
+
+    entry->sequence = Journal_Read(page, slot, RECORD_SEQUENCE);
+    entry->type = (uint8_t)(info >> INFO_TYPE_SHIFT);
+    entry->op = (char)(info >> INFO_OP_SHIFT);
+    entry->error = (uint8_t)(info >> INFO_ERROR_SHIFT);
+    entry->op1 = Journal_Get_Number(page, slot, RECORD_OP1, (info & INFO_FLOAT_OP1) != 0);
+    entry->op2 = Journal_Get_Number(page, slot, RECORD_OP2, (info & INFO_FLOAT_OP2) != 0);
+    entry->result = Journal_Get_Number(page, slot, RECORD_RESULT, (info & INFO_FLOAT_RESULT) != 0);
+}
+
+static uint32_t Journal_Oldest_Sequence(void)
+{
+    return (index_count > 0) ? journal_index[0].first_sequence : journal_stats.next_sequence;
+}
+
+// Rebuild the state of a used page: returns the next sequence number
+// after its records and sets write_slot to its first free slot
+static uint32_t Journal_Scan_Page(uint32_t page, uint32_t first_sequence)
+{
+    uint32_t next_sequence = first_sequence;
+
+    write_slot = 1;
+    for (uint32_t slot = 1; slot <= JOURNAL_RECORDS_PER_PAGE; slot++)
+    {
+        uint32_t sequence = Journal_Read(page, slot, RECORD_SEQUENCE);
+
+        if (sequence != FLASH_ERASED_WORD)
+        {
+            next_sequence = sequence + 1;
+        }
+
+        // A torn record (sequence not programmed) still takes its slot
+        if (!Journal_Slot_Blank(page, slot))
+        {
+            write_slot = slot + 1;
+        }
+    }
+    return next_sequence;
+}
+
+void Journal_Init(void)
+{
+    memset(&journal_stats, 0, sizeof(journal_stats));
+    index_count = 0;
+    queue_head = 0;
+    queue_tail = 0;
+
+    for (uint32_t page = 0; page < JOURNAL_PAGE_COUNT; page++)
+    {
+        if (Journal_Read(page, 0, HEADER_MAGIC) == JOURNAL_MAGIC)
+        {
+            // Insert into the index, ordered by first sequence number
+            uint32_t first_sequence = Journal_Read(page, 0, HEADER_FIRST_SEQUENCE);
+            uint32_t i = index_count++;
+
+            while (i > 0 && journal_index[i - 1].first_sequence > first_sequence)
+            {
+                journal_index[i] = journal_index[i - 1];
+                i--;
+            }
+            journal_index[i].first_sequence = first_sequence;
+            journal_index[i].page = page;
+
+            page_state[page] = PAGE_USED;
+        }
+        else
+        {
+            // Torn headers and leftovers are erased by Journal_Poll
+            page_state[page] = Journal_Page_Blank(page) ? PAGE_ERASED : PAGE_RETIRED;
+        }
+    }
+
+    if (index_count > 0)
+    {
+        // Continue in the newest page
+        const Journal_Index_Entry *newest = &journal_index[index_count - 1];
+
+        write_page = newest->page;
+        write_open = 1;
+        journal_stats.next_sequence = Journal_Scan_Page(newest->page, newest->first_sequence);
+    }
+    else
+    {
+        // Empty journal, sequence numbers start at 1 (0 means none)
+        write_page = 0;
+        write_slot = 1;
+        write_open = 0;
+        journal_stats.next_sequence = 1;
+    }
+
+    journal_stats.oldest_sequence = Journal_Oldest_Sequence();
+}
+
+static uint32_t Journal_Queue(Journal_Type type, char op, Calc_Number op1, Calc_Number op2,
+                              Calc_Number result, uint8_t error)
+{
+    if (journal_paused)
+    {
+        return 0;
+    }
+
+    if (queue_head - queue_tail >= JOURNAL_QUEUE_SIZE)
+    {
+        journal_stats.dropped++;
+        return 0;
+    }
+
+    Journal_Entry *entry = &queue[queue_head & (JOURNAL_QUEUE_SIZE - 1)];
+    entry->sequence = journal_stats.next_sequence++;
+    entry->type = (uint8_t)type;
+    entry->op = op;
+    entry->error = error;
+    entry->op1 = op1;
+    entry->op2 = op2;
+    entry->result = result;
+
+    queue_head++;
+    journal_stats.appended++;
+    return entry->sequence;
+}
+
+uint32_t Journal_Append(char op, Calc_Number op1, Calc_Number op2, Calc_Number result, uint8_t error)
+{
+    return Journal_Queue(JOURNAL_TYPE_CALCULATION, op, op1, op2, result, error);
+}
+
+uint32_t Journal_Append_Result(Journal_Type type, Calc_Number result, uint8_t error)
+{
+    const Calc_Number zero = { CALC_NUMBER_INT, { .i = 0 } };
+
+    return Journal_Queue(type, '\0', zero, zero, result, error);
+}
+
+void Journal_Set_Paused(uint8_t paused)
+{
+    journal_paused = paused;
+}
+
+// Make sure there is a free slot at the write position, opening the
+// next (erased) page if needed
+static uint8_t Journal_Open_Slot(uint32_t first_sequence)
+{
+    if (write_open && write_slot <= JOURNAL_RECORDS_PER_PAGE)
+    {
+        return 1;
+    }
+
+    uint32_t page = write_open ? (write_page + 1) % JOURNAL_PAGE_COUNT : write_page;
+    if (page_state[page] != PAGE_ERASED)
+    {
+        return 0;
+    }
+
+    if (!Flash_Program_Word(JOURNAL_SLOT_ADDRESS(page, 0) + (HEADER_FIRST_SEQUENCE * 4U), first_sequence) ||
+        !Flash_Program_Word(JOURNAL_SLOT_ADDRESS(page, 0) + (HEADER_MAGIC * 4U), JOURNAL_MAGIC))
+    {
+        journal_stats.errors++;
+        page_state[page] = PAGE_RETIRED;
+        return 0;
+    }
+
+    page_state[page] = PAGE_USED;
+    journal_index[index_count].first_sequence = first_sequence;
+    journal_index[index_count].page = page;
+    index_count++;
+
+    write_page = page;
+    write_slot = 1;
+    write_open = 1;
+    return 1;
+}
+
+static void Journal_Program_Record(const Journal_Entry *entry)
+{
+    uint32_t words[JOURNAL_RECORD_WORDS];
+    uint32_t address = JOURNAL_SLOT_ADDRESS(write_page, write_slot);
+    uint8_t ok = 1;
+
+    words[RECORD_SEQUENCE] = entry->sequence;
+    words[RECORD_INFO] = ((uint32_t)(uint8_t)entry->op << INFO_OP_SHIFT) |
+                         ((uint32_t)entry->error << INFO_ERROR_SHIFT) |
+                         ((uint32_t)entry->type << INFO_TYPE_SHIFT) |
+                         ((entry->op1.type == CALC_NUMBER_FLOAT) ? INFO_FLOAT_OP1 : 0) |
+                         ((entry->op2.type == CALC_NUMBER_FLOAT) ? INFO_FLOAT_OP2 : 0) |
+                         ((entry->result.type == CALC_NUMBER_FLOAT) ? INFO_FLOAT_RESULT : 0);
+    Journal_Put_Number(&words[RECORD_OP1], entry->op1);
+    Journal_Put_Number(&words[RECORD_OP2], entry->op2);
+    Journal_Put_Number(&words[RECORD_RESULT], entry->result);
+
+    // The sequence number last, it commits the record
+    for (uint32_t word = 1; word < JOURNAL_RECORD_WORDS && ok; word++)
+    {
+        ok = Flash_Program_Word(address + (word * 4U), words[word]);
+    }
+    if (ok)
+    {
+        ok = Flash_Program_Word(address + (RECORD_SEQUENCE * 4U), words[RECORD_SEQUENCE]);
+    }
+
+    write_slot++;
+
+    if (ok)
+    {
+        queue_tail++;
+        journal_stats.written++;
+    }
+    else
+    {
+        // Try again in the next slot
+        journal_stats.errors++;
+    }
+}
+
+// Retire the used page that follows the write position (the oldest page)
+static uint8_t Journal_Retire_Page(void)
+{
+    for (uint32_t i = 1; i < JOURNAL_PAGE_COUNT; i++)
+    {
+        uint32_t page = (write_page + i) % JOURNAL_PAGE_COUNT;
+
+        if (page_state[page] == PAGE_USED)
+        {
+            // Remove it from the index
+            uint32_t position = 0;
+            while (journal_index[position].page != page)
+            {
+                position++;
+            }
+            if (position + 1 < index_count)
+            {
+                journal_stats.retired += journal_index[position + 1].first_sequence - journal_index[position].first_sequence;
+            }
+            index_count--;
+            memmove(&journal_index[position], &journal_index[position + 1], (index_count - position) * sizeof(journal_index[0]));
+
+            page_state[page] = PAGE_RETIRED;
+            journal_stats.oldest_sequence = Journal_Oldest_Sequence();
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Erase the retired page closest ahead of the write position
+static uint8_t Journal_Erase_Page(void)
+{
+    for (uint32_t i = 1; i <= JOURNAL_PAGE_COUNT; i++)
+    {
+        uint32_t page = (write_page + i) % JOURNAL_PAGE_COUNT;
+
+        if (page_state[page] == PAGE_RETIRED)
+        {
+            uint64_t start_us = SysTick_Get_Time_us();
+
+            if (Flash_Erase_Page(JOURNAL_SLOT_ADDRESS(page, 0)))
+            {
+                page_state[page] = PAGE_ERASED;
+                journal_stats.erases++;
+            }
+            else
+            {
+                journal_stats.errors++;
+            }
+
+            uint32_t erase_us = (uint32_t)(SysTick_Get_Time_us() - start_us);
+            if (erase_us > journal_stats.erase_us_max)
+            {
+                journal_stats.erase_us_max = erase_us;
+            }
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void Journal_Poll(uint8_t may_erase)
+{
+    uint8_t blocked = 0;
+
+    // 1. Program one queued record
+    if (queue_head != queue_tail)
+    {
+        const Journal_Entry *entry = &queue[queue_tail & (JOURNAL_QUEUE_SIZE - 1)];
+
+        if (Journal_Open_Slot(entry->sequence))
+        {
+            uint64_t start_us = SysTick_Get_Time_us();
+
+            Journal_Program_Record(entry);
+
+            uint32_t program_us = (uint32_t)(SysTick_Get_Time_us() - start_us);
+            if (program_us > journal_stats.program_us_max)
+            {
+                journal_stats.program_us_max = program_us;
+            }
+            return;
+        }
+
+        // The next page is not erased yet
+        blocked = 1;
+    }
+
+    // Erasing stalls the CPU for a few ms, only when the caller allows it
+    if (!may_erase)
+    {
+        return;
+    }
+
+    // Keep erased pages ahead of the write position
+    uint32_t erased = 0;
+    for (uint32_t page = 0; page < JOURNAL_PAGE_COUNT; page++)
+    {
+        if (page_state[page] == PAGE_ERASED)
+        {
+            erased++;
+        }
+    }
+
+    if (erased < JOURNAL_SPARE_PAGES || blocked)
+    {
+        // 2. Erase one retired page, or 3. retire the oldest page
+        if (!Journal_Erase_Page())
+        {
+            Journal_Retire_Page();
+        }
+    }
+}
+
+uint8_t Journal_Find(uint32_t sequence, Journal_Entry *entry)
+{
+    // Still queued
+    if (queue_head != queue_tail)
+    {
+        uint32_t queued_first = queue[queue_tail & (JOURNAL_QUEUE_SIZE - 1)].sequence;
+
+        if (sequence >= queued_first && sequence < journal_stats.next_sequence)
+        {
+            *entry = queue[(queue_tail + (sequence - queued_first)) & (JOURNAL_QUEUE_SIZE - 1)];
+            return 1;
+        }
+    }
+
+    if (index_count == 0 || sequence < journal_index[0].first_sequence || sequence >= journal_stats.next_sequence)
+    {
+        return 0;
+    }
+
+    // Binary search for the last page that starts at or before the sequence number
+    uint32_t low = 0;
+    uint32_t high = index_count - 1;
+    while (low < high)
+    {
+        uint32_t middle = (low + high + 1) / 2;
+        if (journal_index[middle].first_sequence <= sequence)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle - 1;
+        }
+    }
+
+    uint32_t page = journal_index[low].page;
+
+    // Records are dense unless a torn record took a slot
+    uint32_t slot = 1 + (sequence - journal_index[low].first_sequence);
+    if (slot > JOURNAL_RECORDS_PER_PAGE || Journal_Read(page, slot, RECORD_SEQUENCE) != sequence)
+    {
+        for (slot = 1; slot <= JOURNAL_RECORDS_PER_PAGE; slot++)
+        {
+            if (Journal_Read(page, slot, RECORD_SEQUENCE) == sequence)
+            {
+                break;
+            }
+        }
+        if (slot > JOURNAL_RECORDS_PER_PAGE)
+        {
+            return 0;
+        }
+    }
+
+    Journal_Decode(page, slot, entry);
+    return 1;
+}
+
+void Journal_Get_Stats(Journal_Stats *stats)
+{
+    *stats = journal_stats;
+}
@@ -0,0 +1,174 @@
+/**
+ * @file Journal.h
+ *
+ * @brief Header file for the Journal module.
+ *
+ * It keeps every calculation (operands, operator, result, and error) in an
+ * append-only journal in the spare on-chip flash, so that it survives
+ * resets and power cycles. The accepted results of the expression editor,
+ * the integration mode and the polynomial mode are kept as well, as
+ * records of their own type with the result only. The last
+ * JOURNAL_PAGE_COUNT pages of the flash are reserved for it: the scatter
+ * file ends the code region at JOURNAL_FLASH_START (see Memory_Map.h).
+ *
+ * The journal is log-structured: the pages are used in a circle, and
+ * each page starts with a header that holds the sequence number of its
+ * first record. A record is 8 words; its sequence number is programmed
+ * last, so a record torn by a reset is not taken as valid.
+ *
+ * Programming and erasing stall the CPU (see Flash.h), so
+ * Journal_Append only copies the record into a RAM queue. Journal_Poll
+ * is called from the key wait loop and does one small step of background
+ * work at a time:
+ *  1. Program one queued record (about 0.4 ms).
+ *  2. Otherwise, if fewer than JOURNAL_SPARE_PAGES pages are erased, erase
+ *     one retired page (a few ms).
+ *  3. Otherwise, if still short of erased pages, retire the oldest page.
+ * Compaction is therefore incremental: retiring and erasing happen at most
+ * one page per poll, ahead of the write position. Steps 2 and 3 are only
+ * taken when the caller allows them, i.e. when the keypad scanner is in its
+ * interrupt wake mode and the clock governor is idle, so that an erase
+ * never delays a key of fast typing.
+ *
+ * Journal_Set_Paused stops the appends, e.g. while the session replay
+ * corpus runs through the calculator at startup.
+ *
+ * A sparse index in RAM holds the first sequence number of each page in
+ * log order. Journal_Find locates a record by sequence number with a
+ * binary search of the index, then indexes into the page.
+ *
+ * @note When the journal is full, the oldest page is retired. Its records
+ * (JOURNAL_RECORDS_PER_PAGE) are lost, and Journal_Get_Stats reports the
+ * oldest sequence number still held.
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef JOURNAL_H_
+#define JOURNAL_H_
+
+#include "Calc_Number.h"
+#include "Memory_Map.h"
+#include <stdint.h>
+
+// Reserved flash: the last 32 KB of the 256 KB flash
+#define JOURNAL_FLASH_START         ((uint32_t)MEMORY_JOURNAL_BASE)
+#define JOURNAL_PAGE_COUNT          32U
+
+// Erased pages kept ahead of the write position
+#define JOURNAL_SPARE_PAGES         2U
+
+// Records waiting to be programmed (power of two)
+#define JOURNAL_QUEUE_SIZE          8U
+
+// Page header and records are 8 words each
+#define JOURNAL_RECORD_WORDS        8U
+#define JOURNAL_RECORDS_PER_PAGE    ((1024U / (JOURNAL_RECORD_WORDS * 4U)) - 1U)
+
+// Record types; the records of a mode result have op '\0' and zero operands
+typedef enum {
+    JOURNAL_TYPE_CALCULATION,   // op1 op op2 = result
+    JOURNAL_TYPE_EXPRESSION,    // accepted value of the expression editor
+    JOURNAL_TYPE_INTEGRAL,      // accepted value of the integration mode
+    JOURNAL_TYPE_ROOT           // accepted root of the polynomial mode
+} Journal_Type;
+
+typedef struct {
+    uint32_t sequence;
+    uint8_t type;               // Journal_Type
+    char op;
+    uint8_t error;
+    Calc_Number op1;
+    Calc_Number op2;
+    Calc_Number result;
+} Journal_Entry;
+
+typedef struct {
+    uint32_t appended;          // records queued
+    uint32_t written;           // records programmed
+    uint32_t dropped;           // records lost because the queue was full
+    uint32_t retired;           // records lost to compaction
+    uint32_t erases;
+    uint32_t errors;            // program or erase errors
+    uint32_t oldest_sequence;   // oldest record held
+    uint32_t next_sequence;     // sequence number of the next record
+    uint32_t program_us_max;    // longest record program
+    uint32_t erase_us_max;      // longest page erase
+} Journal_Stats;
+
+/**
+ * @brief Scan the reserved flash and rebuild the index and the write position.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Journal_Init(void);
+
+/**
+ * @brief Queue a calculation for the journal. Does not touch the flash.
+ *
+ * @param op     The operator ('+', '-', '*', '/').
+ * @param op1    The first operand.
+ * @param op2    The second operand.
+ * @param result The result.
+ * @param error  The Calc_Error of the calculation.
+ *
+ * @return uint32_t The sequence number of the record, or 0 if the queue was full or
+ *                  the journal is paused.
+ */
+uint32_t Journal_Append(char op, Calc_Number op1, Calc_Number op2, Calc_Number result, uint8_t error);
+
+/**
+ * @brief Queue the result of a mode (editor, integration, polynomial) for the journal.
+ *
+ * @param type   The record type (not JOURNAL_TYPE_CALCULATION).
+ * @param result The result.
+ * @param error  The Calc_Error of the result.
+ *
+ * @return uint32_t The sequence number of the record, or 0 if the queue was full or
+ *                  the journal is paused.
+ */
+uint32_t Journal_Append_Result(Journal_Type type, Calc_Number result, uint8_t error);
+
+/**
+ * @brief Stop or resume the appends (the queued records are still programmed).
+ *
+ * @param paused 1 to ignore the appends, 0 to resume.
+ *
+ * @return None
+ */
+void Journal_Set_Paused(uint8_t paused);
+
+/**
+ * @brief Do one step of the background work (program, erase, or retire).
+ *
+ * Called from the key wait loop.
+ *
+ * @param may_erase 1 if a page may be erased or retired now, 0 to only
+ *                  program queued records.
+ *
+ * @return None
+ */
+void Journal_Poll(uint8_t may_erase);
+
+/**
+ * @brief Find a record by sequence number (in the flash or still queued).
+ *
+ * @param sequence The sequence number.
+ * @param entry    Receives the record.
+ *
+ * @return uint8_t 1 if found, 0 if the record was retired or does not exist.
+ */
+uint8_t Journal_Find(uint32_t sequence, Journal_Entry *entry);
+
+/**
+ * @brief Get the journal statistics.
+ *
+ * @param stats Receives the statistics.
+ *
+ * @return None
+ */
+void Journal_Get_Stats(Journal_Stats *stats);
+
+#endif // JOURNAL_H_
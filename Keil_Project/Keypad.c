@@ -33,6 +33,13 @@
 #include "TM4C123GH6PM.h"
 #include "Keypad.h"
 #include "SysTick_Delay.h"
+#include "Trace.h"
+#include "Watchdog.h"
+#include "Clock_Governor.h"
+#include "Keypad_Scan.h"
+#include "Journal.h"
+#include "Interrupts.h"
+#include "Spsc_Queue.h"
 #include <stdint.h>
 
 // ----- Pin mapping -----
@@ -69,6 +76,17 @@ static const char Keypad_Map[16] = {
     '/', '*', '-', '+'    // K12..K15
 };
 
+// Debounce and release polling (see Keypad_Set_Timing)
+static uint32_t debounce_delay_us = KEYPAD_DEBOUNCE_US;
+static uint32_t release_poll_delay_us = KEYPAD_RELEASE_POLL_US;
+
+static Keypad_Timing keypad_timing;
+
+// Keypad interrupt times (us, low 32 bits), from GPIOD_Handler to Keypad_Scan
+#define WAKE_QUEUE_SIZE 4
+static uint32_t wake_buffer[WAKE_QUEUE_SIZE];
+static Spsc_Queue wake_queue;
+
 /**
  * @brief Initialize the EduBase keypad GPIO pins.
  */
@@ -93,6 +111,75 @@ void Keypad_Init(void)
     ROW_PORT->DIR  &= ~ROW_MASK;  // input
     ROW_PORT->DEN  |= ROW_MASK;   // digital enable
     // No pull-ups/pull-downs needed; columns drive high when active
+
+    // ----- Row interrupts (masked until Keypad_Wake_Enable) -----
+    ROW_PORT->IM  &= ~ROW_MASK;   // masked
+    ROW_PORT->IS  &= ~ROW_MASK;   // edge sensitive
+    ROW_PORT->IBE &= ~ROW_MASK;   // single edge
+    ROW_PORT->IEV |= ROW_MASK;    // rising edge (key pressed)
+    ROW_PORT->ICR  = ROW_MASK;
+
+    Spsc_Queue_Init(&wake_queue, wake_buffer, WAKE_QUEUE_SIZE);
+
+    NVIC_SetPriority(GPIOD_IRQn, IRQ_PRIORITY_KEYPAD);
+    NVIC_EnableIRQ(GPIOD_IRQn);
+}
+
+/**
+ * @brief Drive all columns high and enable the row interrupts.
+ * @return 1 if a key is already pressed (no edge will follow), 0 otherwise.
+ */
+int Keypad_Wake_Enable(void)
+{
+    // Any key now connects a high column to its row
+    COL_PORT->DATA |= COL_MASK;
+    SysTick_Delay1us(5);
+
+    ROW_PORT->ICR = ROW_MASK;
+    ROW_PORT->IM |= ROW_MASK;
+
+    return (ROW_PORT->DATA & ROW_MASK) != 0;
+}
+
+/**
+ * @brief Disable the row interrupts and release the columns.
+ */
+void Keypad_Wake_Disable(void)
+{
+    ROW_PORT->IM &= ~ROW_MASK;
+    COL_PORT->DATA &= ~COL_MASK;
+}
+
+/**
+ * @brief Check for a keypad interrupt that has not been taken with Keypad_Wake_Pop.
+ */
+int Keypad_Wake_Pending(void)
+{
+    return Spsc_Queue_Count(&wake_queue) != 0;
+}
+
+/**
+ * @brief Take the time of the oldest keypad interrupt.
+ */
+int Keypad_Wake_Pop(uint32_t *time_us)
+{
+    return Spsc_Queue_Pop(&wake_queue, time_us);
+}
+
+/**
+ * @brief Row interrupt: record the time of the key press.
+ */
+void GPIOD_Handler(void)
+{
+    uint32_t start = Interrupts_Handler_Enter(IRQ_SOURCE_KEYPAD, 0);
+
+    // One wake-up per Keypad_Wake_Enable (contact bounce raises more edges)
+    ROW_PORT->IM &= ~ROW_MASK;
+    ROW_PORT->ICR = ROW_MASK;
+
+    Spsc_Queue_Push(&wake_queue, (uint32_t)SysTick_Get_Time_us());
+
+    Interrupts_Handler_Exit(IRQ_SOURCE_KEYPAD, start);
 }
 
 /**
@@ -142,13 +229,23 @@ static int Keypad_ScanOnce(void)
  */
 int Keypad_GetKeyIndex(void)
 {
+    uint32_t scan_start = Trace_Timestamp();
     int first = Keypad_ScanOnce();
     if (first < 0)
         return -1;
 
+    // Only scans that found a key are traced (idle polling would flood the trace)
+    Trace_Begin_At(TRACE_ZONE_KEYPAD_SCAN, scan_start, (uint16_t)first);
+    Trace_End(TRACE_ZONE_KEYPAD_SCAN);
+
     // Debounce: wait, then confirm it's still the same key
-    SysTick_Delay1us(20000);   // ~20 ms
+    Trace_Begin(TRACE_ZONE_DEBOUNCE, (uint16_t)first);
+    SysTick_Delay1us(debounce_delay_us);   // ~20 ms by default
+    Trace_End(TRACE_ZONE_DEBOUNCE);
+
+    Trace_Begin(TRACE_ZONE_KEYPAD_SCAN, (uint16_t)first);
     int second = Keypad_ScanOnce();
+    Trace_End(TRACE_ZONE_KEYPAD_SCAN);
 
     if (second == first)
         return first;
@@ -176,24 +273,63 @@ char Keypad_GetChar(void)
 int Keypad_WaitForKeyIndex(void)
 {
     int key = -1;
+    uint64_t press_scan_us = 0;
 
-    // Wait until a key press is detected
+    // Wait until a key press is detected, at the rate set by Keypad_Scan
+    // (waiting is not a stall, so keep feeding the watchdog)
     while (key < 0)
     {
+        Watchdog_Feed();
+        Clock_Governor_Poll();
+        Journal_Poll(Keypad_Scan_Is_Idle() && Clock_Governor_Is_Idle());
+        Keypad_Scan_Wait();
+        press_scan_us = SysTick_Get_Time_us();
         key = Keypad_GetKeyIndex();
+        Keypad_Scan_Record(key >= 0);
     }
 
+    uint64_t accepted_us = SysTick_Get_Time_us();
+    keypad_timing.press_us = (uint32_t)(accepted_us - press_scan_us);
+
     // Wait for key release to avoid auto-repeats
     int stillPressed = key;
+    uint64_t scan_us = accepted_us;
+    uint64_t last_pressed_us = accepted_us;
     while (stillPressed >= 0)
     {
+        Watchdog_Feed();
+        last_pressed_us = scan_us;
+        scan_us = SysTick_Get_Time_us();
         stillPressed = Keypad_GetKeyIndex();
-        SysTick_Delay1us(5000);   // small delay to avoid busy hammering
+        SysTick_Delay1us(release_poll_delay_us);   // small delay to avoid busy hammering
     }
 
+    keypad_timing.release_us = (uint32_t)(scan_us - last_pressed_us);
+    keypad_timing.hold_us = (uint32_t)(scan_us - accepted_us);
+
+    // The release starts a new fast scan window
+    Keypad_Scan_Activity();
+
     return key;
 }
 
+/**
+ * @brief Set the debounce time and the release polling interval.
+ */
+void Keypad_Set_Timing(uint32_t debounce_us, uint32_t release_poll_us)
+{
+    debounce_delay_us = debounce_us;
+    release_poll_delay_us = release_poll_us;
+}
+
+/**
+ * @brief Measured timing of the last key returned by a blocking read.
+ */
+const Keypad_Timing *Keypad_Get_Timing(void)
+{
+    return &keypad_timing;
+}
+
 /**
  * @brief Blocking read: wait until a key is pressed and released.
  * @return mapped character.
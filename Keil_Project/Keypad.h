@@ -3,6 +3,17 @@
 
 #include <stdint.h>
 
+// Default debounce time and release polling interval
+#define KEYPAD_DEBOUNCE_US      20000U
+#define KEYPAD_RELEASE_POLL_US  5000U
+
+// Measured timing of the last key (microseconds)
+typedef struct {
+    uint32_t press_us;      // from the first scan that saw the key to its acceptance (debounce)
+    uint32_t release_us;    // from the last scan that saw the key to the scan that saw it released
+    uint32_t hold_us;       // from the acceptance to the release
+} Keypad_Timing;
+
 /**
  * @brief Initialize the Edubase keypad GPIO pins.
  *        Rows are outputs, columns are inputs with pull-ups.
@@ -33,4 +44,47 @@ int Keypad_WaitForKeyIndex(void);
  */
 char Keypad_WaitForChar(void);
 
+/**
+ * @brief Set the debounce time and the release polling interval.
+ * @param debounce_us     Time between the two scans that must agree on a key.
+ * @param release_poll_us Time between the scans that wait for the release.
+ */
+void Keypad_Set_Timing(uint32_t debounce_us, uint32_t release_poll_us);
+
+/**
+ * @brief Measured timing of the last key returned by a blocking read.
+ * @return Pointer to the timing.
+ */
+const Keypad_Timing *Keypad_Get_Timing(void);
+
+/**
+ * @brief Drive all columns high and enable the row (GPIO Port D) interrupts,
+ *        so that a key press wakes the CPU. Used by Keypad_Scan while idle.
+ * @return 1 if a key is already pressed (no edge will follow), 0 otherwise.
+ */
+int Keypad_Wake_Enable(void);
+
+/**
+ * @brief Disable the row interrupts and drive the columns low again.
+ */
+void Keypad_Wake_Disable(void);
+
+/**
+ * @brief Check for a keypad interrupt not yet taken with Keypad_Wake_Pop.
+ * @return 1 if there is one, 0 otherwise.
+ */
+int Keypad_Wake_Pending(void);
+
+/**
+ * @brief Take the time of the oldest keypad interrupt.
+ * @param time_us Receives the time (SysTick_Get_Time_us, low 32 bits).
+ * @return 1 if there was one, 0 otherwise.
+ */
+int Keypad_Wake_Pop(uint32_t *time_us);
+
+/**
+ * @brief Row interrupt handler (GPIO Port D), records the time of a key press.
+ */
+void GPIOD_Handler(void);
+
 #endif // EDUBASE_KEYPAD_H_
@@ -0,0 +1,223 @@
+/**
+ * @file Keypad_Scan.c
+ *
+ * @brief Source code for the Keypad_Scan module.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Keypad_Scan.h"
+#include "Keypad.h"
+#include "SysTick_Delay.h"
+#include "Interrupts.h"
+
+static Keypad_Scan_Config scan_config = {
+    KEYPAD_SCAN_FAST_PERIOD_US,
+    KEYPAD_SCAN_FAST_WINDOW_US,
+    KEYPAD_SCAN_BACKOFF_SHIFT,
+    KEYPAD_SCAN_MAX_PERIOD_US,
+    KEYPAD_SCAN_WAKE_AFTER_US,
+    KEYPAD_SCAN_HEARTBEAT_US
+};
+
+static Keypad_Scan_Stats scan_stats;
+
+// Time of the last activity and of the start of the last scan
+static uint64_t activity_us = 0;
+static uint64_t last_scan_us = 0;
+
+// Current polling period (grows during the back-off)
+static uint32_t period_us = KEYPAD_SCAN_FAST_PERIOD_US;
+
+// Start of the current Keypad_Scan_Wait, and of the scan that follows it
+static uint64_t wait_start_us = 0;
+static uint64_t scan_start_us = 0;
+
+// Time of the keypad interrupt that woke the scanner, if any
+static uint8_t woken = 0;
+static uint32_t wake_us = 0;
+
+static volatile uint8_t timer_expired = 0;
+
+static void Keypad_Scan_Start_Timer(uint32_t delay_us)
+{
+    uint32_t cycles = delay_us * (SystemCoreClock / 1000000U);
+
+    timer_expired = 0;
+    TIMER2->CTL &= ~0x01;
+    TIMER2->TAILR = (cycles > 0) ? cycles - 1 : 0;
+    TIMER2->ICR = 0x01;
+    TIMER2->CTL |= 0x01;
+}
+
+// Sleep until the timer expires or the keypad interrupt wakes the CPU
+static void Keypad_Scan_Sleep(uint32_t delay_us, uint8_t wake)
+{
+    Keypad_Scan_Start_Timer(delay_us);
+
+    // A key that is already held does not raise an edge
+    if (wake && Keypad_Wake_Enable())
+    {
+        timer_expired = 1;
+    }
+
+    // PRIMASK closes the window between the check and WFI; a pending
+    // interrupt still ends WFI and is taken once PRIMASK is cleared
+    __disable_irq();
+    while (!timer_expired && !Keypad_Wake_Pending())
+    {
+        __WFI();
+        __enable_irq();
+        __disable_irq();
+    }
+    __enable_irq();
+
+    TIMER2->CTL &= ~0x01;
+
+    if (wake)
+    {
+        Keypad_Wake_Disable();
+    }
+}
+
+void Keypad_Scan_Init(void)
+{
+    // Enable the clock to Timer 2 by setting the
+    // R2 bit (Bit 2) in the RCGCTIMER register
+    SYSCTL->RCGCTIMER |= 0x04;
+    while ((SYSCTL->PRTIMER & 0x04) == 0);
+
+    // 32-bit one-shot timer, started by Keypad_Scan_Sleep
+    TIMER2->CTL &= ~0x01;
+    TIMER2->CFG = 0x0;
+    TIMER2->TAMR = 0x01;
+    TIMER2->ICR = 0x01;
+    TIMER2->IMR |= 0x01;
+
+    NVIC_SetPriority(TIMER2A_IRQn, IRQ_PRIORITY_KEYPAD);
+    NVIC_EnableIRQ(TIMER2A_IRQn);
+
+    Keypad_Scan_Activity();
+}
+
+void Keypad_Scan_Set_Config(const Keypad_Scan_Config *config)
+{
+    scan_config = *config;
+    Keypad_Scan_Activity();
+}
+
+void Keypad_Scan_Wait(void)
+{
+    uint64_t now_us = SysTick_Get_Time_us();
+    uint64_t idle_us = now_us - activity_us;
+    uint8_t wake = 0;
+    uint32_t interval_us;
+
+    wait_start_us = now_us;
+
+    if (idle_us < scan_config.fast_window_us)
+    {
+        period_us = scan_config.fast_period_us;
+        interval_us = period_us;
+    }
+    else if (scan_config.wake_after_us != 0 && idle_us >= scan_config.wake_after_us)
+    {
+        wake = 1;
+        interval_us = scan_config.heartbeat_us;
+    }
+    else
+    {
+        // Exponential back-off, one step per empty scan
+        period_us <<= scan_config.backoff_shift;
+        if (period_us > scan_config.max_period_us || period_us == 0)
+        {
+            period_us = scan_config.max_period_us;
+        }
+        interval_us = period_us;
+    }
+
+    // The period is measured from the start of the last scan
+    uint64_t deadline_us = last_scan_us + interval_us;
+    if (deadline_us > now_us)
+    {
+        Keypad_Scan_Sleep((uint32_t)(deadline_us - now_us), wake);
+    }
+
+    uint32_t time_us;
+    while (Keypad_Wake_Pop(&time_us))
+    {
+        scan_stats.wakeups++;
+        woken = 1;
+        wake_us = time_us;
+    }
+
+    scan_start_us = SysTick_Get_Time_us();
+    if (woken)
+    {
+        // Back to the fast window, in case the wake-up was a bounce
+        activity_us = scan_start_us;
+    }
+}
+
+void Keypad_Scan_Record(uint8_t found)
+{
+    if (found)
+    {
+        // Worst case: the key was pressed right after the previous scan,
+        // unless the keypad interrupt shows when it was pressed
+        uint32_t latency_us = woken ? ((uint32_t)scan_start_us - wake_us)
+                                    : (uint32_t)(scan_start_us - last_scan_us);
+
+        scan_stats.detections++;
+        scan_stats.latency_us_last = latency_us;
+        if (latency_us > scan_stats.latency_us_max)
+        {
+            scan_stats.latency_us_max = latency_us;
+        }
+
+        // The debounce of the detected key is not waiting time
+        scan_stats.wait_us += scan_start_us - wait_start_us;
+        woken = 0;
+        activity_us = scan_start_us;
+    }
+    else
+    {
+        uint64_t end_us = SysTick_Get_Time_us();
+
+        scan_stats.scans++;
+        scan_stats.scan_us += end_us - scan_start_us;
+        scan_stats.wait_us += end_us - wait_start_us;
+    }
+
+    last_scan_us = scan_start_us;
+}
+
+void Keypad_Scan_Activity(void)
+{
+    activity_us = SysTick_Get_Time_us();
+    last_scan_us = activity_us;
+    period_us = scan_config.fast_period_us;
+}
+
+uint8_t Keypad_Scan_Is_Idle(void)
+{
+    return (scan_config.wake_after_us != 0) &&
+           (SysTick_Get_Time_us() - activity_us >= scan_config.wake_after_us);
+}
+
+void Keypad_Scan_Get_Stats(Keypad_Scan_Stats *stats)
+{
+    *stats = scan_stats;
+    stats->cpu_permille = (stats->wait_us != 0) ? (uint32_t)((stats->scan_us * 1000U) / stats->wait_us) : 0;
+}
+
+void TIMER2A_Handler(void)
+{
+    uint32_t start = Interrupts_Handler_Enter(IRQ_SOURCE_KEYPAD, 0);
+
+    // Clear the time-out interrupt
+    TIMER2->ICR = 0x01;
+    timer_expired = 1;
+
+    Interrupts_Handler_Exit(IRQ_SOURCE_KEYPAD, start);
+}
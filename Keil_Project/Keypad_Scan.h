@@ -0,0 +1,150 @@
+/**
+ * @file Keypad_Scan.h
+ *
+ * @brief Header file for the Keypad_Scan module.
+ *
+ * It governs how often the keypad is scanned while the calculator waits
+ * for a key. Scanning continuously wastes the CPU when nobody is typing,
+ * and scanning slowly makes the calculator miss fast typing, so the scan
+ * period follows a curve based on the time since the last activity
+ * (a key press, a key release, or a keypad interrupt):
+ *
+ *  1. Fast window: for fast_window_us after the activity, the keypad is
+ *     scanned every fast_period_us, to catch the next key of fast typing.
+ *  2. Back-off: after the fast window, the period is multiplied by
+ *     2^backoff_shift after every empty scan, up to max_period_us.
+ *  3. Interrupt wake: after wake_after_us without activity, polling stops.
+ *     All keypad columns are driven high and the row inputs (GPIO Port D)
+ *     interrupt on a rising edge, so that a key press wakes the scanner
+ *     immediately. The keypad is still scanned every heartbeat_us, as a
+ *     safety net and so that the watchdog is fed.
+ *
+ * Between scans the CPU sleeps (WFI) until Timer 2A (one-shot) or the
+ * keypad interrupt wakes it up.
+ *
+ * The module reports:
+ *  - the average scan CPU cost: the time spent in empty scans, relative to
+ *    the time spent waiting for a key (in permille)
+ *  - the worst-case detection latency of each key: the time from the last
+ *    empty scan (the key may have been pressed right after it), or from
+ *    the keypad interrupt, to the scan that detected the key
+ *
+ * @note The heartbeat must be shorter than the watchdog budget.
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef KEYPAD_SCAN_H_
+#define KEYPAD_SCAN_H_
+
+#include "TM4C123GH6PM.h"
+#include <stdint.h>
+
+// Default scan curve
+#define KEYPAD_SCAN_FAST_PERIOD_US      1000U
+#define KEYPAD_SCAN_FAST_WINDOW_US      300000U
+#define KEYPAD_SCAN_BACKOFF_SHIFT       1U
+#define KEYPAD_SCAN_MAX_PERIOD_US       50000U
+#define KEYPAD_SCAN_WAKE_AFTER_US       2000000U
+#define KEYPAD_SCAN_HEARTBEAT_US        500000U
+
+typedef struct {
+    uint32_t fast_period_us;
+    uint32_t fast_window_us;
+    uint32_t backoff_shift;
+    uint32_t max_period_us;
+    uint32_t wake_after_us;     // 0: never stop polling
+    uint32_t heartbeat_us;
+} Keypad_Scan_Config;
+
+typedef struct {
+    uint32_t scans;             // empty scans
+    uint32_t wakeups;           // keypad interrupts
+    uint32_t detections;
+    uint32_t latency_us_last;   // worst-case detection latency
+    uint32_t latency_us_max;
+    uint32_t cpu_permille;      // scan_us relative to wait_us
+    uint64_t scan_us;           // time spent in empty scans
+    uint64_t wait_us;           // time spent waiting for a key
+} Keypad_Scan_Stats;
+
+/**
+ * @brief Initialize Timer 2A as the scan timer and start with the default curve.
+ *
+ * Must be called after Keypad_Init.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Keypad_Scan_Init(void);
+
+/**
+ * @brief Change the scan curve.
+ *
+ * @param config The new curve (copied).
+ *
+ * @return None
+ */
+void Keypad_Scan_Set_Config(const Keypad_Scan_Config *config);
+
+/**
+ * @brief Sleep until the next scan is due (or a keypad interrupt arrives).
+ *
+ * Called before every scan of the key wait loop.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Keypad_Scan_Wait(void);
+
+/**
+ * @brief Record the result of the scan that followed Keypad_Scan_Wait.
+ *
+ * @param found 1 if the scan detected a key, 0 otherwise.
+ *
+ * @return None
+ */
+void Keypad_Scan_Record(uint8_t found);
+
+/**
+ * @brief Restart the fast window, e.g. when a key is released.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Keypad_Scan_Activity(void);
+
+/**
+ * @brief Tell whether the scanner is in its interrupt wake mode.
+ *
+ * Nobody has typed for wake_after_us, so slow background work (e.g. a
+ * flash erase) does not delay a key of fast typing.
+ *
+ * @param None
+ *
+ * @return uint8_t 1 if the keypad is idle, 0 otherwise.
+ */
+uint8_t Keypad_Scan_Is_Idle(void);
+
+/**
+ * @brief Get the scan statistics.
+ *
+ * @param stats Receives the statistics.
+ *
+ * @return None
+ */
+void Keypad_Scan_Get_Stats(Keypad_Scan_Stats *stats);
+
+/**
+ * @brief The TIMER2A_Handler function is the interrupt service routine for the scan timer.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void TIMER2A_Handler(void);
+
+#endif // KEYPAD_SCAN_H_
@@ -0,0 +1,102 @@
+/**
+ * @file LCD_Frame.c
+ *
+ * @brief Source code for the LCD_Frame module.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "LCD_Frame.h"
+#include "EduBase_LCD.h"
+#include <string.h>
+
+// What the display routines drew, and what the LCD shows
+static LCD_Frame target;
+static LCD_Frame shown;
+
+// Drawing position in the framebuffer
+static uint8_t draw_col;
+static uint8_t draw_row;
+
+void LCD_Frame_Init(void)
+{
+    memset(&shown, ' ', sizeof(shown));
+    LCD_Frame_Clear();
+}
+
+void LCD_Frame_Clear(void)
+{
+    memset(&target, ' ', sizeof(target));
+    draw_col = 0;
+    draw_row = 0;
+}
+
+void LCD_Frame_Set_Cursor(uint8_t col, uint8_t row)
+{
+    if (col < LCD_FRAME_COLUMNS && row < LCD_FRAME_ROWS)
+    {
+        draw_col = col;
+        draw_row = row;
+    }
+}
+
+void LCD_Frame_Put_Char(char data)
+{
+    if (draw_col < LCD_FRAME_COLUMNS)
+    {
+        target.cells[draw_row][draw_col] = data;
+        draw_col++;
+    }
+}
+
+void LCD_Frame_Print(const char *string)
+{
+    while (*string != '\0')
+    {
+        LCD_Frame_Put_Char(*string);
+        string++;
+    }
+}
+
+const LCD_Frame *LCD_Frame_Get(void)
+{
+    return &target;
+}
+
+void LCD_Frame_Set(const LCD_Frame *frame)
+{
+    target = *frame;
+}
+
+uint32_t LCD_Frame_Flush(void)
+{
+    uint32_t written = 0;
+
+    for (uint8_t row = 0; row < LCD_FRAME_ROWS; row++)
+    {
+        // Column after the last written cell of this row (the LCD cursor)
+        uint8_t lcd_col = LCD_FRAME_COLUMNS;
+
+        for (uint8_t col = 0; col < LCD_FRAME_COLUMNS; col++)
+        {
+            char data = target.cells[row][col];
+
+            if (data == shown.cells[row][col])
+            {
+                continue;
+            }
+
+            if (col != lcd_col)
+            {
+                EduBase_LCD_Set_Cursor(col, row);
+            }
+
+            EduBase_LCD_Send_Data((uint8_t)data);
+            shown.cells[row][col] = data;
+            lcd_col = col + 1;
+            written++;
+        }
+    }
+
+    return written;
+}
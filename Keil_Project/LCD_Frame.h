@@ -0,0 +1,114 @@
+/**
+ * @file LCD_Frame.h
+ *
+ * @brief Header file for the LCD_Frame module.
+ *
+ * It keeps a framebuffer of the 16x2 LCD in SRAM. The display routines
+ * draw into the framebuffer (which costs nothing), and LCD_Frame_Flush
+ * sends only the cells that differ from what the LCD shows, instead of
+ * clearing and redrawing whole lines:
+ *  - Each HD44780 write takes about 40 us and a clear takes 1.52 ms, so
+ *    typing a digit now costs one data write instead of a clear of the
+ *    line and 16 characters.
+ *  - A saved frame (e.g. in an undo snapshot) can be put back with
+ *    LCD_Frame_Set, and only the cells that changed are redrawn.
+ *
+ * The cursor is moved only when the next changed cell is not the one
+ * after the last written cell (the LCD increments its address by itself).
+ *
+ * Everything drawn on the LCD outside this module (e.g. the settings menu)
+ * must be followed by a clear of the display and LCD_Frame_Init, so that
+ * the framebuffer matches the LCD again.
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef LCD_FRAME_H_
+#define LCD_FRAME_H_
+
+#include <stdint.h>
+
+#define LCD_FRAME_COLUMNS       16U
+#define LCD_FRAME_ROWS          2U
+
+typedef struct {
+    char cells[LCD_FRAME_ROWS][LCD_FRAME_COLUMNS];
+} LCD_Frame;
+
+/**
+ * @brief Initialize the framebuffer for a cleared LCD.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void LCD_Frame_Init(void);
+
+/**
+ * @brief Clear the framebuffer and move the drawing position to (0, 0).
+ *
+ * @param None
+ *
+ * @return None
+ */
+void LCD_Frame_Clear(void);
+
+/**
+ * @brief Move the drawing position.
+ *
+ * @param col The column (0 to 15).
+ * @param row The row (0 or 1).
+ *
+ * @return None
+ */
+void LCD_Frame_Set_Cursor(uint8_t col, uint8_t row);
+
+/**
+ * @brief Draw a character at the drawing position and advance it.
+ *
+ * Characters past the end of the line are dropped (they would not be
+ * visible on the LCD either).
+ *
+ * @param data The character.
+ *
+ * @return None
+ */
+void LCD_Frame_Put_Char(char data);
+
+/**
+ * @brief Draw a string at the drawing position and advance it.
+ *
+ * @param string The null-terminated string.
+ *
+ * @return None
+ */
+void LCD_Frame_Print(const char *string);
+
+/**
+ * @brief Get the framebuffer (what the LCD shows after the next flush).
+ *
+ * @param None
+ *
+ * @return const LCD_Frame* The framebuffer.
+ */
+const LCD_Frame *LCD_Frame_Get(void);
+
+/**
+ * @brief Replace the framebuffer with a saved frame.
+ *
+ * @param frame The frame.
+ *
+ * @return None
+ */
+void LCD_Frame_Set(const LCD_Frame *frame);
+
+/**
+ * @brief Send the cells that changed since the last flush to the LCD.
+ *
+ * @param None
+ *
+ * @return uint32_t The number of cells written.
+ */
+uint32_t LCD_Frame_Flush(void);
+
+#endif // LCD_FRAME_H_
@@ -0,0 +1,67 @@
+/**
+ * @file Log.c
+ *
+ * @brief Source code for the Log module.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Log.h"
+
+#ifndef LOG_DISABLE
+
+#if (LOG_BUFFER_WORDS & (LOG_BUFFER_WORDS - 1)) != 0
+#error "LOG_BUFFER_WORDS must be a power of two"
+#endif
+
+uint32_t log_buffer[LOG_BUFFER_WORDS];
+
+// Total number of words reserved; the next record starts at log_write_index % LOG_BUFFER_WORDS
+volatile uint32_t log_write_index = 0;
+
+// Index of the first word not yet flushed
+static uint32_t log_read_index = 0;
+
+static void Log_Put_U32(Log_Put_Char_Fn put_char, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        put_char((char)(value >> (8 * i)));
+    }
+}
+
+void Log_Flush(Log_Put_Char_Fn put_char)
+{
+    uint32_t write_index = log_write_index;
+    uint32_t lost = 0;
+
+    if (write_index == log_read_index)
+    {
+        return;
+    }
+
+    // The writers overtook the reader: the oldest unread records were
+    // overwritten, and the remaining words may start in the middle of a
+    // record, so drop everything up to the current write position
+    if (write_index - log_read_index > LOG_BUFFER_WORDS)
+    {
+        lost = write_index - log_read_index;
+        log_read_index = write_index;
+    }
+
+    put_char('L');
+    put_char('O');
+    put_char('G');
+    put_char('1');
+    Log_Put_U32(put_char, lost);
+    Log_Put_U32(put_char, write_index - log_read_index);
+
+    // Records written by interrupt handlers during the flush are sent next time
+    while (log_read_index != write_index)
+    {
+        Log_Put_U32(put_char, log_buffer[log_read_index & (LOG_BUFFER_WORDS - 1)]);
+        log_read_index++;
+    }
+}
+
+#endif // LOG_DISABLE
@@ -0,0 +1,127 @@
+/**
+ * @file Log.h
+ *
+ * @brief Header file for the Log module.
+ *
+ * It is a binary log channel with deferred formatting. A log call does not
+ * format anything on the target: it writes the address of its format string
+ * and its raw arguments into a RAM ring buffer, and the text is produced on
+ * the PC. This keeps a call to a few dozen cycles, so it does not distort
+ * the timing being measured, and it can be used from interrupt handlers.
+ *
+ * The format strings are placed in their own section (.logfmt), which is
+ * kept in flash but never read by the firmware. Its contents, read from the
+ * linked image (ECE425_Final_SibCal.axf), form the ID table: the ID of a
+ * message is the address of its format string. tests/tools/logdecode
+ * turns a UART capture back into text with it.
+ *
+ * Usage:
+ *      LOG("Calculator started");
+ *      LOG2("Error %u after operator %c", error, op);
+ *
+ * Arguments are stored as 32-bit words, so only integer conversions
+ * (%d, %u, %x, %c) are supported.
+ *
+ * Record format (32-bit words):
+ *  - format string address, with the number of arguments (0-3) in bits 1:0
+ *  - DWT cycle count
+ *  - arguments
+ *
+ * Log_Flush sends the records written since the previous flush through a
+ * character callback (little-endian):
+ *  - "LOG1"
+ *  - uint32_t: number of words lost because the buffer overflowed
+ *  - uint32_t: number of words that follow
+ *  - words
+ *
+ * Logging can be compiled out by defining LOG_DISABLE.
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef LOG_H_
+#define LOG_H_
+
+#include "TM4C123GH6PM.h"
+#include "Atomic.h"
+#include <stdint.h>
+
+// Size of the ring buffer in 32-bit words, must be a power of two
+#define LOG_BUFFER_WORDS        512
+
+// Place a format string in the .logfmt section (4-byte aligned, so bits 1:0 of its address are free)
+#define LOG_FORMAT(format)                                                              \
+    ({                                                                                  \
+        static const char log_format[] __attribute__((section(".logfmt"), aligned(4))) = format; \
+        log_format;                                                                     \
+    })
+
+#define LOG(format)             Log_Write(LOG_FORMAT(format), 0, 0, 0, 0)
+#define LOG1(format, a)         Log_Write(LOG_FORMAT(format), 1, (uint32_t)(a), 0, 0)
+#define LOG2(format, a, b)      Log_Write(LOG_FORMAT(format), 2, (uint32_t)(a), (uint32_t)(b), 0)
+#define LOG3(format, a, b, c)   Log_Write(LOG_FORMAT(format), 3, (uint32_t)(a), (uint32_t)(b), (uint32_t)(c))
+
+typedef void (*Log_Put_Char_Fn)(char c);
+
+#ifndef LOG_DISABLE
+
+// Ring buffer state, written by Log_Write
+extern uint32_t log_buffer[LOG_BUFFER_WORDS];
+extern volatile uint32_t log_write_index;
+
+/**
+ * @brief Write a log record into the ring buffer (use the LOG macros).
+ *
+ * @param format The format string, placed in the .logfmt section.
+ * @param count  The number of arguments (0-3).
+ * @param a      The first argument.
+ * @param b      The second argument.
+ * @param c      The third argument.
+ *
+ * @return None
+ */
+static inline void Log_Write(const char *format, uint32_t count, uint32_t a, uint32_t b, uint32_t c)
+{
+    // Reserve the words
+    uint32_t index = Atomic_Fetch_Add(&log_write_index, 2 + count);
+
+    log_buffer[index & (LOG_BUFFER_WORDS - 1)] = (uint32_t)(uintptr_t)format | count;
+    log_buffer[(index + 1) & (LOG_BUFFER_WORDS - 1)] = DWT->CYCCNT;
+
+    if (count > 0)
+    {
+        log_buffer[(index + 2) & (LOG_BUFFER_WORDS - 1)] = a;
+    }
+    if (count > 1)
+    {
+        log_buffer[(index + 3) & (LOG_BUFFER_WORDS - 1)] = b;
+    }
+    if (count > 2)
+    {
+        log_buffer[(index + 4) & (LOG_BUFFER_WORDS - 1)] = c;
+    }
+}
+
+/**
+ * @brief Send the records written since the previous flush.
+ *
+ * Must be called from the main loop, not from an interrupt handler, so
+ * that every record it sends has been completely written.
+ *
+ * @param put_char Called for each output byte.
+ *
+ * @return None
+ */
+void Log_Flush(Log_Put_Char_Fn put_char);
+
+#else
+
+static inline void Log_Write(const char *format, uint32_t count, uint32_t a, uint32_t b, uint32_t c)
+{
+    (void)format; (void)count; (void)a; (void)b; (void)c;
+}
+static inline void Log_Flush(Log_Put_Char_Fn put_char) { (void)put_char; }
+
+#endif // LOG_DISABLE
+
+#endif // LOG_H_
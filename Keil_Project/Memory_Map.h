@@ -0,0 +1,64 @@
+/**
+ * @file Memory_Map.h
+ *
+ * @brief Memory map of the image.
+ *
+ * It is shared by the firmware and the scatter file of the linker
+ * (ECE425_Final_SibCal.sct), which is run through the C preprocessor, so
+ * this header only holds plain #defines without type suffixes.
+ *
+ * Flash (256 KB):
+ *  - 0x00000000 - 0x00037FFF: code, constants and the initial data; the
+ *    linker fails if they do not fit
+ *  - 0x00038000 - 0x0003FFFF: the calculation journal (Journal.h), which
+ *    the image never occupies, so it survives a new download
+ *
+ * SRAM (32 KB):
+ *  - 0x20000000 - 0x20007EFF: data, zero-initialized data, stack and heap;
+ *    the linker fails if they do not fit, and Calc_Memory.c checks at
+ *    compile time that the engine pools leave room for the rest
+ *  - 0x20007F00 - 0x20007FFF: the watchdog record (Watchdog.h), which the
+ *    startup code does not initialize, so it survives a reset
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef MEMORY_MAP_H_
+#define MEMORY_MAP_H_
+
+#define MEMORY_FLASH_BASE       0x00000000
+#define MEMORY_FLASH_SIZE       0x00040000
+
+// Journal area at the top of the flash
+#define MEMORY_JOURNAL_SIZE     0x00008000
+#define MEMORY_JOURNAL_BASE     (MEMORY_FLASH_BASE + MEMORY_FLASH_SIZE - MEMORY_JOURNAL_SIZE)
+
+// Flash left to the linker
+#define MEMORY_CODE_SIZE        (MEMORY_FLASH_SIZE - MEMORY_JOURNAL_SIZE)
+
+#define MEMORY_SRAM_BASE        0x20000000
+#define MEMORY_SRAM_SIZE        0x00008000
+
+// No-initialization area at the top of SRAM
+#define MEMORY_NOINIT_SIZE      0x00000100
+#define MEMORY_NOINIT_BASE      (MEMORY_SRAM_BASE + MEMORY_SRAM_SIZE - MEMORY_NOINIT_SIZE)
+
+// SRAM left to the linker
+#define MEMORY_RAM_SIZE         (MEMORY_SRAM_SIZE - MEMORY_NOINIT_SIZE)
+
+// Stack_Size and Heap_Size in RTE/Device/TM4C123GH6PM/startup_TM4C123.s
+// (armasm cannot read this header, keep them equal)
+//
+// Stack budget (2 KB): the deepest path is an edit in the integration mode,
+// main (about 560 bytes, with the snapshot being built) -> Calc_Integrate_Mode
+// (256) -> Calc_Editor_Run (144) -> Calc_Expr_Relex, _Evaluate and _Operand
+// (about 290) -> Calc_Number_Parse -> strtod, about 1.25 KB before the C
+// library (gcc -fstack-usage on the host). Interrupts nest up to the five
+// priority levels of Interrupts.h: the first frame holds the FPU context
+// (104 bytes), the nested ones 32 bytes, about 400 bytes with their handlers.
+// That leaves about 400 bytes for strtod. The link writes the exact worst
+// case to Listings/ECE425_Final_SibCal.htm (armlink --callgraph).
+#define MEMORY_STACK_SIZE       0x00000800
+#define MEMORY_HEAP_SIZE        0x00000000
+
+#endif // MEMORY_MAP_H_
@@ -0,0 +1,174 @@
+/**
+ * @file Profiler.c
+ *
+ * @brief Source code for the Profiler module.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Profiler.h"
+
+#ifdef PROFILER_ENABLE
+
+#include "Interrupts.h"
+#include <string.h>
+
+// Exception stack frame: R0, R1, R2, R3, R12, LR, PC, xPSR
+#define FRAME_LR        5
+#define FRAME_PC        6
+
+static volatile uint16_t pc_histogram[PROFILER_BUCKET_COUNT];
+static volatile uint16_t lr_histogram[PROFILER_BUCKET_COUNT];
+
+static volatile uint32_t profiler_samples = 0;
+static volatile uint32_t profiler_out_of_range = 0;
+static uint32_t profiler_rate_hz = 0;
+
+void Profiler_Sample(const uint32_t *frame);
+
+static void Profiler_Count(volatile uint16_t *histogram, uint32_t address)
+{
+    uint32_t bucket = (address - PROFILER_CODE_BASE) >> PROFILER_BUCKET_SHIFT;
+
+    // Counts saturate instead of wrapping
+    if (bucket < PROFILER_BUCKET_COUNT && histogram[bucket] != 0xFFFF)
+    {
+        histogram[bucket]++;
+    }
+}
+
+void Profiler_Init(uint32_t sample_rate_hz)
+{
+    profiler_rate_hz = sample_rate_hz;
+    Profiler_Clear();
+
+    // Enable the clock to Timer 1 by setting the
+    // R1 bit (Bit 1) in the RCGCTIMER register
+    SYSCTL->RCGCTIMER |= 0x02;
+    while ((SYSCTL->PRTIMER & 0x02) == 0);
+
+    // Disable Timer 1A while it is being configured
+    TIMER1->CTL &= ~0x01;
+
+    // 32-bit periodic timer
+    TIMER1->CFG = 0x0;
+    TIMER1->TAMR = 0x02;
+    TIMER1->TAILR = (SystemCoreClock / sample_rate_hz) - 1;
+
+    // Clear and enable the time-out interrupt
+    TIMER1->ICR = 0x01;
+    TIMER1->IMR |= 0x01;
+
+    // Highest priority, so that other interrupt handlers are sampled too
+    NVIC_SetPriority(TIMER1A_IRQn, IRQ_PRIORITY_PROFILER);
+    NVIC_EnableIRQ(TIMER1A_IRQn);
+
+    TIMER1->CTL |= 0x01;
+}
+
+void Profiler_Update_Clock(void)
+{
+    TIMER1->TAILR = (SystemCoreClock / profiler_rate_hz) - 1;
+}
+
+void Profiler_Clear(void)
+{
+    NVIC_DisableIRQ(TIMER1A_IRQn);
+
+    memset((void *)pc_histogram, 0, sizeof(pc_histogram));
+    memset((void *)lr_histogram, 0, sizeof(lr_histogram));
+    profiler_samples = 0;
+    profiler_out_of_range = 0;
+
+    NVIC_EnableIRQ(TIMER1A_IRQn);
+}
+
+// Called from TIMER1A_Handler with the stacked exception frame
+void Profiler_Sample(const uint32_t *frame)
+{
+    uint32_t pc = frame[FRAME_PC];
+
+    // Latency: the timer has counted down since the time-out
+    uint32_t start = Interrupts_Handler_Enter(IRQ_SOURCE_PROFILER, TIMER1->TAILR - TIMER1->TAV);
+
+    // Clear the time-out interrupt
+    TIMER1->ICR = 0x01;
+
+    profiler_samples++;
+    if (pc - PROFILER_CODE_BASE >= ((uint32_t)PROFILER_BUCKET_COUNT << PROFILER_BUCKET_SHIFT))
+    {
+        profiler_out_of_range++;
+    }
+    else
+    {
+        Profiler_Count(pc_histogram, pc);
+        Profiler_Count(lr_histogram, frame[FRAME_LR] & ~1U);
+    }
+
+    Interrupts_Handler_Exit(IRQ_SOURCE_PROFILER, start);
+}
+
+// Passes the stack pointer that holds the exception frame (MSP or PSP,
+// selected by bit 2 of EXC_RETURN) to Profiler_Sample
+__attribute__((naked)) void TIMER1A_Handler(void)
+{
+    __asm volatile(
+        "tst    lr, #4          \n"
+        "ite    eq              \n"
+        "mrseq  r0, msp         \n"
+        "mrsne  r0, psp         \n"
+        "b      Profiler_Sample \n"
+    );
+}
+
+static void Profiler_Put_U16(Profiler_Put_Char_Fn put_char, uint16_t value)
+{
+    put_char((char)value);
+    put_char((char)(value >> 8));
+}
+
+static void Profiler_Put_U32(Profiler_Put_Char_Fn put_char, uint32_t value)
+{
+    Profiler_Put_U16(put_char, (uint16_t)value);
+    Profiler_Put_U16(put_char, (uint16_t)(value >> 16));
+}
+
+void Profiler_Dump(Profiler_Put_Char_Fn put_char)
+{
+    uint32_t entries = 0;
+
+    NVIC_DisableIRQ(TIMER1A_IRQn);
+
+    for (uint32_t i = 0; i < PROFILER_BUCKET_COUNT; i++)
+    {
+        if (pc_histogram[i] != 0 || lr_histogram[i] != 0)
+        {
+            entries++;
+        }
+    }
+
+    put_char('P');
+    put_char('R');
+    put_char('F');
+    put_char('1');
+    Profiler_Put_U32(put_char, profiler_rate_hz);
+    Profiler_Put_U32(put_char, PROFILER_CODE_BASE);
+    Profiler_Put_U32(put_char, PROFILER_BUCKET_SHIFT);
+    Profiler_Put_U32(put_char, profiler_samples);
+    Profiler_Put_U32(put_char, profiler_out_of_range);
+    Profiler_Put_U32(put_char, entries);
+
+    for (uint32_t i = 0; i < PROFILER_BUCKET_COUNT; i++)
+    {
+        if (pc_histogram[i] != 0 || lr_histogram[i] != 0)
+        {
+            Profiler_Put_U16(put_char, (uint16_t)i);
+            Profiler_Put_U16(put_char, pc_histogram[i]);
+            Profiler_Put_U16(put_char, lr_histogram[i]);
+        }
+    }
+
+    NVIC_EnableIRQ(TIMER1A_IRQn);
+}
+
+#endif // PROFILER_ENABLE
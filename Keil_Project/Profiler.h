@@ -0,0 +1,114 @@
+/**
+ * @file Profiler.h
+ *
+ * @brief Header file for the Profiler module.
+ *
+ * It is a statistical PC-sampling profiler. Timer 1A interrupts the
+ * program at a fixed rate with the highest interrupt priority, and its
+ * handler reads the program counter (PC) and link register (LR) that the
+ * processor stacked on exception entry. The addresses are counted in two
+ * histograms over the code in flash, with one bucket per
+ * 2^PROFILER_BUCKET_SHIFT bytes:
+ *  - PC histogram: where the CPU spends its time (flat profile)
+ *  - LR histogram: the return address of the sampled code, which for leaf
+ *    functions such as the soft-float helpers is the caller
+ *
+ * Because no code has to be instrumented, time spent in library code such
+ * as strtod, snprintf, and the floating-point runtime, and in the delay
+ * busy-wait loops, shows up as well.
+ *
+ * Profiler_Dump sends the non-zero buckets through a character callback,
+ * e.g. a UART transmit function. The bucket addresses are symbolized on
+ * the PC against the linker map file (Listings/ECE425_Final_SibCal.map)
+ * by tests/tools/prfsym, which prints a flat profile or folded stacks for
+ * a flame graph.
+ *
+ * Dump format (little-endian):
+ *  - "PRF1"
+ *  - uint32_t: sample rate in Hz
+ *  - uint32_t: PROFILER_CODE_BASE
+ *  - uint32_t: PROFILER_BUCKET_SHIFT
+ *  - uint32_t: number of samples
+ *  - uint32_t: number of samples outside the histogram range
+ *  - uint32_t: number of entries that follow
+ *  - entries:  uint16_t bucket, uint16_t PC count, uint16_t LR count
+ *
+ * The profiler is compiled in only when PROFILER_ENABLE is defined, since
+ * the histograms take 8 KB of SRAM.
+ *
+ * @note The LR value is only meaningful for leaf functions; non-leaf
+ * functions may have reused LR by the time they are sampled.
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include "TM4C123GH6PM.h"
+#include <stdint.h>
+
+// Start of the sampled code region (flash)
+#define PROFILER_CODE_BASE          0x00000000U
+
+// Bucket size of 32 bytes
+#define PROFILER_BUCKET_SHIFT       5
+
+// 2048 buckets cover the first 64 KB of flash
+#define PROFILER_BUCKET_COUNT       2048
+
+// Default sample rate; a prime number avoids locking onto periodic code
+#define PROFILER_SAMPLE_RATE_HZ     997
+
+typedef void (*Profiler_Put_Char_Fn)(char c);
+
+#ifdef PROFILER_ENABLE
+
+/**
+ * @brief Clear the histograms and start sampling with Timer 1A.
+ *
+ * @param sample_rate_hz The number of samples per second.
+ *
+ * @return None
+ */
+void Profiler_Init(uint32_t sample_rate_hz);
+
+/**
+ * @brief Recompute the timer period after a change of the system clock.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Profiler_Update_Clock(void);
+
+/**
+ * @brief Clear the histograms.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Profiler_Clear(void);
+
+/**
+ * @brief Send the non-zero histogram buckets (see the format above).
+ *
+ * Sampling is paused while the histograms are sent.
+ *
+ * @param put_char Called for each output byte.
+ *
+ * @return None
+ */
+void Profiler_Dump(Profiler_Put_Char_Fn put_char);
+
+#else
+
+static inline void Profiler_Init(uint32_t sample_rate_hz) { (void)sample_rate_hz; }
+static inline void Profiler_Update_Clock(void) {}
+static inline void Profiler_Clear(void) {}
+static inline void Profiler_Dump(Profiler_Put_Char_Fn put_char) { (void)put_char; }
+
+#endif // PROFILER_ENABLE
+
+#endif // PROFILER_H_
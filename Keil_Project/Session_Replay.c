@@ -0,0 +1,89 @@
+/**
+ * @file Session_Replay.c
+ *
+ * @brief Source code for the Session_Replay module.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Session_Replay.h"
+#include <string.h>
+
+const Session_Replay_Session Session_Replay_Corpus[] = {
+    { "add",            "12+30=" },
+    { "sub_negative",   "5-8=" },
+    { "mul_decimal",    "1.5*4=" },
+    { "div_exact",      "84/7=" },
+    { "div_inexact",    "1/3=" },
+    { "div_by_zero",    "7/0=" },
+    { "zero_by_zero",   "0/0=" },
+    { "int_overflow",   "9999999999*9999999999=" },
+    { "long_entry",     "1234567890123456+1=" },
+    { "chain",          "1+2=+4=*3=-5=/2=" },
+    { "change_op",      "9+-*/3=" },
+    { "extra_point",    "3..1.4*2=" },
+    { "leading_zero",   "0007+0.5=" },
+    { "repeat_equal",   "6*7===" },
+    { "new_after_eq",   "2+2=8*8=" },
+};
+
+const uint32_t Session_Replay_Corpus_Size = sizeof(Session_Replay_Corpus) / sizeof(Session_Replay_Corpus[0]);
+
+uint32_t Session_Replay_Run(const Session_Replay_Session *sessions, uint32_t count,
+                            Session_Replay_Result *results, Cycle_Counter_Stats *total,
+                            Session_Replay_Reset_Fn reset, Session_Replay_Key_Fn key,
+                            void *context)
+{
+    uint32_t keys_replayed = 0;
+
+    if (total != NULL)
+    {
+        memset(total, 0, sizeof(*total));
+    }
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        Session_Replay_Result *result = &results[i];
+        memset(result, 0, sizeof(*result));
+        result->name = sessions[i].name;
+
+        // Every session starts from the power-on state
+        reset(context);
+
+        for (const char *k = sessions[i].keys; *k != '\0'; k++)
+        {
+            uint32_t start = Cycle_Counter_Read();
+            key(context, *k);
+            uint32_t cycles = Cycle_Counter_Read() - start;
+
+            Cycle_Counter_Stats_Add(&result->key_cycles, cycles);
+            Cycle_Counter_Record_Key(*k, cycles);
+            if (total != NULL)
+            {
+                Cycle_Counter_Stats_Add(total, cycles);
+            }
+            result->key_count++;
+        }
+
+        keys_replayed += result->key_count;
+    }
+
+    return keys_replayed;
+}
+
+void Session_Replay_Sort_Slowest(Session_Replay_Result *results, uint32_t count)
+{
+    // Insertion sort: the corpus is small and this avoids qsort's code size
+    for (uint32_t i = 1; i < count; i++)
+    {
+        Session_Replay_Result current = results[i];
+        uint32_t j = i;
+
+        while (j > 0 && results[j - 1].key_cycles.max < current.key_cycles.max)
+        {
+            results[j] = results[j - 1];
+            j--;
+        }
+        results[j] = current;
+    }
+}
@@ -0,0 +1,80 @@
+/**
+ * @file Session_Replay.h
+ *
+ * @brief Header file for the Session_Replay module.
+ *
+ * It replays recorded keypad sessions through the calculator on the target
+ * and measures every keystroke with the DWT cycle counter. Each session
+ * starts from a freshly reset calculator, so sessions are independent of
+ * each other and of the order in which they run.
+ *
+ * A session is a string of keypad characters, e.g. "12+30=". The module
+ * does not know about the calculator itself: the caller provides a reset
+ * function and a key handler, together with a context pointer that is
+ * passed back to both.
+ *
+ * For each session, the number of keys and the per-key cycle statistics
+ * are collected. The results of the whole run are also aggregated, so the
+ * totals of two firmware builds can be compared from the debugger watch
+ * window. Session_Replay_Sort_Slowest orders the results so that the
+ * sessions with the slowest keystroke come first.
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef SESSION_REPLAY_H_
+#define SESSION_REPLAY_H_
+
+#include <stdint.h>
+#include "Cycle_Counter.h"
+
+typedef struct {
+    const char *name;
+    const char *keys;
+} Session_Replay_Session;
+
+typedef struct {
+    const char *name;
+    uint32_t key_count;
+    Cycle_Counter_Stats key_cycles;
+} Session_Replay_Result;
+
+typedef void (*Session_Replay_Reset_Fn)(void *context);
+typedef void (*Session_Replay_Key_Fn)(void *context, char key);
+
+// Built-in session corpus
+extern const Session_Replay_Session Session_Replay_Corpus[];
+extern const uint32_t Session_Replay_Corpus_Size;
+
+/**
+ * @brief Replay a list of sessions and measure every keystroke.
+ *
+ * The keystrokes are also recorded with Cycle_Counter_Record_Key, so the
+ * per-key statistics include the replayed sessions.
+ *
+ * @param sessions The sessions to replay.
+ * @param count    The number of sessions.
+ * @param results  Output array with one result per session.
+ * @param total    Output statistics over all keystrokes of the run (may be NULL).
+ * @param reset    Called with context before each session.
+ * @param key      Called with context for each keystroke.
+ * @param context  Caller state passed to reset and key.
+ *
+ * @return uint32_t The total number of keystrokes replayed.
+ */
+uint32_t Session_Replay_Run(const Session_Replay_Session *sessions, uint32_t count,
+                            Session_Replay_Result *results, Cycle_Counter_Stats *total,
+                            Session_Replay_Reset_Fn reset, Session_Replay_Key_Fn key,
+                            void *context);
+
+/**
+ * @brief Sort results by their slowest keystroke, slowest first.
+ *
+ * @param results The results to sort.
+ * @param count   The number of results.
+ *
+ * @return None
+ */
+void Session_Replay_Sort_Slowest(Session_Replay_Result *results, uint32_t count);
+
+#endif // SESSION_REPLAY_H_
@@ -0,0 +1,264 @@
+/**
+ * @file Settings.c
+ *
+ * @brief Source code for the Settings module.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Settings.h"
+#include "EEPROM.h"
+#include "EduBase_LCD.h"
+#include "Keypad.h"
+#include "Clock_Governor.h"
+#include "SysTick_Delay.h"
+#include <stddef.h>
+#include <stdio.h>
+
+#define SETTINGS_MAGIC          0x31544553U     // "SET1"
+#define SETTINGS_PROFILE_WORDS  (sizeof(Settings_Profile) / sizeof(uint32_t))
+
+// What the bottom line of the menu shows for a setting
+typedef enum {
+    SETTINGS_MEASURE_PRESS,
+    SETTINGS_MEASURE_RELEASE,
+    SETTINGS_MEASURE_REDRAW,
+    SETTINGS_MEASURE_CLOCK_SWITCH
+} Settings_Measure;
+
+typedef struct {
+    const char *name;           // up to 9 characters
+    uint32_t offset;            // in Settings_Profile
+    uint32_t min;
+    uint32_t max;
+    uint32_t step;
+    Settings_Measure measure;
+} Settings_Knob;
+
+static const Settings_Knob knobs[] = {
+    { "Debounce",  offsetof(Settings_Profile, debounce_us),     0,  50000, 1000, SETTINGS_MEASURE_PRESS },
+    { "Release",   offsetof(Settings_Profile, release_poll_us), 0,  20000, 1000, SETTINGS_MEASURE_RELEASE },
+    { "LCD write", offsetof(Settings_Profile, lcd_nibble_us),   50, 2000,  50,   SETTINGS_MEASURE_REDRAW },
+    { "LCD cmd",   offsetof(Settings_Profile, lcd_command_us),  37, 517,   20,   SETTINGS_MEASURE_REDRAW },
+    { "Clock",     offsetof(Settings_Profile, clock_profile),   0,  2,     1,    SETTINGS_MEASURE_CLOCK_SWITCH }
+};
+
+#define SETTINGS_KNOB_COUNT     (sizeof(knobs) / sizeof(knobs[0]))
+
+// Labels for the measurements, up to 6 characters
+static const char *const measure_labels[] = { "press", "releas", "redraw", "switch" };
+
+static const char *const clock_profile_names[] = { "Auto", "Fast", "Slow" };
+
+static const Settings_Profile default_profile = {
+    KEYPAD_DEBOUNCE_US,
+    KEYPAD_RELEASE_POLL_US,
+    EDUBASE_LCD_NIBBLE_DELAY_US,
+    EDUBASE_LCD_COMMAND_DELAY_US,
+    CLOCK_GOVERNOR_PROFILE_AUTO
+};
+
+// Stored form of the profile
+typedef struct {
+    uint32_t magic;
+    Settings_Profile profile;
+    uint32_t checksum;
+} Settings_Record;
+
+static Settings_Profile current_profile;
+static uint8_t eeprom_ready = 0;
+
+static uint32_t *Settings_Value(Settings_Profile *profile, uint32_t index)
+{
+    return (uint32_t *)((uint8_t *)profile + knobs[index].offset);
+}
+
+static uint32_t Settings_Checksum(const Settings_Profile *profile)
+{
+    const uint32_t *words = (const uint32_t *)profile;
+    uint32_t checksum = SETTINGS_MAGIC;
+
+    for (uint32_t i = 0; i < SETTINGS_PROFILE_WORDS; i++)
+    {
+        checksum = ((checksum << 5) | (checksum >> 27)) ^ words[i];
+    }
+    return checksum;
+}
+
+static uint8_t Settings_Valid(Settings_Profile *profile)
+{
+    for (uint32_t i = 0; i < SETTINGS_KNOB_COUNT; i++)
+    {
+        uint32_t value = *Settings_Value(profile, i);
+        if (value < knobs[i].min || value > knobs[i].max)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void Settings_Init(void)
+{
+    Settings_Profile profile = default_profile;
+    Settings_Record record;
+
+    eeprom_ready = EEPROM_Init();
+    if (eeprom_ready)
+    {
+        EEPROM_Read(SETTINGS_EEPROM_ADDRESS, (uint32_t *)&record, sizeof(record) / sizeof(uint32_t));
+
+        // An erased EEPROM reads 0xFFFFFFFF, so the magic is missing
+        if (record.magic == SETTINGS_MAGIC &&
+            record.checksum == Settings_Checksum(&record.profile) &&
+            Settings_Valid(&record.profile))
+        {
+            profile = record.profile;
+        }
+    }
+
+    Settings_Apply(&profile);
+}
+
+const Settings_Profile *Settings_Get(void)
+{
+    return &current_profile;
+}
+
+void Settings_Apply(const Settings_Profile *profile)
+{
+    current_profile = *profile;
+
+    Keypad_Set_Timing(profile->debounce_us, profile->release_poll_us);
+    EduBase_LCD_Set_Timing(profile->lcd_nibble_us, profile->lcd_command_us);
+    Clock_Governor_Set_Profile((Clock_Governor_Profile)profile->clock_profile);
+}
+
+uint8_t Settings_Save(void)
+{
+    Settings_Record record;
+
+    if (!eeprom_ready)
+    {
+        return 0;
+    }
+
+    record.magic = SETTINGS_MAGIC;
+    record.profile = current_profile;
+    record.checksum = Settings_Checksum(&current_profile);
+
+    return EEPROM_Write(SETTINGS_EEPROM_ADDRESS, (const uint32_t *)&record, sizeof(record) / sizeof(uint32_t));
+}
+
+// Draw a setting and the latency measured with its value
+static void Settings_Draw(Settings_Profile *profile, uint32_t index)
+{
+    const Settings_Knob *knob = &knobs[index];
+    uint32_t value = *Settings_Value(profile, index);
+    uint32_t measured_us;
+    char value_text[8];
+    char line[17];
+
+    if (knob->measure == SETTINGS_MEASURE_CLOCK_SWITCH)
+    {
+        snprintf(value_text, sizeof(value_text), "%s", clock_profile_names[value]);
+    }
+    else
+    {
+        snprintf(value_text, sizeof(value_text), "%u", (unsigned)value);
+    }
+
+    // Top line: name and value, e.g. "Debounce   20000"
+    snprintf(line, sizeof(line), "%-9s%7s", knob->name, value_text);
+
+    uint64_t start_us = SysTick_Get_Time_us();
+    EduBase_LCD_Set_Cursor(0, 0);
+    EduBase_LCD_Display_String(line);
+    uint32_t draw_us = (uint32_t)(SysTick_Get_Time_us() - start_us);
+
+    switch (knob->measure)
+    {
+        case SETTINGS_MEASURE_PRESS:
+            measured_us = Keypad_Get_Timing()->press_us;
+            break;
+
+        case SETTINGS_MEASURE_RELEASE:
+            measured_us = Keypad_Get_Timing()->release_us;
+            break;
+
+        case SETTINGS_MEASURE_REDRAW:
+            measured_us = draw_us;
+            break;
+
+        default:
+        {
+            Clock_Governor_Stats stats;
+            Clock_Governor_Get_Stats(&stats);
+            measured_us = stats.switch_us_last;
+            break;
+        }
+    }
+
+    // Bottom line: the latency measured with this value, e.g. "press    20412us"
+    snprintf(line, sizeof(line), "%-6s%8uus", measure_labels[knob->measure], (unsigned)measured_us);
+    EduBase_LCD_Set_Cursor(0, 1);
+    EduBase_LCD_Display_String(line);
+}
+
+void Settings_Menu(void)
+{
+    Settings_Profile previous = current_profile;
+    Settings_Profile edited = current_profile;
+    uint32_t index = 0;
+
+    EduBase_LCD_Clear_Display();
+
+    while (1)
+    {
+        Settings_Draw(&edited, index);
+
+        char key = Keypad_WaitForChar();
+        uint32_t *value = Settings_Value(&edited, index);
+        const Settings_Knob *knob = &knobs[index];
+
+        if (key == '*')
+        {
+            index = (index + 1) % SETTINGS_KNOB_COUNT;
+        }
+        else if (key == '/')
+        {
+            index = (index + SETTINGS_KNOB_COUNT - 1) % SETTINGS_KNOB_COUNT;
+        }
+        else if (key == '+' || key == '-')
+        {
+            if (key == '+')
+            {
+                *value = (*value + knob->step <= knob->max) ? *value + knob->step : knob->max;
+            }
+            else
+            {
+                *value = (*value >= knob->min + knob->step) ? *value - knob->step : knob->min;
+            }
+
+            // Live effect, the next redraw and key presses use the new value
+            Settings_Apply(&edited);
+        }
+        else if (key == '=')
+        {
+            uint8_t saved = Settings_Save();
+
+            EduBase_LCD_Clear_Display();
+            EduBase_LCD_Set_Cursor(0, 0);
+            EduBase_LCD_Display_String(saved ? "Settings saved" : "Save failed");
+            SysTick_Delay1ms(500);
+            break;
+        }
+        else if (key == '.')
+        {
+            Settings_Apply(&previous);
+            break;
+        }
+    }
+
+    EduBase_LCD_Clear_Display();
+}
@@ -0,0 +1,101 @@
+/**
+ * @file Settings.h
+ *
+ * @brief Header file for the Settings module.
+ *
+ * It holds the timing profile of the calculator, which used to be made of
+ * compile-time constants, and an on-device menu to tune it:
+ *  - Debounce:  time between the two scans that must agree on a key
+ *  - Release:   polling interval while waiting for a key release
+ *  - LCD write: delay after each 4-bit write to the LCD
+ *  - LCD cmd:   extra delay after an LCD command
+ *  - Clock:     Auto (16 MHz idle, 80 MHz per key), Fast or Slow
+ *
+ * The menu is reached by holding '=' for SETTINGS_HOLD_US. Every change
+ * takes effect immediately, and the bottom line shows the latency measured
+ * with the current value next to it:
+ *  - Debounce:  press latency (first scan to acceptance) of the last key
+ *  - Release:   release detection latency of the last key
+ *  - LCD write, LCD cmd: time taken to redraw the menu's top line
+ *  - Clock:     duration of the last clock switch
+ *
+ * Menu keys:
+ *  - '*' / '/': next / previous setting
+ *  - '+' / '-': increase / decrease the value
+ *  - '=':       save the profile to the EEPROM and exit
+ *  - '.':       restore the profile in effect before the menu and exit
+ *
+ * The profile is stored in the first EEPROM block with a magic number and
+ * a checksum; Settings_Init loads it, or uses the defaults if it is
+ * missing or invalid.
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef SETTINGS_H_
+#define SETTINGS_H_
+
+#include <stdint.h>
+
+// Hold time of the '=' key that opens the menu
+#define SETTINGS_HOLD_US        1000000U
+
+// Location of the profile in the EEPROM (word offset)
+#define SETTINGS_EEPROM_ADDRESS 0U
+
+typedef struct {
+    uint32_t debounce_us;
+    uint32_t release_poll_us;
+    uint32_t lcd_nibble_us;
+    uint32_t lcd_command_us;
+    uint32_t clock_profile;
+} Settings_Profile;
+
+/**
+ * @brief Load the profile from the EEPROM (or use the defaults) and apply it.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Settings_Init(void);
+
+/**
+ * @brief Get the profile in effect.
+ *
+ * @param None
+ *
+ * @return const Settings_Profile* The profile.
+ */
+const Settings_Profile *Settings_Get(void);
+
+/**
+ * @brief Make a profile the one in effect, and pass it on to the drivers.
+ *
+ * @param profile The profile (copied).
+ *
+ * @return None
+ */
+void Settings_Apply(const Settings_Profile *profile);
+
+/**
+ * @brief Store the profile in effect in the EEPROM.
+ *
+ * @param None
+ *
+ * @return uint8_t 1 if stored, 0 on error.
+ */
+uint8_t Settings_Save(void);
+
+/**
+ * @brief Run the settings menu until the user saves or cancels.
+ *
+ * The LCD is cleared on exit, the caller redraws its own display.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Settings_Menu(void);
+
+#endif // SETTINGS_H_
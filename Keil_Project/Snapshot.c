@@ -0,0 +1,83 @@
+/**
+ * @file Snapshot.c
+ *
+ * @brief Source code for the Snapshot module.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Snapshot.h"
+#include <string.h>
+
+static uint8_t *slot(const Snapshot_Ring *ring, uint32_t index)
+{
+    return ring->storage + (index % ring->capacity) * ring->size;
+}
+
+void Snapshot_Init(Snapshot_Ring *ring, void *storage, uint32_t size, uint32_t capacity, const void *initial)
+{
+    ring->storage = (uint8_t *)storage;
+    ring->size = size;
+    ring->capacity = capacity;
+    ring->oldest = 0;
+    ring->current = 0;
+    ring->newest = 0;
+
+    memcpy(slot(ring, 0), initial, size);
+}
+
+const void *Snapshot_Current(const Snapshot_Ring *ring)
+{
+    return slot(ring, ring->current);
+}
+
+void *Snapshot_Begin(Snapshot_Ring *ring)
+{
+    // The free slot after the newest snapshot, so that the snapshots that
+    // can be redone are kept if nothing is committed
+    uint8_t *next = slot(ring, ring->newest + 1);
+
+    memcpy(next, slot(ring, ring->current), ring->size);
+    return next;
+}
+
+void Snapshot_Commit(Snapshot_Ring *ring)
+{
+    uint8_t *staged = slot(ring, ring->newest + 1);
+
+    // Anything that could have been redone is discarded
+    ring->current++;
+    if (ring->current != ring->newest + 1)
+    {
+        memcpy(slot(ring, ring->current), staged, ring->size);
+    }
+    ring->newest = ring->current;
+
+    // Keep one slot free for the next Snapshot_Begin
+    if (ring->newest - ring->oldest > ring->capacity - 2)
+    {
+        ring->oldest = ring->newest - (ring->capacity - 2);
+    }
+}
+
+uint8_t Snapshot_Undo(Snapshot_Ring *ring)
+{
+    if (ring->current == ring->oldest)
+    {
+        return 0;
+    }
+
+    ring->current--;
+    return 1;
+}
+
+uint8_t Snapshot_Redo(Snapshot_Ring *ring)
+{
+    if (ring->current == ring->newest)
+    {
+        return 0;
+    }
+
+    ring->current++;
+    return 1;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file Snapshot.h
+ *
+ * @brief Header file for the Snapshot module.
+ *
+ * It is a bounded ring of immutable state snapshots, for undo and redo.
+ * Each transition of the owner's state is written into a new slot (a copy
+ * of the current snapshot, from Snapshot_Begin), and published with
+ * Snapshot_Commit; a published snapshot is never modified again. Undo and
+ * redo only move the current position along the ring, in O(1), without
+ * copying anything.
+ *
+ * The ring holds up to capacity - 1 snapshots (the latest capacity - 2
+ * transitions can be undone): when it is full, a new snapshot replaces
+ * the oldest one. The remaining slot receives the snapshot being written,
+ * so a transition that is not committed (e.g. a key that changed nothing)
+ * is simply dropped, and the snapshots that can be redone are kept. A new snapshot after an undo discards the snapshots
+ * that could have been redone.
+ *
+ * The caller provides the storage, an array of capacity snapshots of any
+ * type.
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+#include <stdint.h>
+
+typedef struct {
+    uint8_t *storage;
+    uint32_t size;          // bytes per snapshot
+    uint32_t capacity;      // snapshots
+
+    // Free-running indices, oldest <= current <= newest
+    uint32_t oldest;
+    uint32_t current;
+    uint32_t newest;
+} Snapshot_Ring;
+
+/**
+ * @brief Initialize a ring with its first snapshot.
+ *
+ * @param ring     The ring.
+ * @param storage  The storage for the snapshots.
+ * @param size     The size of one snapshot in bytes.
+ * @param capacity The number of snapshots in storage (at least 3).
+ * @param initial  The first snapshot (copied).
+ *
+ * @return None
+ */
+void Snapshot_Init(Snapshot_Ring *ring, void *storage, uint32_t size, uint32_t capacity, const void *initial);
+
+/**
+ * @brief Get the current snapshot.
+ *
+ * @param ring The ring.
+ *
+ * @return const void* The snapshot.
+ */
+const void *Snapshot_Current(const Snapshot_Ring *ring);
+
+/**
+ * @brief Start a transition: get a copy of the current snapshot to modify.
+ *
+ * The copy becomes the current snapshot only with Snapshot_Commit; until
+ * then, the next Snapshot_Begin overwrites it.
+ *
+ * @param ring The ring.
+ *
+ * @return void* The new snapshot.
+ */
+void *Snapshot_Begin(Snapshot_Ring *ring);
+
+/**
+ * @brief Publish the snapshot from Snapshot_Begin as the current one.
+ *
+ * @param ring The ring.
+ *
+ * @return None
+ */
+void Snapshot_Commit(Snapshot_Ring *ring);
+
+/**
+ * @brief Move back to the previous snapshot.
+ *
+ * @param ring The ring.
+ *
+ * @return uint8_t 1 if the current snapshot changed, 0 if there is nothing to undo.
+ */
+uint8_t Snapshot_Undo(Snapshot_Ring *ring);
+
+/**
+ * @brief Move forward to the snapshot that was undone last.
+ *
+ * @param ring The ring.
+ *
+ * @return uint8_t 1 if the current snapshot changed, 0 if there is nothing to redo.
+ */
+uint8_t Snapshot_Redo(Snapshot_Ring *ring);
+
+#endif // SNAPSHOT_H_
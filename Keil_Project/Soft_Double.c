@@ -0,0 +1,730 @@
+/**
+ * @file Soft_Double.c
+ *
+ * @brief Source code for the Soft_Double library.
+ *
+ * Significands are handled as 64-bit integers with the leading bit at
+ * bit 62 and 10 extra bits below the 52-bit fraction for rounding
+ * (sticky bits are "jammed" into the least significant bit).
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Soft_Double.h"
+#include <string.h>
+
+#define DEFAULT_NAN     0x7FF8000000000000ULL
+
+// Cumulative exception flags
+static uint32_t soft_double_flags = 0;
+
+// ----- Bit-level helpers -----
+
+static inline uint64_t Bits(double x)
+{
+    uint64_t u;
+    memcpy(&u, &x, sizeof(u));
+    return u;
+}
+
+static inline double From_Bits(uint64_t u)
+{
+    double x;
+    memcpy(&x, &u, sizeof(x));
+    return x;
+}
+
+static inline uint64_t Frac(uint64_t a)  { return a & 0x000FFFFFFFFFFFFFULL; }
+static inline int32_t  Exp(uint64_t a)   { return (int32_t)((a >> 52) & 0x7FF); }
+static inline uint32_t Sign(uint64_t a)  { return (uint32_t)(a >> 63); }
+
+// The significand is added (not OR-ed) so that a carry out of the
+// fraction increments the exponent.
+static inline uint64_t Pack(uint32_t sign, int32_t exp, uint64_t sig)
+{
+    return ((uint64_t)sign << 63) + ((uint64_t)exp << 52) + sig;
+}
+
+static inline int Is_NaN(uint64_t a)
+{
+    return (a << 1) > 0xFFE0000000000000ULL;
+}
+
+static inline int Is_Signaling_NaN(uint64_t a)
+{
+    return (((a >> 51) & 0xFFF) == 0xFFE) && (a & 0x0007FFFFFFFFFFFFULL);
+}
+
+static uint64_t Propagate_NaN(uint64_t a, uint64_t b)
+{
+    if (Is_Signaling_NaN(a) || Is_Signaling_NaN(b))
+    {
+        soft_double_flags |= SOFT_DOUBLE_FLAG_INVALID;
+    }
+    return DEFAULT_NAN;
+}
+
+// Count leading zeros of a 64-bit value (CLZ on each word)
+static inline int32_t Clz64(uint64_t a)
+{
+    uint32_t high = (uint32_t)(a >> 32);
+    if (high != 0)
+    {
+        return __builtin_clz(high);
+    }
+    return 32 + __builtin_clz((uint32_t)a);
+}
+
+// Shift right, OR-ing any bits shifted out into bit 0
+static inline uint64_t Shift_Right_Jamming(uint64_t a, int32_t count)
+{
+    if (count == 0)
+    {
+        return a;
+    }
+    if (count < 64)
+    {
+        return (a >> count) | ((a << (64 - count)) != 0);
+    }
+    return (a != 0);
+}
+
+// Full 64x64 -> 128-bit product from four 32x32 partial products
+static inline void Mul_64_To_128(uint64_t a, uint64_t b, uint64_t *high, uint64_t *low)
+{
+    uint32_t a0 = (uint32_t)a;
+    uint32_t a1 = (uint32_t)(a >> 32);
+    uint32_t b0 = (uint32_t)b;
+    uint32_t b1 = (uint32_t)(b >> 32);
+
+    uint64_t p00 = (uint64_t)a0 * b0;
+    uint64_t p01 = (uint64_t)a0 * b1;
+    uint64_t p10 = (uint64_t)a1 * b0;
+    uint64_t p11 = (uint64_t)a1 * b1;
+
+    uint64_t middle = (p00 >> 32) + (uint32_t)p01 + (uint32_t)p10;
+
+    *low = (middle << 32) | (uint32_t)p00;
+    *high = p11 + (p01 >> 32) + (p10 >> 32) + (middle >> 32);
+}
+
+static inline void Sub_128(uint64_t a0, uint64_t a1, uint64_t b0, uint64_t b1,
+                           uint64_t *z0, uint64_t *z1)
+{
+    *z1 = a1 - b1;
+    *z0 = a0 - b0 - (a1 < b1);
+}
+
+static inline void Add_128(uint64_t a0, uint64_t a1, uint64_t b0, uint64_t b1,
+                           uint64_t *z0, uint64_t *z1)
+{
+    uint64_t sum = a1 + b1;
+    *z1 = sum;
+    *z0 = a0 + b0 + (sum < a1);
+}
+
+// Estimate (a0:a1) / b, where b is normalized and a0 < b. The result is
+// at most 2 larger than the true quotient and is never smaller.
+static uint64_t Estimate_Div_128_To_64(uint64_t a0, uint64_t a1, uint64_t b)
+{
+    uint64_t b0, b1, rem0, rem1, term0, term1, z;
+
+    if (b <= a0)
+    {
+        return 0xFFFFFFFFFFFFFFFFULL;
+    }
+
+    b0 = b >> 32;
+    z = ((b0 << 32) <= a0) ? 0xFFFFFFFF00000000ULL : ((a0 / b0) << 32);
+    Mul_64_To_128(b, z, &term0, &term1);
+    Sub_128(a0, a1, term0, term1, &rem0, &rem1);
+
+    while ((int64_t)rem0 < 0)
+    {
+        z -= 0x100000000ULL;
+        b1 = b << 32;
+        Add_128(rem0, rem1, b0, b1, &rem0, &rem1);
+    }
+
+    rem0 = (rem0 << 32) | (rem1 >> 32);
+    z |= ((b0 << 32) <= rem0) ? 0xFFFFFFFFULL : (rem0 / b0);
+    return z;
+}
+
+static inline void Normalize_Subnormal(uint64_t sig, int32_t *exp, uint64_t *norm)
+{
+    int32_t shift = Clz64(sig) - 11;
+    *norm = sig << shift;
+    *exp = 1 - shift;
+}
+
+// Round a significand with its leading bit at bit 62 and pack the result.
+// exp is one less than the biased exponent of the result.
+static uint64_t Round_And_Pack(uint32_t sign, int32_t exp, uint64_t sig)
+{
+    uint32_t round_bits = (uint32_t)(sig & 0x3FF);
+
+    if ((uint32_t)exp >= 0x7FD)
+    {
+        if ((exp > 0x7FD) || ((exp == 0x7FD) && ((int64_t)(sig + 0x200) < 0)))
+        {
+            soft_double_flags |= SOFT_DOUBLE_FLAG_OVERFLOW | SOFT_DOUBLE_FLAG_INEXACT;
+            return Pack(sign, 0x7FF, 0);
+        }
+
+        if (exp < 0)
+        {
+            // Tininess is detected before rounding, as on ARM
+            uint8_t is_tiny = (exp < -1) || (sig + 0x200 < 0x8000000000000000ULL);
+            sig = Shift_Right_Jamming(sig, -exp);
+            exp = 0;
+            round_bits = (uint32_t)(sig & 0x3FF);
+
+            if (is_tiny && round_bits)
+            {
+                soft_double_flags |= SOFT_DOUBLE_FLAG_UNDERFLOW;
+            }
+        }
+    }
+
+    if (round_bits)
+    {
+        soft_double_flags |= SOFT_DOUBLE_FLAG_INEXACT;
+    }
+
+    sig = (sig + 0x200) >> 10;
+
+    // Ties to even
+    if (round_bits == 0x200)
+    {
+        sig &= ~1ULL;
+    }
+
+    if (sig == 0)
+    {
+        exp = 0;
+    }
+
+    return Pack(sign, exp, sig);
+}
+
+static uint64_t Normalize_Round_And_Pack(uint32_t sign, int32_t exp, uint64_t sig)
+{
+    int32_t shift = Clz64(sig) - 1;
+    return Round_And_Pack(sign, exp - shift, sig << shift);
+}
+
+// ----- Addition and subtraction -----
+
+static uint64_t Add_Sigs(uint64_t a, uint64_t b, uint32_t sign)
+{
+    int32_t a_exp = Exp(a);
+    int32_t b_exp = Exp(b);
+    uint64_t a_sig = Frac(a) << 9;
+    uint64_t b_sig = Frac(b) << 9;
+    int32_t exp_diff = a_exp - b_exp;
+    int32_t z_exp;
+    uint64_t z_sig;
+
+    if (exp_diff > 0)
+    {
+        if (a_exp == 0x7FF)
+        {
+            return a_sig ? Propagate_NaN(a, b) : a;
+        }
+        if (b_exp == 0)
+        {
+            exp_diff--;
+        }
+        else
+        {
+            b_sig |= 0x2000000000000000ULL;
+        }
+        b_sig = Shift_Right_Jamming(b_sig, exp_diff);
+        z_exp = a_exp;
+    }
+    else if (exp_diff < 0)
+    {
+        if (b_exp == 0x7FF)
+        {
+            return b_sig ? Propagate_NaN(a, b) : Pack(sign, 0x7FF, 0);
+        }
+        if (a_exp == 0)
+        {
+            exp_diff++;
+        }
+        else
+        {
+            a_sig |= 0x2000000000000000ULL;
+        }
+        a_sig = Shift_Right_Jamming(a_sig, -exp_diff);
+        z_exp = b_exp;
+    }
+    else
+    {
+        if (a_exp == 0x7FF)
+        {
+            return (a_sig | b_sig) ? Propagate_NaN(a, b) : a;
+        }
+        if (a_exp == 0)
+        {
+            return Pack(sign, 0, (a_sig + b_sig) >> 9);
+        }
+        z_sig = 0x4000000000000000ULL + a_sig + b_sig;
+        return Round_And_Pack(sign, a_exp, z_sig);
+    }
+
+    a_sig |= 0x2000000000000000ULL;
+    z_sig = (a_sig + b_sig) << 1;
+    z_exp--;
+
+    if ((int64_t)z_sig < 0)
+    {
+        z_sig = a_sig + b_sig;
+        z_exp++;
+    }
+
+    return Round_And_Pack(sign, z_exp, z_sig);
+}
+
+static uint64_t Sub_Sigs(uint64_t a, uint64_t b, uint32_t sign)
+{
+    int32_t a_exp = Exp(a);
+    int32_t b_exp = Exp(b);
+    uint64_t a_sig = Frac(a) << 10;
+    uint64_t b_sig = Frac(b) << 10;
+    int32_t exp_diff = a_exp - b_exp;
+    int32_t z_exp;
+    uint64_t z_sig;
+
+    if (exp_diff == 0)
+    {
+        if (a_exp == 0x7FF)
+        {
+            if (a_sig | b_sig)
+            {
+                return Propagate_NaN(a, b);
+            }
+            // inf - inf
+            soft_double_flags |= SOFT_DOUBLE_FLAG_INVALID;
+            return DEFAULT_NAN;
+        }
+        if (a_exp == 0)
+        {
+            a_exp = 1;
+            b_exp = 1;
+        }
+        if (a_sig == b_sig)
+        {
+            return Pack(0, 0, 0);
+        }
+        if (a_sig > b_sig)
+        {
+            z_sig = a_sig - b_sig;
+            z_exp = a_exp;
+        }
+        else
+        {
+            z_sig = b_sig - a_sig;
+            z_exp = b_exp;
+            sign ^= 1;
+        }
+    }
+    else if (exp_diff < 0)
+    {
+        if (b_exp == 0x7FF)
+        {
+            return b_sig ? Propagate_NaN(a, b) : Pack(sign ^ 1, 0x7FF, 0);
+        }
+        if (a_exp == 0)
+        {
+            exp_diff++;
+        }
+        else
+        {
+            a_sig |= 0x4000000000000000ULL;
+        }
+        a_sig = Shift_Right_Jamming(a_sig, -exp_diff);
+        b_sig |= 0x4000000000000000ULL;
+        z_sig = b_sig - a_sig;
+        z_exp = b_exp;
+        sign ^= 1;
+    }
+    else
+    {
+        if (a_exp == 0x7FF)
+        {
+            return a_sig ? Propagate_NaN(a, b) : a;
+        }
+        if (b_exp == 0)
+        {
+            exp_diff--;
+        }
+        else
+        {
+            b_sig |= 0x4000000000000000ULL;
+        }
+        b_sig = Shift_Right_Jamming(b_sig, exp_diff);
+        a_sig |= 0x4000000000000000ULL;
+        z_sig = a_sig - b_sig;
+        z_exp = a_exp;
+    }
+
+    return Normalize_Round_And_Pack(sign, z_exp - 1, z_sig);
+}
+
+double Soft_Double_Add(double a, double b)
+{
+    uint64_t ua = Bits(a);
+    uint64_t ub = Bits(b);
+    uint32_t sign = Sign(ua);
+
+    if (sign == Sign(ub))
+    {
+        return From_Bits(Add_Sigs(ua, ub, sign));
+    }
+    return From_Bits(Sub_Sigs(ua, ub, sign));
+}
+
+double Soft_Double_Sub(double a, double b)
+{
+    uint64_t ua = Bits(a);
+    uint64_t ub = Bits(b);
+    uint32_t sign = Sign(ua);
+
+    if (sign == Sign(ub))
+    {
+        return From_Bits(Sub_Sigs(ua, ub, sign));
+    }
+    return From_Bits(Add_Sigs(ua, ub, sign));
+}
+
+// ----- Multiplication and division -----
+
+double Soft_Double_Mul(double a, double b)
+{
+    uint64_t ua = Bits(a);
+    uint64_t ub = Bits(b);
+    int32_t a_exp = Exp(ua);
+    int32_t b_exp = Exp(ub);
+    uint64_t a_sig = Frac(ua);
+    uint64_t b_sig = Frac(ub);
+    uint32_t sign = Sign(ua) ^ Sign(ub);
+    uint64_t z_sig0, z_sig1;
+
+    if (a_exp == 0x7FF)
+    {
+        if (a_sig || ((b_exp == 0x7FF) && b_sig))
+        {
+            return From_Bits(Propagate_NaN(ua, ub));
+        }
+        if ((b_exp | (int32_t)(b_sig != 0)) == 0)
+        {
+            // inf * 0
+            soft_double_flags |= SOFT_DOUBLE_FLAG_INVALID;
+            return From_Bits(DEFAULT_NAN);
+        }
+        return From_Bits(Pack(sign, 0x7FF, 0));
+    }
+
+    if (b_exp == 0x7FF)
+    {
+        if (b_sig)
+        {
+            return From_Bits(Propagate_NaN(ua, ub));
+        }
+        if ((a_exp | (int32_t)(a_sig != 0)) == 0)
+        {
+            soft_double_flags |= SOFT_DOUBLE_FLAG_INVALID;
+            return From_Bits(DEFAULT_NAN);
+        }
+        return From_Bits(Pack(sign, 0x7FF, 0));
+    }
+
+    if (a_exp == 0)
+    {
+        if (a_sig == 0)
+        {
+            return From_Bits(Pack(sign, 0, 0));
+        }
+        Normalize_Subnormal(a_sig, &a_exp, &a_sig);
+    }
+
+    if (b_exp == 0)
+    {
+        if (b_sig == 0)
+        {
+            return From_Bits(Pack(sign, 0, 0));
+        }
+        Normalize_Subnormal(b_sig, &b_exp, &b_sig);
+    }
+
+    int32_t z_exp = a_exp + b_exp - 0x3FF;
+    a_sig = (a_sig | 0x0010000000000000ULL) << 10;
+    b_sig = (b_sig | 0x0010000000000000ULL) << 11;
+
+    Mul_64_To_128(a_sig, b_sig, &z_sig0, &z_sig1);
+    z_sig0 |= (z_sig1 != 0);
+
+    if ((int64_t)(z_sig0 << 1) >= 0)
+    {
+        z_sig0 <<= 1;
+        z_exp--;
+    }
+
+    return From_Bits(Round_And_Pack(sign, z_exp, z_sig0));
+}
+
+double Soft_Double_Div(double a, double b)
+{
+    uint64_t ua = Bits(a);
+    uint64_t ub = Bits(b);
+    int32_t a_exp = Exp(ua);
+    int32_t b_exp = Exp(ub);
+    uint64_t a_sig = Frac(ua);
+    uint64_t b_sig = Frac(ub);
+    uint32_t sign = Sign(ua) ^ Sign(ub);
+    uint64_t rem0, rem1, term0, term1;
+
+    if (a_exp == 0x7FF)
+    {
+        if (a_sig)
+        {
+            return From_Bits(Propagate_NaN(ua, ub));
+        }
+        if (b_exp == 0x7FF)
+        {
+            if (b_sig)
+            {
+                return From_Bits(Propagate_NaN(ua, ub));
+            }
+            // inf / inf
+            soft_double_flags |= SOFT_DOUBLE_FLAG_INVALID;
+            return From_Bits(DEFAULT_NAN);
+        }
+        return From_Bits(Pack(sign, 0x7FF, 0));
+    }
+
+    if (b_exp == 0x7FF)
+    {
+        return b_sig ? From_Bits(Propagate_NaN(ua, ub)) : From_Bits(Pack(sign, 0, 0));
+    }
+
+    if (b_exp == 0)
+    {
+        if (b_sig == 0)
+        {
+            if ((a_exp | (int32_t)(a_sig != 0)) == 0)
+            {
+                // 0 / 0
+                soft_double_flags |= SOFT_DOUBLE_FLAG_INVALID;
+                return From_Bits(DEFAULT_NAN);
+            }
+            soft_double_flags |= SOFT_DOUBLE_FLAG_DIVIDE_BY_ZERO;
+            return From_Bits(Pack(sign, 0x7FF, 0));
+        }
+        Normalize_Subnormal(b_sig, &b_exp, &b_sig);
+    }
+
+    if (a_exp == 0)
+    {
+        if (a_sig == 0)
+        {
+            return From_Bits(Pack(sign, 0, 0));
+        }
+        Normalize_Subnormal(a_sig, &a_exp, &a_sig);
+    }
+
+    int32_t z_exp = a_exp - b_exp + 0x3FD;
+    a_sig = (a_sig | 0x0010000000000000ULL) << 10;
+    b_sig = (b_sig | 0x0010000000000000ULL) << 11;
+
+    if (b_sig <= (a_sig + a_sig))
+    {
+        a_sig >>= 1;
+        z_exp++;
+    }
+
+    uint64_t z_sig = Estimate_Div_128_To_64(a_sig, 0, b_sig);
+
+    // Only quotients close to a rounding boundary need the exact remainder
+    if ((z_sig & 0x1FF) <= 2)
+    {
+        Mul_64_To_128(b_sig, z_sig, &term0, &term1);
+        Sub_128(a_sig, 0, term0, term1, &rem0, &rem1);
+
+        while ((int64_t)rem0 < 0)
+        {
+            z_sig--;
+            Add_128(rem0, rem1, 0, b_sig, &rem0, &rem1);
+        }
+
+        z_sig |= (rem1 != 0);
+    }
+
+    return From_Bits(Round_And_Pack(sign, z_exp, z_sig));
+}
+
+// ----- Comparison -----
+
+int Soft_Double_Compare(double a, double b)
+{
+    uint64_t ua = Bits(a);
+    uint64_t ub = Bits(b);
+
+    if (Is_NaN(ua) || Is_NaN(ub))
+    {
+        if (Is_Signaling_NaN(ua) || Is_Signaling_NaN(ub))
+        {
+            soft_double_flags |= SOFT_DOUBLE_FLAG_INVALID;
+        }
+        return SOFT_DOUBLE_UNORDERED;
+    }
+
+    // +0 == -0
+    if (((ua | ub) << 1) == 0)
+    {
+        return 0;
+    }
+
+    uint32_t a_sign = Sign(ua);
+    if (a_sign != Sign(ub))
+    {
+        return a_sign ? -1 : 1;
+    }
+
+    if (ua == ub)
+    {
+        return 0;
+    }
+
+    return ((ua < ub) ^ a_sign) ? -1 : 1;
+}
+
+// ----- Integer conversion -----
+
+double Soft_Double_From_Int32(int32_t value)
+{
+    if (value == 0)
+    {
+        return From_Bits(0);
+    }
+
+    uint32_t sign = (value < 0);
+    uint32_t magnitude = sign ? (0U - (uint32_t)value) : (uint32_t)value;
+
+    // Every int32 is exact in a double: just normalize
+    int32_t shift = __builtin_clz(magnitude) + 21;
+    return From_Bits(Pack(sign, 0x432 - shift, (uint64_t)magnitude << shift));
+}
+
+double Soft_Double_From_Int64(int64_t value)
+{
+    if (value == 0)
+    {
+        return From_Bits(0);
+    }
+
+    if (value == INT64_MIN)
+    {
+        return From_Bits(Pack(1, 0x43E, 0));
+    }
+
+    uint32_t sign = (value < 0);
+    uint64_t magnitude = sign ? (0 - (uint64_t)value) : (uint64_t)value;
+    return From_Bits(Normalize_Round_And_Pack(sign, 0x43C, magnitude));
+}
+
+int64_t Soft_Double_To_Int64(double value)
+{
+    uint64_t ua = Bits(value);
+    int32_t a_exp = Exp(ua);
+    uint64_t a_sig = Frac(ua);
+    uint32_t a_sign = Sign(ua);
+    int32_t shift = a_exp - 0x433;
+    uint64_t z;
+
+    if (a_exp)
+    {
+        a_sig |= 0x0010000000000000ULL;
+    }
+
+    if (shift >= 0)
+    {
+        if (a_exp >= 0x43E)
+        {
+            if (ua == 0xC3E0000000000000ULL)
+            {
+                return INT64_MIN;
+            }
+            soft_double_flags |= SOFT_DOUBLE_FLAG_INVALID;
+            if (Is_NaN(ua))
+            {
+                return 0;
+            }
+            return a_sign ? INT64_MIN : INT64_MAX;
+        }
+        z = a_sig << shift;
+    }
+    else
+    {
+        if (a_exp < 0x3FE)
+        {
+            if (a_exp | (int32_t)(a_sig != 0))
+            {
+                soft_double_flags |= SOFT_DOUBLE_FLAG_INEXACT;
+            }
+            return 0;
+        }
+        z = a_sig >> -shift;
+        if (a_sig << (shift & 63))
+        {
+            soft_double_flags |= SOFT_DOUBLE_FLAG_INEXACT;
+        }
+    }
+
+    return a_sign ? (int64_t)(0 - z) : (int64_t)z;
+}
+
+int32_t Soft_Double_To_Int32(double value)
+{
+    uint64_t ua = Bits(value);
+
+    if (Is_NaN(ua))
+    {
+        soft_double_flags |= SOFT_DOUBLE_FLAG_INVALID;
+        return 0;
+    }
+
+    // |value| < 2^62 converts exactly through the 64-bit path
+    if (Exp(ua) < 0x43D)
+    {
+        int64_t z = Soft_Double_To_Int64(value);
+        if (z > INT32_MAX)
+        {
+            soft_double_flags |= SOFT_DOUBLE_FLAG_INVALID;
+            return INT32_MAX;
+        }
+        if (z < INT32_MIN)
+        {
+            soft_double_flags |= SOFT_DOUBLE_FLAG_INVALID;
+            return INT32_MIN;
+        }
+        return (int32_t)z;
+    }
+
+    soft_double_flags |= SOFT_DOUBLE_FLAG_INVALID;
+    return Sign(ua) ? INT32_MIN : INT32_MAX;
+}
+
+// ----- Exception flags -----
+
+uint32_t Soft_Double_Get_Flags(void)
+{
+    return soft_double_flags;
+}
+
+void Soft_Double_Clear_Flags(void)
+{
+    soft_double_flags = 0;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file Soft_Double.h
+ *
+ * @brief Header file for the Soft_Double library.
+ *
+ * The TM4C123GH6PM FPU only supports single precision, so every double
+ * operation in the calculator goes through the compiler runtime helpers
+ * (__aeabi_dadd, __aeabi_dmul, __aeabi_ddiv, ...). This library provides
+ * IEEE-754 binary64 add, subtract, multiply, divide, compare, and integer
+ * conversion in portable C written for the Cortex-M4: 64x64 products are
+ * built from 32x32 partial products (UMULL/UMAAL), normalization uses CLZ,
+ * and division estimates each 32-bit quotient digit from the leading
+ * divisor word before correcting it against the exact remainder.
+ *
+ * All results are rounded to nearest, ties to even, and are bit-exact with
+ * IEEE-754 hardware except for NaN payloads: every NaN result is the
+ * default NaN (0x7FF8000000000000), as with FPSCR.DN set.
+ *
+ * Exception flags are accumulated in the same bit positions as the FPSCR
+ * cumulative flags and can be read or cleared once per evaluation.
+ *
+ * @note The algorithms follow John R. Hauser's SoftFloat (Release 2).
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef SOFT_DOUBLE_H_
+#define SOFT_DOUBLE_H_
+
+#include <stdint.h>
+
+// Cumulative exception flags (same bit positions as FPSCR IOC..IXC)
+#define SOFT_DOUBLE_FLAG_INVALID        0x01U
+#define SOFT_DOUBLE_FLAG_DIVIDE_BY_ZERO 0x02U
+#define SOFT_DOUBLE_FLAG_OVERFLOW       0x04U
+#define SOFT_DOUBLE_FLAG_UNDERFLOW      0x08U
+#define SOFT_DOUBLE_FLAG_INEXACT        0x10U
+
+// Return value of Soft_Double_Compare when either operand is NaN
+#define SOFT_DOUBLE_UNORDERED           2
+
+/**
+ * @brief Double-precision arithmetic, rounded to nearest even.
+ *
+ * @param a Left operand.
+ * @param b Right operand.
+ *
+ * @return double The correctly rounded result.
+ */
+double Soft_Double_Add(double a, double b);
+double Soft_Double_Sub(double a, double b);
+double Soft_Double_Mul(double a, double b);
+double Soft_Double_Div(double a, double b);
+
+/**
+ * @brief Compare two doubles.
+ *
+ * @param a Left operand.
+ * @param b Right operand.
+ *
+ * @return int -1 if a < b, 0 if a == b, 1 if a > b, or
+ *         SOFT_DOUBLE_UNORDERED if either operand is NaN.
+ */
+int Soft_Double_Compare(double a, double b);
+
+/**
+ * @brief Convert integers to double (rounded to nearest even).
+ *
+ * @param value The integer to convert.
+ *
+ * @return double The converted value.
+ */
+double Soft_Double_From_Int32(int32_t value);
+double Soft_Double_From_Int64(int64_t value);
+
+/**
+ * @brief Convert a double to an integer, truncating toward zero.
+ *
+ * Out-of-range values saturate and NaN converts to 0 (as VCVT does),
+ * raising the invalid flag.
+ *
+ * @param value The double to convert.
+ *
+ * @return The converted integer.
+ */
+int32_t Soft_Double_To_Int32(double value);
+int64_t Soft_Double_To_Int64(double value);
+
+/**
+ * @brief Read or clear the cumulative exception flags.
+ *
+ * @return uint32_t The flags raised since the last clear.
+ */
+uint32_t Soft_Double_Get_Flags(void);
+void Soft_Double_Clear_Flags(void);
+
+#endif // SOFT_DOUBLE_H_
@@ -0,0 +1,60 @@
+/**
+ * @file Spsc_Queue.c
+ *
+ * @brief Source code for the Spsc_Queue module.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Spsc_Queue.h"
+#include "Atomic.h"
+
+void Spsc_Queue_Init(Spsc_Queue *queue, uint32_t *buffer, uint32_t capacity)
+{
+    queue->buffer = buffer;
+    queue->mask = capacity - 1;
+    queue->head = 0;
+    queue->tail = 0;
+    queue->dropped = 0;
+}
+
+uint8_t Spsc_Queue_Push(Spsc_Queue *queue, uint32_t value)
+{
+    uint32_t head = Atomic_Load(&queue->head);
+
+    // The indices run freely; head - tail is the number of values. The
+    // consumer has finished reading a slot once it has moved the tail past it
+    if (head - Atomic_Load_Acquire(&queue->tail) > queue->mask)
+    {
+        Atomic_Store(&queue->dropped, Atomic_Load(&queue->dropped) + 1);
+        return 0;
+    }
+
+    queue->buffer[head & queue->mask] = value;
+
+    // Publish the value with the new head
+    Atomic_Store_Release(&queue->head, head + 1);
+    return 1;
+}
+
+uint8_t Spsc_Queue_Pop(Spsc_Queue *queue, uint32_t *value)
+{
+    uint32_t tail = Atomic_Load(&queue->tail);
+
+    // Read the value only after seeing the head that published it
+    if (tail == Atomic_Load_Acquire(&queue->head))
+    {
+        return 0;
+    }
+
+    *value = queue->buffer[tail & queue->mask];
+
+    // Finish reading it before the slot is handed back to the producer
+    Atomic_Store_Release(&queue->tail, tail + 1);
+    return 1;
+}
+
+uint32_t Spsc_Queue_Count(const Spsc_Queue *queue)
+{
+    return Atomic_Load(&queue->head) - Atomic_Load(&queue->tail);
+}
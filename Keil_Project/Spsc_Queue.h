@@ -0,0 +1,71 @@
+/**
+ * @file Spsc_Queue.h
+ *
+ * @brief Header file for the Spsc_Queue module.
+ *
+ * It is a lock-free single-producer, single-consumer queue of 32-bit
+ * values, e.g. for passing events from an interrupt handler (producer)
+ * to the main loop (consumer). The producer only writes the head index
+ * and the consumer only writes the tail index, so neither side needs
+ * interrupts to be disabled.
+ *
+ * The caller provides the storage, whose size must be a power of two.
+ * The queue holds up to that many values.
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef SPSC_QUEUE_H_
+#define SPSC_QUEUE_H_
+
+#include <stdint.h>
+
+typedef struct {
+    uint32_t *buffer;
+    uint32_t mask;
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    volatile uint32_t dropped;
+} Spsc_Queue;
+
+/**
+ * @brief Initialize a queue.
+ *
+ * @param queue    The queue.
+ * @param buffer   The storage for the values.
+ * @param capacity The number of values in buffer, a power of two.
+ *
+ * @return None
+ */
+void Spsc_Queue_Init(Spsc_Queue *queue, uint32_t *buffer, uint32_t capacity);
+
+/**
+ * @brief Add a value (producer side).
+ *
+ * @param queue The queue.
+ * @param value The value.
+ *
+ * @return uint8_t 1 if the value was added, 0 if the queue was full (the value is counted as dropped).
+ */
+uint8_t Spsc_Queue_Push(Spsc_Queue *queue, uint32_t value);
+
+/**
+ * @brief Remove the oldest value (consumer side).
+ *
+ * @param queue The queue.
+ * @param value Receives the value.
+ *
+ * @return uint8_t 1 if a value was removed, 0 if the queue was empty.
+ */
+uint8_t Spsc_Queue_Pop(Spsc_Queue *queue, uint32_t *value);
+
+/**
+ * @brief Get the number of values in the queue.
+ *
+ * @param queue The queue.
+ *
+ * @return uint32_t The number of values.
+ */
+uint32_t Spsc_Queue_Count(const Spsc_Queue *queue);
+
+#endif // SPSC_QUEUE_H_
@@ -4,32 +4,33 @@
  * @brief Source code for the SysTick_Delay driver.
  *
  * It provides two blocking functions, SysTick_Delay1ms and SysTick_Delay1us,
- * to create a delay with a busy-wait loop. It uses the SysTick timer with 
- * a specified reload value to generate interrupts every 1 us.
+ * to create a delay with a busy-wait loop. The SysTick timer runs freely
+ * with its maximum reload value and is used as a timebase: a delay computes
+ * its deadline once and waits until the timebase reaches it.
  * 
  * In addition, it uses the Peripheral Internal Oscillator (PIOSC) 
- * as the clock source. The PIOSC provides 16 MHz which is then divided by 4. 
- * The timer is used for creating delays in either microseconds or milliseconds.
+ * as the clock source. The PIOSC provides 16 MHz which is then divided by 4,
+ * so one tick is 0.25 us. The counter wraps every 2^24 ticks (~4.19 s) and
+ * the SysTick interrupt only fires on a wrap, instead of every microsecond.
  *
  * @author Aaron Nanas
  */
 
 #include "SysTick_Delay.h"
+#include "Trace.h"
+#include "Interrupts.h"
 
-// Global variable used to keep track of elapsed time in microseconds
-static uint32_t us_elapsed = 0;
+// Reload value for a free-running 24-bit counter
+#define SYSTICK_RELOAD          0x00FFFFFFU
 
-// Global variable used to keep track of elapsed time in milliseconds
-static uint32_t ms_elapsed = 0;
-
-// Global flag used to indicate if milliseconds delay is active
-static uint8_t ms_active = 0;
+// Number of times the 24-bit counter has wrapped
+static volatile uint32_t systick_wraps = 0;
 
 void SysTick_Delay_Init(void)
 {	
-	// Set the SysTick timer reload value for 1 us intervals
+	// Set the SysTick timer reload value to the maximum so that it runs freely
 	// Each clock cycle is (1 / 4 MHz) = 0.25 us
-	SysTick->LOAD = (4 - 1);
+	SysTick->LOAD = SYSTICK_RELOAD;
 	
 	// Clear the VAL register by writing any value to it
 	SysTick->VAL = 0;
@@ -39,43 +40,78 @@ void SysTick_Delay_Init(void)
 	SysTick->CTRL |= 0x03;
 }
 
-void SysTick_Delay1us(uint32_t delay_in_us)
+uint64_t SysTick_Get_Ticks(void)
 {
-	// Reset the global variable, us_elapsed
-	us_elapsed = 0;
+	uint32_t wraps;
+	uint32_t value;
+	uint32_t pending;
+	
+	// Re-read if the wrap interrupt ran while sampling VAL
+	do
+	{
+		wraps = systick_wraps;
+		value = SysTick->VAL;
+		pending = SCB->ICSR & SCB_ICSR_PENDSTSET_Msk;
+	} while (wraps != systick_wraps);
+	
+	// The counter wrapped but the interrupt has not run yet
+	// (interrupts masked or a higher priority handler is active)
+	if (pending && (value > (SYSTICK_RELOAD / 2)))
+	{
+		wraps = wraps + 1;
+	}
 	
-	// Wait until ms_value reaches the specified delay_in_ms
-	while (delay_in_us > us_elapsed);
+	// SysTick counts down
+	return ((uint64_t)wraps << 24) + (SYSTICK_RELOAD - value);
 }
 
-void SysTick_Delay1ms(uint32_t delay_in_ms)
+uint64_t SysTick_Get_Time_us(void)
+{
+	return SysTick_Get_Ticks() / SYSTICK_TICKS_PER_US;
+}
+
+void SysTick_Delay1us(uint32_t delay_in_us)
 {
-	// Reset the global variables, us_elapsed and ms_elapsed
-	us_elapsed = 0;
-	ms_elapsed = 0;
+	// Compute the deadline once
+	uint64_t deadline = SysTick_Get_Ticks() + ((uint64_t)delay_in_us * SYSTICK_TICKS_PER_US);
 	
-	// Set the ms_active global flag
-	ms_active = 0x01;
+	// Short settle times (e.g. every keypad scan) are not traced, they would fill the buffer
+	if (delay_in_us < SYSTICK_DELAY_TRACE_MIN_US)
+	{
+		while (SysTick_Get_Ticks() < deadline)
+		{
+			SYSTICK_DELAY_SPIN(deadline);
+		}
+		return;
+	}
+	
+	Trace_Begin(TRACE_ZONE_DELAY, (delay_in_us > 0xFFFF) ? 0xFFFF : (uint16_t)delay_in_us);
 	
-	// Wait until ms_elapsed reaches the specified delay_in_ms
-	while (delay_in_ms > ms_elapsed);
+	// Wait until the timebase reaches the deadline
+	while (SysTick_Get_Ticks() < deadline)
+	{
+		SYSTICK_DELAY_SPIN(deadline);
+	}
 	
-	// Reset the ms_active global flag
-	ms_active = 0x00;
+	Trace_End(TRACE_ZONE_DELAY);
+}
+
+void SysTick_Delay1ms(uint32_t delay_in_ms)
+{
+	SysTick_Delay1us(delay_in_ms * 1000U);
 }
 
 void SysTick_Handler(void)
 {
-	// Increment the global variable, us_elapsed
-	us_elapsed = us_elapsed + 1;
+	// Latency: the ticks counted since the wrap, converted to CPU cycles
+	uint32_t latency_ticks = SYSTICK_RELOAD - SysTick->VAL;
+	uint32_t start = Interrupts_Handler_Enter(IRQ_SOURCE_SYSTICK,
+		(latency_ticks * (SystemCoreClock / 1000000U)) / SYSTICK_TICKS_PER_US);
 	
-	// Check if us_elapsed has reached 1000 (1 millisecond) and if milliseconds delay is active
-	if (us_elapsed == 1000 && (ms_active == 0x01))
-	{
-		// Reset us_elapsed
-		us_elapsed = 0;
-		
-		// Increment ms_elapsed to indicate that 1 millisecond has passed
-		ms_elapsed = ms_elapsed + 1;
-	}
+	// Count the wrap of the 24-bit counter
+	systick_wraps = systick_wraps + 1;
+	
+	Trace_Mark(TRACE_ZONE_ISR, (uint16_t)systick_wraps);
+	
+	Interrupts_Handler_Exit(IRQ_SOURCE_SYSTICK, start);
 }
@@ -4,23 +4,41 @@
  * @brief Header file for the SysTick_Delay driver.
  *
  * It provides two blocking functions, SysTick_Delay1ms and SysTick_Delay1us,
- * to create a delay with a busy-wait loop. It uses the SysTick timer with 
- * a specified reload value to generate interrupts every 1 us.
+ * to create a delay with a busy-wait loop. The SysTick timer runs freely
+ * with its maximum reload value and serves as a 64-bit timebase; the
+ * SysTick interrupt only fires when the 24-bit counter wraps (~4.19 s).
  * 
  * In addition, it uses the Peripheral Internal Oscillator (PIOSC) 
  * as the clock source. The PIOSC provides 16 MHz which is then divided by 4. 
  * The timer is used for creating delays in either microseconds or milliseconds.
  *
+ * Every wait is expressed as a deadline on the timebase rather than a count
+ * of interrupts, so the cost of a delay does not depend on its length and a
+ * simulator can advance time straight to the deadline.
+ *
  * @author Aaron  Nanas
  */
  
 #include "TM4C123GH6PM.h"
 
+// SysTick ticks per microsecond (PIOSC / 4 = 4 MHz)
+#define SYSTICK_TICKS_PER_US    4U
+
+// Shortest delay recorded in the trace (TRACE_ZONE_DELAY)
+#define SYSTICK_DELAY_TRACE_MIN_US    100U
+
+// Called on each pass of a delay loop with its deadline (in ticks). Empty on
+// the target; the host simulator (tests/sim) defines it in its device header
+// to advance its virtual clock straight to the deadline.
+#ifndef SYSTICK_DELAY_SPIN
+#define SYSTICK_DELAY_SPIN(deadline_ticks)
+#endif
+
 /**
  * @brief The SysTick_Delay_Init function initializes the SysTick timer to be used for a blocking delay function.
  *
- * This function configures the SysTick timer and its interrupt with a specified reload value to 
- * generate interrupts every 1 us. It uses the Peripheral Internal Oscillator (PIOSC) as the clock source.
+ * This function configures the SysTick timer as a free-running counter with the maximum reload value
+ * and enables its wrap interrupt. It uses the Peripheral Internal Oscillator (PIOSC) as the clock source.
  * The PIOSC provides 16 MHz which is then divided by 4. The timer is used for creating delays in either 
  * microseconds or milliseconds.
  *
@@ -30,11 +48,32 @@
  */
 void SysTick_Delay_Init(void);
 
+/**
+ * @brief The SysTick_Get_Ticks function returns the number of SysTick ticks (0.25 us) since initialization.
+ *
+ * This function combines the wrap count kept by SysTick_Handler with the current value of the
+ * 24-bit counter. It can be called with interrupts masked.
+ *
+ * @param None
+ *
+ * @return uint64_t The elapsed time in SysTick ticks.
+ */
+uint64_t SysTick_Get_Ticks(void);
+
+/**
+ * @brief The SysTick_Get_Time_us function returns the time since initialization in microseconds.
+ *
+ * @param None
+ *
+ * @return uint64_t The elapsed time in microseconds.
+ */
+uint64_t SysTick_Get_Time_us(void);
+
 /**
  * @brief The SysTick_Delay1us function provides a blocking delay in microseconds using the SysTick timer.
  *
- * This function resets the global variable, us_elapsed, to zero and waits until us_elapsed reaches 
- * the specified delay_in_us.
+ * This function computes the deadline from the current time and waits until the timebase reaches it.
+ * Delays of SYSTICK_DELAY_TRACE_MIN_US or more are recorded in the trace.
  *
  * @param delay_in_us The delay time in microseconds.
  *
@@ -45,9 +84,7 @@ void SysTick_Delay1us(uint32_t delay_in_us);
 /**
  * @brief The SysTick_Delay1ms function provides a blocking delay in milliseconds using the SysTick timer.
  *
- * This function clears the global variables, us_elapsed and ms_elapsed, to zero and sets ms_active flag to 0x01 
- * indicating that milliseconds delay is active. It then waits until ms_elapsed reaches the specified delay_in_ms.
- * After the delay, it clears ms_active flag back to 0x00.
+ * This function waits for delay_in_ms * 1000 microseconds using SysTick_Delay1us.
  *
  * @param delay_in_ms The delay time in milliseconds.
  *
@@ -58,9 +95,8 @@ void SysTick_Delay1ms(uint32_t delay_in_ms);
 /**
  * @brief The SysTick_Handler function is the interrupt service routine for the SysTick timer.
  *
- * This function is called whenever the SysTick timer generates an interrupt. It increments the global variable
- * us_elapsed by 1, indicating that 1 microsecond has passed. Additionally, if us_elapsed reaches 1000 and ms_active
- * flag is set to 0x01, it resets us_elapsed and increments ms_elapsed by 1, indicating that 1 millisecond has passed.
+ * This function is called whenever the 24-bit SysTick counter wraps around. It increments
+ * the wrap count used by SysTick_Get_Ticks to extend the counter to 64 bits.
  *
  * @param None
  *
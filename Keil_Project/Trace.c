@@ -0,0 +1,89 @@
+/**
+ * @file Trace.c
+ *
+ * @brief Source code for the Trace module.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Trace.h"
+
+#ifndef TRACE_DISABLE
+
+#if (TRACE_BUFFER_SIZE & (TRACE_BUFFER_SIZE - 1)) != 0
+#error "TRACE_BUFFER_SIZE must be a power of two"
+#endif
+
+Trace_Record trace_buffer[TRACE_BUFFER_SIZE];
+
+// Total number of records written; the next one goes to trace_count % TRACE_BUFFER_SIZE
+volatile uint32_t trace_count = 0;
+
+volatile uint32_t trace_frozen = 0;
+
+// Bit n is set while zone n is open
+volatile uint32_t trace_open_zones = 0;
+
+void Trace_Init(void)
+{
+    trace_count = 0;
+    trace_frozen = 0;
+    trace_open_zones = 0;
+}
+
+void Trace_Freeze(void)
+{
+    trace_frozen = 1;
+}
+
+void Trace_Unfreeze(void)
+{
+    trace_frozen = 0;
+}
+
+uint8_t Trace_Is_Frozen(void)
+{
+    return (trace_frozen != 0);
+}
+
+// Index of the oldest record still in the buffer
+static uint32_t Trace_First(uint32_t count)
+{
+    return (count > TRACE_BUFFER_SIZE) ? (count - TRACE_BUFFER_SIZE) : 0;
+}
+
+static void Trace_Put_String(Trace_Put_Char_Fn put_char, const char *s)
+{
+    while (*s != '\0')
+    {
+        put_char(*s++);
+    }
+}
+
+static void Trace_Put_U32(Trace_Put_Char_Fn put_char, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        put_char((char)(value >> (8 * i)));
+    }
+}
+
+void Trace_Dump_Binary(Trace_Put_Char_Fn put_char)
+{
+    uint32_t count = trace_count;
+    uint32_t first = Trace_First(count);
+
+    Trace_Put_String(put_char, "TRC1");
+    Trace_Put_U32(put_char, SystemCoreClock);
+    Trace_Put_U32(put_char, count - first);
+
+    for (uint32_t i = first; i < count; i++)
+    {
+        const Trace_Record *record = &trace_buffer[i & (TRACE_BUFFER_SIZE - 1)];
+
+        Trace_Put_U32(put_char, record->timestamp);
+        Trace_Put_U32(put_char, record->event | ((uint32_t)record->payload << 16));
+    }
+}
+
+#endif // TRACE_DISABLE
@@ -0,0 +1,271 @@
+/**
+ * @file Trace.h
+ *
+ * @brief Header file for the Trace module.
+ *
+ * It is an always-on event trace: fixed-size binary records are written
+ * into a RAM ring buffer, which keeps the most recent TRACE_BUFFER_SIZE
+ * events. Each record holds a timestamp, an event ID, and a 16-bit payload
+ * (8 bytes in total). Events are recorded for keypad scans, debounce waits,
+ * SysTick delays, LCD commands and data writes (the byte is the payload),
+ * key handling (the key is the payload), calculator state transitions,
+ * computations, errors, the SysTick interrupt, and system clock changes
+ * (the new frequency in MHz is the payload).
+ *
+ * Recording is lock-free: a slot is reserved with an LDREX/STREX increment
+ * of the write index, so events can be recorded from the main loop and from
+ * interrupt handlers. The timestamp is the DWT cycle counter, so
+ * Cycle_Counter_Init must be called first. Since the cycle rate changes
+ * with the system clock, a reader converts timestamps to time using the
+ * clock change events. A record costs about a dozen
+ * cycles, which is small enough to leave tracing enabled in release builds.
+ *
+ * The buffer can be frozen (e.g. on an error) so that the events leading
+ * up to it are kept, and then dumped as raw records through a character
+ * callback, e.g. a UART transmit function (Trace_Dump_Binary). On the PC,
+ * tests/tools/trace2chrome converts a dump to Chrome trace-event JSON with
+ * one track per zone, which can be opened in chrome://tracing or
+ * https://ui.perfetto.dev.
+ *
+ * Binary dump format (little-endian):
+ *  - "TRC1"
+ *  - uint32_t: timestamp clock in Hz (SystemCoreClock)
+ *  - uint32_t: number of records that follow, oldest first
+ *  - records:  uint32_t timestamp, uint16_t event ID, uint16_t payload
+ *
+ * The event ID is TRACE_EVENT_ID(zone, phase).
+ *
+ * The zones currently open in the main loop are also kept as a bit mask
+ * (Trace_Open_Zones), which the watchdog uses to attribute a stall.
+ *
+ * Tracing can be compiled out by defining TRACE_DISABLE.
+ *
+ * @note Idle keypad scans (no key pressed) are not recorded, since the
+ * main loop polls the keypad continuously and would fill the buffer.
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include "TM4C123GH6PM.h"
+#include "Atomic.h"
+#include <stdint.h>
+
+// Number of records kept in the buffer (8 bytes each), must be a power of two
+#define TRACE_BUFFER_SIZE       1024
+
+// The trace converter (tests/tools/Trace_Chrome.c) names the zones in this order
+typedef enum {
+    TRACE_ZONE_KEYPAD_SCAN,
+    TRACE_ZONE_DEBOUNCE,
+    TRACE_ZONE_LCD_COMMAND,
+    TRACE_ZONE_LCD_DATA,
+    TRACE_ZONE_KEY,
+    TRACE_ZONE_COMPUTE,
+    TRACE_ZONE_ISR,
+    TRACE_ZONE_DELAY,
+    TRACE_ZONE_STATE,
+    TRACE_ZONE_ERROR,
+    TRACE_ZONE_CLOCK,
+    TRACE_ZONE_COUNT
+} Trace_Zone;
+
+typedef enum {
+    TRACE_PHASE_BEGIN = 1,
+    TRACE_PHASE_END = 2,
+    TRACE_PHASE_MARK = 3
+} Trace_Phase;
+
+#define TRACE_EVENT_ID(zone, phase)     ((uint16_t)(((phase) << 8) | (zone)))
+
+typedef struct {
+    uint32_t timestamp;
+    uint16_t event;
+    uint16_t payload;
+} Trace_Record;
+
+typedef void (*Trace_Put_Char_Fn)(char c);
+
+#ifndef TRACE_DISABLE
+
+// Ring buffer state, written by the inline functions below
+extern Trace_Record trace_buffer[TRACE_BUFFER_SIZE];
+extern volatile uint32_t trace_count;
+extern volatile uint32_t trace_frozen;
+extern volatile uint32_t trace_open_zones;
+
+/**
+ * @brief Write a record into the ring buffer.
+ *
+ * @param event     The event ID.
+ * @param payload   The payload.
+ * @param timestamp The timestamp.
+ *
+ * @return None
+ */
+static inline void Trace_Write(uint16_t event, uint16_t payload, uint32_t timestamp)
+{
+    if (trace_frozen)
+    {
+        return;
+    }
+
+    // Reserve a slot
+    uint32_t index = Atomic_Fetch_Add(&trace_count, 1);
+
+    Trace_Record *record = &trace_buffer[index & (TRACE_BUFFER_SIZE - 1)];
+    record->timestamp = timestamp;
+    record->event = event;
+    record->payload = payload;
+}
+
+/**
+ * @brief Get the current trace timestamp.
+ *
+ * @param None
+ *
+ * @return uint32_t The DWT cycle count.
+ */
+static inline uint32_t Trace_Timestamp(void)
+{
+    return DWT->CYCCNT;
+}
+
+/**
+ * @brief Record the beginning of a zone.
+ *
+ * @param zone    The zone.
+ * @param payload The payload (e.g. the LCD byte or the key).
+ *
+ * @return None
+ */
+static inline void Trace_Begin(Trace_Zone zone, uint16_t payload)
+{
+    trace_open_zones |= (1U << zone);
+    Trace_Write(TRACE_EVENT_ID(zone, TRACE_PHASE_BEGIN), payload, Trace_Timestamp());
+}
+
+/**
+ * @brief Record the beginning of a zone at an earlier timestamp.
+ *
+ * Used when it is only known afterwards that a zone is worth recording.
+ *
+ * @param zone      The zone.
+ * @param timestamp The timestamp returned by Trace_Timestamp when the zone began.
+ * @param payload   The payload.
+ *
+ * @return None
+ */
+static inline void Trace_Begin_At(Trace_Zone zone, uint32_t timestamp, uint16_t payload)
+{
+    trace_open_zones |= (1U << zone);
+    Trace_Write(TRACE_EVENT_ID(zone, TRACE_PHASE_BEGIN), payload, timestamp);
+}
+
+/**
+ * @brief Record the end of a zone.
+ *
+ * @param zone The zone.
+ *
+ * @return None
+ */
+static inline void Trace_End(Trace_Zone zone)
+{
+    trace_open_zones &= ~(1U << zone);
+    Trace_Write(TRACE_EVENT_ID(zone, TRACE_PHASE_END), 0, Trace_Timestamp());
+}
+
+/**
+ * @brief Record an instant event, e.g. an interrupt or a state transition.
+ *
+ * @param zone    The zone.
+ * @param payload The payload.
+ *
+ * @return None
+ */
+static inline void Trace_Mark(Trace_Zone zone, uint16_t payload)
+{
+    Trace_Write(TRACE_EVENT_ID(zone, TRACE_PHASE_MARK), payload, Trace_Timestamp());
+}
+
+/**
+ * @brief Get the zones that are currently open.
+ *
+ * Zones are only opened and closed by the main loop (interrupt handlers
+ * record instant events), so the mask needs no atomic update.
+ *
+ * @param None
+ *
+ * @return uint32_t A bit mask with bit n set if zone n is open.
+ */
+static inline uint32_t Trace_Open_Zones(void)
+{
+    return trace_open_zones;
+}
+
+/**
+ * @brief Clear the trace buffer and resume recording.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Trace_Init(void);
+
+/**
+ * @brief Stop recording, keeping the events currently in the buffer.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Trace_Freeze(void);
+
+/**
+ * @brief Resume recording after Trace_Freeze.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Trace_Unfreeze(void);
+
+/**
+ * @brief Check whether the trace is frozen.
+ *
+ * @param None
+ *
+ * @return uint8_t 1 if frozen, 0 otherwise.
+ */
+uint8_t Trace_Is_Frozen(void);
+
+/**
+ * @brief Write the buffer as raw binary records (see the format above).
+ *
+ * The trace should be frozen while it is dumped.
+ *
+ * @param put_char Called for each output byte.
+ *
+ * @return None
+ */
+void Trace_Dump_Binary(Trace_Put_Char_Fn put_char);
+
+#else
+
+static inline uint32_t Trace_Timestamp(void) { return 0; }
+static inline void Trace_Begin(Trace_Zone zone, uint16_t payload) { (void)zone; (void)payload; }
+static inline void Trace_Begin_At(Trace_Zone zone, uint32_t timestamp, uint16_t payload) { (void)zone; (void)timestamp; (void)payload; }
+static inline void Trace_End(Trace_Zone zone) { (void)zone; }
+static inline void Trace_Mark(Trace_Zone zone, uint16_t payload) { (void)zone; (void)payload; }
+static inline uint32_t Trace_Open_Zones(void) { return 0; }
+static inline void Trace_Init(void) {}
+static inline void Trace_Freeze(void) {}
+static inline void Trace_Unfreeze(void) {}
+static inline uint8_t Trace_Is_Frozen(void) { return 0; }
+static inline void Trace_Dump_Binary(Trace_Put_Char_Fn put_char) { (void)put_char; }
+
+#endif // TRACE_DISABLE
+
+#endif // TRACE_H_
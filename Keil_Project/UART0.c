@@ -0,0 +1,90 @@
+/**
+ * @file UART0.c
+ *
+ * @brief Source code for the UART0 driver.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "UART0.h"
+
+// UARTFR: Transmit FIFO Full, UART Busy
+#define UART0_FR_TXFF           0x20
+#define UART0_FR_BUSY           0x08
+
+// 8-bit word length (WLEN = 0x3), enable the FIFOs (FEN),
+// no parity, and one stop bit
+#define UART0_LCRH_8N1_FIFO     0x70
+
+static void UART0_Set_Baud_Rate(void)
+{
+    // Baud rate divisor = SystemCoreClock / (16 * baud rate), in 1/64 units
+    // e.g. 50 MHz: 27.1267 -> IBRD = 27, FBRD = round(0.1267 * 64) = 8
+    uint32_t divisor_64 = ((SystemCoreClock * 8U) / UART0_BAUD_RATE + 1U) / 2U;
+
+    UART0->IBRD = divisor_64 >> 6;
+    UART0->FBRD = divisor_64 & 0x3F;
+
+    // The new divisor takes effect when LCRH is written
+    UART0->LCRH = UART0_LCRH_8N1_FIFO;
+}
+
+void UART0_Init(void)
+{
+    // Enable the clock to UART0 by setting the
+    // R0 bit (Bit 0) in the RCGCUART register
+    SYSCTL->RCGCUART |= 0x01;
+
+    // Enable the clock to Port A by setting the
+    // R0 bit (Bit 0) in the RCGCGPIO register
+    SYSCTL->RCGCGPIO |= 0x01;
+
+    // Wait until UART0 is ready
+    while ((SYSCTL->PRUART & 0x01) == 0);
+
+    // Disable UART0 while it is being configured
+    UART0->CTL &= ~0x01;
+
+    UART0_Set_Baud_Rate();
+
+    // Use the system clock as the UART clock source
+    UART0->CC = 0x0;
+
+    // Enable UART0 (UARTEN), the transmitter (TXE), and the receiver (RXE)
+    UART0->CTL |= 0x301;
+
+    // Configure PA0 and PA1 to use their alternate function (U0RX and U0TX)
+    GPIOA->AFSEL |= 0x03;
+    GPIOA->PCTL = (GPIOA->PCTL & ~0x000000FF) | 0x00000011;
+
+    // Enable the digital functionality for the PA0 and PA1 pins
+    GPIOA->DEN |= 0x03;
+
+    // Disable the analog functionality for the PA0 and PA1 pins
+    GPIOA->AMSEL &= ~0x03;
+}
+
+void UART0_Update_Clock(void)
+{
+    // Let the transmitter finish, then change the divisor while disabled
+    while ((UART0->FR & UART0_FR_BUSY) != 0);
+
+    UART0->CTL &= ~0x01;
+    UART0_Set_Baud_Rate();
+    UART0->CTL |= 0x01;
+}
+
+void UART0_Output_Character(char data)
+{
+    // Wait until there is room in the transmit FIFO
+    while ((UART0->FR & UART0_FR_TXFF) != 0);
+    UART0->DR = data;
+}
+
+void UART0_Output_String(const char *string)
+{
+    while (*string != '\0')
+    {
+        UART0_Output_Character(*string++);
+    }
+}
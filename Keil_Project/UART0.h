@@ -0,0 +1,71 @@
+/**
+ * @file UART0.h
+ *
+ * @brief Header file for the UART0 driver.
+ *
+ * This file contains the function definitions for the UART0 driver.
+ * UART0 is connected to the debug USB port of the TM4C123G LaunchPad
+ * (virtual COM port), so its output can be captured on a PC.
+ * The following pins are used:
+ *  - UART0 RX (PA0)
+ *  - UART0 TX (PA1)
+ *
+ * The driver uses 115200 baud, 8 data bits, no parity, and 1 stop bit.
+ * The baud rate divisor is computed from SystemCoreClock, and it must be
+ * recomputed with UART0_Update_Clock when the system clock changes.
+ *
+ * @note For more information regarding the UART module, refer to the
+ * Universal Asynchronous Receivers / Transmitters (UARTs) section
+ * of the TM4C123GH6PM Microcontroller Datasheet.
+ * Link: https://www.ti.com/lit/ds/symlink/tm4c123gh6pm.pdf
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef UART0_H_
+#define UART0_H_
+
+#include "TM4C123GH6PM.h"
+#include <stdint.h>
+
+#define UART0_BAUD_RATE     115200U
+
+/**
+ * @brief Initialize UART0 (PA0, PA1) for 115200 baud, 8-N-1.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void UART0_Init(void);
+
+/**
+ * @brief Recompute the baud rate divisor after a change of the system clock.
+ *
+ * Waits until the characters already in the transmit FIFO have been sent.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void UART0_Update_Clock(void);
+
+/**
+ * @brief Transmit one character, waiting until the transmit FIFO has room.
+ *
+ * @param data The character to transmit.
+ *
+ * @return None
+ */
+void UART0_Output_Character(char data);
+
+/**
+ * @brief Transmit a null-terminated string.
+ *
+ * @param string The string to transmit.
+ *
+ * @return None
+ */
+void UART0_Output_String(const char *string);
+
+#endif // UART0_H_
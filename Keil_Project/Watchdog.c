@@ -0,0 +1,168 @@
+/**
+ * @file Watchdog.c
+ *
+ * @brief Source code for the Watchdog driver.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Watchdog.h"
+#include "Interrupts.h"
+#include <string.h>
+
+// Marks a record that was written by this firmware (and not random SRAM contents)
+#define WATCHDOG_RECORD_MAGIC       0x57444F47U
+
+// Unlock value for the WDTLOCK register
+#define WATCHDOG_UNLOCK             0x1ACCE551U
+
+// RESC: Watchdog Timer 0 reset
+#define RESC_WDT0                   0x08
+
+// Exception stack frame: R0, R1, R2, R3, R12, LR, PC, xPSR
+#define FRAME_LR        5
+#define FRAME_PC        6
+
+_Static_assert(sizeof(Watchdog_Record) <= WATCHDOG_RECORD_SIZE, "The watchdog record does not fit its reserved area");
+
+static Watchdog_Record *const watchdog_record = (Watchdog_Record *)WATCHDOG_RECORD_ADDRESS;
+
+static volatile uint32_t watchdog_state = 0;
+static uint32_t watchdog_budget_ms = WATCHDOG_BUDGET_MS;
+static uint8_t watchdog_reset = 0;
+static uint8_t watchdog_started = 0;
+
+void Watchdog_Early_Warning(const uint32_t *frame);
+
+static uint32_t Watchdog_Reload_Value(void)
+{
+    return (SystemCoreClock / 1000U) * watchdog_budget_ms;
+}
+
+void Watchdog_Init(uint32_t budget_ms)
+{
+    watchdog_budget_ms = budget_ms;
+
+    // The record is not initialized by the startup code
+    if (watchdog_record->magic != WATCHDOG_RECORD_MAGIC)
+    {
+        memset(watchdog_record, 0, sizeof(*watchdog_record));
+        watchdog_record->magic = WATCHDOG_RECORD_MAGIC;
+    }
+
+    // Count a reset caused by the watchdog, then clear the cause
+    watchdog_reset = ((SYSCTL->RESC & RESC_WDT0) != 0);
+    if (watchdog_reset)
+    {
+        watchdog_record->resets++;
+        SYSCTL->RESC &= ~RESC_WDT0;
+    }
+
+    // Enable the clock to Watchdog Timer 0 by setting the
+    // R0 bit (Bit 0) in the RCGCWD register
+    SYSCTL->RCGCWD |= 0x01;
+    while ((SYSCTL->PRWD & 0x01) == 0);
+
+    WATCHDOG0->LOCK = WATCHDOG_UNLOCK;
+    WATCHDOG0->LOAD = Watchdog_Reload_Value();
+
+    // Stop the watchdog while the debugger halts the CPU (STALL)
+    WATCHDOG0->TEST |= 0x100;
+
+    NVIC_SetPriority(WATCHDOG0_IRQn, IRQ_PRIORITY_WATCHDOG);
+    NVIC_EnableIRQ(WATCHDOG0_IRQn);
+
+    // Enable the reset on the second time-out (RESEN) and the
+    // standard (not NMI) interrupt on the first one (INTEN).
+    // INTEN cannot be cleared again until the next reset.
+    WATCHDOG0->CTL |= 0x03;
+
+    // The registers are left unlocked so that Watchdog_Feed can clear the interrupt
+    watchdog_started = 1;
+}
+
+void Watchdog_Feed(void)
+{
+    if (!watchdog_started)
+    {
+        return;
+    }
+
+    // Writing ICR clears the early warning and reloads the counter
+    WATCHDOG0->ICR = 0x01;
+    NVIC_EnableIRQ(WATCHDOG0_IRQn);
+}
+
+void Watchdog_Set_State(uint32_t state)
+{
+    watchdog_state = state;
+}
+
+void Watchdog_Update_Clock(void)
+{
+    if (!watchdog_started)
+    {
+        return;
+    }
+
+    WATCHDOG0->LOAD = Watchdog_Reload_Value();
+}
+
+const Watchdog_Record *Watchdog_Get_Record(void)
+{
+    return watchdog_record;
+}
+
+uint8_t Watchdog_Caused_Reset(void)
+{
+    return watchdog_reset;
+}
+
+// Called from WDT0_Handler with the stacked exception frame
+void Watchdog_Early_Warning(const uint32_t *frame)
+{
+    uint32_t start = Interrupts_Handler_Enter(IRQ_SOURCE_WATCHDOG, 0);
+    uint32_t open_zones = Trace_Open_Zones();
+
+    watchdog_record->pc = frame[FRAME_PC];
+    watchdog_record->lr = frame[FRAME_LR];
+    watchdog_record->state = watchdog_state;
+    watchdog_record->open_zones = open_zones;
+    watchdog_record->overruns++;
+
+    for (uint32_t zone = 0; zone < TRACE_ZONE_COUNT; zone++)
+    {
+        if (open_zones & (1U << zone))
+        {
+            watchdog_record->zone_overruns[zone]++;
+        }
+    }
+
+    Trace_Mark(TRACE_ZONE_ERROR, WATCHDOG_TRACE_PAYLOAD);
+    Trace_Freeze();
+
+    // The interrupt stays asserted until the next feed, so mask it to let
+    // the main loop run; the second time-out resets the MCU if it is stuck
+    NVIC_DisableIRQ(WATCHDOG0_IRQn);
+
+    Interrupts_Handler_Exit(IRQ_SOURCE_WATCHDOG, start);
+}
+
+// Not built for the host simulator (tests/sim), which has no exception
+// frames and does not model the time-out
+#if defined(__arm__)
+
+// Passes the stack pointer that holds the exception frame (MSP or PSP,
+// selected by bit 2 of EXC_RETURN) to Watchdog_Early_Warning
+__attribute__((naked)) void WDT0_Handler(void)
+{
+    __asm volatile(
+        "tst    lr, #4                  \n"
+        "ite    eq                      \n"
+        "mrseq  r0, msp                 \n"
+        "mrsne  r0, psp                 \n"
+        "b      Watchdog_Early_Warning  \n"
+    );
+}
+
+#endif // __arm__
@@ -0,0 +1,123 @@
+/**
+ * @file Watchdog.h
+ *
+ * @brief Header file for the Watchdog driver.
+ *
+ * It uses Watchdog Timer 0 as a stall monitor with a latency budget.
+ * The main loop feeds the watchdog while it waits for a key and after it
+ * has handled one, so the budget (WATCHDOG_BUDGET_MS) applies to the
+ * handling of every event, including the LCD updates and the UART dumps.
+ *
+ * The watchdog times out twice before it resets the MCU:
+ *  - First time-out (early warning): the interrupt handler records where
+ *    the firmware was: the interrupted PC and LR, the calculator state
+ *    reported by main.c, and the trace zones that were open (e.g. Key
+ *    handling + LCD data + Delay). It counts a budget overrun for each
+ *    open zone and freezes the trace, so that the events leading up to
+ *    the stall are kept. It then masks its interrupt so the main loop can
+ *    continue, since a slow path may still finish.
+ *  - Second time-out: if the main loop has not fed the watchdog by then,
+ *    it is stuck and the watchdog resets the MCU.
+ *
+ * The record is kept in a no-initialization area at the top of SRAM
+ * (WATCHDOG_RECORD_ADDRESS), which the scatter file reserves outside the
+ * linker's RAM region (Memory_Map.h), so it survives the reset and can be
+ * read after the next start (Watchdog_Get_Record).
+ *
+ * The watchdog stops counting while the debugger halts the CPU.
+ *
+ * @note For more information regarding the watchdog timers, refer to the
+ * Watchdog Timers section of the TM4C123GH6PM Microcontroller Datasheet.
+ * Link: https://www.ti.com/lit/ds/symlink/tm4c123gh6pm.pdf
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef WATCHDOG_H_
+#define WATCHDOG_H_
+
+#include "TM4C123GH6PM.h"
+#include "Memory_Map.h"
+#include "Trace.h"
+#include <stdint.h>
+
+// Time allowed between two feeds before the early warning
+#define WATCHDOG_BUDGET_MS          1000
+
+// No-initialization area (the last 256 bytes of SRAM)
+#define WATCHDOG_RECORD_ADDRESS     MEMORY_NOINIT_BASE
+#define WATCHDOG_RECORD_SIZE        MEMORY_NOINIT_SIZE
+
+// Payload of the trace error event recorded by the early warning
+#define WATCHDOG_TRACE_PAYLOAD      0xFFFF
+
+typedef struct {
+    uint32_t magic;
+    uint32_t resets;
+    uint32_t overruns;
+    uint32_t zone_overruns[TRACE_ZONE_COUNT];
+
+    // Last early warning
+    uint32_t pc;
+    uint32_t lr;
+    uint32_t state;
+    uint32_t open_zones;
+} Watchdog_Record;
+
+/**
+ * @brief Start Watchdog Timer 0 with the given budget.
+ *
+ * If the previous reset was caused by the watchdog, it is counted in the record.
+ *
+ * @param budget_ms The time allowed between two feeds, in milliseconds.
+ *
+ * @return None
+ */
+void Watchdog_Init(uint32_t budget_ms);
+
+/**
+ * @brief Feed the watchdog (software heartbeat) and re-arm the early warning.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Watchdog_Feed(void);
+
+/**
+ * @brief Set the main loop state recorded by the early warning.
+ *
+ * @param state The state (e.g. a CalcState value).
+ *
+ * @return None
+ */
+void Watchdog_Set_State(uint32_t state);
+
+/**
+ * @brief Recompute the reload value after a change of the system clock.
+ *
+ * @param None
+ *
+ * @return None
+ */
+void Watchdog_Update_Clock(void);
+
+/**
+ * @brief Get the stall record, which survives a watchdog reset.
+ *
+ * @param None
+ *
+ * @return const Watchdog_Record* The record.
+ */
+const Watchdog_Record *Watchdog_Get_Record(void);
+
+/**
+ * @brief Check whether the last reset was caused by the watchdog.
+ *
+ * @param None
+ *
+ * @return uint8_t 1 if the watchdog reset the MCU, 0 otherwise.
+ */
+uint8_t Watchdog_Caused_Reset(void);
+
+#endif // WATCHDOG_H_
@@ -13,14 +13,33 @@
  *  - STATE_ENTER_SECOND: User enters the second operand
  *  - STATE_SHOW_RESULT:  Final result displayed, supports chaining
  *
- * Decimal input is supported using string accumulation and floating-point
- * conversion via strtod(). The SysTick timer is used for keypad debounce
- * timing and LCD command delays.
+ * Operands are held by the Calc_Number engine, which keeps integral values
+ * as 64-bit integers and promotes to floating point only on decimal input,
+ * inexact division, or overflow. The SysTick timer is used for keypad
+ * debounce timing and LCD command delays.
  *
  * The program makes use of:
  *  - Keypad driver (Keypad.c/Keypad.h)
- *  - LCD driver (EduBase_LCD.c/EduBase_LCD.h)
+ *  - Keypad scan governor (Keypad_Scan.c/Keypad_Scan.h), adaptive rate with interrupt wake
+ *  - LCD driver (EduBase_LCD.c/EduBase_LCD.h), drawn through a framebuffer (LCD_Frame.c/LCD_Frame.h)
+ *  - Undo history (Snapshot.c/Snapshot.h), hold '-' to undo a key, hold '+' to redo it
+ *  - Expression editor (Calc_Editor.c/Calc_Editor.h, Calc_Expr.c/Calc_Expr.h), hold '*' to edit the calculation
+ *  - Integration mode (Calc_Integrate.c/Calc_Integrate.h), hold '/', for functions of x (Calc_Func.c/Calc_Func.h)
+ *  - Polynomial mode (Calc_Poly.c/Calc_Poly.h), hold '.', finds the roots of a polynomial
  *  - SysTick delay driver (SysTick_Delay.c/SysTick_Delay.h)
+ *  - Numeric engine (Calc_Number.c/Calc_Number.h)
+ *  - Error detection (Calc_Error.c/Calc_Error.h)
+ *  - Engine memory pools (Calc_Memory.c/Calc_Memory.h, Arena.c/Arena.h), released at each new calculation
+ *  - Cycle counter (Cycle_Counter.c/Cycle_Counter.h)
+ *  - Interrupt priority plan (Interrupts.c/Interrupts.h)
+ *  - Stall monitor (Watchdog.c/Watchdog.h)
+ *  - Clock governor (Clock_Governor.c/Clock_Governor.h), 16 MHz idle, 80 MHz per key
+ *  - Calculation journal (Journal.c/Journal.h) in the spare flash (Flash.c/Flash.h)
+ *  - Settings menu (Settings.c/Settings.h), hold '=' to tune the timing, stored in the EEPROM (EEPROM.c/EEPROM.h)
+ *  - Session replay (Session_Replay.c/Session_Replay.h), when SESSION_REPLAY is defined
+ *  - Event trace (Trace.c/Trace.h), dumped over UART0 (UART0.c/UART0.h) on an error
+ *  - PC-sampling profiler (Profiler.c/Profiler.h), when PROFILER_ENABLE is defined
+ *  - Binary log (Log.c/Log.h), flushed over UART0 after each key
  *
  * This file contains the main control loop, calculator logic, and
  * all display output routines required for the final ECE 425 project.
@@ -32,18 +51,43 @@
 #include "TM4C123GH6PM.h"
 #include "SysTick_Delay.h"
 #include "EduBase_LCD.h"
+#include "LCD_Frame.h"
 #include "Keypad.h"
+#include "Keypad_Scan.h"
+#include "Calc_Number.h"
+#include "Calc_Error.h"
+#include "Calc_Memory.h"
+#include "Calc_Expr.h"
+#include "Calc_Editor.h"
+#include "Calc_Integrate.h"
+#include "Calc_Poly.h"
+#include "Cycle_Counter.h"
+#include "Interrupts.h"
+#include "Watchdog.h"
+#include "Clock_Governor.h"
+#include "Settings.h"
+#include "Journal.h"
+#include "Snapshot.h"
+#include "Session_Replay.h"
+#include "Trace.h"
+#include "UART0.h"
+#include "Profiler.h"
+#include "Log.h"
 #include <stdint.h>
 #include <string.h>
 #include <stdio.h>
-#include <stdlib.h>   // for strtod
 
-// Short LCD names
+// Short LCD names. The display routines draw into the framebuffer, and
+// only the cells that changed are sent to the LCD (see LCD_Frame.h)
+#undef LCD_Clear
+#undef LCD_SetCursor
+#undef LCD_Print
 #define LCD_Init        EduBase_LCD_Init
-#define LCD_Clear       EduBase_LCD_Clear_Display
-#define LCD_SetCursor   EduBase_LCD_Set_Cursor
-#define LCD_Print       EduBase_LCD_Display_String
-#define LCD_SendChar    EduBase_LCD_Send_Data
+#define LCD_Clear       LCD_Frame_Clear
+#define LCD_SetCursor   LCD_Frame_Set_Cursor
+#define LCD_Print       LCD_Frame_Print
+#define LCD_SendChar    LCD_Frame_Put_Char
+#define LCD_Flush       LCD_Frame_Flush
 
 typedef enum {
     STATE_ENTER_FIRST,
@@ -51,17 +95,46 @@ typedef enum {
     STATE_SHOW_RESULT
 } CalcState;
 
-// Print a double compactly (fits within 16 chars)
-static void LCD_PrintDoubleCompact(double x)
+// Complete calculator state
+typedef struct {
+    CalcState state;
+    Calc_Number op1;
+    Calc_Number op2;
+    Calc_Number result;
+    char current_op;
+
+    // 16 chars max for LCD line, plus null terminator
+    char entry[17];
+} CalcContext;
+
+// One step of the undo history: the state after a key, and what it showed
+typedef struct {
+    CalcContext calc;
+    LCD_Frame frame;
+} CalcSnapshot;
+
+// Snapshots in the history (the last UNDO_DEPTH - 2 keys can be undone)
+#define UNDO_DEPTH          16
+
+// Holding '-' or '+' this long undoes or redoes a key instead
+#define UNDO_HOLD_US        1000000U
+
+static CalcSnapshot history_storage[UNDO_DEPTH];
+static Snapshot_Ring history;
+
+static const Calc_Number zero = { CALC_NUMBER_INT, { .i = 0 } };
+
+// Print a number compactly (fits within 16 chars)
+static void LCD_PrintNumberCompact(Calc_Number x)
 {
     char buf[17];
-    // Up to 10 significant digits, total length <= 16
-    snprintf(buf, sizeof(buf), "%.10g", x);
+    // Exact integers, otherwise up to 10 significant digits, total length <= 16
+    Calc_Number_Format(x, buf, sizeof(buf));
     LCD_Print((char*)buf);
 }
 
 // Show expression on the top line, e.g. "1.2+3.7="
-static void update_expression_display(double op1, char op, double op2,
+static void update_expression_display(Calc_Number op1, char op, Calc_Number op2,
                                       uint8_t show_second, uint8_t show_equal)
 {
     char buf[17];
@@ -70,7 +143,7 @@ static void update_expression_display(double op1, char op, double op2,
     buf[0] = '\0';
 
     // op1
-    snprintf(buf, sizeof(buf), "%.10g", op1);
+    Calc_Number_Format(op1, buf, sizeof(buf));
 
     // operator
     if (op != 0)
@@ -86,7 +159,7 @@ static void update_expression_display(double op1, char op, double op2,
     // op2
     if (show_second)
     {
-        snprintf(temp, sizeof(temp), "%.10g", op2);
+        Calc_Number_Format(op2, temp, sizeof(temp));
         if (strlen(buf) + strlen(temp) < sizeof(buf))
         {
             strcat(buf, temp);
@@ -134,201 +207,644 @@ static void update_entry_display(const char *entry)
     LCD_Print((char*)entry);
 }
 
-int main(void)
+// Reset the calculator to its initial state
+static void calc_reset(CalcContext *calc)
 {
-    SysTick_Delay_Init();
-    LCD_Init();
-    Keypad_Init();
-
-    CalcState state = STATE_ENTER_FIRST;
+    calc->state = STATE_ENTER_FIRST;
+    calc->op1 = zero;
+    calc->op2 = zero;
+    calc->result = zero;
+    calc->current_op = 0;
+    Calc_Memory_Reset();
+
+    start_new_calculation(calc->entry, sizeof(calc->entry));
+    LCD_Flush();
+    Watchdog_Set_State(calc->state);
+}
 
-    double op1 = 0.0;
-    double op2 = 0.0;
-    double result = 0.0;
-    char current_op = 0;
+// Write the calculation in progress as an expression, e.g. "12+34"
+static void calc_format_expression(const CalcContext *calc, char *text)
+{
+    char number[18];        // 16 characters, the operator and the terminator
 
-    // 16 chars max for LCD line, plus null terminator
-    char entry[17] = {0};
+    text[0] = '\0';
 
-    start_new_calculation(entry, sizeof(entry));
+    if (calc->state == STATE_ENTER_SECOND)
+    {
+        Calc_Number_Format(calc->op1, number, sizeof(number) - 1);
 
-    while (1)
+        // Numbers in exponent form cannot be edited, start from the entry then
+        if (strchr(number, 'e') == NULL)
+        {
+            size_t len = strlen(number);
+            number[len] = calc->current_op;
+            number[len + 1] = '\0';
+            strcpy(text, number);
+        }
+        strcat(text, calc->entry);
+    }
+    else if (calc->state == STATE_SHOW_RESULT)
     {
-        char key = Keypad_WaitForChar();
+        Calc_Number_Format(calc->result, number, sizeof(number));
+        if (strchr(number, 'e') == NULL)
+        {
+            strcpy(text, number);
+        }
+    }
+    else
+    {
+        strcpy(text, calc->entry);
+    }
+}
+
+// Show the value of an expression from the editor, as a result to chain from
+static void calc_show_expression(CalcContext *calc, const char *text, Calc_Number value)
+{
+    size_t len = strlen(text);
+
+    calc->state = STATE_SHOW_RESULT;
+    calc->op1 = zero;
+    calc->op2 = zero;
+    calc->result = value;
+    calc->current_op = 0;
+    memset(calc->entry, 0, sizeof(calc->entry));
 
-        if (state == STATE_ENTER_FIRST)
+    // Top line: the end of the expression and '='
+    LCD_Clear();
+    LCD_SetCursor(0, 0);
+    LCD_Print((len > 15) ? &text[len - 15] : text);
+    LCD_SendChar('=');
+
+    LCD_SetCursor(0, 1);
+    LCD_PrintNumberCompact(value);
+    LCD_Flush();
+
+    Trace_Mark(TRACE_ZONE_STATE, (uint16_t)calc->state);
+    Watchdog_Set_State(calc->state);
+}
+
+// Handle one keystroke
+static void handle_key(CalcContext *calc, char key)
+{
+    CalcState previous_state = calc->state;
+
+    if (calc->state == STATE_ENTER_FIRST)
+    {
+        if ((key >= '0' && key <= '9') || key == '.')
         {
-            if ((key >= '0' && key <= '9') || key == '.')
+            // Only allow one '.' in the number
+            if (key == '.' && strchr(calc->entry, '.') != NULL)
+            {
+                // ignore extra '.'
+            }
+            else
             {
-                // Only allow one '.' in the number
-                if (key == '.' && strchr(entry, '.') != NULL)
+                // Handle leading zero (replace "0" with first digit/point)
+                if (strcmp(calc->entry, "0") == 0 && key != '.')
                 {
-                    // ignore extra '.'
+                    calc->entry[0] = '\0';
                 }
-                else
+
+                size_t len = strlen(calc->entry);
+                if (len < sizeof(calc->entry) - 1)   // limit to 16 chars
                 {
-                    // Handle leading zero (replace "0" with first digit/point)
-                    if (strcmp(entry, "0") == 0 && key != '.')
-                    {
-                        entry[0] = '\0';
-                    }
-
-                    size_t len = strlen(entry);
-                    if (len < sizeof(entry) - 1)   // limit to 16 chars
-                    {
-                        entry[len] = key;
-                        entry[len + 1] = '\0';
-                    }
+                    calc->entry[len] = key;
+                    calc->entry[len + 1] = '\0';
                 }
-
-                update_entry_display(entry);
-            }
-            else if (key == '+' || key == '-' || key == '*' || key == '/')
-            {
-                // Convert entry to first operand (may have decimal)
-                op1 = strtod(entry, NULL);
-                current_op = key;
-                state = STATE_ENTER_SECOND;
-
-                // Show "op1 op" on top
-                update_expression_display(op1, current_op, 0.0, 0, 0);
-
-                // Prepare entry for second operand
-                memset(entry, 0, sizeof(entry));
-                entry[0] = '0';
-                entry[1] = '\0';
-                update_entry_display(entry);
-            }
-            else if (key == '=')
-            {
-                // '=' pressed without operator: just show entry as result
-                op1 = strtod(entry, NULL);
-                result = op1;
-                state = STATE_SHOW_RESULT;
-                current_op = 0;
-
-                // Clear and show result only (no "Result:" text)
-                LCD_Clear();
-                LCD_SetCursor(0, 1);
-                LCD_PrintDoubleCompact(result);
             }
+
+            update_entry_display(calc->entry);
+        }
+        else if (key == '+' || key == '-' || key == '*' || key == '/')
+        {
+            // Convert entry to first operand (may have decimal)
+            calc->op1 = Calc_Number_Parse(calc->entry);
+            calc->current_op = key;
+            calc->state = STATE_ENTER_SECOND;
+
+            // Show "op1 op" on top
+            update_expression_display(calc->op1, calc->current_op, zero, 0, 0);
+
+            // Prepare entry for second operand
+            memset(calc->entry, 0, sizeof(calc->entry));
+            calc->entry[0] = '0';
+            calc->entry[1] = '\0';
+            update_entry_display(calc->entry);
         }
-        else if (state == STATE_ENTER_SECOND)
+        else if (key == '=')
         {
-            if ((key >= '0' && key <= '9') || key == '.')
+            // '=' pressed without operator: just show entry as result
+            calc->op1 = Calc_Number_Parse(calc->entry);
+            calc->result = calc->op1;
+            calc->state = STATE_SHOW_RESULT;
+            calc->current_op = 0;
+
+            // Clear and show result only (no "Result:" text)
+            LCD_Clear();
+            LCD_SetCursor(0, 1);
+            LCD_PrintNumberCompact(calc->result);
+        }
+    }
+    else if (calc->state == STATE_ENTER_SECOND)
+    {
+        if ((key >= '0' && key <= '9') || key == '.')
+        {
+            // Only one '.' allowed in second operand
+            if (key == '.' && strchr(calc->entry, '.') != NULL)
             {
-                // Only one '.' allowed in second operand
-                if (key == '.' && strchr(entry, '.') != NULL)
+                // ignore extra '.'
+            }
+            else
+            {
+                if (strcmp(calc->entry, "0") == 0 && key != '.')
                 {
-                    // ignore extra '.'
+                    calc->entry[0] = '\0';
                 }
-                else
+
+                size_t len = strlen(calc->entry);
+                if (len < sizeof(calc->entry) - 1)   // limit to 16 chars
                 {
-                    if (strcmp(entry, "0") == 0 && key != '.')
-                    {
-                        entry[0] = '\0';
-                    }
-
-                    size_t len = strlen(entry);
-                    if (len < sizeof(entry) - 1)   // limit to 16 chars
-                    {
-                        entry[len] = key;
-                        entry[len + 1] = '\0';
-                    }
+                    calc->entry[len] = key;
+                    calc->entry[len + 1] = '\0';
                 }
-
-                update_entry_display(entry);
             }
-            else if (key == '=')
-            {
-                // Finalize second operand
-                op2 = strtod(entry, NULL);
 
-                // Show full expression "op1 op op2 =" on top
-                update_expression_display(op1, current_op, op2, 1, 1);
+            update_entry_display(calc->entry);
+        }
+        else if (key == '=')
+        {
+            // Finalize second operand
+            calc->op2 = Calc_Number_Parse(calc->entry);
 
-                // Compute result
-                if (current_op == '+')
-                {
-                    result = op1 + op2;
-                }
-                else if (current_op == '-')
-                {
-                    result = op1 - op2;
-                }
-                else if (current_op == '*')
-                {
-                    result = op1 * op2;
-                }
-                else if (current_op == '/')
-                {
-                    if (op2 == 0.0)
-                    {
-                        LCD_SetCursor(0, 0);
-                        LCD_Print((char*)"Err: Div by 0  ");
-                        LCD_SetCursor(0, 1);
-                        LCD_Print((char*)"Press any key  ");
-                        state = STATE_SHOW_RESULT;
-                        continue;
-                    }
-                    else
-                    {
-                        result = op1 / op2;
-                    }
-                }
+            // Show full expression "op1 op op2 =" on top
+            update_expression_display(calc->op1, calc->current_op, calc->op2, 1, 1);
 
-                // Bottom line: only the result (no label), up to 16 chars
-                LCD_SetCursor(0, 1);
-                LCD_Print((char*)"                ");
-                LCD_SetCursor(0, 1);
-                LCD_PrintDoubleCompact(result);
+            // Compute result. Errors (division by zero, overflow,
+            // invalid, underflow) are collected from the exception
+            // flags once, after the operation.
+            Trace_Begin(TRACE_ZONE_COMPUTE, (uint16_t)calc->current_op);
+            Calc_Error_Begin();
 
-                state = STATE_SHOW_RESULT;
+            if (calc->current_op == '+')
+            {
+                calc->result = Calc_Number_Add(calc->op1, calc->op2);
             }
-            else if (key == '+' || key == '-' || key == '*' || key == '/')
+            else if (calc->current_op == '-')
             {
-                // Change operator before entering second operand
-                current_op = key;
-                update_expression_display(op1, current_op, 0.0, 0, 0);
+                calc->result = Calc_Number_Sub(calc->op1, calc->op2);
             }
-        }
-        else if (state == STATE_SHOW_RESULT)
-        {
-            if ((key >= '0' && key <= '9') || key == '.')
+            else if (calc->current_op == '*')
+            {
+                calc->result = Calc_Number_Mul(calc->op1, calc->op2);
+            }
+            else if (calc->current_op == '/')
             {
-                // Start a new calculation with fresh entry
-                state = STATE_ENTER_FIRST;
-                op1 = op2 = 0.0;
-                current_op = 0;
+                calc->result = Calc_Number_Div(calc->op1, calc->op2);
+            }
 
-                memset(entry, 0, sizeof(entry));
-                entry[0] = key;
-                entry[1] = '\0';
+            Calc_Error error = Calc_Error_End(calc->result);
+            Trace_End(TRACE_ZONE_COMPUTE);
 
-                LCD_Clear();
-                LCD_SetCursor(0, 0);
-                LCD_Print((char*)"Calc Ready");
-                update_entry_display(entry);
-            }
-            else if (key == '+' || key == '-' || key == '*' || key == '/')
+            // Only queued here, programmed into the flash while waiting for the next key
+            Journal_Append(calc->current_op, calc->op1, calc->op2, calc->result, (uint8_t)error);
+
+            if (error != CALC_ERROR_NONE)
             {
-                // Chain: use last result as new op1
-                op1 = result;
-                op2 = 0.0;
-                current_op = key;
-                state = STATE_ENTER_SECOND;
-
-                update_expression_display(op1, current_op, 0.0, 0, 0);
-
-                memset(entry, 0, sizeof(entry));
-                entry[0] = '0';
-                entry[1] = '\0';
-                update_entry_display(entry);
+                LCD_SetCursor(0, 0);
+                LCD_Print((char*)Calc_Error_Message(error));
+                LCD_SetCursor(0, 1);
+                LCD_Print((char*)"Press any key  ");
+
+                // Don't chain from an invalid result
+                calc->result = zero;
+
+                // Keep the events that led to the error for the dump
+                Trace_Mark(TRACE_ZONE_ERROR, (uint16_t)error);
+                Trace_Freeze();
+                LOG2("Error %u after operator %c", error, calc->current_op);
             }
-            else if (key == '=')
+            else
             {
-                // Could repeat last op, but do nothing for now
+                // Bottom line: only the result (no label), up to 16 chars
+                LCD_SetCursor(0, 1);
+                LCD_Print((char*)"                ");
+                LCD_SetCursor(0, 1);
+                LCD_PrintNumberCompact(calc->result);
             }
+
+            calc->state = STATE_SHOW_RESULT;
+        }
+        else if (key == '+' || key == '-' || key == '*' || key == '/')
+        {
+            // Change operator before entering second operand
+            calc->current_op = key;
+            update_expression_display(calc->op1, calc->current_op, zero, 0, 0);
+        }
+    }
+    else if (calc->state == STATE_SHOW_RESULT)
+    {
+        if ((key >= '0' && key <= '9') || key == '.')
+        {
+            // Start a new calculation with fresh entry
+            calc->state = STATE_ENTER_FIRST;
+            calc->op1 = zero;
+            calc->op2 = zero;
+            calc->current_op = 0;
+            Calc_Memory_Reset();
+
+            memset(calc->entry, 0, sizeof(calc->entry));
+            calc->entry[0] = key;
+            calc->entry[1] = '\0';
+
+            LCD_Clear();
+            LCD_SetCursor(0, 0);
+            LCD_Print((char*)"Calc Ready");
+            update_entry_display(calc->entry);
+        }
+        else if (key == '+' || key == '-' || key == '*' || key == '/')
+        {
+            // Chain: use last result as new op1 (held by value, not in the pools)
+            calc->op1 = calc->result;
+            calc->op2 = zero;
+            calc->current_op = key;
+            calc->state = STATE_ENTER_SECOND;
+            Calc_Memory_Reset();
+
+            update_expression_display(calc->op1, calc->current_op, zero, 0, 0);
+
+            memset(calc->entry, 0, sizeof(calc->entry));
+            calc->entry[0] = '0';
+            calc->entry[1] = '\0';
+            update_entry_display(calc->entry);
+        }
+        else if (key == '=')
+        {
+            // Could repeat last op, but do nothing for now
+        }
+    }
+
+    if (calc->state != previous_state)
+    {
+        Trace_Mark(TRACE_ZONE_STATE, (uint16_t)calc->state);
+        Watchdog_Set_State(calc->state);
+    }
+
+    LCD_Flush();
+}
+
+// Compare two numbers by type and value (the padding of Calc_Number is
+// not initialized, so the structures cannot be compared with memcmp)
+static uint8_t number_equal(const Calc_Number *a, const Calc_Number *b)
+{
+    if (a->type != b->type)
+    {
+        return 0;
+    }
+    if (a->type == CALC_NUMBER_INT)
+    {
+        return a->value.i == b->value.i;
+    }
+    return memcmp(&a->value.f, &b->value.f, sizeof(Calc_Float)) == 0;
+}
+
+// Compare two snapshots field by field
+static uint8_t history_equal(const CalcSnapshot *a, const CalcSnapshot *b)
+{
+    return a->calc.state == b->calc.state &&
+           number_equal(&a->calc.op1, &b->calc.op1) &&
+           number_equal(&a->calc.op2, &b->calc.op2) &&
+           number_equal(&a->calc.result, &b->calc.result) &&
+           a->calc.current_op == b->calc.current_op &&
+           strcmp(a->calc.entry, b->calc.entry) == 0 &&
+           memcmp(&a->frame, &b->frame, sizeof(LCD_Frame)) == 0;
+}
+
+// Start a new calculation with an empty undo history
+static void history_reset(void)
+{
+    CalcSnapshot initial;
+
+    memset(&initial, 0, sizeof(initial));
+    calc_reset(&initial.calc);
+    initial.frame = *LCD_Frame_Get();
+    Snapshot_Init(&history, history_storage, sizeof(CalcSnapshot), UNDO_DEPTH, &initial);
+}
+
+// Handle one keystroke as a new snapshot; keys that change nothing are not recorded
+static void history_handle_key(char key)
+{
+    const CalcSnapshot *current = Snapshot_Current(&history);
+    CalcSnapshot *next = Snapshot_Begin(&history);
+
+    handle_key(&next->calc, key);
+    next->frame = *LCD_Frame_Get();
+
+    if (!history_equal(next, current))
+    {
+        Snapshot_Commit(&history);
+    }
+}
+
+// Edit the current calculation as an expression; an accepted value is a new snapshot
+static void history_edit(void)
+{
+    const CalcSnapshot *current = Snapshot_Current(&history);
+    char text[CALC_EXPR_MAX_CHARS + 1];
+    Calc_Number value;
+    Calc_Editor_Stats stats;
+
+    calc_format_expression(&current->calc, text);
+
+    if (Calc_Editor_Run("", NULL, text, &value))
+    {
+        CalcSnapshot *next = Snapshot_Begin(&history);
+
+        calc_show_expression(&next->calc, text, value);
+        next->frame = *LCD_Frame_Get();
+        Snapshot_Commit(&history);
+
+        Journal_Append_Result(JOURNAL_TYPE_EXPRESSION, value, CALC_ERROR_NONE);
+    }
+    else
+    {
+        // Canceled: show the calculation again
+        LCD_Frame_Set(&current->frame);
+        LCD_Flush();
+    }
+
+    // Cost of the edits, see Calc_Expr.h
+    Calc_Editor_Get_Stats(&stats);
+    LOG3("Editor: %u cycles last edit (max %u), %u terms re-evaluated", stats.cycles_last, stats.cycles_max, stats.expr.terms_evaluated);
+}
+
+// Run the integration mode; an accepted integral is a new snapshot
+static void history_integrate(void)
+{
+    const CalcSnapshot *current = Snapshot_Current(&history);
+    Calc_Number value;
+    Calc_Integrate_Result result;
+
+    if (Calc_Integrate_Mode(&value))
+    {
+        CalcSnapshot *next = Snapshot_Begin(&history);
+
+        calc_show_expression(&next->calc, "Integral", value);
+        next->frame = *LCD_Frame_Get();
+        Snapshot_Commit(&history);
+
+        Journal_Append_Result(JOURNAL_TYPE_INTEGRAL, value, CALC_ERROR_NONE);
+    }
+    else
+    {
+        LCD_Frame_Set(&current->frame);
+        LCD_Flush();
+    }
+
+    Calc_Integrate_Get_Last(&result);
+    LOG3("Integral: %u evaluations, %u cycles, status %u", result.evaluations, result.cycles, result.status);
+    LOG1("Integral: f native %u", result.native);
+}
+
+// Run the polynomial mode; an accepted root is a new snapshot
+static void history_poly(void)
+{
+    const CalcSnapshot *current = Snapshot_Current(&history);
+    Calc_Number value;
+    Calc_Poly_Result result;
+
+    if (Calc_Poly_Mode(&value))
+    {
+        CalcSnapshot *next = Snapshot_Begin(&history);
+
+        calc_show_expression(&next->calc, "Root", value);
+        next->frame = *LCD_Frame_Get();
+        Snapshot_Commit(&history);
+
+        Journal_Append_Result(JOURNAL_TYPE_ROOT, value, CALC_ERROR_NONE);
+    }
+    else
+    {
+        LCD_Frame_Set(&current->frame);
+        LCD_Flush();
+    }
+
+    Calc_Poly_Get_Last(&result);
+    LOG3("Roots: degree %u, %u iterations, %u cycles", result.degree, result.iterations, result.cycles);
+}
+
+// Undo or redo a key: only the cells that differ from the restored frame are redrawn
+static void history_move(uint8_t redo)
+{
+    uint8_t moved = redo ? Snapshot_Redo(&history) : Snapshot_Undo(&history);
+
+    if (moved)
+    {
+        const CalcSnapshot *snapshot = Snapshot_Current(&history);
+
+        LCD_Frame_Set(&snapshot->frame);
+        uint32_t cells = LCD_Flush();
+
+        Trace_Mark(TRACE_ZONE_STATE, (uint16_t)snapshot->calc.state);
+        Watchdog_Set_State(snapshot->calc.state);
+        LOG2("History %c: %u cells redrawn", redo ? '+' : '-', cells);
+    }
+}
+
+#ifdef PROFILER_ENABLE
+// Send the profile to the PC after this many keys
+#define PROFILER_DUMP_INTERVAL_KEYS     16
+#endif
+
+#ifdef SESSION_REPLAY
+// Replay results, slowest session first (inspect in the debugger watch window)
+static Session_Replay_Result replay_results[32];
+static Cycle_Counter_Stats replay_total;
+
+static void replay_reset(void *context)
+{
+    calc_reset((CalcContext *)context);
+}
+
+static void replay_key(void *context, char key)
+{
+    handle_key((CalcContext *)context, key);
+}
+
+// Replay the built-in session corpus before accepting keypad input
+static void run_session_replay(void)
+{
+    CalcContext calc;
+    uint32_t count = Session_Replay_Corpus_Size;
+    if (count > sizeof(replay_results) / sizeof(replay_results[0]))
+    {
+        count = sizeof(replay_results) / sizeof(replay_results[0]);
+    }
+
+    // Replay at the speed used for keypad input
+    Clock_Governor_Request_Fast();
+
+    // The replayed calculations are not the user's, keep them out of the journal
+    Journal_Set_Paused(1);
+    Session_Replay_Run(Session_Replay_Corpus, count, replay_results, &replay_total,
+                       replay_reset, replay_key, &calc);
+    Journal_Set_Paused(0);
+    Session_Replay_Sort_Slowest(replay_results, count);
+
+    // The replayed error sessions froze the trace; start over for keypad input
+    Trace_Init();
+}
+#endif
+
+int main(void)
+{
+    SysTick_Delay_Init();
+    Cycle_Counter_Init();
+    Interrupts_Init();
+    Trace_Init();
+    UART0_Init();
+    Profiler_Init(PROFILER_SAMPLE_RATE_HZ);
+    LCD_Init();
+    LCD_Frame_Init();
+    Keypad_Init();
+    Keypad_Scan_Init();
+
+    // Drivers that depend on the system clock
+    Clock_Governor_Register_Listener(UART0_Update_Clock);
+    Clock_Governor_Register_Listener(Watchdog_Update_Clock);
+    Clock_Governor_Register_Listener(Profiler_Update_Clock);
+    Clock_Governor_Init();
+
+    // Timing profile stored in the EEPROM (defaults on first start)
+    Settings_Init();
+
+    // Find the end of the calculation journal
+    Journal_Init();
+
+    Journal_Stats journal_stats;
+    Journal_Entry last_entry;
+
+    Clock_Governor_Stats clock_stats;
+    uint64_t previous_energy_nj = 0;
+    Keypad_Scan_Stats scan_stats;
+
+#ifdef PROFILER_ENABLE
+    uint32_t profiled_keys = 0;
+#endif
+
+#ifdef SESSION_REPLAY
+    run_session_replay();
+#endif
+
+    history_reset();
+    LOG1("Calculator started, system clock %u Hz", SystemCoreClock);
+
+    // Start the stall monitor last, so initialization is not counted
+    Watchdog_Init(WATCHDOG_BUDGET_MS);
+
+    if (Watchdog_Caused_Reset())
+    {
+        const Watchdog_Record *stall = Watchdog_Get_Record();
+        LOG3("Watchdog reset: PC %08x, state %u, open zones %x", stall->pc, stall->state, stall->open_zones);
+    }
+
+    // What the journal kept across the reset
+    Journal_Get_Stats(&journal_stats);
+    LOG2("Journal: records %u to %u", journal_stats.oldest_sequence, journal_stats.next_sequence - 1U);
+    if (Journal_Find(journal_stats.next_sequence - 1U, &last_entry))
+    {
+        LOG3("Journal: last record type %u, op %c, error %u", last_entry.type, last_entry.op, last_entry.error);
+    }
+
+    while (1)
+    {
+        char key = Keypad_WaitForChar();
+
+        // Holding '=' opens the settings menu instead of evaluating
+        if (key == '=' && Keypad_Get_Timing()->hold_us >= SETTINGS_HOLD_US)
+        {
+            Settings_Menu();
+
+            // The menu used (and cleared) the display, start a new calculation
+            LCD_Frame_Init();
+            history_reset();
+            continue;
+        }
+
+        // Full speed for the key handling (and the idle timeout after it)
+        Clock_Governor_Request_Fast();
+
+        // Holding '-' or '+' moves in the undo history instead of entering an operator
+        if ((key == '-' || key == '+') && Keypad_Get_Timing()->hold_us >= UNDO_HOLD_US)
+        {
+            history_move(key == '+');
+            Log_Flush(UART0_Output_Character);
+            continue;
+        }
+
+        // Holding '*' opens the expression editor instead of entering an operator
+        if (key == '*' && Keypad_Get_Timing()->hold_us >= CALC_EDITOR_OPEN_HOLD_US)
+        {
+            history_edit();
+            Log_Flush(UART0_Output_Character);
+            continue;
+        }
+
+        // Holding '/' opens the integration mode
+        if (key == '/' && Keypad_Get_Timing()->hold_us >= CALC_INTEGRATE_HOLD_US)
+        {
+            history_integrate();
+            Log_Flush(UART0_Output_Character);
+            continue;
+        }
+
+        // Holding '.' opens the polynomial mode
+        if (key == '.' && Keypad_Get_Timing()->hold_us >= CALC_POLY_HOLD_US)
+        {
+            history_poly();
+            Log_Flush(UART0_Output_Character);
+            continue;
+        }
+
+        // Cycles spent handling this key (engine + LCD), see Cycle_Counter.h
+        uint32_t key_start = Cycle_Counter_Read();
+
+        Trace_Begin(TRACE_ZONE_KEY, (uint16_t)key);
+        history_handle_key(key);
+        Trace_End(TRACE_ZONE_KEY);
+
+        Cycle_Counter_Record_Key(key, Cycle_Counter_Read() - key_start);
+
+        // Energy used since the previous key (idle wait + switch + handling)
+        Clock_Governor_Get_Stats(&clock_stats);
+        LOG2("Key %c: %u uJ", key, (uint32_t)((clock_stats.energy_nj - previous_energy_nj) / 1000U));
+        previous_energy_nj = clock_stats.energy_nj;
+
+        // Detection latency of this key and the CPU cost of scanning for it
+        Keypad_Scan_Get_Stats(&scan_stats);
+        LOG3("Scan: %u us latency (max %u us), %u permille CPU", scan_stats.latency_us_last, scan_stats.latency_us_max, scan_stats.cpu_permille);
+
+        // Records still in the RAM queue, and those lost to a full queue
+        Journal_Get_Stats(&journal_stats);
+        LOG2("Journal: %u pending, %u dropped", journal_stats.appended - journal_stats.written, journal_stats.dropped);
+
+        Log_Flush(UART0_Output_Character);
+
+        // An error froze the trace: send it to the PC, then resume recording
+        if (Trace_Is_Frozen())
+        {
+            Trace_Dump_Binary(UART0_Output_Character);
+            Trace_Unfreeze();
+        }
+
+#ifdef PROFILER_ENABLE
+        // Send the profile to the PC and start a new one
+        profiled_keys++;
+        if (profiled_keys >= PROFILER_DUMP_INTERVAL_KEYS)
+        {
+            Profiler_Dump(UART0_Output_Character);
+            Profiler_Clear();
+            profiled_keys = 0;
         }
+#endif
     }
 }
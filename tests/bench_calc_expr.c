@@ -0,0 +1,80 @@
+/**
+ * @file bench_calc_expr.c
+ *
+ * @brief Host benchmark of an edit of a long expression (Calc_Expr).
+ *
+ * A digit is inserted and deleted again in the middle of an expression of
+ * CALC_EXPR_MAX_CHARS - 1 characters, and the time per edit is compared
+ * with building the same expression from its text (Calc_Expr_Create, a
+ * full re-lex and re-parse). The times are host times; the firmware
+ * reports the cycles of its edits over the UART (see Calc_Editor.h).
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "test.h"
+#include "Calc_Expr.h"
+#include "Calc_Memory.h"
+#include <string.h>
+
+#define BENCH_ROUNDS    200000U
+
+int main(void)
+{
+    static const char pattern[] = "12*3.5-7/2+";
+    char text[CALC_EXPR_MAX_CHARS];
+    uint32_t length = 0;
+
+    while (length < sizeof(text) - 1U)
+    {
+        text[length] = pattern[length % (sizeof(pattern) - 1U)];
+        length++;
+    }
+
+    // End on an operand, so that the expression has a value
+    while (!(text[length - 1] >= '0' && text[length - 1] <= '9'))
+    {
+        length--;
+    }
+    text[length] = '\0';
+
+    // Incremental: an insert and a delete in the middle of the line
+    Calc_Memory_Reset();
+    Calc_Expr *expr = Calc_Expr_Create(text, NULL);
+    Calc_Expr_Stats stats;
+    Calc_Expr_Move(expr, -(int32_t)(length / 2U));
+
+    uint64_t rounds = Test_Iterations(BENCH_ROUNDS);
+    double start = Test_Seconds();
+    for (uint64_t i = 0; i < rounds; i++)
+    {
+        Calc_Expr_Insert(expr, '5');
+        Calc_Expr_Delete(expr);
+    }
+    double edit_ns = (Test_Seconds() - start) * 1e9 / (2.0 * (double)rounds);
+    Calc_Expr_Get_Stats(expr, &stats);
+    TEST_CHECK(strcmp(expr->text, text) == 0 && expr->complete);
+
+    // Full: the same expression lexed and parsed from its text
+    Calc_Memory_Reset();
+    uint32_t token_mark = Arena_Mark(&Calc_Memory_Tokens);
+    uint32_t node_mark = Arena_Mark(&Calc_Memory_Nodes);
+    Calc_Number full_value = { CALC_NUMBER_INT, { .i = 0 } };
+
+    start = Test_Seconds();
+    for (uint64_t i = 0; i < rounds; i++)
+    {
+        Calc_Expr *full = Calc_Expr_Create(text, NULL);
+        full_value = full->value;
+        Arena_Release(&Calc_Memory_Nodes, node_mark);
+        Arena_Release(&Calc_Memory_Tokens, token_mark);
+    }
+    double full_ns = (Test_Seconds() - start) * 1e9 / (double)rounds;
+    TEST_CHECK(Calc_Number_To_Double(full_value) == Calc_Number_To_Double(expr->value));
+
+    printf("bench_calc_expr: %u characters, %u terms: %.0f ns per edit (%u tokens lexed, %u terms evaluated), "
+           "%.0f ns per full parse (%.1fx)\n", length, stats.terms, edit_ns, stats.tokens_lexed,
+           stats.terms_evaluated, full_ns, full_ns / edit_ns);
+
+    return Test_Report("bench_calc_expr");
+}
@@ -0,0 +1,78 @@
+/**
+ * @file bench_calc_func.c
+ *
+ * @brief Host benchmark of Calc_Func evaluations, interpreted and compiled.
+ *
+ * Calc_Func.c is built for the target (see test_calc_func_jit.c), and for
+ * each function the table gives:
+ *  - the postfix instructions the interpreter dispatches per evaluation,
+ *    and its evaluations per second on the host
+ *  - the Thumb-2 instructions and bytes of the machine code, its cycles
+ *    per call as estimated by the emulator (sim/Host_Jit.h), and the
+ *    evaluations per second they allow at CLOCK_GOVERNOR_FAST_HZ
+ * The machine code cannot run on the host, so its rate is an estimate;
+ * on the board, the integral mode reports the measured cycles and
+ * evaluations of each integral (see Calc_Integrate.h).
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "test.h"
+#include "Host_Jit.h"
+#include "Calc_Func.h"
+#include "Calc_Memory.h"
+#include "Clock_Governor.h"
+
+#define BENCH_EVALUATIONS   2000000U
+
+static const char *const functions[] = {
+    "x*x-2",
+    "1/x",
+    "x*x*x-2*x+5",
+    "3*x*x*x*x-2*x*x*x+x*x-7*x+1",
+    "0.5*x*x+13.25/x-x/7+100*x-0.1",
+};
+
+int main(void)
+{
+    uint64_t evaluations = Test_Iterations(BENCH_EVALUATIONS);
+    Host_Jit_Stats stats;
+
+    printf("bench_calc_func: %-30s | %7s %12s | %7s %5s %6s %12s\n", "f", "postfix", "host eval/s",
+           "thumb", "bytes", "cycles", "target eval/s");
+
+    for (uint32_t i = 0; i < sizeof(functions) / sizeof(functions[0]); i++)
+    {
+        Calc_Memory_Reset();
+        const Calc_Func *func = Calc_Func_Compile(functions[i]);
+        TEST_CHECK_MSG(func != NULL && func->native != NULL, "%s: not compiled", functions[i]);
+        if (func == NULL || func->native == NULL)
+        {
+            continue;
+        }
+
+        Calc_Func interpreted = *func;
+        interpreted.native = NULL;
+
+        volatile float sink = 0.0f;
+        float x = 0.75f;
+        double start = Test_Seconds();
+        for (uint64_t n = 0; n < evaluations; n++)
+        {
+            sink = Calc_Func_Eval(&interpreted, x);
+            x += 1.0f / 1024.0f;
+        }
+        double host_rate = (double)evaluations / (Test_Seconds() - start);
+
+        float value = Host_Jit_Run(func, 0.75f, &stats);
+        TEST_CHECK_MSG(stats.error == NULL && value == Calc_Func_Eval(&interpreted, 0.75f), "%s: %s", functions[i],
+                       (stats.error != NULL) ? stats.error : "different value");
+        (void)sink;
+
+        printf("bench_calc_func: %-30s | %7u %12.3g | %7u %5u %6u %12.3g\n", functions[i], func->length, host_rate,
+               stats.instructions, func->native_bytes, stats.cycles,
+               (double)CLOCK_GOVERNOR_FAST_HZ / (double)stats.cycles);
+    }
+
+    return Test_Report("bench_calc_func");
+}
@@ -0,0 +1,110 @@
+/**
+ * @file bench_calc_integrate.c
+ *
+ * @brief Host benchmark of the adaptive quadrature against fixed steps.
+ *
+ * For each function, Calc_Integrate is run with the default tolerance,
+ * then composite Simpson's rule with a fixed step is run with 2, 4, 8...
+ * intervals until it is as accurate, with the same single-precision
+ * evaluations (Calc_Func_Eval). The evaluations and the host time of both
+ * are printed. The fixed step must be fine enough for the steepest part
+ * of f everywhere, the adaptive steps are only fine there.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "test.h"
+#include "Host_Device.h"
+#include "Calc_Integrate.h"
+#include "Calc_Memory.h"
+#include "Cycle_Counter.h"
+#include "SysTick_Delay.h"
+#include <math.h>
+
+#define BENCH_REPEATS       2000U
+#define BENCH_MAX_INTERVALS (1U << 20)
+
+typedef struct {
+    const char *text;
+    float a;
+    float b;
+    double integral;
+} Bench_Integral;
+
+static const Bench_Integral functions[] = {
+    { "x*x*x*x",        -1.0f, 2.0f,  33.0 / 5.0 },
+    { "1/x",            1.0f,  2.0f,  0.69314718055994531 },
+    { "1/x",            0.01f, 1.0f,  4.6051701859880914 },
+    { "1/x/x",          0.05f, 4.0f,  1.0 / 0.05 - 1.0 / 4.0 },
+};
+
+// Composite Simpson's rule with n (even) intervals, in the precision of the firmware
+static double Fixed_Simpson(const Calc_Func *func, float a, float b, uint32_t n)
+{
+    float h = (b - a) / (float)n;
+    double sum = (double)Calc_Func_Eval(func, a) + (double)Calc_Func_Eval(func, b);
+
+    for (uint32_t i = 1; i < n; i++)
+    {
+        sum += ((i & 1U) ? 4.0 : 2.0) * (double)Calc_Func_Eval(func, a + (float)i * h);
+    }
+    return sum * (double)h / 3.0;
+}
+
+int main(void)
+{
+    Calc_Integrate_Budget budget = { CALC_INTEGRATE_TOLERANCE, CALC_INTEGRATE_MAX_EVALUATIONS,
+                                     CALC_INTEGRATE_MAX_CYCLES };
+    Calc_Integrate_Result result;
+
+    TEST_CHECK(Host_Device_Init(NULL, 0) == 0);
+    SysTick_Delay_Init();
+    Cycle_Counter_Init();
+
+    printf("bench_calc_integrate: %-8s %-13s %8s %10s %9s | %8s %10s %9s\n", "f", "[a, b]",
+           "adaptive", "error", "us", "fixed", "error", "us");
+
+    for (uint32_t i = 0; i < sizeof(functions) / sizeof(functions[0]); i++)
+    {
+        const Bench_Integral *f = &functions[i];
+
+        Calc_Memory_Reset();
+        const Calc_Func *func = Calc_Func_Compile(f->text);
+
+        double start = Test_Seconds();
+        for (uint32_t r = 0; r < BENCH_REPEATS; r++)
+        {
+            Calc_Integrate(func, f->a, f->b, &budget, &result);
+        }
+        double adaptive_us = (Test_Seconds() - start) * 1e6 / BENCH_REPEATS;
+        double adaptive_error = fabs(result.value - f->integral);
+        TEST_CHECK_MSG(result.status == CALC_INTEGRATE_OK, "%s: status %u", f->text, result.status);
+
+        // The fewest fixed intervals (a power of two) that are as accurate
+        uint32_t n = 2;
+        double fixed_error = fabs(Fixed_Simpson(func, f->a, f->b, n) - f->integral);
+        while (fixed_error > adaptive_error && n < BENCH_MAX_INTERVALS)
+        {
+            n *= 2U;
+            fixed_error = fabs(Fixed_Simpson(func, f->a, f->b, n) - f->integral);
+        }
+
+        uint32_t repeats = (BENCH_REPEATS * 64U) / n + 1U;
+        double value = 0.0;
+        start = Test_Seconds();
+        for (uint32_t r = 0; r < repeats; r++)
+        {
+            value += Fixed_Simpson(func, f->a, f->b, n);
+        }
+        double fixed_us = (Test_Seconds() - start) * 1e6 / repeats;
+        TEST_CHECK(isfinite(value));
+
+        char bounds[32];
+        snprintf(bounds, sizeof(bounds), "[%g, %g]", f->a, f->b);
+        printf("bench_calc_integrate: %-8s %-13s %8u %10.2e %9.2f | %8u%s %9.2e %9.2f\n", f->text, bounds,
+               result.evaluations, adaptive_error, adaptive_us, n + 1U,
+               (fixed_error > adaptive_error) ? "+" : " ", fixed_error, fixed_us);
+    }
+
+    return Test_Report("bench_calc_integrate");
+}
@@ -0,0 +1,192 @@
+/**
+ * @file bench_calc_poly.c
+ *
+ * @brief Host benchmark of the polynomial root finder against Newton's method.
+ *
+ * For each polynomial, multiplied out from known roots, Calc_Poly_Solve
+ * (the closed forms up to degree 3, Durand-Kerner above) is compared with
+ * Newton's method on one root at a time, each root divided out of the
+ * polynomial before the next (deflation), from the same tolerance. The
+ * largest distance to a known root and the host time of both are printed.
+ * Deflation is cheaper per iteration, but each root divided out carries
+ * its error into the next ones; Durand-Kerner refines all of them on the
+ * polynomial as given.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "test.h"
+#include "Host_Device.h"
+#include "Calc_Poly.h"
+#include "Cycle_Counter.h"
+#include "SysTick_Delay.h"
+#include <math.h>
+
+#define BENCH_REPEATS   20000U
+
+typedef struct {
+    const char *name;
+    uint32_t degree;
+    Calc_Poly_Complex roots[CALC_POLY_MAX_DEGREE];
+} Bench_Poly;
+
+static const Bench_Poly polynomials[] = {
+    { "quadratic",  2, { { -3.0, 0.0 }, { 1.0e-6, 0.0 } } },
+    { "cubic",      3, { { 0.5, 0.0 }, { -1.0, 1.0 }, { -1.0, -1.0 } } },
+    { "1..4",       4, { { 1.0, 0.0 }, { 2.0, 0.0 }, { 3.0, 0.0 }, { 4.0, 0.0 } } },
+    { "-2..2",      5, { { -2.0, 0.0 }, { -1.0, 0.0 }, { 0.0, 0.0 }, { 1.0, 0.0 }, { 2.0, 0.0 } } },
+    { "1..6",       6, { { 1.0, 0.0 }, { 2.0, 0.0 }, { 3.0, 0.0 }, { 4.0, 0.0 }, { 5.0, 0.0 }, { 6.0, 0.0 } } },
+    { "mixed",      6, { { 1.0, 0.0 }, { -1.0, 0.0 }, { 0.5, 2.0 }, { 0.5, -2.0 }, { -3.0, 0.25 }, { -3.0, -0.25 } } },
+    { "cluster",    6, { { 3.0, 0.0 }, { 3.25, 0.0 }, { 3.5, 0.0 }, { 3.75, 0.0 }, { 4.0, 0.25 }, { 4.0, -0.25 } } },
+};
+
+static Calc_Poly_Complex Make(double re, double im)
+{
+    Calc_Poly_Complex z = { re, im };
+    return z;
+}
+
+static Calc_Poly_Complex Mul(Calc_Poly_Complex a, Calc_Poly_Complex b)
+{
+    return Make(a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re);
+}
+
+static Calc_Poly_Complex Div(Calc_Poly_Complex a, Calc_Poly_Complex b)
+{
+    double d = b.re * b.re + b.im * b.im;
+    return Make((a.re * b.re + a.im * b.im) / d, (a.im * b.re - a.re * b.im) / d);
+}
+
+// Coefficients, highest degree first, of the product of (x - root)
+static void Multiply_Out(const Calc_Poly_Complex *roots, uint32_t degree, double *coefficients)
+{
+    Calc_Poly_Complex c[CALC_POLY_MAX_DEGREE + 1] = { { 1.0, 0.0 } };
+
+    for (uint32_t k = 0; k < degree; k++)
+    {
+        for (uint32_t i = k + 1; i > 0; i--)
+        {
+            Calc_Poly_Complex product = Mul(roots[k], c[i - 1]);
+            c[i] = Make(c[i].re - product.re, c[i].im - product.im);
+        }
+    }
+    for (uint32_t i = 0; i <= degree; i++)
+    {
+        coefficients[i] = c[i].re;
+    }
+}
+
+// Newton's method on one root at a time, then the root divided out; returns the iterations
+static uint32_t Newton_Deflation(const double *coefficients, uint32_t degree, Calc_Poly_Complex *roots)
+{
+    Calc_Poly_Complex c[CALC_POLY_MAX_DEGREE + 1];
+    uint32_t iterations = 0;
+
+    for (uint32_t i = 0; i <= degree; i++)
+    {
+        c[i] = Make(coefficients[i], 0.0);
+    }
+
+    for (uint32_t n = degree; n > 0; n--)
+    {
+        // Off the real axis, so that complex roots can be reached
+        Calc_Poly_Complex z = Make(0.4, 0.9);
+
+        for (uint32_t k = 0; k < CALC_POLY_MAX_ITERATIONS; k++)
+        {
+            Calc_Poly_Complex p = c[0];
+            Calc_Poly_Complex dp = Make(0.0, 0.0);
+
+            for (uint32_t i = 1; i <= n; i++)
+            {
+                dp = Mul(dp, z);
+                dp = Make(dp.re + p.re, dp.im + p.im);
+                p = Mul(p, z);
+                p = Make(p.re + c[i].re, p.im + c[i].im);
+            }
+            iterations++;
+
+            if (dp.re == 0.0 && dp.im == 0.0)
+            {
+                break;
+            }
+
+            Calc_Poly_Complex step = Div(p, dp);
+            z = Make(z.re - step.re, z.im - step.im);
+            if (hypot(step.re, step.im) <= CALC_POLY_TOLERANCE * (1.0 + hypot(z.re, z.im)))
+            {
+                break;
+            }
+        }
+        roots[degree - n] = z;
+
+        // Divide (x - z) out (synthetic division)
+        for (uint32_t i = 1; i < n; i++)
+        {
+            Calc_Poly_Complex product = Mul(c[i - 1], z);
+            c[i] = Make(c[i].re + product.re, c[i].im + product.im);
+        }
+    }
+    return iterations;
+}
+
+// The largest distance from a known root to the nearest root found
+static double Largest_Error(const Calc_Poly_Complex *known, const Calc_Poly_Complex *found, uint32_t degree)
+{
+    double largest = 0.0;
+
+    for (uint32_t k = 0; k < degree; k++)
+    {
+        double nearest = INFINITY;
+        for (uint32_t j = 0; j < degree; j++)
+        {
+            nearest = fmin(nearest, hypot(known[k].re - found[j].re, known[k].im - found[j].im));
+        }
+        largest = fmax(largest, nearest);
+    }
+    return largest;
+}
+
+int main(void)
+{
+    double coefficients[CALC_POLY_MAX_DEGREE + 1];
+    Calc_Poly_Complex newton_roots[CALC_POLY_MAX_DEGREE];
+    Calc_Poly_Result result;
+    uint32_t repeats = (uint32_t)Test_Iterations(BENCH_REPEATS);
+
+    TEST_CHECK(Host_Device_Init(NULL, 0) == 0);
+    SysTick_Delay_Init();
+    Cycle_Counter_Init();
+
+    printf("bench_calc_poly: %-10s %6s %10s %10s %8s | %10s %10s %8s\n", "roots", "degree", "iterations",
+           "error", "us", "iterations", "error", "us");
+
+    for (uint32_t n = 0; n < sizeof(polynomials) / sizeof(polynomials[0]); n++)
+    {
+        const Bench_Poly *poly = &polynomials[n];
+        Multiply_Out(poly->roots, poly->degree, coefficients);
+
+        double start = Test_Seconds();
+        for (uint32_t r = 0; r < repeats; r++)
+        {
+            Calc_Poly_Solve(coefficients, poly->degree, &result);
+        }
+        double solve_us = (Test_Seconds() - start) * 1e6 / repeats;
+        double solve_error = Largest_Error(poly->roots, result.roots, poly->degree);
+        TEST_CHECK_MSG(result.converged, "%s: no convergence", poly->name);
+
+        uint32_t newton_iterations = 0;
+        start = Test_Seconds();
+        for (uint32_t r = 0; r < repeats; r++)
+        {
+            newton_iterations = Newton_Deflation(coefficients, poly->degree, newton_roots);
+        }
+        double newton_us = (Test_Seconds() - start) * 1e6 / repeats;
+        double newton_error = Largest_Error(poly->roots, newton_roots, poly->degree);
+
+        printf("bench_calc_poly: %-10s %6u %10u %10.2e %8.3f | %10u %10.2e %8.3f\n", poly->name, poly->degree,
+               result.iterations, solve_error, solve_us, newton_iterations, newton_error, newton_us);
+    }
+
+    return Test_Report("bench_calc_poly");
+}
@@ -0,0 +1,959 @@
+/**
+ * @file Host_Device.c
+ *
+ * @brief Device model and virtual clock of the host simulator.
+ *
+ * Every register access (Host_Device_Access) happens just before the
+ * firmware reads or writes the register, so the model works in steps:
+ *  1. apply the write, if any, of the previous access (its register is
+ *     compared with the value the model left in it)
+ *  2. advance the virtual clock by the cost of an access, and run the
+ *     events that fall due (timer, SysTick wrap, key press or release)
+ *  3. take the pending interrupts that are not masked
+ *  4. refresh the registers of the peripheral being accessed (the SysTick
+ *     counter, the keypad rows, ...)
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Host_Device.h"
+#include "Memory_Map.h"
+#include <string.h>
+#include <sys/mman.h>
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE MAP_FIXED
+#endif
+
+// Regions of the target memory map used through pointers
+#define JOURNAL_FLASH_BASE      ((uint32_t)MEMORY_JOURNAL_BASE)
+#define JOURNAL_FLASH_SIZE      ((uint32_t)MEMORY_JOURNAL_SIZE)
+#define SRAM_TOP_PAGE           0x20007000U
+#define SRAM_TOP_PAGE_SIZE      0x00001000U
+
+_Static_assert(MEMORY_NOINIT_BASE >= SRAM_TOP_PAGE &&
+               MEMORY_NOINIT_BASE + MEMORY_NOINIT_SIZE <= SRAM_TOP_PAGE + SRAM_TOP_PAGE_SIZE,
+               "The watchdog record is outside the mapped SRAM page");
+
+#define FLASH_PAGE_BYTES        1024U
+#define EEPROM_WORDS            512U
+
+// Register fields used by the model
+#define SYSTICK_CTRL_ENABLE     0x01U
+#define SYSTICK_CTRL_TICKINT    0x02U
+#define SYSTICK_COUNTER_BITS    24U
+#define SYSCTL_PLLLRIS          (1U << 6)
+#define TIMER_CTL_TAEN          0x01U
+#define TIMER_TATORIS           0x01U
+#define FMC_WRITE               (1U << 0)
+#define FMC_ERASE               (1U << 1)
+#define FCRIS_ACCESS_ERROR      0x01U
+#define LCD_E                   0x40U           // PC6
+#define LCD_RS                  0x01U           // PE0
+#define KEYPAD_COLUMNS          0x3CU           // PA2-PA5
+#define KEYPAD_ROWS             0x0FU           // PD0-PD3
+
+// Value left in UART0->DR, so that a write of any character is seen
+#define UART_DR_EMPTY           0x80000000U
+
+#define NO_PERIPHERAL           HOST_PERIPHERAL_COUNT
+#define NO_EVENT                UINT64_MAX
+
+// Keypad characters in column-major order (index = column * 4 + row)
+static const char keypad_map[HOST_DEVICE_KEY_COUNT] = {
+    '7', '4', '1', '0',
+    '8', '5', '2', '.',
+    '9', '6', '3', '=',
+    '/', '*', '-', '+'
+};
+
+// Interrupt sources of the model, in the order they are checked
+typedef enum {
+    SOURCE_SYSTICK,
+    SOURCE_GPIOD,
+    SOURCE_TIMER2A,
+    SOURCE_COUNT
+} Source;
+
+extern void SysTick_Handler(void);
+extern void GPIOD_Handler(void);
+extern void TIMER2A_Handler(void);
+
+static const struct {
+    IRQn_Type irq;
+    void (*handler)(void);
+} sources[SOURCE_COUNT] = {
+    { SysTick_IRQn, SysTick_Handler },
+    { GPIOD_IRQn, GPIOD_Handler },
+    { TIMER2A_IRQn, TIMER2A_Handler }
+};
+
+uint32_t SystemCoreClock = 16000000U;
+
+static struct {
+    GPIOA_Type gpio[6];
+    SysTick_Type systick;
+    SCB_Type scb;
+    DWT_Type dwt;
+    CoreDebug_Type core_debug;
+    SYSCTL_Type sysctl;
+    UART0_Type uart0;
+    TIMER0_Type timer[3];
+    WATCHDOG0_Type watchdog0;
+    EEPROM_Type eeprom;
+    FLASH_CTRL_Type flash_ctrl;
+} regs;
+
+static void *const peripherals[HOST_PERIPHERAL_COUNT] = {
+    &regs.gpio[0], &regs.gpio[1], &regs.gpio[2], &regs.gpio[3], &regs.gpio[4], &regs.gpio[5],
+    &regs.systick, &regs.scb, &regs.dwt, &regs.core_debug, &regs.sysctl, &regs.uart0,
+    &regs.timer[0], &regs.timer[1], &regs.timer[2], &regs.watchdog0, &regs.eeprom, &regs.flash_ctrl
+};
+
+static struct {
+    // Virtual clock
+    uint64_t now_ps;
+    uint32_t clock_hz;
+    uint64_t cycle_ps;
+    uint64_t cycles;
+    uint64_t cycle_remainder_ps;
+    uint32_t cyccnt_offset;
+
+    // Last register access, and the values the model left in the registers it watches
+    Host_Peripheral last;
+    uint32_t shadow_gpio_data[6];
+    uint32_t shadow_gpio_icr[6];
+    uint32_t shadow_systick_ctrl;
+    uint32_t shadow_cyccnt;
+    uint32_t shadow_timer_ctl;
+    uint32_t shadow_timer_icr;
+    uint32_t shadow_eerdwr;
+    uint32_t shadow_fmc;
+
+    // SysTick
+    uint8_t systick_running;
+    uint64_t systick_start_ps;
+    uint64_t systick_wraps;
+    uint8_t systick_pending;
+
+    // Timer 2A one-shot
+    uint64_t timer2_deadline_ps;
+
+    // Flash controller: the end of the operation in progress
+    uint64_t flash_busy_until_ps;
+
+    // The PLL never locks (Host_Device_Set_Pll_Fails)
+    uint8_t pll_fails;
+
+    // Keypad
+    Host_Device_Key keys[HOST_DEVICE_MAX_KEYS];
+    uint8_t key_index[HOST_DEVICE_MAX_KEYS];
+    uint32_t key_count;
+    uint32_t next_key_event;        // Presses and releases, 2 per key
+    int pressed;                    // Matrix index, or -1
+    int current_key;                // Key event of the last press, or -1
+    uint32_t rows;
+
+    // LCD controller
+    uint8_t ddram[128];
+    uint8_t lcd_address;
+    uint8_t lcd_four_bit;
+    uint8_t lcd_have_upper;
+    uint8_t lcd_upper;
+    uint8_t lcd_cgram;
+    uint8_t lcd_e;
+
+    uint32_t eeprom[EEPROM_WORDS];
+
+    // Interrupts
+    uint8_t enabled[SOURCE_COUNT];
+    uint32_t priority[SOURCE_COUNT];
+    uint32_t primask;
+    uint32_t basepri;
+    uint8_t in_handler;
+
+    // Session
+    Host_Device_Output_Fn uart_output;
+    void *uart_context;
+    uint64_t end_ps;
+    uint64_t limit_ps;
+    Host_Device_Exit_Fn exit;
+    void *exit_context;
+    Host_Device_Stats stats;
+} model;
+
+static uint8_t memory_mapped = 0;
+
+static void Host_Device_Advance(uint64_t target_ps, uint8_t sleeping);
+static void Host_Device_Dispatch(void);
+
+// ----- Memory -----
+
+static int Host_Device_Map(uint32_t address, uint32_t size, uint8_t fill)
+{
+    void *memory = mmap((void *)(uintptr_t)address, size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+    if (memory != (void *)(uintptr_t)address)
+    {
+        return -1;
+    }
+    memset(memory, fill, size);
+    return 0;
+}
+
+// ----- Virtual clock -----
+
+static uint64_t Host_Device_Ticks(void)
+{
+    return (model.now_ps - model.systick_start_ps) / HOST_DEVICE_PS_PER_TICK;
+}
+
+static uint64_t Host_Device_Next_Wrap_ps(void)
+{
+    if (!model.systick_running)
+    {
+        return NO_EVENT;
+    }
+    return model.systick_start_ps +
+           ((model.systick_wraps + 1U) << SYSTICK_COUNTER_BITS) * HOST_DEVICE_PS_PER_TICK;
+}
+
+static uint64_t Host_Device_Next_Key_ps(void)
+{
+    if (model.next_key_event >= 2U * model.key_count)
+    {
+        return NO_EVENT;
+    }
+
+    const Host_Device_Key *key = &model.keys[model.next_key_event / 2U];
+    return (model.next_key_event & 1U) ? key->release_ps : key->press_ps;
+}
+
+static uint64_t Host_Device_Next_Event_ps(void)
+{
+    uint64_t next = Host_Device_Next_Wrap_ps();
+    uint64_t key = Host_Device_Next_Key_ps();
+
+    if (key < next)
+    {
+        next = key;
+    }
+    if (model.timer2_deadline_ps < next)
+    {
+        next = model.timer2_deadline_ps;
+    }
+    return next;
+}
+
+// Follow the changes of SystemCoreClock made by the clock governor
+static void Host_Device_Update_Clock(void)
+{
+    if (SystemCoreClock != model.clock_hz && SystemCoreClock != 0U)
+    {
+        model.clock_hz = SystemCoreClock;
+        model.cycle_ps = 1000000000000ULL / SystemCoreClock;
+        model.cycle_remainder_ps = 0;
+    }
+}
+
+// ----- Keypad -----
+
+static void Host_Device_Update_Rows(void)
+{
+    GPIOA_Type *rows_port = &regs.gpio[3];
+    uint32_t rows = 0;
+
+    if (model.pressed >= 0)
+    {
+        uint32_t column = (uint32_t)model.pressed / 4U;
+        uint32_t row = (uint32_t)model.pressed % 4U;
+
+        if (regs.gpio[0].DATA & (1U << (2U + column)))
+        {
+            rows = 1U << row;
+        }
+    }
+
+    // Rising edges on the rows (the keypad only uses edge-sensitive rising interrupts)
+    uint32_t rising = rows & ~model.rows & KEYPAD_ROWS;
+    if (rising & ~rows_port->IS & rows_port->IEV)
+    {
+        rows_port->RIS |= rising;
+    }
+    model.rows = rows;
+}
+
+static void Host_Device_Key_Event(void)
+{
+    uint32_t event = model.next_key_event++;
+    uint32_t key = event / 2U;
+
+    if ((event & 1U) == 0U)
+    {
+        model.pressed = model.key_index[key];
+        model.current_key = (int)key;
+    }
+    else
+    {
+        model.pressed = -1;
+    }
+    Host_Device_Update_Rows();
+}
+
+// ----- LCD controller -----
+
+static void Host_Device_Lcd_Execute(uint8_t byte, uint8_t data)
+{
+    if (data)
+    {
+        if (!model.lcd_cgram)
+        {
+            model.ddram[model.lcd_address] = byte;
+            model.lcd_address = (model.lcd_address == 0x27U) ? 0x40U :
+                                (model.lcd_address == 0x67U) ? 0x00U : (uint8_t)(model.lcd_address + 1U);
+        }
+
+        model.stats.lcd_bytes++;
+        if (model.current_key >= 0)
+        {
+            model.stats.key_lcd_ps[model.current_key] = model.now_ps;
+        }
+        return;
+    }
+
+    if (byte & 0x80U)
+    {
+        model.lcd_address = byte & 0x7FU;
+        model.lcd_cgram = 0;
+    }
+    else if (byte & 0x40U)
+    {
+        model.lcd_cgram = 1;
+    }
+    else if (byte & 0x20U)
+    {
+        model.lcd_four_bit = (byte & 0x10U) == 0U;
+    }
+    else if (byte & 0x02U)
+    {
+        model.lcd_address = 0;
+    }
+    else if (byte & 0x01U)
+    {
+        memset(model.ddram, ' ', sizeof(model.ddram));
+        model.lcd_address = 0;
+    }
+}
+
+// Falling edge of E: latch D7-D4 (PA5-PA2) with RS (PE0)
+static void Host_Device_Lcd_Latch(void)
+{
+    uint8_t nibble = (uint8_t)((regs.gpio[0].DATA & KEYPAD_COLUMNS) >> 2);
+    uint8_t data = (uint8_t)(regs.gpio[4].DATA & LCD_RS);
+
+    if (!model.lcd_four_bit)
+    {
+        // 8-bit mode: D3-D0 are not connected and read as 0
+        Host_Device_Lcd_Execute((uint8_t)(nibble << 4), data);
+        model.lcd_have_upper = 0;
+    }
+    else if (!model.lcd_have_upper)
+    {
+        model.lcd_upper = nibble;
+        model.lcd_have_upper = 1;
+    }
+    else
+    {
+        model.lcd_have_upper = 0;
+        Host_Device_Lcd_Execute((uint8_t)((model.lcd_upper << 4) | nibble), data);
+    }
+}
+
+// ----- Register writes -----
+
+static void Host_Device_Flash_Command(uint32_t command)
+{
+    uint32_t address = regs.flash_ctrl.FMA;
+    uint64_t duration_us = (command & FMC_ERASE) ? HOST_DEVICE_FLASH_ERASE_US : HOST_DEVICE_FLASH_PROGRAM_US;
+
+    if (address < JOURNAL_FLASH_BASE || address >= JOURNAL_FLASH_BASE + JOURNAL_FLASH_SIZE)
+    {
+        *(volatile uint32_t *)&regs.flash_ctrl.FCRIS |= FCRIS_ACCESS_ERROR;
+        return;
+    }
+
+    if (command & FMC_ERASE)
+    {
+        memset((void *)(uintptr_t)(address & ~(FLASH_PAGE_BYTES - 1U)), 0xFF, FLASH_PAGE_BYTES);
+        model.stats.flash_erases++;
+    }
+    else
+    {
+        // Programming can only clear bits
+        *(uint32_t *)(uintptr_t)(address & ~3U) &= regs.flash_ctrl.FMD;
+        model.stats.flash_programs++;
+    }
+
+    model.flash_busy_until_ps = model.now_ps + duration_us * HOST_DEVICE_PS_PER_US;
+}
+
+static void Host_Device_Apply_Write(Host_Peripheral peripheral)
+{
+    switch (peripheral)
+    {
+        case HOST_GPIOA:
+        case HOST_GPIOB:
+        case HOST_GPIOC:
+        case HOST_GPIOD:
+        case HOST_GPIOE:
+        case HOST_GPIOF:
+        {
+            GPIOA_Type *port = &regs.gpio[peripheral - HOST_GPIOA];
+            uint32_t previous = model.shadow_gpio_data[peripheral - HOST_GPIOA];
+
+            if (port->ICR != 0U)
+            {
+                port->RIS &= ~port->ICR;
+                port->ICR = 0;
+            }
+            if (port->DATA == previous)
+            {
+                break;
+            }
+            if (peripheral == HOST_GPIOA)
+            {
+                Host_Device_Update_Rows();
+            }
+            else if (peripheral == HOST_GPIOC && (previous & LCD_E) && !(port->DATA & LCD_E))
+            {
+                Host_Device_Lcd_Latch();
+            }
+            break;
+        }
+
+        case HOST_SYSTICK:
+            if (!model.systick_running && (regs.systick.CTRL & SYSTICK_CTRL_ENABLE))
+            {
+                model.systick_running = 1;
+                model.systick_start_ps = model.now_ps;
+                model.systick_wraps = 0;
+            }
+            break;
+
+        case HOST_DWT:
+            if (regs.dwt.CYCCNT != model.shadow_cyccnt)
+            {
+                model.cyccnt_offset = regs.dwt.CYCCNT - (uint32_t)model.cycles;
+            }
+            break;
+
+        case HOST_UART0:
+            if (regs.uart0.DR != UART_DR_EMPTY)
+            {
+                model.stats.uart_bytes++;
+                if (model.uart_output != NULL)
+                {
+                    model.uart_output((uint8_t)regs.uart0.DR, model.uart_context);
+                }
+            }
+            break;
+
+        case HOST_TIMER2:
+        {
+            TIMER0_Type *timer = &regs.timer[2];
+
+            if (timer->ICR != 0U)
+            {
+                *(volatile uint32_t *)&timer->RIS &= ~timer->ICR;
+                timer->ICR = 0;
+            }
+            if ((timer->CTL & TIMER_CTL_TAEN) && !(model.shadow_timer_ctl & TIMER_CTL_TAEN))
+            {
+                // One-shot, counts down from TAILR at the system clock
+                model.timer2_deadline_ps = model.now_ps + ((uint64_t)timer->TAILR + 1U) * model.cycle_ps;
+            }
+            else if (!(timer->CTL & TIMER_CTL_TAEN))
+            {
+                model.timer2_deadline_ps = NO_EVENT;
+            }
+            break;
+        }
+
+        case HOST_EEPROM:
+            if (regs.eeprom.EERDWR != model.shadow_eerdwr)
+            {
+                uint32_t word = regs.eeprom.EEBLOCK * 16U + regs.eeprom.EEOFFSET;
+
+                if (word < EEPROM_WORDS)
+                {
+                    model.eeprom[word] = regs.eeprom.EERDWR;
+                }
+            }
+            break;
+
+        case HOST_FLASH_CTRL:
+            if ((regs.flash_ctrl.FMC & (FMC_WRITE | FMC_ERASE)) && regs.flash_ctrl.FMC != model.shadow_fmc)
+            {
+                *(volatile uint32_t *)&regs.flash_ctrl.FCRIS = 0;
+                Host_Device_Flash_Command(regs.flash_ctrl.FMC);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+// ----- Register reads -----
+
+static void Host_Device_Refresh(Host_Peripheral peripheral)
+{
+    switch (peripheral)
+    {
+        case HOST_GPIOA:
+        case HOST_GPIOB:
+        case HOST_GPIOC:
+        case HOST_GPIOD:
+        case HOST_GPIOE:
+        case HOST_GPIOF:
+        {
+            GPIOA_Type *port = &regs.gpio[peripheral - HOST_GPIOA];
+
+            if (peripheral == HOST_GPIOD)
+            {
+                port->DATA = (port->DATA & ~KEYPAD_ROWS) | model.rows;
+            }
+            port->MIS = port->RIS & port->IM;
+            model.shadow_gpio_data[peripheral - HOST_GPIOA] = port->DATA;
+            break;
+        }
+
+        case HOST_SYSTICK:
+        {
+            uint32_t reload = regs.systick.LOAD & ((1U << SYSTICK_COUNTER_BITS) - 1U);
+
+            regs.systick.VAL = model.systick_running ? reload - (uint32_t)(Host_Device_Ticks() & reload) : 0U;
+            break;
+        }
+
+        case HOST_SCB:
+            regs.scb.ICSR = model.systick_pending ? SCB_ICSR_PENDSTSET_Msk : 0U;
+            break;
+
+        case HOST_DWT:
+            regs.dwt.CYCCNT = (uint32_t)model.cycles + model.cyccnt_offset;
+            model.shadow_cyccnt = regs.dwt.CYCCNT;
+            break;
+
+        case HOST_SYSCTL:
+            *(volatile uint32_t *)&regs.sysctl.PRWD = regs.sysctl.RCGCWD;
+            *(volatile uint32_t *)&regs.sysctl.PRTIMER = regs.sysctl.RCGCTIMER;
+            *(volatile uint32_t *)&regs.sysctl.PRGPIO = regs.sysctl.RCGCGPIO;
+            *(volatile uint32_t *)&regs.sysctl.PRUART = regs.sysctl.RCGCUART;
+            *(volatile uint32_t *)&regs.sysctl.PREEPROM = regs.sysctl.RCGCEEPROM;
+            // Writing MISC clears the lock status, which comes back at once
+            if ((regs.sysctl.MISC & SYSCTL_PLLLRIS) != 0U)
+            {
+                regs.sysctl.RIS &= ~SYSCTL_PLLLRIS;
+                regs.sysctl.MISC = 0;
+            }
+            if (!model.pll_fails)
+            {
+                regs.sysctl.RIS |= SYSCTL_PLLLRIS;
+            }
+            break;
+
+        case HOST_UART0:
+            *(volatile uint32_t *)&regs.uart0.FR = 0;
+            regs.uart0.DR = UART_DR_EMPTY;
+            break;
+
+        case HOST_TIMER2:
+            model.shadow_timer_ctl = regs.timer[2].CTL;
+            break;
+
+        case HOST_EEPROM:
+        {
+            uint32_t word = regs.eeprom.EEBLOCK * 16U + regs.eeprom.EEOFFSET;
+
+            *(volatile uint32_t *)&regs.eeprom.EEDONE = 0;
+            regs.eeprom.EESUPP = 0;
+            regs.eeprom.EERDWR = (word < EEPROM_WORDS) ? model.eeprom[word] : 0U;
+            model.shadow_eerdwr = regs.eeprom.EERDWR;
+            break;
+        }
+
+        case HOST_FLASH_CTRL:
+            // A busy controller is only polled: jump to the end of the operation
+            if (model.flash_busy_until_ps > model.now_ps)
+            {
+                Host_Device_Advance(model.flash_busy_until_ps, 0);
+                model.stats.spins++;
+            }
+            regs.flash_ctrl.FMC &= ~(FMC_WRITE | FMC_ERASE);
+            model.shadow_fmc = regs.flash_ctrl.FMC;
+            break;
+
+        default:
+            break;
+    }
+}
+
+// ----- Events and interrupts -----
+
+static void Host_Device_Run_Events(void)
+{
+    if (Host_Device_Next_Wrap_ps() <= model.now_ps)
+    {
+        model.systick_wraps++;
+        if (regs.systick.CTRL & SYSTICK_CTRL_TICKINT)
+        {
+            model.systick_pending = 1;
+        }
+    }
+
+    while (Host_Device_Next_Key_ps() <= model.now_ps)
+    {
+        Host_Device_Key_Event();
+    }
+
+    if (model.timer2_deadline_ps <= model.now_ps)
+    {
+        model.timer2_deadline_ps = NO_EVENT;
+        regs.timer[2].CTL &= ~TIMER_CTL_TAEN;
+        *(volatile uint32_t *)&regs.timer[2].RIS |= TIMER_TATORIS;
+    }
+}
+
+// Move the virtual clock forward, running the events on the way
+static void Host_Device_Advance(uint64_t target_ps, uint8_t sleeping)
+{
+    while (model.now_ps < target_ps)
+    {
+        uint64_t next_ps = Host_Device_Next_Event_ps();
+        uint64_t step_ps = ((next_ps < target_ps) ? next_ps : target_ps) - model.now_ps;
+        uint64_t total_ps = model.cycle_remainder_ps + step_ps;
+
+        model.now_ps += step_ps;
+        model.cycles += total_ps / model.cycle_ps;
+        model.cycle_remainder_ps = total_ps % model.cycle_ps;
+
+        if (sleeping)
+        {
+            model.stats.sleep_ps += step_ps;
+        }
+        else
+        {
+            model.stats.busy_ps += step_ps;
+            if (model.current_key >= 0)
+            {
+                model.stats.key_busy_ps[model.current_key] += step_ps;
+            }
+        }
+
+        Host_Device_Run_Events();
+    }
+}
+
+static uint8_t Host_Device_Asserted(Source source)
+{
+    switch (source)
+    {
+        case SOURCE_SYSTICK:
+            return model.systick_pending;
+        case SOURCE_GPIOD:
+            return (regs.gpio[3].RIS & regs.gpio[3].IM) != 0U;
+        case SOURCE_TIMER2A:
+            return (regs.timer[2].RIS & regs.timer[2].IMR & TIMER_TATORIS) != 0U;
+        default:
+            return 0;
+    }
+}
+
+// Pending, enabled and above the BASEPRI level (PRIMASK is checked by the callers)
+static int Host_Device_Next_Source(void)
+{
+    int best = -1;
+
+    for (int source = 0; source < SOURCE_COUNT; source++)
+    {
+        uint32_t level = model.priority[source] << (8 - __NVIC_PRIO_BITS);
+
+        if (!model.enabled[source] || !Host_Device_Asserted((Source)source))
+        {
+            continue;
+        }
+        if (model.basepri != 0U && level >= model.basepri)
+        {
+            continue;
+        }
+        if (best < 0 || model.priority[source] < model.priority[best])
+        {
+            best = source;
+        }
+    }
+    return best;
+}
+
+static void Host_Device_Dispatch(void)
+{
+    int source;
+
+    if (model.in_handler || model.primask)
+    {
+        return;
+    }
+
+    while ((source = Host_Device_Next_Source()) >= 0)
+    {
+        if (source == SOURCE_SYSTICK)
+        {
+            model.systick_pending = 0;
+        }
+
+        model.in_handler = 1;
+        model.stats.interrupts++;
+        sources[source].handler();
+
+        // The last write of the handler
+        if (model.last != NO_PERIPHERAL)
+        {
+            Host_Device_Apply_Write(model.last);
+            model.last = NO_PERIPHERAL;
+        }
+        model.in_handler = 0;
+    }
+}
+
+static void Host_Device_Check_Limit(void)
+{
+    if (model.exit != NULL && model.now_ps >= model.limit_ps && !model.in_handler)
+    {
+        model.exit(model.exit_context);
+    }
+}
+
+// ----- Interface used by the stub device header -----
+
+void *Host_Device_Access(Host_Peripheral peripheral)
+{
+    if (model.last != NO_PERIPHERAL)
+    {
+        Host_Device_Apply_Write(model.last);
+        model.last = NO_PERIPHERAL;
+    }
+
+    model.stats.accesses++;
+    Host_Device_Update_Clock();
+    Host_Device_Advance(model.now_ps + HOST_DEVICE_ACCESS_CYCLES * model.cycle_ps, 0);
+    Host_Device_Dispatch();
+    Host_Device_Check_Limit();
+
+    Host_Device_Refresh(peripheral);
+    model.last = peripheral;
+    return peripherals[peripheral];
+}
+
+void Host_Device_Spin_Until(uint64_t deadline_ticks)
+{
+    uint64_t deadline_ps = model.systick_start_ps + deadline_ticks * HOST_DEVICE_PS_PER_TICK;
+    uint64_t next_ps = Host_Device_Next_Event_ps();
+
+    if (model.last != NO_PERIPHERAL)
+    {
+        Host_Device_Apply_Write(model.last);
+        model.last = NO_PERIPHERAL;
+    }
+
+    // The loop only reads the timebase: nothing changes before the deadline
+    // or the next event, whichever comes first
+    Host_Device_Advance((next_ps < deadline_ps) ? next_ps : deadline_ps, 0);
+    model.stats.spins++;
+    Host_Device_Dispatch();
+    Host_Device_Check_Limit();
+}
+
+void Host_Device_Wait_For_Interrupt(void)
+{
+    if (model.last != NO_PERIPHERAL)
+    {
+        Host_Device_Apply_Write(model.last);
+        model.last = NO_PERIPHERAL;
+    }
+
+    if (model.exit != NULL && model.now_ps >= model.end_ps && !model.in_handler)
+    {
+        model.exit(model.exit_context);
+    }
+
+    // WFI ends on a pending interrupt that PRIMASK alone would hold back
+    while (Host_Device_Next_Source() < 0)
+    {
+        uint64_t next_ps = Host_Device_Next_Event_ps();
+
+        if (next_ps == NO_EVENT)
+        {
+            // Nothing will ever happen: the session is over
+            if (model.exit != NULL)
+            {
+                model.exit(model.exit_context);
+            }
+            return;
+        }
+        Host_Device_Advance(next_ps, 1);
+    }
+
+    Host_Device_Dispatch();
+}
+
+uint32_t Host_Device_Get_Primask(void)
+{
+    return model.primask;
+}
+
+void Host_Device_Set_Primask(uint32_t primask)
+{
+    model.primask = primask & 1U;
+    Host_Device_Dispatch();
+}
+
+uint32_t Host_Device_Get_Basepri(void)
+{
+    return model.basepri;
+}
+
+void Host_Device_Set_Basepri(uint32_t basepri)
+{
+    model.basepri = basepri;
+    Host_Device_Dispatch();
+}
+
+static int Host_Device_Source(IRQn_Type irq)
+{
+    for (int source = 0; source < SOURCE_COUNT; source++)
+    {
+        if (sources[source].irq == irq)
+        {
+            return source;
+        }
+    }
+    return -1;
+}
+
+void Host_Device_Enable_IRQ(IRQn_Type irq, uint8_t enable)
+{
+    int source = Host_Device_Source(irq);
+
+    if (source >= 0 && source != SOURCE_SYSTICK)
+    {
+        model.enabled[source] = enable;
+    }
+}
+
+void Host_Device_Set_Priority(IRQn_Type irq, uint32_t priority)
+{
+    int source = Host_Device_Source(irq);
+
+    if (source >= 0)
+    {
+        model.priority[source] = priority & ((1U << __NVIC_PRIO_BITS) - 1U);
+    }
+}
+
+// ----- Interface used by the simulator -----
+
+int Host_Device_Init(const Host_Device_Key *keys, uint32_t count)
+{
+    if (!memory_mapped)
+    {
+        if (Host_Device_Map(JOURNAL_FLASH_BASE, JOURNAL_FLASH_SIZE, 0xFF) != 0 ||
+            Host_Device_Map(SRAM_TOP_PAGE, SRAM_TOP_PAGE_SIZE, 0x00) != 0)
+        {
+            return -1;
+        }
+        memory_mapped = 1;
+    }
+    else
+    {
+        memset((void *)(uintptr_t)JOURNAL_FLASH_BASE, 0xFF, JOURNAL_FLASH_SIZE);
+        memset((void *)(uintptr_t)SRAM_TOP_PAGE, 0x00, SRAM_TOP_PAGE_SIZE);
+    }
+
+    memset(&regs, 0, sizeof(regs));
+    memset(&model, 0, sizeof(model));
+
+    SystemCoreClock = 16000000U;
+    Host_Device_Update_Clock();
+
+    model.last = NO_PERIPHERAL;
+    model.timer2_deadline_ps = NO_EVENT;
+    model.pressed = -1;
+    model.current_key = -1;
+    model.enabled[SOURCE_SYSTICK] = 1;
+    model.end_ps = NO_EVENT;
+    model.limit_ps = NO_EVENT;
+    memset(model.ddram, ' ', sizeof(model.ddram));
+    memset(model.eeprom, 0xFF, sizeof(model.eeprom));
+
+    // The SysTick reload value is used before the first access refreshes it
+    regs.systick.LOAD = (1U << SYSTICK_COUNTER_BITS) - 1U;
+
+    // Flash write key selected by BOOTCFG.KEY (erased: 0xA442)
+    regs.flash_ctrl.BOOTCFG = 0xFFFFFFFEU;
+
+    model.key_count = (count < HOST_DEVICE_MAX_KEYS) ? count : HOST_DEVICE_MAX_KEYS;
+    for (uint32_t i = 0; i < model.key_count; i++)
+    {
+        model.keys[i] = keys[i];
+        model.key_index[i] = 0;
+        for (uint8_t index = 0; index < HOST_DEVICE_KEY_COUNT; index++)
+        {
+            if (keypad_map[index] == keys[i].key)
+            {
+                model.key_index[i] = index;
+            }
+        }
+    }
+    return 0;
+}
+
+void Host_Device_Set_Pll_Fails(uint8_t fails)
+{
+    model.pll_fails = fails;
+}
+
+void Host_Device_Set_Uart_Output(Host_Device_Output_Fn output, void *context)
+{
+    model.uart_output = output;
+    model.uart_context = context;
+}
+
+void Host_Device_Set_Exit(uint64_t end_ps, uint64_t limit_ps, Host_Device_Exit_Fn exit, void *context)
+{
+    model.end_ps = end_ps;
+    model.limit_ps = limit_ps;
+    model.exit = exit;
+    model.exit_context = context;
+}
+
+uint64_t Host_Device_Now_ps(void)
+{
+    return model.now_ps;
+}
+
+void Host_Device_Get_Lcd(char lines[2][17])
+{
+    for (uint32_t i = 0; i < 16U; i++)
+    {
+        lines[0][i] = (char)model.ddram[i];
+        lines[1][i] = (char)model.ddram[0x40U + i];
+    }
+    lines[0][16] = '\0';
+    lines[1][16] = '\0';
+}
+
+const Host_Device_Stats *Host_Device_Get_Stats(void)
+{
+    return &model.stats;
+}
@@ -0,0 +1,168 @@
+/**
+ * @file Host_Device.h
+ *
+ * @brief Device model and virtual clock of the host simulator.
+ *
+ * The firmware sources are compiled for the host against the stub device
+ * header (tests/stub/TM4C123GH6PM.h), whose peripheral macros call
+ * Host_Device_Access on every register access. The model implements the
+ * parts of the board the drivers use:
+ *  - SysTick (4 MHz timebase and wrap interrupt), DWT cycle counter
+ *  - SYSCTL: clock gates always ready, PLL locks at once (or never, see
+ *    Host_Device_Set_Pll_Fails)
+ *  - Timer 2A one-shot (keypad scan sleep) and its interrupt
+ *  - 4x4 keypad matrix on PA2-PA5 / PD0-PD3, with the row interrupts,
+ *    pressed and released from a list of key events
+ *  - HD44780 LCD in 4-bit mode on PA2-PA5, PC6 (E) and PE0 (RS)
+ *  - UART0 transmitter, never busy; each byte goes to a callback
+ *  - Flash controller (erase and program with their duration) and the
+ *    EEPROM, both starting erased
+ *
+ * Time is virtual and event-driven. It only advances by a small cost per
+ * register access and in waits: a SysTick_Delay1us loop hands its
+ * deadline to Host_Device_Spin_Until, WFI (Host_Device_Wait_For_Interrupt)
+ * and a poll of a busy flash controller jump straight to the next event
+ * (a timer expiry, a SysTick wrap, a key press or release, the end of a
+ * flash operation). A 50 ms LCD power-on delay or a 20 ms debounce costs
+ * a few host microseconds, and the timing seen by the firmware is the
+ * same on every run.
+ *
+ * The computation between register accesses takes no virtual time, so
+ * the waits (which dominate the latency of a key) are exact and the
+ * cycles of the engine are not modelled. The watchdog time-out and the
+ * profiler timer are not modelled.
+ *
+ * The model is a single instance per process; tests/sim/Host_Sim.c runs
+ * each session in a child process.
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef HOST_DEVICE_H_
+#define HOST_DEVICE_H_
+
+#include "TM4C123GH6PM.h"
+#include <stdint.h>
+
+// Virtual time is counted in picoseconds
+#define HOST_DEVICE_PS_PER_US           1000000ULL
+
+// SysTick runs from PIOSC / 4 = 4 MHz
+#define HOST_DEVICE_PS_PER_TICK         250000ULL
+
+// Cost of one register access, in CPU cycles
+#define HOST_DEVICE_ACCESS_CYCLES       2U
+
+// Duration of the flash operations
+#define HOST_DEVICE_FLASH_ERASE_US      10000U
+#define HOST_DEVICE_FLASH_PROGRAM_US    50U
+
+// Keypad matrix
+#define HOST_DEVICE_KEY_COUNT           16U
+
+// Most key events in a session
+#define HOST_DEVICE_MAX_KEYS            256U
+
+typedef struct {
+    char key;               // Character on the keypad, e.g. '7' or '+'
+    uint64_t press_ps;
+    uint64_t release_ps;
+} Host_Device_Key;
+
+typedef struct {
+    uint64_t busy_ps;           // Virtual time outside WFI
+    uint64_t sleep_ps;          // Virtual time in WFI
+    uint64_t accesses;          // Register accesses
+    uint64_t spins;             // Jumps of the virtual clock in delay loops
+    uint32_t interrupts;        // Interrupt handlers run
+    uint32_t lcd_bytes;         // Bytes latched by the LCD controller
+    uint32_t uart_bytes;
+    uint32_t flash_erases;
+    uint32_t flash_programs;
+
+    // Per key event: time of the last LCD byte before the next press
+    // (0 if none), and the virtual time outside WFI in the same interval
+    uint64_t key_lcd_ps[HOST_DEVICE_MAX_KEYS];
+    uint64_t key_busy_ps[HOST_DEVICE_MAX_KEYS];
+} Host_Device_Stats;
+
+typedef void (*Host_Device_Output_Fn)(uint8_t byte, void *context);
+typedef void (*Host_Device_Exit_Fn)(void *context);
+
+/**
+ * @brief Reset the model for a new session.
+ *
+ * Maps the journal flash (0x38000-0x3FFFF, erased) and the top page of
+ * SRAM (for the watchdog record) at their target addresses, so the
+ * firmware can read them through pointers.
+ *
+ * @param keys  The key events, in order of press time (copied).
+ * @param count The number of key events.
+ *
+ * @return int 0 on success, -1 if the target addresses cannot be mapped.
+ */
+int Host_Device_Init(const Host_Device_Key *keys, uint32_t count);
+
+/**
+ * @brief Make the PLL fail to lock, to test the clock fallback.
+ *
+ * @param fails 1 to keep the PLL from locking, 0 to let it lock at once.
+ *
+ * @return None
+ */
+void Host_Device_Set_Pll_Fails(uint8_t fails);
+
+/**
+ * @brief Set where the bytes sent on UART0 go.
+ *
+ * @param output  Called for each byte, or NULL to drop them.
+ * @param context Passed to output.
+ *
+ * @return None
+ */
+void Host_Device_Set_Uart_Output(Host_Device_Output_Fn output, void *context);
+
+/**
+ * @brief Set how a session ends.
+ *
+ * When the firmware waits (WFI) at or after end_ps, exit is called; it
+ * must not return (e.g. it calls longjmp). It is also called from any
+ * register access after limit_ps, for a firmware that stopped waiting.
+ *
+ * @param end_ps   Virtual time at which an idle firmware is stopped.
+ * @param limit_ps Virtual time at which the firmware is stopped anyway.
+ * @param exit     The exit function.
+ * @param context  Passed to exit.
+ *
+ * @return None
+ */
+void Host_Device_Set_Exit(uint64_t end_ps, uint64_t limit_ps, Host_Device_Exit_Fn exit, void *context);
+
+/**
+ * @brief Get the virtual time.
+ *
+ * @param None
+ *
+ * @return uint64_t Picoseconds since the start of the session.
+ */
+uint64_t Host_Device_Now_ps(void);
+
+/**
+ * @brief Get the text shown on the LCD.
+ *
+ * @param lines Receives the two lines (16 characters and a terminator each).
+ *
+ * @return None
+ */
+void Host_Device_Get_Lcd(char lines[2][17]);
+
+/**
+ * @brief Get the statistics of the session.
+ *
+ * @param None
+ *
+ * @return const Host_Device_Stats* The statistics.
+ */
+const Host_Device_Stats *Host_Device_Get_Stats(void);
+
+#endif // HOST_DEVICE_H_
@@ -0,0 +1,368 @@
+/**
+ * @file Host_Farm.c
+ *
+ * @brief Runs a corpus of key sessions on the simulator, on every core.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Host_Farm.h"
+#include "Host_Sim.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define PS_PER_US       1000000.0
+
+#define CSV_HEADER      "name,completed,keys,lcd_bytes,mean_latency_us,max_latency_us,slowest_key,busy_us,virtual_ms,host_ms"
+
+typedef struct {
+    const Host_Farm_Result *base;
+    const Host_Farm_Result *next;
+    double change_us;
+} Host_Farm_Change;
+
+int Host_Farm_Read_Sessions(FILE *file, Host_Farm_Session *sessions, uint32_t max)
+{
+    char line[HOST_FARM_NAME_LENGTH + HOST_FARM_KEYS_LENGTH + 16];
+    uint32_t count = 0;
+
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        char name[sizeof(line)];
+        char keys[sizeof(line)];
+        char rest;
+        int fields = sscanf(line, "%s %s %c", name, keys, &rest);
+
+        if (fields <= 0 || name[0] == '#')
+        {
+            continue;
+        }
+        if (fields != 2 || count >= max || strlen(name) >= HOST_FARM_NAME_LENGTH ||
+            strlen(keys) >= HOST_FARM_KEYS_LENGTH)
+        {
+            return -1;
+        }
+
+        strcpy(sessions[count].name, name);
+        strcpy(sessions[count].keys, keys);
+        count++;
+    }
+    return (int)count;
+}
+
+static void Host_Farm_Summarize(const Host_Sim_Result *sim, Host_Farm_Result *result)
+{
+    double total_us = 0.0;
+    uint32_t shown = 0;
+
+    result->completed = sim->completed;
+    result->key_count = sim->key_count;
+    result->lcd_bytes = sim->stats.lcd_bytes;
+    result->busy_us = (double)sim->stats.busy_ps / PS_PER_US;
+    result->virtual_ms = (double)sim->end_ps / (1000.0 * PS_PER_US);
+    result->host_ms = sim->host_seconds * 1000.0;
+
+    // A key that did not change the display (e.g. a second '.') has no latency
+    for (uint32_t i = 0; i < sim->key_count; i++)
+    {
+        if (sim->stats.key_lcd_ps[i] <= sim->keys[i].press_ps)
+        {
+            continue;
+        }
+
+        double latency_us = (double)(sim->stats.key_lcd_ps[i] - sim->keys[i].press_ps) / PS_PER_US;
+
+        if (latency_us > result->max_latency_us)
+        {
+            result->max_latency_us = latency_us;
+            result->slowest_key = sim->keys[i].key;
+        }
+        total_us += latency_us;
+        shown++;
+    }
+    result->mean_latency_us = (shown > 0) ? total_us / shown : 0.0;
+}
+
+// Worker process: takes the next session until there are none left
+static void Host_Farm_Worker(const Host_Farm_Session *sessions, uint32_t count, uint32_t *next,
+                             Host_Farm_Result *results)
+{
+    static Host_Sim_Result sim;
+    uint32_t i;
+
+    while ((i = __atomic_fetch_add(next, 1U, __ATOMIC_RELAXED)) < count)
+    {
+        Host_Farm_Result *result = &results[i];
+
+        memset(result, 0, sizeof(*result));
+        strcpy(result->name, sessions[i].name);
+        if (Host_Sim_Run(sessions[i].keys, &sim) == 0)
+        {
+            Host_Farm_Summarize(&sim, result);
+        }
+    }
+    _exit(0);
+}
+
+int Host_Farm_Run(const Host_Farm_Session *sessions, uint32_t count, uint32_t workers,
+                  Host_Farm_Result *results)
+{
+    size_t size = sizeof(uint32_t) + count * sizeof(Host_Farm_Result);
+    int status = 0;
+
+    if (workers == 0)
+    {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = (cores > 0) ? (uint32_t)cores : 1U;
+    }
+    if (workers > count)
+    {
+        workers = (count > 0) ? count : 1U;
+    }
+
+    // The work index and the results are shared with the workers
+    uint8_t *shared = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED)
+    {
+        return -1;
+    }
+
+    uint32_t *next = (uint32_t *)shared;
+    Host_Farm_Result *shared_results = (Host_Farm_Result *)(shared + sizeof(uint32_t));
+    uint32_t started = 0;
+
+    *next = 0;
+    for (; started < workers; started++)
+    {
+        pid_t worker = fork();
+
+        if (worker == 0)
+        {
+            Host_Farm_Worker(sessions, count, next, shared_results);
+        }
+        if (worker < 0)
+        {
+            break;
+        }
+    }
+
+    for (uint32_t i = 0; i < started; i++)
+    {
+        int worker_status;
+
+        if (wait(&worker_status) < 0 || !WIFEXITED(worker_status) || WEXITSTATUS(worker_status) != 0)
+        {
+            status = -1;
+        }
+    }
+
+    if (started == 0)
+    {
+        status = -1;
+    }
+    memcpy(results, shared_results, count * sizeof(Host_Farm_Result));
+    munmap(shared, size);
+    return status;
+}
+
+static int Host_Farm_Compare_Slowest(const void *a, const void *b)
+{
+    const Host_Farm_Result *x = a;
+    const Host_Farm_Result *y = b;
+
+    // Failed sessions first, then by slowest key, then by name for a stable order
+    if (x->completed != y->completed)
+    {
+        return (x->completed < y->completed) ? -1 : 1;
+    }
+    if (x->max_latency_us != y->max_latency_us)
+    {
+        return (x->max_latency_us > y->max_latency_us) ? -1 : 1;
+    }
+    return strcmp(x->name, y->name);
+}
+
+void Host_Farm_Sort_Slowest(Host_Farm_Result *results, uint32_t count)
+{
+    qsort(results, count, sizeof(results[0]), Host_Farm_Compare_Slowest);
+}
+
+void Host_Farm_Write_Csv(FILE *file, const Host_Farm_Result *results, uint32_t count)
+{
+    fprintf(file, "%s\n", CSV_HEADER);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const Host_Farm_Result *r = &results[i];
+        char slowest_key[2] = { r->slowest_key, '\0' };
+
+        fprintf(file, "%s,%u,%u,%u,%.3f,%.3f,%s,%.3f,%.3f,%.3f\n", r->name, r->completed, r->key_count,
+                r->lcd_bytes, r->mean_latency_us, r->max_latency_us, r->slowest_key ? slowest_key : "none",
+                r->busy_us, r->virtual_ms, r->host_ms);
+    }
+}
+
+int Host_Farm_Read_Csv(FILE *file, Host_Farm_Result *results, uint32_t max)
+{
+    char line[256];
+    uint32_t count = 0;
+
+    if (fgets(line, sizeof(line), file) == NULL || strncmp(line, CSV_HEADER, strlen(CSV_HEADER)) != 0)
+    {
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        Host_Farm_Result *r = &results[count];
+        unsigned completed;
+        char slowest_key[8];
+        char *comma = strchr(line, ',');
+
+        if (count >= max || comma == NULL || (size_t)(comma - line) >= HOST_FARM_NAME_LENGTH)
+        {
+            return -1;
+        }
+
+        memset(r, 0, sizeof(*r));
+        memcpy(r->name, line, (size_t)(comma - line));
+        if (sscanf(comma + 1, "%u,%u,%u,%lf,%lf,%7[^,],%lf,%lf,%lf", &completed, &r->key_count, &r->lcd_bytes,
+                   &r->mean_latency_us, &r->max_latency_us, slowest_key, &r->busy_us, &r->virtual_ms,
+                   &r->host_ms) != 9)
+        {
+            return -1;
+        }
+        r->completed = (uint8_t)completed;
+        r->slowest_key = (strcmp(slowest_key, "none") == 0) ? '\0' : slowest_key[0];
+        count++;
+    }
+    return (int)count;
+}
+
+void Host_Farm_Report(FILE *file, const Host_Farm_Result *results, uint32_t count, uint32_t top)
+{
+    Host_Farm_Result *sorted = malloc((count > 0 ? count : 1U) * sizeof(*sorted));
+    uint32_t failed = 0;
+    double host_ms = 0.0;
+    double virtual_ms = 0.0;
+
+    if (sorted == NULL)
+    {
+        return;
+    }
+    memcpy(sorted, results, count * sizeof(*sorted));
+    Host_Farm_Sort_Slowest(sorted, count);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        failed += !results[i].completed;
+        host_ms += results[i].host_ms;
+        virtual_ms += results[i].virtual_ms;
+    }
+    fprintf(file, "%u sessions, %u failed, %.1f virtual s in %.3f host s of sessions\n", count, failed,
+            virtual_ms / 1000.0, host_ms / 1000.0);
+
+    fprintf(file, "%-24s %6s %12s %12s %12s\n", "slowest", "keys", "max_us", "mean_us", "busy_us");
+    for (uint32_t i = 0; i < count && i < top; i++)
+    {
+        const Host_Farm_Result *r = &sorted[i];
+
+        fprintf(file, "%-24s %6u %12.1f %12.1f %12.1f %s\n", r->name, r->key_count, r->max_latency_us,
+                r->mean_latency_us, r->busy_us, r->completed ? "" : "FAILED");
+    }
+    free(sorted);
+}
+
+static const Host_Farm_Result *Host_Farm_Find(const Host_Farm_Result *results, uint32_t count, const char *name)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (strcmp(results[i].name, name) == 0)
+        {
+            return &results[i];
+        }
+    }
+    return NULL;
+}
+
+static int Host_Farm_Compare_Change(const void *a, const void *b)
+{
+    const Host_Farm_Change *x = a;
+    const Host_Farm_Change *y = b;
+
+    if (fabs(x->change_us) != fabs(y->change_us))
+    {
+        return (fabs(x->change_us) > fabs(y->change_us)) ? -1 : 1;
+    }
+    return strcmp(x->next->name, y->next->name);
+}
+
+void Host_Farm_Diff(FILE *file, const Host_Farm_Result *base, uint32_t base_count,
+                    const Host_Farm_Result *next, uint32_t next_count, uint32_t top)
+{
+    Host_Farm_Change *changes = malloc((next_count > 0 ? next_count : 1U) * sizeof(*changes));
+    uint32_t matched = 0;
+    double base_total_us = 0.0;
+    double next_total_us = 0.0;
+    double base_busy_us = 0.0;
+    double next_busy_us = 0.0;
+
+    if (changes == NULL)
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < next_count; i++)
+    {
+        const Host_Farm_Result *match = Host_Farm_Find(base, base_count, next[i].name);
+
+        if (match == NULL)
+        {
+            continue;
+        }
+        changes[matched].base = match;
+        changes[matched].next = &next[i];
+        changes[matched].change_us = next[i].max_latency_us - match->max_latency_us;
+        matched++;
+
+        base_total_us += match->mean_latency_us * match->key_count;
+        next_total_us += next[i].mean_latency_us * next[i].key_count;
+        base_busy_us += match->busy_us;
+        next_busy_us += next[i].busy_us;
+    }
+    qsort(changes, matched, sizeof(changes[0]), Host_Farm_Compare_Change);
+
+    fprintf(file, "%-24s %12s %12s %12s %12s\n", "session", "base_max_us", "next_max_us", "change_us",
+            "busy_change_us");
+    for (uint32_t i = 0; i < matched && i < top; i++)
+    {
+        const Host_Farm_Change *c = &changes[i];
+        const char *status = (c->base->completed && !c->next->completed) ? "FAILED" :
+                             (!c->base->completed && c->next->completed) ? "FIXED" : "";
+
+        fprintf(file, "%-24s %12.1f %12.1f %+12.1f %+12.1f %s\n", c->next->name, c->base->max_latency_us,
+                c->next->max_latency_us, c->change_us, c->next->busy_us - c->base->busy_us, status);
+    }
+
+    fprintf(file, "%u sessions compared: key latency %+.1f us in total, busy time %+.1f us\n", matched,
+            next_total_us - base_total_us, next_busy_us - base_busy_us);
+
+    for (uint32_t i = 0; i < base_count; i++)
+    {
+        if (Host_Farm_Find(next, next_count, base[i].name) == NULL)
+        {
+            fprintf(file, "only in base: %s\n", base[i].name);
+        }
+    }
+    for (uint32_t i = 0; i < next_count; i++)
+    {
+        if (Host_Farm_Find(base, base_count, next[i].name) == NULL)
+        {
+            fprintf(file, "only in next: %s\n", next[i].name);
+        }
+    }
+    free(changes);
+}
@@ -0,0 +1,136 @@
+/**
+ * @file Host_Farm.h
+ *
+ * @brief Runs a corpus of key sessions on the simulator, on every core.
+ *
+ * Each session runs on its own simulated calculator (Host_Sim_Run). A
+ * pool of worker processes takes the sessions from a shared index, so a
+ * worker that finishes early keeps taking work until the corpus is done.
+ * The results are the same for any number of workers.
+ *
+ * For each session, the latency of every key is measured in virtual time,
+ * from the press to the last LCD byte it caused, together with the time
+ * the firmware was busy (outside WFI). The results can be written to and
+ * read back from CSV, so that the runs of two firmware builds can be
+ * compared session by session.
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef HOST_FARM_H_
+#define HOST_FARM_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#define HOST_FARM_NAME_LENGTH       32U
+#define HOST_FARM_KEYS_LENGTH       256U
+
+typedef struct {
+    char name[HOST_FARM_NAME_LENGTH];
+    char keys[HOST_FARM_KEYS_LENGTH];   // Key script (Host_Sim.h)
+} Host_Farm_Session;
+
+typedef struct {
+    char name[HOST_FARM_NAME_LENGTH];
+    uint8_t completed;          // 0 if the session failed, crashed or hit the limit
+    uint32_t key_count;
+    uint32_t lcd_bytes;
+    double mean_latency_us;     // Over the keys that updated the LCD
+    double max_latency_us;
+    char slowest_key;
+    double busy_us;             // Virtual time outside WFI
+    double virtual_ms;          // Virtual length of the session
+    double host_ms;             // Host time taken by the session
+} Host_Farm_Result;
+
+/**
+ * @brief Read sessions from a text file.
+ *
+ * Each line holds a name and a key script, separated by white space.
+ * Empty lines and lines starting with '#' are skipped.
+ *
+ * @param file     The file to read.
+ * @param sessions Receives the sessions.
+ * @param max      The size of sessions.
+ *
+ * @return int The number of sessions, or -1 on a line that is not valid.
+ */
+int Host_Farm_Read_Sessions(FILE *file, Host_Farm_Session *sessions, uint32_t max);
+
+/**
+ * @brief Run sessions on a pool of worker processes.
+ *
+ * @param sessions The sessions to run.
+ * @param count    The number of sessions.
+ * @param workers  The number of worker processes (0: one per core).
+ * @param results  Receives one result per session, in the order of sessions.
+ *
+ * @return int 0 on success, -1 if the workers could not be started.
+ */
+int Host_Farm_Run(const Host_Farm_Session *sessions, uint32_t count, uint32_t workers,
+                  Host_Farm_Result *results);
+
+/**
+ * @brief Sort results by their slowest key, slowest first.
+ *
+ * @param results The results to sort.
+ * @param count   The number of results.
+ *
+ * @return None
+ */
+void Host_Farm_Sort_Slowest(Host_Farm_Result *results, uint32_t count);
+
+/**
+ * @brief Write results as CSV, with a header line.
+ *
+ * @param file    The file to write.
+ * @param results The results.
+ * @param count   The number of results.
+ *
+ * @return None
+ */
+void Host_Farm_Write_Csv(FILE *file, const Host_Farm_Result *results, uint32_t count);
+
+/**
+ * @brief Read results written by Host_Farm_Write_Csv.
+ *
+ * @param file    The file to read.
+ * @param results Receives the results.
+ * @param max     The size of results.
+ *
+ * @return int The number of results, or -1 if the file is not valid.
+ */
+int Host_Farm_Read_Csv(FILE *file, Host_Farm_Result *results, uint32_t max);
+
+/**
+ * @brief Print the slowest sessions of a run.
+ *
+ * @param file    The file to print to.
+ * @param results The results (not modified).
+ * @param count   The number of results.
+ * @param top     The number of sessions to print.
+ *
+ * @return None
+ */
+void Host_Farm_Report(FILE *file, const Host_Farm_Result *results, uint32_t count, uint32_t top);
+
+/**
+ * @brief Print the changes between the runs of two builds.
+ *
+ * Sessions are matched by name. The sessions whose slowest key changed
+ * most come first, then the totals and the sessions found in one run only.
+ *
+ * @param file     The file to print to.
+ * @param base     The results of the first build.
+ * @param base_count The number of base results.
+ * @param next     The results of the second build.
+ * @param next_count The number of next results.
+ * @param top      The number of sessions to print.
+ *
+ * @return None
+ */
+void Host_Farm_Diff(FILE *file, const Host_Farm_Result *base, uint32_t base_count,
+                    const Host_Farm_Result *next, uint32_t next_count, uint32_t top);
+
+#endif // HOST_FARM_H_
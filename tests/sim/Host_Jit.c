@@ -0,0 +1,191 @@
+/**
+ * @file Host_Jit.c
+ *
+ * @brief Source code for the Host_Jit module.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Host_Jit.h"
+#include <math.h>
+#include <string.h>
+
+// Registers a callee may use without saving them: s0 to s15
+#define HOST_JIT_SCRATCH        0x0000FFFFU
+
+#define HOST_JIT_BX_LR          0x4770U
+
+// Cortex-M4 cycles
+#define HOST_JIT_CYCLES_ALU     1U
+#define HOST_JIT_CYCLES_VLDR    2U
+#define HOST_JIT_CYCLES_VDIV    14U
+#define HOST_JIT_CYCLES_BX      3U
+
+typedef struct {
+    float s[32];
+    uint32_t r0;
+    uint32_t written;           // S registers holding a value
+    Host_Jit_Stats *stats;
+} Host_Jit_State;
+
+// Read sn, or stop if it holds nothing
+static uint8_t Host_Jit_Read(Host_Jit_State *state, uint32_t n, float *value)
+{
+    if (!(state->written & (1UL << n)))
+    {
+        state->stats->error = "register read before it is written";
+        return 0;
+    }
+    *value = state->s[n];
+    return 1;
+}
+
+// Write sd, or stop if it is not a scratch register
+static uint8_t Host_Jit_Write(Host_Jit_State *state, uint32_t d, float value)
+{
+    if (!(HOST_JIT_SCRATCH & (1UL << d)))
+    {
+        state->stats->error = "callee-saved register written";
+        return 0;
+    }
+    state->s[d] = value;
+    state->written |= (1UL << d);
+    state->stats->registers |= (1UL << d);
+    return 1;
+}
+
+float Host_Jit_Run(const Calc_Func *func, float x, Host_Jit_Stats *stats)
+{
+    const uint8_t *base = (const uint8_t *)((uintptr_t)func->native & ~(uintptr_t)1U);
+    uint32_t end = func->native_bytes;
+    Host_Jit_State state;
+
+    memset(stats, 0, sizeof(Host_Jit_Stats));
+    memset(&state, 0, sizeof(state));
+    state.stats = stats;
+
+#ifdef __ARM_PCS_VFP
+    state.s[0] = x;
+    state.written = 1U;
+#else
+    memcpy(&state.r0, &x, sizeof(x));
+#endif
+
+    if (!((uintptr_t)func->native & 1U) || ((uintptr_t)base & 3U))
+    {
+        stats->error = "not a word-aligned Thumb address";
+        return NAN;
+    }
+
+    for (uint32_t pc = 0; ; pc += 4U)
+    {
+        uint16_t first;
+        uint16_t second;
+        float n_value;
+        float m_value;
+        float loaded;
+
+        if (pc + 2U > end)
+        {
+            stats->error = "ran off the end of the code";
+            return NAN;
+        }
+        memcpy(&first, base + pc, sizeof(first));
+        stats->instructions++;
+
+        if (first == HOST_JIT_BX_LR)
+        {
+            float result;
+
+            stats->cycles += HOST_JIT_CYCLES_BX;
+#ifdef __ARM_PCS_VFP
+            return Host_Jit_Read(&state, 0, &result) ? result : NAN;
+#else
+            memcpy(&result, &state.r0, sizeof(result));
+            return result;
+#endif
+        }
+
+        if (pc + 4U > end)
+        {
+            stats->error = "ran off the end of the code";
+            return NAN;
+        }
+        memcpy(&second, base + pc + 2U, sizeof(second));
+
+        // Single registers: Vd:D, Vn:N, Vm:M
+        uint32_t d = (((uint32_t)second >> 12) & 0xFU) << 1 | (((uint32_t)first >> 6) & 1U);
+        uint32_t n = ((uint32_t)first & 0xFU) << 1 | (((uint32_t)second >> 7) & 1U);
+        uint32_t m = ((uint32_t)second & 0xFU) << 1 | (((uint32_t)second >> 5) & 1U);
+        uint8_t ok;
+
+        if ((first & 0xFFB0U) == 0xEE30U && (second & 0x0F50U) == 0x0A00U)
+        {
+            ok = Host_Jit_Read(&state, n, &n_value) && Host_Jit_Read(&state, m, &m_value) &&
+                 Host_Jit_Write(&state, d, n_value + m_value);
+            stats->cycles += HOST_JIT_CYCLES_ALU;
+        }
+        else if ((first & 0xFFB0U) == 0xEE30U && (second & 0x0F50U) == 0x0A40U)
+        {
+            ok = Host_Jit_Read(&state, n, &n_value) && Host_Jit_Read(&state, m, &m_value) &&
+                 Host_Jit_Write(&state, d, n_value - m_value);
+            stats->cycles += HOST_JIT_CYCLES_ALU;
+        }
+        else if ((first & 0xFFB0U) == 0xEE20U && (second & 0x0F50U) == 0x0A00U)
+        {
+            ok = Host_Jit_Read(&state, n, &n_value) && Host_Jit_Read(&state, m, &m_value) &&
+                 Host_Jit_Write(&state, d, n_value * m_value);
+            stats->cycles += HOST_JIT_CYCLES_ALU;
+        }
+        else if ((first & 0xFFB0U) == 0xEE80U && (second & 0x0F50U) == 0x0A00U)
+        {
+            ok = Host_Jit_Read(&state, n, &n_value) && Host_Jit_Read(&state, m, &m_value) &&
+                 Host_Jit_Write(&state, d, n_value / m_value);
+            stats->cycles += HOST_JIT_CYCLES_VDIV;
+        }
+        else if ((first & 0xFFBFU) == 0xEEB0U && (second & 0x0FD0U) == 0x0A40U)
+        {
+            // VMOV.F32 sd, sm
+            ok = Host_Jit_Read(&state, m, &m_value) && Host_Jit_Write(&state, d, m_value);
+            stats->cycles += HOST_JIT_CYCLES_ALU;
+        }
+        else if ((first & 0xFFBFU) == 0xED9FU && (second & 0x0F00U) == 0x0A00U)
+        {
+            // VLDR sd, [pc, #imm8 * 4], from the word-aligned PC + 4
+            uint32_t address = ((pc + 4U) & ~3U) + ((uint32_t)second & 0xFFU) * 4U;
+
+            if (address + 4U > end || address < pc + 4U)
+            {
+                stats->error = "literal outside the pool";
+                return NAN;
+            }
+            memcpy(&loaded, base + address, sizeof(loaded));
+            ok = Host_Jit_Write(&state, d, loaded);
+            stats->cycles += HOST_JIT_CYCLES_VLDR;
+        }
+        else if (first == 0xEE00U && second == 0x0A10U)
+        {
+            // VMOV s0, r0
+            memcpy(&loaded, &state.r0, sizeof(loaded));
+            ok = Host_Jit_Write(&state, 0, loaded);
+            stats->cycles += HOST_JIT_CYCLES_ALU;
+        }
+        else if (first == 0xEE10U && second == 0x0A10U)
+        {
+            // VMOV r0, s0
+            ok = Host_Jit_Read(&state, 0, &n_value);
+            memcpy(&state.r0, &n_value, sizeof(state.r0));
+            stats->cycles += HOST_JIT_CYCLES_ALU;
+        }
+        else
+        {
+            stats->error = "unknown instruction";
+            return NAN;
+        }
+
+        if (!ok)
+        {
+            return NAN;
+        }
+    }
+}
@@ -0,0 +1,54 @@
+/**
+ * @file Host_Jit.h
+ *
+ * @brief Emulator of the machine code compiled by Calc_Func.
+ *
+ * On the host, Calc_Func.c can be built with the defines of the target
+ * (-D__ARM_ARCH_7EM__ -D__ARM_FP=4, and -D__ARM_PCS_VFP for the
+ * hard-float calling convention) so that it compiles every function to
+ * Thumb-2 code as on the board. The code cannot run on the host;
+ * Host_Jit_Run executes it instead, one instruction at a time, with the
+ * single-precision arithmetic of the host (IEEE 754, round to nearest, as
+ * the FPU of the TM4C123 after reset).
+ *
+ * Only the instructions Calc_Func emits are accepted, in single precision.
+ * The run stops with an error if the code:
+ *  - holds any other instruction, or runs off its end without BX LR
+ *  - reads a register it has not written (other than the argument)
+ *  - writes s16-s31, which a callee must save
+ *  - loads from outside its literal pool
+ *
+ * The cycles are estimated from the instruction timings of the Cortex-M4
+ * (VADD, VSUB, VMUL, VMOV 1, VLDR 2, VDIV 14, BX LR 3 with the refill),
+ * without wait states; the code runs from SRAM, which has none.
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef HOST_JIT_H_
+#define HOST_JIT_H_
+
+#include "Calc_Func.h"
+#include <stdint.h>
+
+typedef struct {
+    uint32_t instructions;      // executed, BX LR included
+    uint32_t cycles;            // estimated Cortex-M4 cycles
+    uint32_t registers;         // mask of the S registers written
+    const char *error;          // NULL, or why the run stopped
+} Host_Jit_Stats;
+
+/**
+ * @brief Run the machine code of a function.
+ *
+ * @param func  The function, with its machine code (func->native).
+ * @param x     The value of x, passed as the calling convention of the
+ *              build passes it (s0 with __ARM_PCS_VFP, r0 without).
+ * @param stats Receives the counts of the run, and the error if any.
+ *
+ * @return float The value returned by the code, or NaN if it stopped with
+ *         an error.
+ */
+float Host_Jit_Run(const Calc_Func *func, float x, Host_Jit_Stats *stats);
+
+#endif // HOST_JIT_H_
@@ -0,0 +1,175 @@
+/**
+ * @file Host_Sim.c
+ *
+ * @brief Runs the firmware on the host against the device model.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Host_Sim.h"
+#include <setjmp.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define PS_PER_MS       (1000ULL * HOST_DEVICE_PS_PER_US)
+
+// main() of the firmware, renamed by the build
+extern int Firmware_Main(void);
+
+static jmp_buf session_exit;
+
+// Where Host_Sim_Trace_Output writes the trace dump
+static Host_Sim_Result *trace_result;
+
+static double Host_Sim_Seconds(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+static void Host_Sim_Uart_Output(uint8_t byte, void *context)
+{
+    Host_Sim_Result *result = context;
+
+    if (result->uart_length < HOST_SIM_UART_BYTES)
+    {
+        result->uart[result->uart_length++] = byte;
+    }
+}
+
+static void Host_Sim_Trace_Output(char c)
+{
+    if (trace_result->trace_length < HOST_SIM_TRACE_BYTES)
+    {
+        trace_result->trace[trace_result->trace_length++] = (uint8_t)c;
+    }
+}
+
+static void Host_Sim_Exit(void *context)
+{
+    (void)context;
+    longjmp(session_exit, 1);
+}
+
+int Host_Sim_Parse_Keys(const char *script, Host_Device_Key *keys, uint32_t max)
+{
+    static const char keypad[] = "0123456789.=+-*/";
+    uint64_t press_ps = HOST_SIM_FIRST_PRESS_MS * PS_PER_MS;
+    uint32_t count = 0;
+
+    while (*script != '\0')
+    {
+        char key = *script++;
+        unsigned long hold_ms = HOST_SIM_HOLD_MS;
+
+        if (key == ' ')
+        {
+            continue;
+        }
+        if (strchr(keypad, key) == NULL || count >= max)
+        {
+            return -1;
+        }
+
+        if (*script == '@')
+        {
+            char *end;
+
+            hold_ms = strtoul(script + 1, &end, 10);
+            if (end == script + 1 || hold_ms == 0)
+            {
+                return -1;
+            }
+            script = end;
+        }
+
+        keys[count].key = key;
+        keys[count].press_ps = press_ps;
+        keys[count].release_ps = press_ps + hold_ms * PS_PER_MS;
+        press_ps = keys[count].release_ps + HOST_SIM_GAP_MS * PS_PER_MS;
+        count++;
+    }
+    return (int)count;
+}
+
+// Runs in the child process, which exits at the end of the session
+static void Host_Sim_Session(Host_Sim_Result *result)
+{
+    uint64_t end_ps = HOST_SIM_FIRST_PRESS_MS * PS_PER_MS;
+    double start = Host_Sim_Seconds();
+
+    if (result->key_count > 0)
+    {
+        end_ps = result->keys[result->key_count - 1].release_ps;
+    }
+    end_ps += HOST_SIM_IDLE_MS * PS_PER_MS;
+
+    if (Host_Device_Init(result->keys, result->key_count) != 0)
+    {
+        _exit(1);
+    }
+    Host_Device_Set_Uart_Output(Host_Sim_Uart_Output, result);
+    Host_Device_Set_Exit(end_ps, end_ps + HOST_SIM_LIMIT_MS * PS_PER_MS, Host_Sim_Exit, NULL);
+
+    if (setjmp(session_exit) == 0)
+    {
+        Firmware_Main();
+    }
+
+    // Stopped while waiting after the last key, or by the limit
+    result->end_ps = Host_Device_Now_ps();
+    result->completed = (result->end_ps < end_ps + HOST_SIM_LIMIT_MS * PS_PER_MS);
+    result->host_seconds = Host_Sim_Seconds() - start;
+    result->stats = *Host_Device_Get_Stats();
+    Host_Device_Get_Lcd(result->lcd);
+
+    // The trace is read straight from the buffer, without the device model
+    trace_result = result;
+    Trace_Dump_Binary(Host_Sim_Trace_Output);
+    _exit(0);
+}
+
+int Host_Sim_Run(const char *script, Host_Sim_Result *result)
+{
+    Host_Device_Key keys[HOST_DEVICE_MAX_KEYS];
+    int count = Host_Sim_Parse_Keys(script, keys, HOST_DEVICE_MAX_KEYS);
+    int status;
+
+    if (count < 0)
+    {
+        return -1;
+    }
+
+    // The child writes the result straight into shared memory
+    Host_Sim_Result *shared = mmap(NULL, sizeof(*shared), PROT_READ | PROT_WRITE,
+                                   MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED)
+    {
+        return -1;
+    }
+    memset(shared, 0, sizeof(*shared));
+    memcpy(shared->keys, keys, (size_t)count * sizeof(keys[0]));
+    shared->key_count = (uint32_t)count;
+
+    pid_t child = fork();
+    if (child == 0)
+    {
+        Host_Sim_Session(shared);
+    }
+
+    int ran = (child > 0 && waitpid(child, &status, 0) == child);
+
+    if (ran && !(WIFEXITED(status) && WEXITSTATUS(status) == 0))
+    {
+        shared->completed = 0;
+    }
+    *result = *shared;
+    munmap(shared, sizeof(*shared));
+    return ran ? 0 : -1;
+}
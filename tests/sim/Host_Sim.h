@@ -0,0 +1,80 @@
+/**
+ * @file Host_Sim.h
+ *
+ * @brief Runs the firmware on the host against the device model.
+ *
+ * The firmware is built for the host with its main renamed Firmware_Main
+ * (tests/Makefile). A session resets the model, presses the keys of a
+ * script and runs the firmware until it is idle after the last key.
+ * Each session runs in a child process, so the static state of the
+ * firmware starts from scratch and a crash only fails that session.
+ *
+ * At the end of a session the trace buffer of the firmware is dumped
+ * (Trace_Dump_Binary) into the result, for tests/tools/trace2chrome.
+ *
+ * A key script is a string of keypad characters, each optionally followed
+ * by @<ms> to hold it for that long, e.g. "12+34=" or "=@1500" (hold '='
+ * to open the settings menu). Spaces are ignored.
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef HOST_SIM_H_
+#define HOST_SIM_H_
+
+#include "Host_Device.h"
+#include "Trace.h"
+#include <stdint.h>
+
+// Key timing of a script
+#define HOST_SIM_FIRST_PRESS_MS     500U
+#define HOST_SIM_HOLD_MS            100U
+#define HOST_SIM_GAP_MS             300U
+
+// Virtual time run after the last release, and the limit after it
+#define HOST_SIM_IDLE_MS            2000U
+#define HOST_SIM_LIMIT_MS           60000U
+
+// UART bytes kept per session
+#define HOST_SIM_UART_BYTES         65536U
+
+// Size of a trace dump: header and records
+#define HOST_SIM_TRACE_BYTES        (12U + 8U * TRACE_BUFFER_SIZE)
+
+typedef struct {
+    uint8_t completed;          // 0 if the session crashed or hit the limit
+    char lcd[2][17];            // Text on the LCD at the end
+    uint64_t end_ps;            // Virtual time at the end
+    double host_seconds;        // Host time taken by the session
+    uint32_t key_count;
+    Host_Device_Key keys[HOST_DEVICE_MAX_KEYS];
+    Host_Device_Stats stats;
+    uint32_t uart_length;
+    uint8_t uart[HOST_SIM_UART_BYTES];
+    uint32_t trace_length;
+    uint8_t trace[HOST_SIM_TRACE_BYTES];
+} Host_Sim_Result;
+
+/**
+ * @brief Convert a key script to key events.
+ *
+ * @param script The key script.
+ * @param keys   Receives the key events.
+ * @param max    The size of keys.
+ *
+ * @return int The number of key events, or -1 if the script is not valid.
+ */
+int Host_Sim_Parse_Keys(const char *script, Host_Device_Key *keys, uint32_t max);
+
+/**
+ * @brief Run the firmware for one key script.
+ *
+ * @param script The key script.
+ * @param result Receives the result of the session.
+ *
+ * @return int 0 if the session ran (see result->completed), -1 if the
+ *             script is not valid or the child process failed to start.
+ */
+int Host_Sim_Run(const char *script, Host_Sim_Result *result);
+
+#endif // HOST_SIM_H_
@@ -0,0 +1,127 @@
+/**
+ * @file sim_farm.c
+ *
+ * @brief Command line runner of the simulation farm (Host_Farm.h).
+ *
+ *   sim_farm [-j workers] [-o results.csv] [-n top] [sessions.txt]
+ *       Runs the sessions (by default the corpus of Session_Replay.c) on
+ *       the firmware linked into this build, prints the slowest sessions
+ *       and writes every result to the CSV file.
+ *
+ *   sim_farm -d base.csv next.csv [-n top]
+ *       Compares the results of two builds.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Host_Farm.h"
+#include "Session_Replay.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define MAX_SESSIONS    100000U
+
+static Host_Farm_Session sessions[MAX_SESSIONS];
+static Host_Farm_Result results[MAX_SESSIONS];
+static Host_Farm_Result base_results[MAX_SESSIONS];
+
+static int Read_Results(const char *path, Host_Farm_Result *out)
+{
+    FILE *file = fopen(path, "r");
+    int count = (file != NULL) ? Host_Farm_Read_Csv(file, out, MAX_SESSIONS) : -1;
+
+    if (file != NULL)
+    {
+        fclose(file);
+    }
+    if (count < 0)
+    {
+        fprintf(stderr, "sim_farm: cannot read results from %s\n", path);
+    }
+    return count;
+}
+
+int main(int argc, char **argv)
+{
+    const char *output = NULL;
+    const char *diff_base = NULL;
+    uint32_t workers = 0;
+    uint32_t top = 10;
+    int count;
+    int option;
+
+    while ((option = getopt(argc, argv, "j:o:n:d:")) != -1)
+    {
+        switch (option)
+        {
+            case 'j': workers = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'o': output = optarg; break;
+            case 'n': top = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'd': diff_base = optarg; break;
+            default:
+                fprintf(stderr, "usage: sim_farm [-j workers] [-o results.csv] [-n top] [sessions.txt]\n"
+                                "       sim_farm -d base.csv next.csv [-n top]\n");
+                return 2;
+        }
+    }
+
+    if (diff_base != NULL)
+    {
+        int base_count = Read_Results(diff_base, base_results);
+        int next_count = (optind < argc) ? Read_Results(argv[optind], results) : -1;
+
+        if (base_count < 0 || next_count < 0)
+        {
+            return 1;
+        }
+        Host_Farm_Diff(stdout, base_results, (uint32_t)base_count, results, (uint32_t)next_count, top);
+        return 0;
+    }
+
+    if (optind < argc)
+    {
+        FILE *file = fopen(argv[optind], "r");
+
+        count = (file != NULL) ? Host_Farm_Read_Sessions(file, sessions, MAX_SESSIONS) : -1;
+        if (file != NULL)
+        {
+            fclose(file);
+        }
+        if (count < 0)
+        {
+            fprintf(stderr, "sim_farm: cannot read sessions from %s\n", argv[optind]);
+            return 1;
+        }
+    }
+    else
+    {
+        for (count = 0; (uint32_t)count < Session_Replay_Corpus_Size; count++)
+        {
+            snprintf(sessions[count].name, HOST_FARM_NAME_LENGTH, "%s", Session_Replay_Corpus[count].name);
+            snprintf(sessions[count].keys, HOST_FARM_KEYS_LENGTH, "%s", Session_Replay_Corpus[count].keys);
+        }
+    }
+
+    if (Host_Farm_Run(sessions, (uint32_t)count, workers, results) != 0)
+    {
+        fprintf(stderr, "sim_farm: the workers failed\n");
+        return 1;
+    }
+
+    Host_Farm_Report(stdout, results, (uint32_t)count, top);
+
+    if (output != NULL)
+    {
+        FILE *file = fopen(output, "w");
+
+        if (file == NULL)
+        {
+            fprintf(stderr, "sim_farm: cannot write %s\n", output);
+            return 1;
+        }
+        Host_Farm_Write_Csv(file, results, (uint32_t)count);
+        fclose(file);
+    }
+    return 0;
+}
@@ -0,0 +1,38 @@
+/**
+ * @file sim_trace.c
+ *
+ * @brief Runs one key script on the simulator and writes its trace.
+ *
+ *   sim_trace "12+34=" > trace.json
+ *
+ * The trace of the session (the last TRACE_BUFFER_SIZE events) is written
+ * as Chrome trace-event JSON, to open in chrome://tracing or
+ * https://ui.perfetto.dev: keypad scans, debounce waits, every LCD command
+ * and data byte, key handling, computations and interrupts on their own
+ * tracks, in virtual time.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Host_Sim.h"
+#include "Trace_Chrome.h"
+
+static Host_Sim_Result result;
+
+int main(int argc, char **argv)
+{
+    if (argc != 2)
+    {
+        fprintf(stderr, "usage: sim_trace <key script> > trace.json\n");
+        return 2;
+    }
+
+    if (Host_Sim_Run(argv[1], &result) != 0 || !result.completed)
+    {
+        fprintf(stderr, "sim_trace: the session did not complete\n");
+        return 1;
+    }
+
+    fprintf(stderr, "sim_trace: LCD \"%s\" / \"%s\"\n", result.lcd[0], result.lcd[1]);
+    return (Trace_Chrome_Convert(result.trace, result.trace_length, stdout) == 1) ? 0 : 1;
+}
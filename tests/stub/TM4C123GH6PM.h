@@ -0,0 +1,423 @@
+/**
+ * @file TM4C123GH6PM.h
+ *
+ * @brief Host stand-in for the device header, used by the host tests.
+ *
+ * Only what the firmware uses is provided, with the names of the CMSIS
+ * device header.
+ *
+ * Each peripheral macro (GPIOA, SysTick, ...) calls Host_Device_Access,
+ * so that the device model (tests/sim/Host_Device.c) sees every register
+ * access of the firmware: it applies the effect of the previous write,
+ * advances the virtual clock, refreshes the registers that are read (the
+ * SysTick counter, the keypad rows, ...) and takes pending interrupts.
+ * Programs that do not use the peripherals do not need the model.
+ *
+ * The core intrinsics behave as on the target for a single core:
+ *  - __LDREXW / __STREXW: the exclusive monitor is a compare-and-swap of
+ *    the value loaded by the last __LDREXW of the thread, so the retry
+ *    loops of Atomic.h are atomic between host threads too
+ *  - __DMB / __DSB / __ISB: full memory barriers
+ *  - PRIMASK, BASEPRI, NVIC and __WFI: implemented by the device model
+ *  - FPSCR cumulative exception flags: the host's floating-point
+ *    environment, so a module built with -D__ARM_FP reports its
+ *    exceptions as on the target
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef TM4C123GH6PM_H_
+#define TM4C123GH6PM_H_
+
+#include <stdint.h>
+#include <fenv.h>
+
+#define __IO    volatile
+#define __I     volatile const
+#define __O     volatile
+
+#define __NVIC_PRIO_BITS    3
+
+// ----- Interrupt numbers -----
+
+typedef enum {
+    SysTick_IRQn        = -1,
+    GPIOD_IRQn          = 3,
+    UART0_IRQn          = 5,
+    WATCHDOG0_IRQn      = 18,
+    TIMER1A_IRQn        = 21,
+    TIMER2A_IRQn        = 23
+} IRQn_Type;
+
+// ----- Peripheral registers -----
+
+typedef struct {
+    __IO uint32_t DATA_BITS[255];
+    __IO uint32_t DATA;
+    __IO uint32_t DIR;
+    __IO uint32_t IS;
+    __IO uint32_t IBE;
+    __IO uint32_t IEV;
+    __IO uint32_t IM;
+    __IO uint32_t RIS;
+    __IO uint32_t MIS;
+    __O  uint32_t ICR;
+    __IO uint32_t AFSEL;
+    __IO uint32_t DR2R;
+    __IO uint32_t DR4R;
+    __IO uint32_t DR8R;
+    __IO uint32_t ODR;
+    __IO uint32_t PUR;
+    __IO uint32_t PDR;
+    __IO uint32_t SLR;
+    __IO uint32_t DEN;
+    __IO uint32_t LOCK;
+    __IO uint32_t CR;
+    __IO uint32_t AMSEL;
+    __IO uint32_t PCTL;
+} GPIOA_Type;
+
+typedef struct {
+    __IO uint32_t CTRL;
+    __IO uint32_t LOAD;
+    __IO uint32_t VAL;
+    __I  uint32_t CALIB;
+} SysTick_Type;
+
+typedef struct {
+    __I  uint32_t CPUID;
+    __IO uint32_t ICSR;
+    __IO uint32_t VTOR;
+    __IO uint32_t AIRCR;
+    __IO uint32_t SCR;
+    __IO uint32_t CCR;
+} SCB_Type;
+
+#define SCB_ICSR_PENDSTSET_Msk          (1UL << 26)
+
+typedef struct {
+    __IO uint32_t CTRL;
+    __IO uint32_t CYCCNT;
+} DWT_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk          (1UL << 0)
+
+typedef struct {
+    __IO uint32_t DHCSR;
+    __O  uint32_t DCRSR;
+    __IO uint32_t DCRDR;
+    __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define CoreDebug_DEMCR_TRCENA_Msk      (1UL << 24)
+
+typedef struct {
+    __IO uint32_t RIS;
+    __IO uint32_t MISC;
+    __IO uint32_t RESC;
+    __IO uint32_t RCC;
+    __IO uint32_t RCC2;
+    __IO uint32_t SREEPROM;
+    __IO uint32_t RCGCWD;
+    __IO uint32_t RCGCTIMER;
+    __IO uint32_t RCGCGPIO;
+    __IO uint32_t RCGCUART;
+    __IO uint32_t RCGCEEPROM;
+    __I  uint32_t PRWD;
+    __I  uint32_t PRTIMER;
+    __I  uint32_t PRGPIO;
+    __I  uint32_t PRUART;
+    __I  uint32_t PREEPROM;
+} SYSCTL_Type;
+
+typedef struct {
+    __IO uint32_t DR;
+    __IO uint32_t RSR;
+    __I  uint32_t FR;
+    __IO uint32_t ILPR;
+    __IO uint32_t IBRD;
+    __IO uint32_t FBRD;
+    __IO uint32_t LCRH;
+    __IO uint32_t CTL;
+    __IO uint32_t IFLS;
+    __IO uint32_t IM;
+    __I  uint32_t RIS;
+    __I  uint32_t MIS;
+    __O  uint32_t ICR;
+    __IO uint32_t CC;
+} UART0_Type;
+
+typedef struct {
+    __IO uint32_t CFG;
+    __IO uint32_t TAMR;
+    __IO uint32_t TBMR;
+    __IO uint32_t CTL;
+    __IO uint32_t IMR;
+    __I  uint32_t RIS;
+    __I  uint32_t MIS;
+    __O  uint32_t ICR;
+    __IO uint32_t TAILR;
+    __IO uint32_t TAPR;
+    __IO uint32_t TAR;
+    __IO uint32_t TAV;
+} TIMER0_Type;
+
+typedef struct {
+    __IO uint32_t LOAD;
+    __I  uint32_t VALUE;
+    __IO uint32_t CTL;
+    __O  uint32_t ICR;
+    __I  uint32_t RIS;
+    __I  uint32_t MIS;
+    __IO uint32_t TEST;
+    __IO uint32_t LOCK;
+} WATCHDOG0_Type;
+
+typedef struct {
+    __I  uint32_t EESIZE;
+    __IO uint32_t EEBLOCK;
+    __IO uint32_t EEOFFSET;
+    __IO uint32_t EERDWR;
+    __IO uint32_t EERDWRINC;
+    __I  uint32_t EEDONE;
+    __IO uint32_t EESUPP;
+} EEPROM_Type;
+
+typedef struct {
+    __IO uint32_t FMA;
+    __IO uint32_t FMD;
+    __IO uint32_t FMC;
+    __I  uint32_t FCRIS;
+    __IO uint32_t FCIM;
+    __IO uint32_t FCMISC;
+    __IO uint32_t BOOTCFG;
+} FLASH_CTRL_Type;
+
+// ----- Device model interface (tests/sim/Host_Device.c) -----
+
+typedef enum {
+    HOST_GPIOA,
+    HOST_GPIOB,
+    HOST_GPIOC,
+    HOST_GPIOD,
+    HOST_GPIOE,
+    HOST_GPIOF,
+    HOST_SYSTICK,
+    HOST_SCB,
+    HOST_DWT,
+    HOST_COREDEBUG,
+    HOST_SYSCTL,
+    HOST_UART0,
+    HOST_TIMER0,
+    HOST_TIMER1,
+    HOST_TIMER2,
+    HOST_WATCHDOG0,
+    HOST_EEPROM,
+    HOST_FLASH_CTRL,
+    HOST_PERIPHERAL_COUNT
+} Host_Peripheral;
+
+void *Host_Device_Access(Host_Peripheral peripheral);
+void Host_Device_Wait_For_Interrupt(void);
+uint32_t Host_Device_Get_Primask(void);
+void Host_Device_Set_Primask(uint32_t primask);
+uint32_t Host_Device_Get_Basepri(void);
+void Host_Device_Set_Basepri(uint32_t basepri);
+void Host_Device_Enable_IRQ(IRQn_Type irq, uint8_t enable);
+void Host_Device_Set_Priority(IRQn_Type irq, uint32_t priority);
+
+#define GPIOA       ((GPIOA_Type *)Host_Device_Access(HOST_GPIOA))
+#define GPIOB       ((GPIOA_Type *)Host_Device_Access(HOST_GPIOB))
+#define GPIOC       ((GPIOA_Type *)Host_Device_Access(HOST_GPIOC))
+#define GPIOD       ((GPIOA_Type *)Host_Device_Access(HOST_GPIOD))
+#define GPIOE       ((GPIOA_Type *)Host_Device_Access(HOST_GPIOE))
+#define GPIOF       ((GPIOA_Type *)Host_Device_Access(HOST_GPIOF))
+#define SysTick     ((SysTick_Type *)Host_Device_Access(HOST_SYSTICK))
+#define SCB         ((SCB_Type *)Host_Device_Access(HOST_SCB))
+#define DWT         ((DWT_Type *)Host_Device_Access(HOST_DWT))
+#define CoreDebug   ((CoreDebug_Type *)Host_Device_Access(HOST_COREDEBUG))
+#define SYSCTL      ((SYSCTL_Type *)Host_Device_Access(HOST_SYSCTL))
+#define UART0       ((UART0_Type *)Host_Device_Access(HOST_UART0))
+#define TIMER0      ((TIMER0_Type *)Host_Device_Access(HOST_TIMER0))
+#define TIMER1      ((TIMER0_Type *)Host_Device_Access(HOST_TIMER1))
+#define TIMER2      ((TIMER0_Type *)Host_Device_Access(HOST_TIMER2))
+#define WATCHDOG0   ((WATCHDOG0_Type *)Host_Device_Access(HOST_WATCHDOG0))
+#define EEPROM      ((EEPROM_Type *)Host_Device_Access(HOST_EEPROM))
+#define FLASH_CTRL  ((FLASH_CTRL_Type *)Host_Device_Access(HOST_FLASH_CTRL))
+
+extern uint32_t SystemCoreClock;
+
+// A SysTick_Delay1us loop hands its deadline to the model, which advances
+// the virtual clock straight to it (or to the next interrupt before it)
+void Host_Device_Spin_Until(uint64_t deadline_ticks);
+#define SYSTICK_DELAY_SPIN(deadline_ticks)  Host_Device_Spin_Until(deadline_ticks)
+
+// ----- NVIC -----
+
+static inline void NVIC_SetPriorityGrouping(uint32_t grouping)
+{
+    (void)grouping;
+}
+
+static inline void NVIC_SetPriority(IRQn_Type irq, uint32_t priority)
+{
+    Host_Device_Set_Priority(irq, priority);
+}
+
+static inline void NVIC_EnableIRQ(IRQn_Type irq)
+{
+    Host_Device_Enable_IRQ(irq, 1);
+}
+
+static inline void NVIC_DisableIRQ(IRQn_Type irq)
+{
+    Host_Device_Enable_IRQ(irq, 0);
+}
+
+// ----- Core intrinsics -----
+
+static inline void __disable_irq(void)
+{
+    Host_Device_Set_Primask(1);
+}
+
+static inline void __enable_irq(void)
+{
+    Host_Device_Set_Primask(0);
+}
+
+static inline uint32_t __get_PRIMASK(void)
+{
+    return Host_Device_Get_Primask();
+}
+
+static inline void __set_PRIMASK(uint32_t primask)
+{
+    Host_Device_Set_Primask(primask);
+}
+
+static inline uint32_t __get_BASEPRI(void)
+{
+    return Host_Device_Get_Basepri();
+}
+
+static inline void __set_BASEPRI(uint32_t basepri)
+{
+    Host_Device_Set_Basepri(basepri & 0xFFU);
+}
+
+// Only raises the masking level (a lower non-zero value is a higher priority)
+static inline void __set_BASEPRI_MAX(uint32_t basepri)
+{
+    uint32_t current = Host_Device_Get_Basepri();
+
+    basepri &= 0xFFU;
+    if (basepri != 0U && (current == 0U || basepri < current))
+    {
+        Host_Device_Set_Basepri(basepri);
+    }
+}
+
+static inline void __WFI(void)
+{
+    Host_Device_Wait_For_Interrupt();
+}
+
+static inline void __NOP(void)
+{
+}
+
+static inline void __DMB(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline void __DSB(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline void __ISB(void)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+static inline uint32_t __REV(uint32_t value)
+{
+    return __builtin_bswap32(value);
+}
+
+// Exclusive monitor of the calling thread: the address and value of the last __LDREXW
+static __thread volatile uint32_t *host_exclusive_address;
+static __thread uint32_t host_exclusive_value;
+
+static inline uint32_t __LDREXW(volatile uint32_t *address)
+{
+    host_exclusive_address = address;
+    host_exclusive_value = __atomic_load_n(address, __ATOMIC_SEQ_CST);
+    return host_exclusive_value;
+}
+
+// Returns 0 if the store was done, 1 if the value changed since __LDREXW
+static inline uint32_t __STREXW(uint32_t value, volatile uint32_t *address)
+{
+    uint32_t expected = host_exclusive_value;
+
+    if (host_exclusive_address != address)
+    {
+        return 1;
+    }
+    host_exclusive_address = 0;
+    return __atomic_compare_exchange_n(address, &expected, value, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST) ? 0U : 1U;
+}
+
+static inline void __CLREX(void)
+{
+    host_exclusive_address = 0;
+}
+
+// FPSCR cumulative exception flags IOC, DZC, OFC, UFC, IXC
+#define HOST_FPSCR_IOC  0x01U
+#define HOST_FPSCR_DZC  0x02U
+#define HOST_FPSCR_OFC  0x04U
+#define HOST_FPSCR_UFC  0x08U
+#define HOST_FPSCR_IXC  0x10U
+
+static const struct {
+    uint32_t fpscr;
+    int except;
+} host_fpscr_flags[] = {
+    { HOST_FPSCR_IOC, FE_INVALID },
+    { HOST_FPSCR_DZC, FE_DIVBYZERO },
+    { HOST_FPSCR_OFC, FE_OVERFLOW },
+    { HOST_FPSCR_UFC, FE_UNDERFLOW },
+    { HOST_FPSCR_IXC, FE_INEXACT }
+};
+
+static inline uint32_t __get_FPSCR(void)
+{
+    uint32_t fpscr = 0;
+
+    for (uint32_t i = 0; i < sizeof(host_fpscr_flags) / sizeof(host_fpscr_flags[0]); i++)
+    {
+        fpscr |= fetestexcept(host_fpscr_flags[i].except) ? host_fpscr_flags[i].fpscr : 0U;
+    }
+    return fpscr;
+}
+
+static inline void __set_FPSCR(uint32_t fpscr)
+{
+    for (uint32_t i = 0; i < sizeof(host_fpscr_flags) / sizeof(host_fpscr_flags[0]); i++)
+    {
+        if (fpscr & host_fpscr_flags[i].fpscr)
+        {
+            feraiseexcept(host_fpscr_flags[i].except);
+        }
+        else
+        {
+            feclearexcept(host_fpscr_flags[i].except);
+        }
+    }
+}
+
+#endif // TM4C123GH6PM_H_
@@ -0,0 +1,110 @@
+/**
+ * @file test.h
+ *
+ * @brief Minimal check macros for the host tests.
+ *
+ * Each test is a small program built by tests/Makefile. TEST_CHECK records
+ * a failure (and prints where it happened, for the first few), and
+ * Test_Report prints the totals and gives the exit status of the program.
+ *
+ * Tests that loop over random inputs read their iteration count with
+ * Test_Iterations, so that a longer soak run (make soak) can raise it
+ * through the TEST_ITERATIONS environment variable.
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef TEST_H_
+#define TEST_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Failures printed before the rest are only counted
+#define TEST_MAX_PRINTED    10U
+
+static uint64_t test_checks = 0;
+static uint64_t test_failures = 0;
+
+#define TEST_CHECK(condition)       TEST_CHECK_MSG(condition, "%s", #condition)
+
+#define TEST_CHECK_MSG(condition, ...)                                                  \
+    do                                                                                  \
+    {                                                                                   \
+        test_checks++;                                                                  \
+        if (!(condition))                                                               \
+        {                                                                               \
+            if (test_failures++ < TEST_MAX_PRINTED)                                     \
+            {                                                                           \
+                printf("%s:%d: FAIL: ", __FILE__, __LINE__);                            \
+                printf(__VA_ARGS__);                                                    \
+                printf("\n");                                                           \
+            }                                                                           \
+        }                                                                               \
+    } while (0)
+
+/**
+ * @brief Get the number of random iterations to run.
+ *
+ * @param default_count The count for a normal run.
+ *
+ * @return uint64_t TEST_ITERATIONS from the environment, or default_count.
+ */
+static inline uint64_t Test_Iterations(uint64_t default_count)
+{
+    const char *value = getenv("TEST_ITERATIONS");
+
+    return (value != NULL) ? strtoull(value, NULL, 0) : default_count;
+}
+
+/**
+ * @brief Small, fast pseudo-random generator (xorshift64*), so that runs
+ * are reproducible on every host.
+ *
+ * @param state The generator state, not 0.
+ *
+ * @return uint64_t The next 64 random bits.
+ */
+static inline uint64_t Test_Random(uint64_t *state)
+{
+    uint64_t x = *state;
+
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+/**
+ * @brief Host time for the benchmarks.
+ *
+ * @param None
+ *
+ * @return double Seconds from an arbitrary origin.
+ */
+static inline double Test_Seconds(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Print the totals of a test program.
+ *
+ * @param name The name of the test.
+ *
+ * @return int The exit status: 0 if every check passed.
+ */
+static inline int Test_Report(const char *name)
+{
+    printf("%s: %llu checks, %llu failures\n", name, (unsigned long long)test_checks,
+           (unsigned long long)test_failures);
+    return (test_failures == 0) ? 0 : 1;
+}
+
+#endif // TEST_H_
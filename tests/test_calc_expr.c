@@ -0,0 +1,122 @@
+/**
+ * @file test_calc_expr.c
+ *
+ * @brief Host test of the incremental expression model (Calc_Expr).
+ *
+ * Random edit sequences (inserts, deletes and cursor moves, with and
+ * without x) are applied to one expression. After every edit, the
+ * expression is built again from its text with Calc_Expr_Create (one
+ * full lex and parse), and the two must hold the same tokens, the same
+ * terms, and the same value, bit for bit.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "test.h"
+#include "Calc_Expr.h"
+#include "Calc_Memory.h"
+#include <string.h>
+
+static const char characters[] = "0123456789.+-*/x";
+
+static uint8_t Same_Number(Calc_Number a, Calc_Number b)
+{
+    return a.type == b.type && memcmp(&a.value, &b.value, sizeof(a.value)) == 0;
+}
+
+// The engine pools only hold one expression, the re-parse gets its own
+static uint64_t reparse_tokens[CALC_MEMORY_TOKEN_BYTES / 8U];
+static uint64_t reparse_nodes[CALC_MEMORY_NODE_BYTES / 8U];
+
+// Compare an edited expression with the same text parsed from scratch
+static uint8_t Same_As_Reparse(const Calc_Expr *expr)
+{
+    Arena tokens = Calc_Memory_Tokens;
+    Arena nodes = Calc_Memory_Nodes;
+    Calc_Memory_Tokens = (Arena){ (uint8_t *)reparse_tokens, sizeof(reparse_tokens), 0, 0, 0 };
+    Calc_Memory_Nodes = (Arena){ (uint8_t *)reparse_nodes, sizeof(reparse_nodes), 0, 0, 0 };
+
+    const Calc_Expr *full = Calc_Expr_Create(expr->text, expr->has_variable ? &expr->variable : NULL);
+    uint8_t same = (full != NULL);
+
+    if (same)
+    {
+        same = full->length == expr->length && strcmp(full->text, expr->text) == 0 &&
+               full->token_count == expr->token_count && full->term_count == expr->term_count &&
+               full->complete == expr->complete && full->error == expr->error;
+    }
+
+    for (uint32_t i = 0; same && i < expr->token_count; i++)
+    {
+        same = full->tokens[i].start == expr->tokens[i].start && full->tokens[i].length == expr->tokens[i].length &&
+               full->tokens[i].kind == expr->tokens[i].kind;
+    }
+
+    for (uint32_t k = 0; same && k < expr->term_count; k++)
+    {
+        same = full->terms[k].first == expr->terms[k].first && full->terms[k].count == expr->terms[k].count;
+    }
+
+    if (same && expr->complete && expr->error == CALC_ERROR_NONE)
+    {
+        same = Same_Number(full->value, expr->value);
+    }
+
+    Calc_Memory_Tokens = tokens;
+    Calc_Memory_Nodes = nodes;
+    return same;
+}
+
+int main(void)
+{
+    uint64_t seed = 0x5EED0097ULL;
+    uint64_t sequences = Test_Iterations(20000);
+    Calc_Number x = Calc_Number_From_Double(1.5);
+
+    // Fixed cases: a split, a merge, and the value after each
+    Calc_Memory_Reset();
+    Calc_Expr *expr = Calc_Expr_Create("12+34", NULL);
+    TEST_CHECK(expr != NULL && expr->complete && Calc_Number_To_Double(expr->value) == 46.0);
+    Calc_Expr_Move(expr, -1);
+    TEST_CHECK(Calc_Expr_Insert(expr, '*') && expr->term_count == 2 && Same_As_Reparse(expr));
+    TEST_CHECK(Calc_Number_To_Double(expr->value) == 12.0 + 3.0 * 4.0);
+    TEST_CHECK(Calc_Expr_Delete(expr) && strcmp(expr->text, "12+34") == 0 && Same_As_Reparse(expr));
+    Calc_Expr_Move(expr, -1);
+    TEST_CHECK(Calc_Expr_Delete(expr) && strcmp(expr->text, "1234") == 0 && Same_As_Reparse(expr));
+    TEST_CHECK(expr->term_count == 1 && Calc_Number_To_Double(expr->value) == 1234.0);
+
+    // Random edit sequences
+    for (uint64_t n = 0; n < sequences; n++)
+    {
+        uint8_t with_x = (uint8_t)(Test_Random(&seed) & 1U);
+        uint32_t length = (uint32_t)(Test_Random(&seed) % (2U * CALC_EXPR_MAX_CHARS));
+
+        Calc_Memory_Reset();
+        expr = Calc_Expr_Create("", with_x ? &x : NULL);
+
+        for (uint32_t i = 0; i < length; i++)
+        {
+            uint64_t r = Test_Random(&seed);
+
+            switch (r % 8U)
+            {
+                case 0:
+                    Calc_Expr_Move(expr, (int32_t)((r >> 8) % 9U) - 4);
+                    break;
+
+                case 1:
+                    Calc_Expr_Delete(expr);
+                    break;
+
+                default:
+                    Calc_Expr_Insert(expr, characters[(r >> 8) % (sizeof(characters) - (with_x ? 1U : 2U))]);
+                    break;
+            }
+
+            TEST_CHECK_MSG(Same_As_Reparse(expr), "sequence %llu edit %u: \"%s\" differs from its re-parse",
+                           (unsigned long long)n, i, expr->text);
+        }
+    }
+
+    return Test_Report("test_calc_expr");
+}
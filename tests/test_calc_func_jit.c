@@ -0,0 +1,184 @@
+/**
+ * @file test_calc_func_jit.c
+ *
+ * @brief Host test of the machine code of Calc_Func against its interpreter.
+ *
+ * Calc_Func.c is built with the defines of the target, so that every
+ * function is compiled to Thumb-2 code as on the board, and the code is
+ * run on the emulator (sim/Host_Jit.h). The Makefile builds the test twice:
+ * test_calc_func_jit with the hard-float calling convention (x and the
+ * result in s0) and test_calc_func_jit_soft without it (in r0).
+ *
+ * Random expressions of up to CALC_EXPR_MAX_CHARS characters must all
+ * compile to code that fits its pool and the scratch registers, and at
+ * random x the code must give the interpreter's value, bit for bit.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "test.h"
+#include "Host_Jit.h"
+#include "Calc_Expr.h"
+#include "Calc_Func.h"
+#include "Calc_Memory.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef CALC_FUNC_JIT
+#error "Build with -D__ARM_ARCH_7EM__ -D__ARM_FP=4, see tests/Makefile"
+#endif
+
+#ifdef __ARM_PCS_VFP
+#define TEST_NAME           "test_calc_func_jit"
+#else
+#define TEST_NAME           "test_calc_func_jit_soft"
+#endif
+
+// Values of x per function
+#define TEST_POINTS         8U
+
+// Registers of a sum of products: x in s0, then the sum, the product and an operand
+#define TEST_REGISTERS      0x0000000FU
+
+static const char *const operands[] = {
+    "x", "x", "x", "2", "0.5", "13.25", "3", "7", "0.1", "100", "1.", ".25", "0", "65504", "1234567"
+};
+
+static uint8_t Same_Value(float a, float b)
+{
+    return memcmp(&a, &b, sizeof(a)) == 0 || (isnan(a) && isnan(b));
+}
+
+// A random expression: an optional sign, then operands and operators
+static void Random_Expression(uint64_t *seed, char *text)
+{
+    uint32_t length = 0;
+    uint32_t budget = 1U + (uint32_t)(Test_Random(seed) % CALC_EXPR_MAX_CHARS);
+
+    if (Test_Random(seed) % 4U == 0)
+    {
+        text[length++] = (Test_Random(seed) & 1U) ? '-' : '+';
+    }
+
+    while (1)
+    {
+        const char *operand = operands[Test_Random(seed) % (sizeof(operands) / sizeof(operands[0]))];
+        uint32_t operand_length = (uint32_t)strlen(operand);
+
+        if (length + operand_length > CALC_EXPR_MAX_CHARS)
+        {
+            // End on an operator's operand that fits, x always does
+            operand = "x";
+            operand_length = 1;
+        }
+        memcpy(&text[length], operand, operand_length);
+        length += operand_length;
+
+        if (length + 2U > budget)
+        {
+            break;
+        }
+        text[length++] = "+-*/"[Test_Random(seed) % 4U];
+    }
+    text[length] = '\0';
+}
+
+// Random x: small integers, fractions, large and tiny values, zero
+static float Random_X(uint64_t *seed)
+{
+    uint64_t r = Test_Random(seed);
+
+    switch (r % 4U)
+    {
+        case 0:
+            return (float)((int32_t)((r >> 8) % 41U) - 20);
+
+        case 1:
+            return (float)((int32_t)((r >> 8) % 20001U) - 10000) / 37.0f;
+
+        case 2:
+            return ldexpf((float)((r >> 8) & 0xFFFFU) / 65536.0f, (int32_t)((r >> 24) % 200U) - 100);
+
+        default:
+            return 0.0f;
+    }
+}
+
+// Compare the code with the interpreter at x; returns 0 on a difference
+static uint8_t Same_As_Interpreter(const Calc_Func *func, float x, Host_Jit_Stats *stats)
+{
+    Calc_Func interpreted = *func;
+
+    interpreted.native = NULL;
+    float expected = Calc_Func_Eval(&interpreted, x);
+    float actual = Host_Jit_Run(func, x, stats);
+
+    return stats->error == NULL && Same_Value(expected, actual);
+}
+
+int main(void)
+{
+    static const char *const fixed[] = {
+        "x*x-2", "x", "5", "-x", "+x", "x*x*x*x*x*x", "2*x+3*x/7-1", "x+x+x", "1/x", "2*3+4*5", "-1/x/x"
+    };
+    uint64_t seed = 0x5EED0100ULL;
+    uint64_t functions = Test_Iterations(50000);
+    Host_Jit_Stats stats;
+    char text[CALC_EXPR_MAX_CHARS + 1];
+
+    for (uint32_t i = 0; i < sizeof(fixed) / sizeof(fixed[0]); i++)
+    {
+        Calc_Memory_Reset();
+        const Calc_Func *func = Calc_Func_Compile(fixed[i]);
+        TEST_CHECK_MSG(func != NULL && func->native != NULL, "%s: not compiled", fixed[i]);
+
+        for (int32_t x = -3; func != NULL && func->native != NULL && x <= 3; x++)
+        {
+            TEST_CHECK_MSG(Same_As_Interpreter(func, (float)x, &stats), "%s at %d: %s", fixed[i], x,
+                           (stats.error != NULL) ? stats.error : "different value");
+        }
+    }
+
+    // "x*x-2" is the example of Calc_Func.h: five instructions, the padding and one constant
+    Calc_Memory_Reset();
+    const Calc_Func *example = Calc_Func_Compile("x*x-2");
+    Host_Jit_Run(example, 3.0f, &stats);
+#ifdef __ARM_PCS_VFP
+    TEST_CHECK_MSG(stats.instructions == 5 && example->native_bytes == 24, "%u instructions, %u bytes",
+                   stats.instructions, example->native_bytes);
+#else
+    TEST_CHECK_MSG(stats.instructions == 7 && example->native_bytes == 32, "%u instructions, %u bytes",
+                   stats.instructions, example->native_bytes);
+#endif
+
+    for (uint64_t n = 0; n < functions; n++)
+    {
+        Random_Expression(&seed, text);
+
+        Calc_Memory_Reset();
+        const Calc_Func *func = Calc_Func_Compile(text);
+        TEST_CHECK_MSG(func != NULL, "\"%s\" does not compile", text);
+        if (func == NULL)
+        {
+            continue;
+        }
+        TEST_CHECK_MSG(func->native != NULL && func->native_bytes <= CALC_MEMORY_CODE_BYTES,
+                       "\"%s\": no machine code", text);
+        if (func->native == NULL)
+        {
+            continue;
+        }
+
+        for (uint32_t k = 0; k < TEST_POINTS; k++)
+        {
+            float x = Random_X(&seed);
+
+            TEST_CHECK_MSG(Same_As_Interpreter(func, x, &stats), "\"%s\" at %.9g: %s", text, (double)x,
+                           (stats.error != NULL) ? stats.error : "different value");
+        }
+        TEST_CHECK_MSG((stats.registers & ~TEST_REGISTERS) == 0, "\"%s\": registers 0x%04X", text,
+                       stats.registers);
+    }
+
+    return Test_Report(TEST_NAME);
+}
@@ -0,0 +1,90 @@
+/**
+ * @file test_calc_integrate.c
+ *
+ * @brief Host test of the adaptive Simpson quadrature (Calc_Integrate).
+ *
+ * Functions with known integrals must come out within the tolerance
+ * (relative to 1 + |I|, as in Calc_Integrate.h), and the error estimate
+ * must cover the actual error, up to the rounding of single precision.
+ * An evaluation budget that runs out must stop the refinement and say so.
+ * The time is converted with the clock of the measurement, not the clock
+ * at the time it is shown.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "test.h"
+#include "Host_Device.h"
+#include "Calc_Integrate.h"
+#include "Calc_Memory.h"
+#include "Clock_Governor.h"
+#include "Cycle_Counter.h"
+#include "SysTick_Delay.h"
+#include <math.h>
+
+// Rounding of a sum of single-precision terms, relative to 1 + |I|
+#define FLOAT_ROUNDING  1.0e-6
+
+typedef struct {
+    const char *text;
+    float a;
+    float b;
+    double integral;
+} Known_Integral;
+
+static const Known_Integral known[] = {
+    { "x*x",            0.0f,  1.0f,  1.0 / 3.0 },
+    { "3*x*x-2*x+1",    0.0f,  2.0f,  6.0 },
+    { "x*x*x*x",        -1.0f, 2.0f,  33.0 / 5.0 },
+    { "1/x",            1.0f,  2.0f,  0.69314718055994531 },
+    { "1/x",            0.01f, 1.0f,  4.6051701859880914 },
+    { "1/x/x",          1.0f,  3.0f,  2.0 / 3.0 },
+    { "x*x/2-x",        3.0f,  -1.0f, -2.0 / 3.0 },
+};
+
+int main(void)
+{
+    Calc_Integrate_Budget budget = { CALC_INTEGRATE_TOLERANCE, CALC_INTEGRATE_MAX_EVALUATIONS,
+                                     CALC_INTEGRATE_MAX_CYCLES };
+    Calc_Integrate_Result result;
+
+    TEST_CHECK(Host_Device_Init(NULL, 0) == 0);
+    SysTick_Delay_Init();
+    Cycle_Counter_Init();
+
+    for (uint32_t i = 0; i < sizeof(known) / sizeof(known[0]); i++)
+    {
+        Calc_Memory_Reset();
+        const Calc_Func *func = Calc_Func_Compile(known[i].text);
+        TEST_CHECK(func != NULL);
+
+        Calc_Integrate(func, known[i].a, known[i].b, &budget, &result);
+
+        double scale = 1.0 + fabs(known[i].integral);
+        double actual = fabs(result.value - known[i].integral);
+
+        TEST_CHECK_MSG(result.status == CALC_INTEGRATE_OK, "%s: status %u", known[i].text, result.status);
+        TEST_CHECK_MSG(actual <= budget.tolerance * scale, "%s from %g to %g: %.9g, error %.3g",
+                       known[i].text, known[i].a, known[i].b, result.value, actual);
+        TEST_CHECK_MSG(actual <= result.error_estimate + FLOAT_ROUNDING * scale, "%s: error %.3g, estimate %.3g",
+                       known[i].text, actual, result.error_estimate);
+        TEST_CHECK(result.evaluations <= budget.max_evaluations && result.max_stack <= CALC_INTEGRATE_STACK_SIZE);
+    }
+
+    // An evaluation budget that runs out stops the refinement
+    Calc_Memory_Reset();
+    const Calc_Func *func = Calc_Func_Compile("1/x");
+    Calc_Integrate_Budget small = { 1.0e-7f, 21U, CALC_INTEGRATE_MAX_CYCLES };
+    Calc_Integrate(func, 0.001f, 1.0f, &small, &result);
+    TEST_CHECK_MSG(result.status == CALC_INTEGRATE_EVALUATIONS && result.evaluations <= 21U,
+                   "status %u, %u evaluations", result.status, result.evaluations);
+    TEST_CHECK(result.error_estimate > 0.0);
+
+    // The time is converted at the clock it was measured at
+    SystemCoreClock = CLOCK_GOVERNOR_SLOW_HZ;
+    Calc_Integrate(func, 1.0f, 2.0f, &budget, &result);
+    SystemCoreClock = CLOCK_GOVERNOR_FAST_HZ;
+    TEST_CHECK(result.time_us == result.cycles / (CLOCK_GOVERNOR_SLOW_HZ / 1000000U));
+
+    return Test_Report("test_calc_integrate");
+}
@@ -0,0 +1,185 @@
+/**
+ * @file test_calc_poly.c
+ *
+ * @brief Host test of the polynomial root finder (Calc_Poly_Solve).
+ *
+ * Polynomials are multiplied out from known roots, real and complex
+ * pairs, of every degree (the closed forms and Durand-Kerner), and each
+ * known root must be found, within a tolerance relative to 1 + |root|.
+ * Every root found must also be a root of the coefficients as given: the
+ * polynomial at it must be rounding noise next to the sizes of its terms. The time is converted with the clock of the measurement, not
+ * the clock at the time it is shown.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "test.h"
+#include "Host_Device.h"
+#include "Calc_Poly.h"
+#include "Clock_Governor.h"
+#include "Cycle_Counter.h"
+#include "SysTick_Delay.h"
+#include <math.h>
+
+// Distance from a known simple root, relative to 1 + |root|
+#define ROOT_TOLERANCE      1.0e-8
+
+// |p(z)| relative to the sum of |c_i| (1 + |z|)^i, as the roots are relative to 1 + |root|
+#define RESIDUAL_TOLERANCE  1.0e-12
+
+typedef struct {
+    uint32_t degree;
+    Calc_Poly_Complex roots[CALC_POLY_MAX_DEGREE];
+} Known_Roots;
+
+static const Known_Roots known[] = {
+    { 1, { { 2.5, 0.0 } } },
+    { 2, { { -3.0, 0.0 }, { 1.0e-6, 0.0 } } },
+    { 2, { { 1.0, 2.0 }, { 1.0, -2.0 } } },
+    { 3, { { -1.0, 0.0 }, { 2.0, 0.0 }, { 3.0, 0.0 } } },
+    { 3, { { 0.5, 0.0 }, { -1.0, 1.0 }, { -1.0, -1.0 } } },
+    { 4, { { 1.0, 0.0 }, { 2.0, 0.0 }, { 3.0, 0.0 }, { 4.0, 0.0 } } },
+    { 4, { { 0.0, 1.0 }, { 0.0, -1.0 }, { 2.0, 3.0 }, { 2.0, -3.0 } } },
+    { 5, { { -2.0, 0.0 }, { -1.0, 0.0 }, { 0.0, 0.0 }, { 1.0, 0.0 }, { 2.0, 0.0 } } },
+    { 6, { { 1.0, 0.0 }, { -1.0, 0.0 }, { 0.5, 2.0 }, { 0.5, -2.0 }, { -3.0, 0.25 }, { -3.0, -0.25 } } },
+};
+
+// Coefficients, highest degree first, of the product of (x - root)
+static void Multiply_Out(const Calc_Poly_Complex *roots, uint32_t degree, double *coefficients)
+{
+    Calc_Poly_Complex c[CALC_POLY_MAX_DEGREE + 1] = { { 1.0, 0.0 } };
+
+    for (uint32_t k = 0; k < degree; k++)
+    {
+        for (uint32_t i = k + 1; i > 0; i--)
+        {
+            c[i].re -= roots[k].re * c[i - 1].re - roots[k].im * c[i - 1].im;
+            c[i].im -= roots[k].re * c[i - 1].im + roots[k].im * c[i - 1].re;
+        }
+    }
+    for (uint32_t i = 0; i <= degree; i++)
+    {
+        coefficients[i] = c[i].re;
+    }
+}
+
+static double Distance(Calc_Poly_Complex a, Calc_Poly_Complex b)
+{
+    return hypot(a.re - b.re, a.im - b.im);
+}
+
+// Every known root is near a root found, and every root found is a root of p
+static uint8_t Check_Roots(const Calc_Poly_Complex *roots, uint32_t degree, const double *coefficients,
+                           const Calc_Poly_Result *result)
+{
+    uint8_t ok = (result->degree == degree) && result->converged;
+
+    for (uint32_t k = 0; ok && k < degree; k++)
+    {
+        double nearest = INFINITY;
+        for (uint32_t j = 0; j < degree; j++)
+        {
+            nearest = fmin(nearest, Distance(roots[k], result->roots[j]));
+        }
+        ok = nearest <= ROOT_TOLERANCE * (1.0 + hypot(roots[k].re, roots[k].im));
+    }
+
+    for (uint32_t j = 0; ok && j < degree; j++)
+    {
+        Calc_Poly_Complex z = result->roots[j];
+        double re = 0.0, im = 0.0, size = 0.0;
+        double modulus = 1.0 + hypot(z.re, z.im);
+
+        for (uint32_t i = 0; i <= degree; i++)
+        {
+            double next = re * z.re - im * z.im + coefficients[i];
+            im = re * z.im + im * z.re;
+            re = next;
+            size = size * modulus + fabs(coefficients[i]);
+        }
+        ok = hypot(re, im) <= RESIDUAL_TOLERANCE * size;
+    }
+    return ok;
+}
+
+int main(void)
+{
+    uint64_t seed = 0x5EED0099ULL;
+    uint64_t polynomials = Test_Iterations(20000);
+    double coefficients[CALC_POLY_MAX_DEGREE + 1];
+    Calc_Poly_Result result;
+
+    TEST_CHECK(Host_Device_Init(NULL, 0) == 0);
+    SysTick_Delay_Init();
+    Cycle_Counter_Init();
+
+    for (uint32_t n = 0; n < sizeof(known) / sizeof(known[0]); n++)
+    {
+        Multiply_Out(known[n].roots, known[n].degree, coefficients);
+        Calc_Poly_Solve(coefficients, known[n].degree, &result);
+        TEST_CHECK_MSG(Check_Roots(known[n].roots, known[n].degree, coefficients, &result),
+                       "polynomial %u of degree %u: %u iterations", n, known[n].degree, result.iterations);
+        TEST_CHECK(result.method == ((known[n].degree > 3) ? CALC_POLY_DURAND_KERNER : CALC_POLY_CLOSED_FORM));
+    }
+
+    // The roots come out real first, then by real part, with the real ones exactly real
+    Multiply_Out(known[5].roots, 4, coefficients);
+    Calc_Poly_Solve(coefficients, 4, &result);
+    for (uint32_t k = 0; k < 4; k++)
+    {
+        TEST_CHECK(result.roots[k].im == 0.0 && fabs(result.roots[k].re - (double)(k + 1)) < ROOT_TOLERANCE);
+    }
+
+    // Leading zero coefficients lower the degree
+    double linear[] = { 0.0, 0.0, 2.0, -3.0 };
+    Calc_Poly_Solve(linear, 3, &result);
+    TEST_CHECK(result.degree == 1 && result.roots[0].re == 1.5);
+
+    // Random roots on a grid, so that no two are closer than its step
+    for (uint64_t n = 0; n < polynomials; n++)
+    {
+        Calc_Poly_Complex roots[CALC_POLY_MAX_DEGREE];
+        uint32_t degree = 1U + (uint32_t)(Test_Random(&seed) % CALC_POLY_MAX_DEGREE);
+        uint32_t count = 0;
+
+        while (count < degree)
+        {
+            uint64_t r = Test_Random(&seed);
+            double re = (double)((int32_t)(r % 33U) - 16) * 0.25;
+            double im = (double)(int32_t)((r >> 8) % 9U) * 0.25;
+            uint8_t pair = (im != 0.0) && (count + 2U <= degree) && ((r >> 16) & 1U);
+            Calc_Poly_Complex root = { re, pair ? im : 0.0 };
+            uint8_t taken = 0;
+
+            for (uint32_t k = 0; k < count; k++)
+            {
+                taken |= (Distance(roots[k], root) < 0.125);
+            }
+            if (taken)
+            {
+                continue;
+            }
+
+            roots[count++] = root;
+            if (pair)
+            {
+                roots[count++] = (Calc_Poly_Complex){ re, -im };
+            }
+        }
+
+        Multiply_Out(roots, degree, coefficients);
+        Calc_Poly_Solve(coefficients, degree, &result);
+        TEST_CHECK_MSG(Check_Roots(roots, degree, coefficients, &result),
+                       "polynomial %llu of degree %u: %u iterations", (unsigned long long)n, degree,
+                       result.iterations);
+    }
+
+    // The time is converted at the clock it was measured at
+    Multiply_Out(known[8].roots, 6, coefficients);
+    SystemCoreClock = CLOCK_GOVERNOR_SLOW_HZ;
+    Calc_Poly_Solve(coefficients, 6, &result);
+    SystemCoreClock = CLOCK_GOVERNOR_FAST_HZ;
+    TEST_CHECK(result.time_us == result.cycles / (CLOCK_GOVERNOR_SLOW_HZ / 1000000U));
+
+    return Test_Report("test_calc_poly");
+}
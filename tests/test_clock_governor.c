@@ -0,0 +1,72 @@
+/**
+ * @file test_clock_governor.c
+ *
+ * @brief Host test of the Clock_Governor module on the device model.
+ *
+ * A fast request switches to 80 MHz when the PLL locks. When it does not,
+ * the governor must give up after CLOCK_GOVERNOR_PLL_TIMEOUT_US, stay on
+ * the PIOSC with SystemCoreClock at 16 MHz, count the timeout, and switch
+ * on a later request once the PLL locks again.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "test.h"
+#include "Host_Device.h"
+#include "Clock_Governor.h"
+#include "SysTick_Delay.h"
+
+static uint32_t listener_calls;
+
+static void Listener(void)
+{
+    listener_calls++;
+}
+
+int main(void)
+{
+    Clock_Governor_Stats stats;
+
+    TEST_CHECK(Host_Device_Init(NULL, 0) == 0);
+    SysTick_Delay_Init();
+    Clock_Governor_Init();
+    TEST_CHECK(Clock_Governor_Register_Listener(Listener));
+    TEST_CHECK(SystemCoreClock == CLOCK_GOVERNOR_SLOW_HZ);
+
+    Clock_Governor_Request_Fast();
+    Clock_Governor_Get_Stats(&stats);
+    TEST_CHECK(SystemCoreClock == CLOCK_GOVERNOR_FAST_HZ && stats.pll_timeouts == 0);
+    Clock_Governor_Set_Profile(CLOCK_GOVERNOR_PROFILE_SLOW);
+    TEST_CHECK(SystemCoreClock == CLOCK_GOVERNOR_SLOW_HZ);
+
+    // The PLL does not lock: the request times out instead of hanging
+    Host_Device_Set_Pll_Fails(1);
+    uint32_t calls = listener_calls;
+    uint64_t start_us = SysTick_Get_Time_us();
+
+    Clock_Governor_Set_Profile(CLOCK_GOVERNOR_PROFILE_AUTO);
+    uint64_t wait_us = SysTick_Get_Time_us() - start_us;
+    Clock_Governor_Get_Stats(&stats);
+
+    TEST_CHECK_MSG(SystemCoreClock == CLOCK_GOVERNOR_SLOW_HZ, "%u Hz", SystemCoreClock);
+    TEST_CHECK(stats.pll_timeouts == 1 && listener_calls == calls + 1);
+    TEST_CHECK_MSG(wait_us >= CLOCK_GOVERNOR_PLL_TIMEOUT_US && wait_us < CLOCK_GOVERNOR_PLL_TIMEOUT_US + 100U,
+                   "%llu us", (unsigned long long)wait_us);
+    TEST_CHECK(stats.switch_us_last >= CLOCK_GOVERNOR_PLL_TIMEOUT_US);
+
+    // It is tried again on the next request
+    Clock_Governor_Request_Fast();
+    Clock_Governor_Get_Stats(&stats);
+    TEST_CHECK(SystemCoreClock == CLOCK_GOVERNOR_SLOW_HZ && stats.pll_timeouts == 2);
+
+    Host_Device_Set_Pll_Fails(0);
+    Clock_Governor_Request_Fast();
+    Clock_Governor_Get_Stats(&stats);
+    TEST_CHECK(SystemCoreClock == CLOCK_GOVERNOR_FAST_HZ && stats.pll_timeouts == 2);
+
+    SysTick_Delay1us(CLOCK_GOVERNOR_IDLE_TIMEOUT_MS * 1000U);
+    Clock_Governor_Poll();
+    TEST_CHECK(SystemCoreClock == CLOCK_GOVERNOR_SLOW_HZ);
+
+    return Test_Report("test_clock_governor");
+}
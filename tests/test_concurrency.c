@@ -0,0 +1,254 @@
+/**
+ * @file test_concurrency.c
+ *
+ * @brief Host test of the lock-free primitives (Atomic.h, Spsc_Queue.c)
+ * between threads.
+ *
+ * On the target the two sides are an interrupt handler and the main
+ * loop; here they are host threads running at the same time, which is
+ * harsher, since either side can be interrupted anywhere. The waiting
+ * sides yield, so that the test also runs on a single core. The stub
+ * implements the exclusive monitor and the barriers with the host's
+ * atomics (stub/TM4C123GH6PM.h). Each test checks that no update is lost
+ * or torn:
+ *  - Atomic_Fetch_Add and Atomic_Compare_Exchange counters
+ *  - a flag set, each flag set again only after the consumer took it
+ *  - a seqlock whose reader must never see a half-written record
+ *  - a Spsc_Queue carrying a sequence that must come out in order
+ *
+ * make tsan builds the same test with ThreadSanitizer, which also reports
+ * any access to shared state that is not ordered by the primitives.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "test.h"
+#include "Atomic.h"
+#include "Spsc_Queue.h"
+#include <pthread.h>
+#include <sched.h>
+
+#define THREADS         4U
+
+// Iterations per thread
+#define DEFAULT_COUNT   100000U
+
+// Record of the seqlock test; each word is written with the same value
+#define RECORD_WORDS    4U
+
+static uint64_t count;
+
+static volatile uint32_t counter;
+static volatile uint32_t cas_counter;
+
+static Atomic_Flags flags;
+static volatile uint32_t flags_set[THREADS];
+
+static Seqlock lock = SEQLOCK_INIT;
+static uint32_t record[RECORD_WORDS];
+static volatile uint32_t writer_done;
+
+static Spsc_Queue queue;
+static uint32_t queue_buffer[64];
+
+typedef void *(*Thread_Fn)(void *);
+
+static void Run_Threads(Thread_Fn *functions, uint32_t thread_count)
+{
+    pthread_t threads[THREADS + 1];
+
+    for (uint32_t i = 0; i < thread_count; i++)
+    {
+        pthread_create(&threads[i], NULL, functions[i], (void *)(uintptr_t)i);
+    }
+    for (uint32_t i = 0; i < thread_count; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+static void *Counter_Thread(void *argument)
+{
+    for (uint64_t i = 0; i < count; i++)
+    {
+        Atomic_Fetch_Add(&counter, 1);
+
+        uint32_t value;
+        do
+        {
+            value = Atomic_Load(&cas_counter);
+        } while (!Atomic_Compare_Exchange(&cas_counter, value, value + 1));
+    }
+    return argument;
+}
+
+static void *Flag_Producer(void *argument)
+{
+    uint32_t mask = 1U << (uint32_t)(uintptr_t)argument;
+
+    for (uint64_t i = 0; i < count; i++)
+    {
+        // Set again once the consumer took it
+        while ((Atomic_Load(&flags) & mask) != 0)
+        {
+            sched_yield();
+        }
+        Atomic_Flags_Set(&flags, mask);
+    }
+    return argument;
+}
+
+static void *Flag_Consumer(void *argument)
+{
+    uint64_t taken = 0;
+
+    while (taken < THREADS * count)
+    {
+        uint32_t set = Atomic_Flags_Take(&flags, (1U << THREADS) - 1U);
+
+        if (set == 0)
+        {
+            sched_yield();
+        }
+
+        for (uint32_t i = 0; i < THREADS; i++)
+        {
+            if ((set & (1U << i)) != 0)
+            {
+                flags_set[i]++;
+                taken++;
+            }
+        }
+    }
+    return argument;
+}
+
+static void *Seqlock_Writer(void *argument)
+{
+    for (uint32_t value = 1; value <= count; value++)
+    {
+        Seqlock_Write_Begin(&lock);
+        for (uint32_t i = 0; i < RECORD_WORDS; i++)
+        {
+            Atomic_Store(&record[i], value);
+        }
+        Seqlock_Write_End(&lock);
+    }
+    Atomic_Store_Release(&writer_done, 1);
+    return argument;
+}
+
+static void *Seqlock_Reader(void *argument)
+{
+    uint32_t *torn = argument;
+    uint32_t previous = 0;
+
+    while (Atomic_Load_Acquire(&writer_done) == 0)
+    {
+        uint32_t copy[RECORD_WORDS];
+        uint32_t sequence;
+
+        do
+        {
+            sequence = Seqlock_Read_Begin(&lock);
+            for (uint32_t i = 0; i < RECORD_WORDS; i++)
+            {
+                copy[i] = Atomic_Load(&record[i]);
+            }
+        } while (Seqlock_Read_Retry(&lock, sequence));
+
+        for (uint32_t i = 1; i < RECORD_WORDS; i++)
+        {
+            *torn += (copy[i] != copy[0]);
+        }
+        // The records only move forward
+        *torn += (copy[0] < previous);
+        previous = copy[0];
+    }
+    return NULL;
+}
+
+static void *Queue_Producer(void *argument)
+{
+    uint32_t *full = argument;
+
+    for (uint32_t value = 0; value < count; )
+    {
+        if (Spsc_Queue_Push(&queue, value))
+        {
+            value++;
+        }
+        else
+        {
+            (*full)++;
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void *Queue_Consumer(void *argument)
+{
+    uint32_t *out_of_order = argument;
+    uint32_t expected = 0;
+
+    while (expected < count)
+    {
+        uint32_t value;
+
+        if (Spsc_Queue_Pop(&queue, &value))
+        {
+            *out_of_order += (value != expected);
+            expected = value + 1;
+        }
+        else
+        {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    count = Test_Iterations(DEFAULT_COUNT);
+
+    Thread_Fn counters[THREADS] = { Counter_Thread, Counter_Thread, Counter_Thread, Counter_Thread };
+    Run_Threads(counters, THREADS);
+    TEST_CHECK_MSG(counter == THREADS * count, "%u increments", counter);
+    TEST_CHECK_MSG(cas_counter == THREADS * count, "%u increments", cas_counter);
+
+    Thread_Fn flag_threads[THREADS + 1] = { Flag_Producer, Flag_Producer, Flag_Producer, Flag_Producer,
+                                            Flag_Consumer };
+    Run_Threads(flag_threads, THREADS + 1);
+    for (uint32_t i = 0; i < THREADS; i++)
+    {
+        TEST_CHECK_MSG(flags_set[i] == count, "flag %u taken %u times", i, flags_set[i]);
+    }
+    TEST_CHECK(flags == 0);
+
+    // Two threads only, with their results passed through the argument
+    pthread_t writer;
+    pthread_t reader;
+    uint32_t torn = 0;
+    pthread_create(&writer, NULL, Seqlock_Writer, NULL);
+    pthread_create(&reader, NULL, Seqlock_Reader, &torn);
+    pthread_join(writer, NULL);
+    pthread_join(reader, NULL);
+    TEST_CHECK_MSG(torn == 0, "%u torn seqlock reads", torn);
+    TEST_CHECK(lock.sequence == 2 * count);
+
+    uint32_t full = 0;
+    uint32_t out_of_order = 0;
+    Spsc_Queue_Init(&queue, queue_buffer, 64);
+    pthread_t producer;
+    pthread_t consumer;
+    pthread_create(&producer, NULL, Queue_Producer, &full);
+    pthread_create(&consumer, NULL, Queue_Consumer, &out_of_order);
+    pthread_join(producer, NULL);
+    pthread_join(consumer, NULL);
+    TEST_CHECK_MSG(out_of_order == 0, "%u values out of order", out_of_order);
+    TEST_CHECK(queue.dropped == full && Spsc_Queue_Count(&queue) == 0);
+
+    return Test_Report("test_concurrency");
+}
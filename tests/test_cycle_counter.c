@@ -0,0 +1,64 @@
+/**
+ * @file test_cycle_counter.c
+ *
+ * @brief Host test of the Cycle_Counter driver on the device model.
+ *
+ * The DWT cycle counter of the model follows the virtual clock, so a
+ * delay measures as its length times SystemCoreClock, at 16 MHz and at
+ * 80 MHz. A statistics record keeps the clock of its samples and starts
+ * over when the clock changes.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "test.h"
+#include "Host_Device.h"
+#include "Cycle_Counter.h"
+#include "SysTick_Delay.h"
+
+#define DELAY_US        1000U
+
+// Register accesses of the delay loop, at a few cycles each
+#define OVERHEAD_CYCLES 200U
+
+static uint32_t Measure_Delay(void)
+{
+    uint32_t start = Cycle_Counter_Read();
+
+    SysTick_Delay1us(DELAY_US);
+    return Cycle_Counter_Read() - start;
+}
+
+int main(void)
+{
+    TEST_CHECK(Host_Device_Init(NULL, 0) == 0);
+    SysTick_Delay_Init();
+    Cycle_Counter_Init();
+
+    Cycle_Counter_Stats stats = { 0 };
+    uint32_t expected = DELAY_US * 16U;
+    uint32_t cycles = Measure_Delay();
+
+    TEST_CHECK_MSG(cycles >= expected && cycles < expected + OVERHEAD_CYCLES, "%u cycles at 16 MHz", cycles);
+    Cycle_Counter_Stats_Add(&stats, cycles);
+    Cycle_Counter_Stats_Add(&stats, Measure_Delay());
+    TEST_CHECK(stats.count == 2 && stats.clock_hz == 16000000U);
+
+    // The clock governor switched to the PLL
+    SystemCoreClock = 80000000U;
+    expected = DELAY_US * 80U;
+    cycles = Measure_Delay();
+
+    TEST_CHECK_MSG(cycles >= expected && cycles < expected + OVERHEAD_CYCLES, "%u cycles at 80 MHz", cycles);
+    Cycle_Counter_Stats_Add(&stats, cycles);
+    TEST_CHECK(stats.count == 1 && stats.clock_hz == 80000000U && stats.min == cycles && stats.total == cycles);
+
+    // The per-key statistics behave the same
+    Cycle_Counter_Record_Key('5', cycles);
+    SystemCoreClock = 16000000U;
+    Cycle_Counter_Record_Key('5', 1000U);
+    TEST_CHECK(Cycle_Counter_Get_Key_Stats('5')->count == 1 && Cycle_Counter_Get_Key_Stats('5')->max == 1000U);
+    TEST_CHECK(Cycle_Counter_Get_Key_Stats('x') == NULL);
+
+    return Test_Report("test_cycle_counter");
+}
@@ -0,0 +1,121 @@
+/**
+ * @file test_double_float.c
+ *
+ * @brief Host test of the error classification of the Double_Float backend.
+ *
+ * Calc_Number, Calc_Error and Double_Float are built as for the target
+ * with CALC_NUMBER_BACKEND = CALC_BACKEND_DOUBLE_FLOAT and __ARM_FP, so
+ * the errors come from the FPSCR flags (the host's, through the stub
+ * header). Overflow must show as an overflow, not as an invalid
+ * operation, and only a result whose hi word underflows is an underflow.
+ * Random operations well inside the float range must raise nothing and
+ * keep the precision of the format.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "test.h"
+#include "Calc_Number.h"
+#include "Calc_Error.h"
+#include <math.h>
+
+typedef Calc_Number (*Operation)(Calc_Number a, Calc_Number b);
+
+static Calc_Error Evaluate(Operation op, double a, double b, double *value)
+{
+    Calc_Error_Begin();
+    Calc_Number result = op(Calc_Number_From_Double(a), Calc_Number_From_Double(b));
+    *value = Calc_Number_To_Double(result);
+    return Calc_Error_End(result);
+}
+
+static void Check_Error(const char *name, Operation op, double a, double b, Calc_Error expected)
+{
+    double value;
+    Calc_Error error = Evaluate(op, a, b, &value);
+
+    TEST_CHECK_MSG(error == expected, "%s(%g, %g) = %g: \"%s\", expected \"%s\"", name, a, b, value,
+                   Calc_Error_Message(error), Calc_Error_Message(expected));
+}
+
+// A random value with a magnitude between 10^min_exponent and 10^max_exponent
+static double Random_Value(uint64_t *state, int min_exponent, int max_exponent)
+{
+    double mantissa = 1.0 + (double)(Test_Random(state) >> 11) * 0x1p-53 * 9.0;
+    int exponent = min_exponent + (int)(Test_Random(state) % (uint64_t)(max_exponent - min_exponent + 1));
+    double sign = (Test_Random(state) & 1U) ? -1.0 : 1.0;
+
+    return sign * mantissa * pow(10.0, exponent);
+}
+
+int main(void)
+{
+    uint64_t iterations = Test_Iterations(1000000U);
+    uint64_t state = 0xD1B54A32D192ED03ULL;
+
+    // Overflow of the hi word
+    Check_Error("mul", Calc_Number_Mul, 1e30, 1e30, CALC_ERROR_OVERFLOW);
+    Check_Error("mul", Calc_Number_Mul, -3e38, 3e38, CALC_ERROR_OVERFLOW);
+    Check_Error("add", Calc_Number_Add, 3e38, 3e38, CALC_ERROR_OVERFLOW);
+    Check_Error("sub", Calc_Number_Sub, -3e38, 3e38, CALC_ERROR_OVERFLOW);
+    Check_Error("div", Calc_Number_Div, 3e38, 1e-5, CALC_ERROR_OVERFLOW);
+
+    // A subnormal lo word on a normal result is not an underflow
+    Check_Error("mul", Calc_Number_Mul, 1e-30, 1e-5, CALC_ERROR_NONE);
+    Check_Error("mul", Calc_Number_Mul, 1.1, 1.3e-37, CALC_ERROR_NONE);
+    Check_Error("div", Calc_Number_Div, 1e-30, 3e5, CALC_ERROR_NONE);
+    Check_Error("add", Calc_Number_Add, 1.7e-37, 1.3e-38, CALC_ERROR_NONE);
+
+    // The hi word underflows
+    Check_Error("mul", Calc_Number_Mul, 1e-30, 1e-10, CALC_ERROR_UNDERFLOW);
+    Check_Error("mul", Calc_Number_Mul, 1e-20, 1e-20, CALC_ERROR_UNDERFLOW);
+    Check_Error("div", Calc_Number_Div, 1e-30, 1e15, CALC_ERROR_UNDERFLOW);
+
+    // The other errors are unchanged
+    Check_Error("div", Calc_Number_Div, 0.5, 0.0, CALC_ERROR_DIV_BY_ZERO);
+    Check_Error("div", Calc_Number_Div, 0.0, 0.0, CALC_ERROR_INVALID);
+    Check_Error("sub", Calc_Number_Sub, 0.1, 0.1, CALC_ERROR_NONE);
+
+    // Random operations with results between 1e-29 and 1e30, where the lo
+    // word is normal too: no error, about 14 digits
+    static const struct {
+        const char *name;
+        Operation op;
+        char symbol;
+    } operations[] = {
+        { "add", Calc_Number_Add, '+' },
+        { "sub", Calc_Number_Sub, '-' },
+        { "mul", Calc_Number_Mul, '*' },
+        { "div", Calc_Number_Div, '/' }
+    };
+
+    for (uint64_t n = 0; n < iterations; n++)
+    {
+        uint32_t i = (uint32_t)(n % 4U);
+        double a = Random_Value(&state, -14, 14);
+        double b = Random_Value(&state, -14, 14);
+        double value;
+        double exact;
+
+        switch (operations[i].symbol)
+        {
+            case '+': exact = a + b; break;
+            case '-': exact = a - b; break;
+            case '*': exact = a * b; break;
+            default:  exact = a / b; break;
+        }
+
+        Calc_Error error = Evaluate(operations[i].op, a, b, &value);
+
+        // Add and sub are exact relative to the operands, not the (cancelled) result
+        double scale = (operations[i].symbol == '+' || operations[i].symbol == '-')
+                       ? fmax(fabs(a), fabs(b)) : fabs(exact);
+
+        TEST_CHECK_MSG(error == CALC_ERROR_NONE, "%s(%g, %g): \"%s\"", operations[i].name, a, b,
+                       Calc_Error_Message(error));
+        TEST_CHECK_MSG(fabs(value - exact) <= 1e-13 * scale, "%s(%.17g, %.17g) = %.17g, expected %.17g",
+                       operations[i].name, a, b, value, exact);
+    }
+
+    return Test_Report("test_double_float");
+}
@@ -0,0 +1,109 @@
+/**
+ * @file test_farm.c
+ *
+ * @brief Host test of the simulation farm (tests/sim/Host_Farm.c).
+ *
+ * The session corpus of the firmware is run on one worker and on several:
+ * every session completes, and the results do not depend on the number of
+ * workers. The CSV results read back as written, and the comparison of a
+ * run with itself shows no change.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "test.h"
+#include "Host_Farm.h"
+#include "Session_Replay.h"
+#include <math.h>
+#include <string.h>
+
+#define MAX_SESSIONS    64U
+
+static Host_Farm_Session sessions[MAX_SESSIONS];
+static Host_Farm_Result serial[MAX_SESSIONS];
+static Host_Farm_Result parallel[MAX_SESSIONS];
+static Host_Farm_Result loaded[MAX_SESSIONS];
+
+int main(void)
+{
+    uint32_t count = Session_Replay_Corpus_Size;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        snprintf(sessions[i].name, HOST_FARM_NAME_LENGTH, "%s", Session_Replay_Corpus[i].name);
+        snprintf(sessions[i].keys, HOST_FARM_KEYS_LENGTH, "%s", Session_Replay_Corpus[i].keys);
+    }
+
+    double start = Test_Seconds();
+    TEST_CHECK(Host_Farm_Run(sessions, count, 1, serial) == 0);
+    double serial_seconds = Test_Seconds() - start;
+
+    start = Test_Seconds();
+    TEST_CHECK(Host_Farm_Run(sessions, count, 4, parallel) == 0);
+    double parallel_seconds = Test_Seconds() - start;
+
+    printf("test_farm: %u sessions in %.3f s on 1 worker, %.3f s on 4\n", count, serial_seconds,
+           parallel_seconds);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        TEST_CHECK_MSG(serial[i].completed && strcmp(serial[i].name, sessions[i].name) == 0,
+                       "session %s did not complete", sessions[i].name);
+        TEST_CHECK_MSG(serial[i].key_count == strlen(sessions[i].keys) && serial[i].max_latency_us > 0.0,
+                       "session %s: %u keys, %.1f us", sessions[i].name, serial[i].key_count,
+                       serial[i].max_latency_us);
+        TEST_CHECK_MSG(strcmp(serial[i].name, parallel[i].name) == 0 &&
+                       serial[i].completed == parallel[i].completed &&
+                       serial[i].lcd_bytes == parallel[i].lcd_bytes &&
+                       serial[i].max_latency_us == parallel[i].max_latency_us &&
+                       serial[i].mean_latency_us == parallel[i].mean_latency_us &&
+                       serial[i].busy_us == parallel[i].busy_us,
+                       "session %s differs between 1 and 4 workers", sessions[i].name);
+    }
+
+    // CSV round trip (to the printed precision)
+    FILE *file = tmpfile();
+    Host_Farm_Write_Csv(file, serial, count);
+    rewind(file);
+    TEST_CHECK(Host_Farm_Read_Csv(file, loaded, MAX_SESSIONS) == (int)count);
+    fclose(file);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        TEST_CHECK(strcmp(loaded[i].name, serial[i].name) == 0 && loaded[i].key_count == serial[i].key_count &&
+                   loaded[i].slowest_key == serial[i].slowest_key &&
+                   fabs(loaded[i].max_latency_us - serial[i].max_latency_us) < 1e-3);
+    }
+
+    // The slowest session first
+    Host_Farm_Sort_Slowest(loaded, count);
+    for (uint32_t i = 1; i < count; i++)
+    {
+        TEST_CHECK(loaded[i - 1].max_latency_us >= loaded[i].max_latency_us);
+    }
+
+    // A run compared with itself
+    char *text = NULL;
+    size_t length = 0;
+    file = open_memstream(&text, &length);
+    Host_Farm_Diff(file, serial, count, parallel, count, 3);
+    fclose(file);
+    TEST_CHECK_MSG(strstr(text, "key latency +0.0 us in total") != NULL && strstr(text, "only in") == NULL,
+                   "%s", text);
+    free(text);
+
+    // Session files
+    file = tmpfile();
+    fputs("# name keys\n\nadd 1+2=\n  hold_undo   12+3=-@1500\n", file);
+    rewind(file);
+    TEST_CHECK(Host_Farm_Read_Sessions(file, sessions, MAX_SESSIONS) == 2);
+    TEST_CHECK(strcmp(sessions[1].name, "hold_undo") == 0 && strcmp(sessions[1].keys, "12+3=-@1500") == 0);
+    fclose(file);
+
+    file = tmpfile();
+    fputs("add 1+2= extra\n", file);
+    rewind(file);
+    TEST_CHECK(Host_Farm_Read_Sessions(file, sessions, MAX_SESSIONS) < 0);
+    fclose(file);
+
+    return Test_Report("test_farm");
+}
@@ -0,0 +1,107 @@
+/**
+ * @file test_journal.c
+ *
+ * @brief Host test of the Journal module on the flash model.
+ *
+ * The records of each type must come back from Journal_Find, from the
+ * queue and from the flash, and again after Journal_Init scans the flash
+ * as after a reset. A paused journal must not take records. Without
+ * permission to erase, Journal_Poll must only program: once the erased
+ * pages run out, the records wait in the queue (and the overflow is
+ * dropped) until a poll may erase, which retires the oldest page.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "test.h"
+#include "Host_Device.h"
+#include "Journal.h"
+#include "SysTick_Delay.h"
+#include <string.h>
+
+static uint8_t Same_Number(Calc_Number a, Calc_Number b)
+{
+    return a.type == b.type && memcmp(&a.value, &b.value, sizeof(a.value)) == 0;
+}
+
+static void Poll(uint32_t count, uint8_t may_erase)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        Journal_Poll(may_erase);
+    }
+}
+
+int main(void)
+{
+    Journal_Stats stats;
+    Journal_Entry entry;
+    Calc_Number three = Calc_Number_From_Int(3);
+    Calc_Number four = Calc_Number_From_Int(4);
+    Calc_Number root = Calc_Number_From_Double(1.4142135623730951);
+
+    TEST_CHECK(Host_Device_Init(NULL, 0) == 0);
+    SysTick_Delay_Init();
+    Journal_Init();
+
+    // One record of each type, found while queued and once programmed
+    uint32_t first = Journal_Append('+', three, four, Calc_Number_From_Int(7), 0);
+    TEST_CHECK(first == 1);
+    TEST_CHECK(Journal_Append_Result(JOURNAL_TYPE_EXPRESSION, four, 0) == 2);
+    TEST_CHECK(Journal_Append_Result(JOURNAL_TYPE_INTEGRAL, three, 0) == 3);
+    TEST_CHECK(Journal_Append_Result(JOURNAL_TYPE_ROOT, root, 0) == 4);
+    TEST_CHECK(Journal_Find(4, &entry) && entry.type == JOURNAL_TYPE_ROOT && Same_Number(entry.result, root));
+
+    Poll(4, 0);
+    Journal_Get_Stats(&stats);
+    TEST_CHECK(stats.written == 4 && stats.erases == 0);
+
+    TEST_CHECK(Journal_Find(1, &entry));
+    TEST_CHECK(entry.type == JOURNAL_TYPE_CALCULATION && entry.op == '+');
+    TEST_CHECK(Same_Number(entry.op1, three) && Same_Number(entry.op2, four));
+    TEST_CHECK(Journal_Find(2, &entry) && entry.type == JOURNAL_TYPE_EXPRESSION && entry.op == '\0');
+    TEST_CHECK(Journal_Find(3, &entry) && entry.type == JOURNAL_TYPE_INTEGRAL && Same_Number(entry.result, three));
+    TEST_CHECK(Journal_Find(4, &entry) && entry.type == JOURNAL_TYPE_ROOT && Same_Number(entry.result, root));
+    TEST_CHECK(!Journal_Find(5, &entry) && !Journal_Find(0, &entry));
+
+    // Paused: nothing is queued
+    Journal_Set_Paused(1);
+    TEST_CHECK(Journal_Append('*', three, four, Calc_Number_From_Int(12), 0) == 0);
+    TEST_CHECK(Journal_Append_Result(JOURNAL_TYPE_ROOT, root, 0) == 0);
+    Journal_Set_Paused(0);
+    Journal_Get_Stats(&stats);
+    TEST_CHECK(stats.appended == 4 && stats.next_sequence == 5 && stats.dropped == 0);
+
+    // After a reset, the records and their types are read back from the flash
+    Journal_Init();
+    Journal_Get_Stats(&stats);
+    TEST_CHECK_MSG(stats.oldest_sequence == 1 && stats.next_sequence == 5, "%u to %u",
+                   stats.oldest_sequence, stats.next_sequence);
+    TEST_CHECK(Journal_Find(4, &entry) && entry.type == JOURNAL_TYPE_ROOT && Same_Number(entry.result, root));
+    TEST_CHECK(Journal_Find(2, &entry) && entry.type == JOURNAL_TYPE_EXPRESSION);
+
+    // Fill every page without permission to erase (the counts start again at Journal_Init)
+    uint32_t capacity = JOURNAL_PAGE_COUNT * JOURNAL_RECORDS_PER_PAGE;
+    for (uint32_t i = 4; i < capacity + JOURNAL_QUEUE_SIZE + 3U; i++)
+    {
+        Journal_Append('-', Calc_Number_From_Int(i), three, Calc_Number_From_Int((int64_t)i - 3), 0);
+        Poll(1, 0);
+    }
+    Journal_Get_Stats(&stats);
+    TEST_CHECK_MSG(stats.written == capacity - 4U, "%u written", stats.written);
+    TEST_CHECK(stats.erases == 0 && stats.retired == 0 && stats.oldest_sequence == 1);
+    TEST_CHECK_MSG(stats.dropped == 3, "%u dropped", stats.dropped);
+    TEST_CHECK(Journal_Find(1, &entry) && entry.op == '+');
+
+    // Once erasing is allowed, the oldest page makes room for the queue
+    Poll(4 * JOURNAL_QUEUE_SIZE, 1);
+    Journal_Get_Stats(&stats);
+    TEST_CHECK_MSG(stats.written == capacity - 4U + JOURNAL_QUEUE_SIZE, "%u written", stats.written);
+    TEST_CHECK(stats.erases >= 1 && stats.retired >= JOURNAL_RECORDS_PER_PAGE);
+    TEST_CHECK(stats.oldest_sequence > 1 && !Journal_Find(1, &entry));
+    TEST_CHECK(Journal_Find(stats.next_sequence - 1U, &entry) && entry.op == '-');
+    TEST_CHECK_MSG(stats.erase_us_max > 0 && stats.program_us_max > 0, "%u us, %u us",
+                   stats.erase_us_max, stats.program_us_max);
+
+    return Test_Report("test_journal");
+}
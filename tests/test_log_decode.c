@@ -0,0 +1,128 @@
+/**
+ * @file test_log_decode.c
+ *
+ * @brief Host test of the log decoder (tests/tools/Log_Decode.c).
+ *
+ * The test is linked without PIE, like the firmware objects, so the
+ * addresses of its format strings fit the 32-bit IDs, and it reads the
+ * .logfmt section of its own ELF file. Records written by the LOG macros
+ * and flushed by Log_Flush must decode to the text printf gives, with the
+ * time measured by the cycle counter of the device model; the log of a
+ * simulated session must decode as well.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "test.h"
+#include "Log_Decode.h"
+#include "Host_Sim.h"
+#include "Log.h"
+#include "Cycle_Counter.h"
+#include "SysTick_Delay.h"
+#include <string.h>
+
+// Top byte of the ID of the first record, after the 12-byte dump header
+#define FIRST_ID_TOP_BYTE   15U
+
+static Host_Sim_Result result;
+
+static FILE *flush_output;
+
+static void Flush_Output(char c)
+{
+    fputc(c, flush_output);
+}
+
+static char *Flush(size_t *length)
+{
+    char *data = NULL;
+
+    flush_output = open_memstream(&data, length);
+    Log_Flush(Flush_Output);
+    fclose(flush_output);
+    return data;
+}
+
+static char *Decode(const Log_Decode_Formats *formats, const void *data, size_t length, int *dumps)
+{
+    char *text = NULL;
+    size_t text_length = 0;
+    FILE *out = open_memstream(&text, &text_length);
+
+    *dumps = Log_Decode_Convert(formats, data, length, SystemCoreClock, out);
+    fclose(out);
+    return text;
+}
+
+int main(void)
+{
+    Log_Decode_Formats formats;
+    FILE *elf = fopen("/proc/self/exe", "rb");
+    size_t length;
+    int dumps;
+
+    TEST_CHECK(elf != NULL && Log_Decode_Load_Elf(elf, &formats) == 0);
+    if (elf != NULL)
+    {
+        fclose(elf);
+    }
+    if (formats.data == NULL)
+    {
+        return Test_Report("test_log_decode");
+    }
+
+    TEST_CHECK(Host_Device_Init(NULL, 0) == 0);
+    SysTick_Delay_Init();
+    Cycle_Counter_Init();
+
+    LOG("Calculator started");
+    SysTick_Delay1us(1000);
+    LOG1("Delta %d", -5);
+    LOG2("Key %c: %04x", 'A', 0xBEEFU);
+    LOG3("%u%% |%5u|%-3d|", 99U, 42U, 7);
+
+    char *data = Flush(&length);
+    char *text = Decode(&formats, data, length, &dumps);
+    double first_ms;
+    double second_ms;
+
+    TEST_CHECK(dumps == 1);
+    TEST_CHECK_MSG(sscanf(text, "%lf ms  Calculator started\n%lf ms  Delta -5\n", &first_ms, &second_ms) == 2,
+                   "%s", text);
+    TEST_CHECK_MSG(first_ms == 0.0 && second_ms >= 1.0 && second_ms < 1.02, "%.3f ms, %.3f ms", first_ms, second_ms);
+    TEST_CHECK_MSG(strstr(text, "ms  Key A: beef\n") != NULL, "%s", text);
+    TEST_CHECK_MSG(strstr(text, "ms  99% |   42|7  |\n") != NULL, "%s", text);
+
+    // Records of another build, and a dump cut short
+    data[FIRST_ID_TOP_BYTE] ^= 0x40;
+    free(Decode(&formats, data, length, &dumps));
+    TEST_CHECK(dumps < 0);
+    data[FIRST_ID_TOP_BYTE] ^= 0x40;
+    free(Decode(&formats, data, length - 1, &dumps));
+    TEST_CHECK(dumps < 0);
+    free(text);
+    free(data);
+
+    // The writers overtook the reader
+    for (uint32_t i = 0; i < LOG_BUFFER_WORDS; i++)
+    {
+        LOG("Overflow");
+    }
+    data = Flush(&length);
+    text = Decode(&formats, data, length, &dumps);
+    TEST_CHECK(dumps == 1);
+    TEST_CHECK_MSG(strcmp(text, "-- 1024 words lost\n") == 0, "%s", text);
+    free(text);
+    free(data);
+
+    // The log of a simulated session, among the other UART output
+    TEST_CHECK(Host_Sim_Run("12+34=", &result) == 0 && result.completed);
+    text = Decode(&formats, result.uart, result.uart_length, &dumps);
+    TEST_CHECK_MSG(dumps > 0, "%d", dumps);
+    TEST_CHECK_MSG(strstr(text, "ms  Calculator started, system clock ") != NULL, "%s", text);
+    TEST_CHECK_MSG(strstr(text, "ms  Key =: ") != NULL, "%s", text);
+    free(text);
+
+    Log_Decode_Free(&formats);
+    return Test_Report("test_log_decode");
+}
@@ -0,0 +1,158 @@
+/**
+ * @file test_profile_symbols.c
+ *
+ * @brief Host test of the profiler symbolizer (tests/tools/Profile_Symbols.c).
+ *
+ * The symbols of a cut-down armlink map (fixtures/Profile_Symbols.map) and
+ * of nm output are read, and a hand-made dump is charged to them: a
+ * function spread over two buckets, a bucket shared by the end of one
+ * function and the start of the next, LR samples landing in the caller of
+ * a soft-float helper, and samples that no symbol covers.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "test.h"
+#include "Profile_Symbols.h"
+#include <string.h>
+
+static Profile_Dump dump;
+
+static uint32_t Put_U16(uint8_t *data, uint32_t offset, uint32_t value)
+{
+    data[offset] = (uint8_t)value;
+    data[offset + 1] = (uint8_t)(value >> 8);
+    return offset + 2;
+}
+
+static uint32_t Put_U32(uint8_t *data, uint32_t offset, uint32_t value)
+{
+    offset = Put_U16(data, offset, value & 0xFFFFU);
+    return Put_U16(data, offset, value >> 16);
+}
+
+static uint32_t Put_Entry(uint8_t *data, uint32_t offset, uint32_t address, uint32_t pc_count, uint32_t lr_count)
+{
+    offset = Put_U16(data, offset, (address - PROFILER_CODE_BASE) >> PROFILER_BUCKET_SHIFT);
+    offset = Put_U16(data, offset, pc_count);
+    return Put_U16(data, offset, lr_count);
+}
+
+static int Find(const Profile_Symbols *symbols, const char *name)
+{
+    for (uint32_t i = 0; i < symbols->count; i++)
+    {
+        if (strcmp(symbols->symbols[i].name, name) == 0)
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+static char *Print(void (*print)(FILE *, const Profile_Symbols *, const Profile_Dump *),
+                   const Profile_Symbols *symbols)
+{
+    char *text = NULL;
+    size_t text_length = 0;
+    FILE *out = open_memstream(&text, &text_length);
+
+    print(out, symbols, &dump);
+    fclose(out);
+    return text;
+}
+
+int main(void)
+{
+    Profile_Symbols symbols;
+    FILE *map = fopen("fixtures/Profile_Symbols.map", "r");
+
+    TEST_CHECK(map != NULL);
+    if (map == NULL)
+    {
+        return Test_Report("test_profile_symbols");
+    }
+
+    // Code symbols only, without the Thumb bit, in address order
+    TEST_CHECK(Profile_Load_Symbols(map, &symbols) == 6);
+    fclose(map);
+    TEST_CHECK(Find(&symbols, "RESET") < 0 && Find(&symbols, "SystemCoreClock") < 0);
+    TEST_CHECK(Find(&symbols, "Calc_Keypad_Map") < 0);
+
+    int delay = Find(&symbols, "SysTick_Delay1us");
+    TEST_CHECK(delay >= 0 && symbols.symbols[delay].address == 0x340U && symbols.symbols[delay].size == 64U);
+    TEST_CHECK(delay >= 0 && strcmp(symbols.symbols[delay].object, "systick_delay.o") == 0);
+    for (uint32_t i = 1; i < symbols.count; i++)
+    {
+        TEST_CHECK(symbols.symbols[i - 1].address <= symbols.symbols[i].address);
+    }
+
+    // Log bytes before the dump
+    uint8_t data[128];
+    uint32_t length = 0;
+    memcpy(data, "LOG1xxPRF1", 10);
+    length = Put_U32(data, 10, PROFILER_SAMPLE_RATE_HZ);
+    length = Put_U32(data, length, PROFILER_CODE_BASE);
+    length = Put_U32(data, length, PROFILER_BUCKET_SHIFT);
+    length = Put_U32(data, length, 900);
+    length = Put_U32(data, length, 13);
+    length = Put_U32(data, length, 7);
+    length = Put_Entry(data, length, 0x340, 500, 0);        // SysTick_Delay1us, two buckets
+    length = Put_Entry(data, length, 0x360, 100, 0);
+    length = Put_Entry(data, length, 0x280, 200, 0);        // __aeabi_dmul...
+    length = Put_Entry(data, length, 0x380, 0, 150);        // ...called from Calc_Evaluate
+    length = Put_Entry(data, length, 0x300, 50, 0);         // EduBase_LCD_Pulse
+    length = Put_Entry(data, length, 0x420, 30, 0);         // 8 bytes of Calc_Evaluate, 24 of main
+    length = Put_Entry(data, length, 0x1000, 7, 0);         // Past the last function
+
+    TEST_CHECK(Profile_Parse_Dump(data, length, &dump) == 1);
+    TEST_CHECK(dump.rate_hz == PROFILER_SAMPLE_RATE_HZ && dump.samples == 900 && dump.out_of_range == 13);
+    TEST_CHECK(dump.entry_count == 7 && dump.entries[2].pc_count == 200);
+    TEST_CHECK(Profile_Parse_Dump(data, length - 1, &dump) < 0);
+    TEST_CHECK(Profile_Parse_Dump(data, 10, &dump) == 0);
+    TEST_CHECK(Profile_Parse_Dump(data, length, &dump) == 1);
+
+    Profile_Count counts[16];
+    Profile_Attribute(&symbols, &dump, counts);
+    TEST_CHECK(counts[delay].pc_samples == 600);
+    TEST_CHECK(counts[Find(&symbols, "__aeabi_dmul")].pc_samples == 200);
+    TEST_CHECK(counts[Find(&symbols, "Calc_Evaluate")].lr_samples == 150);
+    TEST_CHECK(counts[Find(&symbols, "Calc_Evaluate")].pc_samples == 0);
+    TEST_CHECK(counts[Find(&symbols, "main")].pc_samples == 30);
+    TEST_CHECK(counts[symbols.count].pc_samples == 7);
+
+    char *text = Print(Profile_Print_Flat, &symbols);
+    char *first = strchr(strchr(text, '\n') + 1, '\n') + 1;
+    TEST_CHECK_MSG(strncmp(first, "     600  66.67%", 16) == 0 && strstr(first, "SysTick_Delay1us (systick_delay.o)") < strchr(first, '\n'),
+                   "%s", text);
+    TEST_CHECK_MSG(strstr(text, "900 samples at 997 Hz (0.90 s), 13 outside the histogram") != NULL, "%s", text);
+    TEST_CHECK_MSG(strstr(text, "       0   0.00%      150  16.67%  Calc_Evaluate (calc_core.o)") != NULL, "%s", text);
+    free(text);
+
+    text = Print(Profile_Print_Folded, &symbols);
+    TEST_CHECK_MSG(strstr(text, "systick_delay.o;SysTick_Delay1us 600\n") != NULL, "%s", text);
+    TEST_CHECK_MSG(strstr(text, "main.o;main 30\n") != NULL, "%s", text);
+    TEST_CHECK_MSG(strstr(text, "[unknown];[unknown] 7\n") != NULL, "%s", text);
+    TEST_CHECK_MSG(strstr(text, "[outside the histogram] 13\n") != NULL, "%s", text);
+    TEST_CHECK_MSG(strstr(text, "Calc_Evaluate") == NULL, "%s", text);
+    free(text);
+    Profile_Free_Symbols(&symbols);
+
+    // nm output, with and without sizes
+    static const char nm_output[] =
+        "00000340 T SysTick_Delay1us\n"
+        "00000381 t Calc_Evaluate\n"
+        "00000428 000001e0 T main\n"
+        "20000000 D SystemCoreClock\n";
+    FILE *nm = fmemopen((void *)nm_output, sizeof(nm_output) - 1, "r");
+
+    TEST_CHECK(Profile_Load_Symbols(nm, &symbols) == 3);
+    fclose(nm);
+    TEST_CHECK(symbols.symbols[0].size == 0x40U && symbols.symbols[1].address == 0x380U);
+    TEST_CHECK(symbols.symbols[2].size == 0x1E0U && symbols.symbols[2].object[0] == '\0');
+    Profile_Attribute(&symbols, &dump, counts);
+    TEST_CHECK(counts[0].pc_samples == 600 && counts[2].pc_samples == 30);
+    Profile_Free_Symbols(&symbols);
+
+    return Test_Report("test_profile_symbols");
+}
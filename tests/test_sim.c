@@ -0,0 +1,91 @@
+/**
+ * @file test_sim.c
+ *
+ * @brief Host test of the whole firmware on the simulator (tests/sim).
+ *
+ * Key scripts are run through the firmware as built for the target, and
+ * the LCD is checked at the end. The timing seen by the firmware comes
+ * from the virtual clock: the latency of each key is at least the
+ * debounce delay, and a session of several virtual seconds takes a small
+ * fraction of that on the host. Two runs of the same script give the
+ * same result.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "test.h"
+#include "Host_Sim.h"
+#include <string.h>
+
+#define PS_PER_MS           1000000000ULL
+
+// Keypad debounce delay of the firmware
+#define DEBOUNCE_MS         20U
+
+static Host_Sim_Result result;
+static Host_Sim_Result repeat;
+
+static void Check_Display(const char *script, const char *expected)
+{
+    int status = Host_Sim_Run(script, &result);
+
+    TEST_CHECK_MSG(status == 0 && result.completed, "\"%s\": session did not complete", script);
+    TEST_CHECK_MSG(strstr(result.lcd[0], expected) != NULL || strstr(result.lcd[1], expected) != NULL,
+                   "\"%s\": LCD \"%s\" / \"%s\", expected \"%s\"", script, result.lcd[0], result.lcd[1],
+                   expected);
+}
+
+int main(void)
+{
+    Check_Display("12+34=", "46");
+    Check_Display("7*8=-6=", "50");
+    Check_Display("1.5*4=", "6");
+    Check_Display("7/0=", "Div by 0");
+
+    // Held keys: the settings menu, and undo of the last key
+    Check_Display("=@1500", "Debounce");
+    Check_Display("12+3=-@1500", "12+");
+
+    // Each result is appended to the journal in flash
+    TEST_CHECK(Host_Sim_Run("1+1=2*2=", &result) == 0 && result.completed);
+    TEST_CHECK_MSG(result.stats.flash_programs > 0, "%u flash words programmed", result.stats.flash_programs);
+
+    // Virtual timing: every key is shown after the debounce delay, well
+    // before the next press, and the run is much faster than real time
+    TEST_CHECK(Host_Sim_Run("9-3*2=", &result) == 0 && result.completed);
+    for (uint32_t i = 0; i < result.key_count; i++)
+    {
+        uint64_t latency_ps = result.stats.key_lcd_ps[i] - result.keys[i].press_ps;
+
+        TEST_CHECK_MSG(result.stats.key_lcd_ps[i] > result.keys[i].press_ps &&
+                       latency_ps >= DEBOUNCE_MS * PS_PER_MS &&
+                       latency_ps < (HOST_SIM_HOLD_MS + HOST_SIM_GAP_MS) * PS_PER_MS,
+                       "key %u '%c': shown %.3f ms after the press", i, result.keys[i].key,
+                       (double)latency_ps / PS_PER_MS);
+    }
+
+    double virtual_seconds = (double)result.end_ps * 1e-12;
+    TEST_CHECK_MSG(result.host_seconds < virtual_seconds, "%.3f s on the host for %.3f virtual s",
+                   result.host_seconds, virtual_seconds);
+    printf("test_sim: %.3f virtual s in %.3f host s, %llu register accesses, %.1f%% of the time asleep\n",
+           virtual_seconds, result.host_seconds, (unsigned long long)result.stats.accesses,
+           100.0 * (double)result.stats.sleep_ps / (double)result.end_ps);
+
+    // The same script gives the same display, timing and UART output
+    TEST_CHECK(Host_Sim_Run("9-3*2=", &repeat) == 0);
+    TEST_CHECK(memcmp(result.lcd, repeat.lcd, sizeof(result.lcd)) == 0);
+    TEST_CHECK(memcmp(&result.stats, &repeat.stats, sizeof(result.stats)) == 0);
+    TEST_CHECK(result.end_ps == repeat.end_ps);
+    TEST_CHECK(result.uart_length == repeat.uart_length &&
+               memcmp(result.uart, repeat.uart, result.uart_length) == 0);
+
+    // Scripts that are not valid
+    Host_Device_Key keys[4];
+    TEST_CHECK(Host_Sim_Parse_Keys("12a", keys, 4) < 0);
+    TEST_CHECK(Host_Sim_Parse_Keys("1@", keys, 4) < 0);
+    TEST_CHECK(Host_Sim_Parse_Keys("12345", keys, 4) < 0);
+    TEST_CHECK(Host_Sim_Parse_Keys("1 =@1500", keys, 4) == 2 &&
+               keys[1].release_ps - keys[1].press_ps == 1500U * PS_PER_MS);
+
+    return Test_Report("test_sim");
+}
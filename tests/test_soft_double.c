@@ -0,0 +1,215 @@
+/**
+ * @file test_soft_double.c
+ *
+ * @brief Host test of the Soft_Double library against hardware doubles.
+ *
+ * Every operation is checked bit for bit against the host FPU (SSE2,
+ * round to nearest even) on random bit patterns, on operands with close
+ * exponents (cancellation and rounding boundaries), and on the special
+ * values. NaN results must be the default NaN, as with FPSCR.DN. The
+ * exception flags are checked against the host's, except underflow, whose
+ * tininess detection differs between x86 and ARM.
+ *
+ * A normal run checks 1,000,000 iterations (every operation each); the
+ * soak run (make soak) checks 1e9.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "test.h"
+#include "Soft_Double.h"
+#include <fenv.h>
+#include <math.h>
+#include <float.h>
+#include <string.h>
+
+#define DEFAULT_NAN     0x7FF8000000000000ULL
+
+// Flags compared with the host (see the file comment for underflow)
+#define CHECKED_FLAGS   (SOFT_DOUBLE_FLAG_INVALID | SOFT_DOUBLE_FLAG_DIVIDE_BY_ZERO | \
+                         SOFT_DOUBLE_FLAG_OVERFLOW | SOFT_DOUBLE_FLAG_INEXACT)
+
+static const double special_values[] = {
+    0.0, -0.0, 1.0, -1.0, 0.5, 2.0, 3.0, 10.0, 0.1, -0.1,
+    DBL_MIN, -DBL_MIN, DBL_TRUE_MIN, -DBL_TRUE_MIN, DBL_MAX, -DBL_MAX,
+    DBL_EPSILON, 1.0 + DBL_EPSILON, 1.0 - DBL_EPSILON / 2.0,
+    9007199254740992.0, 9007199254740993.0, 2147483647.0, 2147483648.0, -2147483649.0,
+    9223372036854775807.0, -9223372036854775808.0,
+    INFINITY, -INFINITY, NAN
+};
+
+#define SPECIAL_COUNT   (sizeof(special_values) / sizeof(special_values[0]))
+
+static uint64_t Bits(double x)
+{
+    uint64_t u;
+    memcpy(&u, &x, sizeof(u));
+    return u;
+}
+
+static double From_Bits(uint64_t u)
+{
+    double x;
+    memcpy(&x, &u, sizeof(x));
+    return x;
+}
+
+// Host flags in the Soft_Double bit layout
+static uint32_t Host_Flags(void)
+{
+    uint32_t flags = 0;
+
+    flags |= fetestexcept(FE_INVALID) ? SOFT_DOUBLE_FLAG_INVALID : 0U;
+    flags |= fetestexcept(FE_DIVBYZERO) ? SOFT_DOUBLE_FLAG_DIVIDE_BY_ZERO : 0U;
+    flags |= fetestexcept(FE_OVERFLOW) ? SOFT_DOUBLE_FLAG_OVERFLOW : 0U;
+    flags |= fetestexcept(FE_INEXACT) ? SOFT_DOUBLE_FLAG_INEXACT : 0U;
+    return flags;
+}
+
+// A random operand: any bit pattern, a special value, or close to another operand
+static double Random_Operand(uint64_t *state, double other)
+{
+    uint64_t r = Test_Random(state);
+
+    switch (r & 3U)
+    {
+        case 0:
+            return From_Bits(Test_Random(state));
+
+        case 1:
+            return special_values[(r >> 8) % SPECIAL_COUNT];
+
+        case 2:
+        {
+            // Same exponent range as the other operand, any fraction
+            uint64_t bits = Bits(other);
+            int64_t shift = (int64_t)((r >> 8) % 64U) - 32;
+            uint64_t exponent = (bits >> 52) & 0x7FFU;
+
+            exponent = (uint64_t)((int64_t)exponent + shift) & 0x7FFU;
+            return From_Bits((Test_Random(state) & 0x800FFFFFFFFFFFFFULL) | (exponent << 52));
+        }
+
+        default:
+            // Moderate magnitudes, the calculator's common case
+            return (double)(int64_t)(Test_Random(state) >> 40) / (double)((r >> 8) % 1000U + 1U);
+    }
+}
+
+static void Check_Result(const char *op, double a, double b, double soft, double host,
+                         uint32_t soft_flags, uint32_t host_flags)
+{
+    uint64_t expected = isnan(host) ? DEFAULT_NAN : Bits(host);
+
+    TEST_CHECK_MSG(Bits(soft) == expected, "%s(%a, %a) = %a, expected %a", op, a, b, soft, From_Bits(expected));
+    TEST_CHECK_MSG((soft_flags & CHECKED_FLAGS) == host_flags, "%s(%a, %a) flags %02X, expected %02X",
+                   op, a, b, soft_flags & CHECKED_FLAGS, host_flags);
+}
+
+// The host operations, kept out of line so that the compiler cannot fold them
+static double __attribute__((noinline)) Host_Op(char op, double a, double b)
+{
+    switch (op)
+    {
+        case '+': return a + b;
+        case '-': return a - b;
+        case '*': return a * b;
+        default:  return a / b;
+    }
+}
+
+static void Check_Arithmetic(double a, double b)
+{
+    static const char ops[] = "+-*/";
+    static const char *const names[] = { "add", "sub", "mul", "div" };
+
+    for (uint32_t i = 0; i < 4U; i++)
+    {
+        double soft;
+
+        Soft_Double_Clear_Flags();
+        switch (ops[i])
+        {
+            case '+': soft = Soft_Double_Add(a, b); break;
+            case '-': soft = Soft_Double_Sub(a, b); break;
+            case '*': soft = Soft_Double_Mul(a, b); break;
+            default:  soft = Soft_Double_Div(a, b); break;
+        }
+        uint32_t soft_flags = Soft_Double_Get_Flags();
+
+        feclearexcept(FE_ALL_EXCEPT);
+        double host = Host_Op(ops[i], a, b);
+        uint32_t host_flags = Host_Flags();
+
+        Check_Result(names[i], a, b, soft, host, soft_flags, host_flags);
+    }
+}
+
+static void Check_Compare(double a, double b)
+{
+    int expected = (isnan(a) || isnan(b)) ? SOFT_DOUBLE_UNORDERED : (a < b) ? -1 : (a > b) ? 1 : 0;
+
+    TEST_CHECK_MSG(Soft_Double_Compare(a, b) == expected, "compare(%a, %a)", a, b);
+}
+
+// VCVT semantics: truncate, saturate out-of-range values, NaN converts to 0
+static int64_t Reference_To_Int(double x, int64_t min, int64_t max)
+{
+    if (isnan(x))
+    {
+        return 0;
+    }
+    if (x <= (double)min)
+    {
+        return min;
+    }
+    if (x >= -(double)min)
+    {
+        return max;
+    }
+    return (int64_t)x;
+}
+
+static void Check_Conversions(double x, uint64_t bits)
+{
+    int32_t i32 = (int32_t)bits;
+    int64_t i64 = (int64_t)bits;
+
+    TEST_CHECK_MSG(Bits(Soft_Double_From_Int32(i32)) == Bits((double)i32), "from_int32(%d)", i32);
+    TEST_CHECK_MSG(Bits(Soft_Double_From_Int64(i64)) == Bits((double)i64), "from_int64(%lld)", (long long)i64);
+    TEST_CHECK_MSG(Soft_Double_To_Int32(x) == (int32_t)Reference_To_Int(x, INT32_MIN, INT32_MAX), "to_int32(%a)", x);
+    TEST_CHECK_MSG(Soft_Double_To_Int64(x) == Reference_To_Int(x, INT64_MIN, INT64_MAX), "to_int64(%a)", x);
+}
+
+int main(void)
+{
+    uint64_t iterations = Test_Iterations(1000000U);
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+
+    // Every pair of special values
+    for (uint32_t i = 0; i < SPECIAL_COUNT; i++)
+    {
+        for (uint32_t j = 0; j < SPECIAL_COUNT; j++)
+        {
+            Check_Arithmetic(special_values[i], special_values[j]);
+            Check_Compare(special_values[i], special_values[j]);
+        }
+        Check_Conversions(special_values[i], Bits(special_values[i]));
+    }
+
+    // Signed zeros and NaN propagation of conversions at the limits
+    Check_Conversions(0.0, (uint64_t)INT64_MIN);
+    Check_Conversions(0.0, (uint64_t)INT32_MIN);
+
+    for (uint64_t n = 0; n < iterations; n++)
+    {
+        double a = Random_Operand(&state, 1.0);
+        double b = Random_Operand(&state, a);
+
+        Check_Arithmetic(a, b);
+        Check_Compare(a, b);
+        Check_Conversions(a, Test_Random(&state));
+    }
+
+    return Test_Report("test_soft_double");
+}
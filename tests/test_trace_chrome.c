@@ -0,0 +1,120 @@
+/**
+ * @file test_trace_chrome.c
+ *
+ * @brief Host test of the trace converter (tests/tools/Trace_Chrome.c).
+ *
+ * A hand-made dump checks the time conversion across a clock change and
+ * a cycle counter wrap, and that an end whose beginning was overwritten
+ * is dropped. The trace of a simulated session must hold the key
+ * handling and LCD zones, balanced, with times that do not go back.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "test.h"
+#include "Trace_Chrome.h"
+#include "Host_Sim.h"
+#include <string.h>
+
+static Host_Sim_Result result;
+
+static uint32_t Put_U32(uint8_t *data, uint32_t offset, uint32_t value)
+{
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        data[offset + i] = (uint8_t)(value >> (8 * i));
+    }
+    return offset + 4;
+}
+
+static uint32_t Put_Record(uint8_t *data, uint32_t offset, uint32_t timestamp, Trace_Zone zone,
+                           Trace_Phase phase, uint16_t payload)
+{
+    offset = Put_U32(data, offset, timestamp);
+    return Put_U32(data, offset, TRACE_EVENT_ID(zone, phase) | ((uint32_t)payload << 16));
+}
+
+static char *Convert(const uint8_t *data, size_t length, int *dumps)
+{
+    char *text = NULL;
+    size_t text_length = 0;
+    FILE *out = open_memstream(&text, &text_length);
+
+    *dumps = Trace_Chrome_Convert(data, length, out);
+    fclose(out);
+    return text;
+}
+
+static uint32_t Count(const char *text, const char *pattern)
+{
+    uint32_t count = 0;
+
+    for (const char *p = strstr(text, pattern); p != NULL; p = strstr(p + 1, pattern))
+    {
+        count++;
+    }
+    return count;
+}
+
+int main(void)
+{
+    uint8_t dump[256];
+    uint32_t length = 0;
+    int dumps;
+
+    // Log bytes before the dump, then 16 MHz until the switch to 80 MHz at 1 ms
+    memcpy(dump, "LOG1xx", 6);
+    length = 6;
+    memcpy(dump + length, "TRC1", 4);
+    length = Put_U32(dump, length + 4, 16000000U);
+    length = Put_U32(dump, length, 5);
+    length = Put_Record(dump, length, 0xFFFFF000U, TRACE_ZONE_DEBOUNCE, TRACE_PHASE_END, 0);
+    length = Put_Record(dump, length, 0xFFFFF000U, TRACE_ZONE_KEY, TRACE_PHASE_BEGIN, '5');
+    length = Put_Record(dump, length, 0xFFFFF000U + 16000U, TRACE_ZONE_CLOCK, TRACE_PHASE_MARK, 80);
+    length = Put_Record(dump, length, 0xFFFFF000U + 16000U + 80000U, TRACE_ZONE_KEY, TRACE_PHASE_END, 0);
+    length = Put_Record(dump, length, 0xFFFFF000U + 16000U + 40000U, TRACE_ZONE_COMPUTE, TRACE_PHASE_BEGIN, 1);
+
+    char *text = Convert(dump, length, &dumps);
+    TEST_CHECK(dumps == 1);
+    TEST_CHECK_MSG(strstr(text, "\"name\":\"Debounce\",\"ph\":\"E\"") == NULL, "%s", text);
+    TEST_CHECK_MSG(strstr(text, "\"name\":\"Key handling\",\"ph\":\"B\",\"ts\":0.00,") != NULL, "%s", text);
+    TEST_CHECK_MSG(strstr(text, "\"name\":\"Clock\",\"ph\":\"i\",\"s\":\"t\",\"ts\":1000.00,") != NULL, "%s", text);
+    TEST_CHECK_MSG(strstr(text, "\"name\":\"Key handling\",\"ph\":\"E\",\"ts\":2000.00,") != NULL, "%s", text);
+    TEST_CHECK_MSG(strstr(text, "\"name\":\"Compute\",\"ph\":\"B\",\"ts\":1500.00,") != NULL, "%s", text);
+    TEST_CHECK(Count(text, "\"thread_name\"") == TRACE_ZONE_COUNT);
+    free(text);
+
+    // A dump cut short, and no dump at all
+    text = Convert(dump, length - 1, &dumps);
+    TEST_CHECK(dumps < 0);
+    free(text);
+    text = Convert(dump, 6, &dumps);
+    TEST_CHECK(dumps == 0 && strstr(text, "]}") != NULL);
+    free(text);
+
+    // The trace of a simulated session
+    TEST_CHECK(Host_Sim_Run("12+34=", &result) == 0 && result.completed);
+    text = Convert(result.trace, result.trace_length, &dumps);
+    TEST_CHECK(dumps == 1);
+
+    uint32_t key_begins = Count(text, "\"name\":\"Key handling\",\"ph\":\"B\"");
+    uint32_t key_ends = Count(text, "\"name\":\"Key handling\",\"ph\":\"E\"");
+    TEST_CHECK_MSG(key_begins > 0 && key_begins == key_ends, "%u key begins, %u ends", key_begins, key_ends);
+    TEST_CHECK(Count(text, "\"name\":\"LCD data\",\"ph\":\"B\"") > 0);
+    TEST_CHECK(Count(text, "\"name\":\"Debounce\",\"ph\":\"B\"") > 0);
+
+    double previous = 0.0;
+    uint32_t backwards = 0;
+    for (const char *p = strstr(text, "\"ts\":"); p != NULL; p = strstr(p + 1, "\"ts\":"))
+    {
+        double ts = strtod(p + 5, NULL);
+
+        // Only Trace_Begin_At goes back, by one keypad scan
+        backwards += (ts < previous - 100.0);
+        previous = ts;
+    }
+    TEST_CHECK_MSG(backwards == 0, "%u events go back in time", backwards);
+    free(text);
+
+    return Test_Report("test_trace_chrome");
+}
@@ -0,0 +1,278 @@
+/**
+ * @file Log_Decode.c
+ *
+ * @brief Decodes the binary log records (Log_Flush) on the PC.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Log_Decode.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_MAGIC           "LOG1"
+#define LOG_HEADER_BYTES    12U
+
+#define ELF_SHT_NOBITS      8U
+
+static uint32_t Log_Decode_U16(const uint8_t *data)
+{
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8);
+}
+
+static uint32_t Log_Decode_U32(const uint8_t *data)
+{
+    return Log_Decode_U16(data) | (Log_Decode_U16(data + 2) << 16);
+}
+
+static uint64_t Log_Decode_U64(const uint8_t *data)
+{
+    return (uint64_t)Log_Decode_U32(data) | ((uint64_t)Log_Decode_U32(data + 4) << 32);
+}
+
+static uint8_t *Log_Decode_Read(FILE *file, size_t *length)
+{
+    uint8_t *data = NULL;
+    size_t capacity = 0;
+
+    *length = 0;
+    for (;;)
+    {
+        if (*length == capacity)
+        {
+            capacity = (capacity > 0) ? 2 * capacity : 65536U;
+            uint8_t *grown = realloc(data, capacity);
+            if (grown == NULL)
+            {
+                free(data);
+                return NULL;
+            }
+            data = grown;
+        }
+
+        size_t read = fread(data + *length, 1, capacity - *length, file);
+        if (read == 0)
+        {
+            return data;
+        }
+        *length += read;
+    }
+}
+
+int Log_Decode_Load_Elf(FILE *file, Log_Decode_Formats *formats)
+{
+    size_t length;
+    uint8_t *elf = Log_Decode_Read(file, &length);
+    int status = -1;
+
+    formats->address = 0;
+    formats->size = 0;
+    formats->data = NULL;
+
+    // ELF32 (the Keil image) or ELF64 (a host build), little-endian
+    if (elf == NULL || length < 64 || memcmp(elf, "\177ELF", 4) != 0 || elf[5] != 1 ||
+        (elf[4] != 1 && elf[4] != 2))
+    {
+        free(elf);
+        return -1;
+    }
+
+    int is_64 = (elf[4] == 2);
+    uint64_t section_offset = is_64 ? Log_Decode_U64(elf + 0x28) : Log_Decode_U32(elf + 0x20);
+    uint32_t entry_size = Log_Decode_U16(elf + (is_64 ? 0x3A : 0x2E));
+    uint32_t section_count = Log_Decode_U16(elf + (is_64 ? 0x3C : 0x30));
+    uint32_t names_index = Log_Decode_U16(elf + (is_64 ? 0x3E : 0x32));
+
+    if (entry_size < (is_64 ? 64U : 40U) || names_index >= section_count ||
+        section_offset > length || (length - section_offset) / entry_size < section_count)
+    {
+        free(elf);
+        return -1;
+    }
+
+    const uint8_t *names_header = elf + section_offset + (uint64_t)names_index * entry_size;
+    uint64_t names_offset = is_64 ? Log_Decode_U64(names_header + 0x18) : Log_Decode_U32(names_header + 0x10);
+    uint64_t names_size = is_64 ? Log_Decode_U64(names_header + 0x20) : Log_Decode_U32(names_header + 0x14);
+
+    for (uint32_t i = 0; i < section_count && names_offset + names_size <= length; i++)
+    {
+        const uint8_t *header = elf + section_offset + (uint64_t)i * entry_size;
+        uint32_t name = Log_Decode_U32(header);
+        uint64_t address = is_64 ? Log_Decode_U64(header + 0x10) : Log_Decode_U32(header + 0x0C);
+        uint64_t offset = is_64 ? Log_Decode_U64(header + 0x18) : Log_Decode_U32(header + 0x10);
+        uint64_t size = is_64 ? Log_Decode_U64(header + 0x20) : Log_Decode_U32(header + 0x14);
+
+        if (name + sizeof(".logfmt") > names_size ||
+            memcmp(elf + names_offset + name, ".logfmt", sizeof(".logfmt")) != 0)
+        {
+            continue;
+        }
+
+        // The IDs are 32-bit addresses
+        if (Log_Decode_U32(header + 4) == ELF_SHT_NOBITS || offset + size > length ||
+            address + size > 0xFFFFFFFFULL || size == 0)
+        {
+            break;
+        }
+
+        // One NUL more, in case the last string is not terminated
+        formats->data = calloc(size + 1, 1);
+        if (formats->data != NULL)
+        {
+            memcpy(formats->data, elf + offset, size);
+            formats->address = (uint32_t)address;
+            formats->size = (uint32_t)size;
+            status = 0;
+        }
+        break;
+    }
+
+    free(elf);
+    return status;
+}
+
+void Log_Decode_Free(Log_Decode_Formats *formats)
+{
+    free(formats->data);
+    formats->data = NULL;
+    formats->size = 0;
+}
+
+// Print a message, converting each argument as the 32-bit word it was stored as
+static void Log_Decode_Print(FILE *out, const char *format, const uint32_t *arguments, uint32_t count)
+{
+    uint32_t used = 0;
+
+    while (*format != '\0')
+    {
+        if (*format != '%')
+        {
+            fputc(*format++, out);
+            continue;
+        }
+        if (format[1] == '%')
+        {
+            fputc('%', out);
+            format += 2;
+            continue;
+        }
+
+        // Flags, width and precision are kept, the length modifiers dropped
+        char spec[16];
+        size_t spec_length = 0;
+
+        spec[spec_length++] = *format++;
+        while (*format != '\0' && strchr("-+ #0123456789.", *format) != NULL && spec_length < sizeof(spec) - 2)
+        {
+            spec[spec_length++] = *format++;
+        }
+        while (*format != '\0' && strchr("hlLqjzt", *format) != NULL)
+        {
+            format++;
+        }
+        if (*format == '\0')
+        {
+            break;
+        }
+
+        char conversion = *format++;
+        spec[spec_length++] = conversion;
+        spec[spec_length] = '\0';
+
+        if (used >= count)
+        {
+            fputs("<missing>", out);
+            continue;
+        }
+
+        uint32_t word = arguments[used++];
+        switch (conversion)
+        {
+        case 'd':
+        case 'i':
+            fprintf(out, spec, (int)(int32_t)word);
+            break;
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+            fprintf(out, spec, (unsigned)word);
+            break;
+        case 'c':
+            fprintf(out, spec, (int)(char)word);
+            break;
+        default:
+            // Not an integer conversion
+            fprintf(out, "<%%%c 0x%08x>", conversion, (unsigned)word);
+            break;
+        }
+    }
+}
+
+int Log_Decode_Convert(const Log_Decode_Formats *formats, const uint8_t *data, size_t length,
+                       uint32_t clock_hz, FILE *out)
+{
+    int dumps = 0;
+    int first = 1;
+    uint32_t previous = 0;
+    uint64_t elapsed = 0;
+
+    for (size_t offset = 0; offset + LOG_HEADER_BYTES <= length; offset++)
+    {
+        if (memcmp(data + offset, LOG_MAGIC, 4) != 0)
+        {
+            continue;
+        }
+
+        uint32_t lost = Log_Decode_U32(data + offset + 4);
+        uint32_t words = Log_Decode_U32(data + offset + 8);
+        const uint8_t *word = data + offset + LOG_HEADER_BYTES;
+
+        if ((length - offset - LOG_HEADER_BYTES) / 4 < words)
+        {
+            return -1;
+        }
+        if (lost > 0)
+        {
+            fprintf(out, "-- %u words lost\n", lost);
+        }
+
+        for (uint32_t index = 0; index < words; )
+        {
+            uint32_t id = Log_Decode_U32(word + 4 * index);
+            uint32_t count = id & 3U;
+            uint32_t address = id & ~3U;
+            uint32_t arguments[3];
+
+            // A record cut by the end of the dump
+            if (words - index < 2 + count)
+            {
+                return -1;
+            }
+
+            uint32_t cycles = Log_Decode_U32(word + 4 * (index + 1));
+            for (uint32_t i = 0; i < count; i++)
+            {
+                arguments[i] = Log_Decode_U32(word + 4 * (index + 2 + i));
+            }
+            index += 2 + count;
+
+            elapsed += first ? 0 : (uint32_t)(cycles - previous);
+            previous = cycles;
+            first = 0;
+
+            fprintf(out, "%12.3f ms  ", (clock_hz > 0) ? 1e3 * (double)elapsed / clock_hz : 0.0);
+            if (address < formats->address || address - formats->address >= formats->size)
+            {
+                fprintf(out, "<unknown message 0x%08x>\n", address);
+                return -1;
+            }
+            Log_Decode_Print(out, formats->data + (address - formats->address), arguments, count);
+            fputc('\n', out);
+        }
+
+        dumps++;
+        offset += LOG_HEADER_BYTES + 4 * (size_t)words - 1;
+    }
+    return dumps;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file Log_Decode.h
+ *
+ * @brief Decodes the binary log records (Log_Flush) on the PC.
+ *
+ * The ID of a log message is the address of its format string in the
+ * .logfmt section of the linked image. The section is read from the ELF
+ * file of the build (the Keil .axf, 32-bit, or a host build that links the
+ * firmware without PIE, 64-bit), and the records are printed with their
+ * arguments formatted by the host printf.
+ *
+ * The log dumps are found in a byte stream by their "LOG1" magic, so a raw
+ * UART capture that also holds trace or profiler dumps can be decoded as
+ * it is. The time of a record is its DWT cycle count since the first
+ * record, accumulated from consecutive differences so that the counter
+ * may wrap, at the clock given by the caller; it is only right while the
+ * clock governor keeps the same clock.
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef LOG_DECODE_H_
+#define LOG_DECODE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+typedef struct {
+    uint32_t address;       // Address of the .logfmt section
+    uint32_t size;
+    char *data;             // Contents of the section
+} Log_Decode_Formats;
+
+/**
+ * @brief Read the .logfmt section of an ELF file.
+ *
+ * @param file    The ELF file.
+ * @param formats Receives the format strings (free with Log_Decode_Free).
+ *
+ * @return int 0 on success, -1 if the file is not a little-endian ELF
+ *             file or has no .logfmt section.
+ */
+int Log_Decode_Load_Elf(FILE *file, Log_Decode_Formats *formats);
+
+/**
+ * @brief Free the format strings read by Log_Decode_Load_Elf.
+ *
+ * @param formats The format strings.
+ *
+ * @return None
+ */
+void Log_Decode_Free(Log_Decode_Formats *formats);
+
+/**
+ * @brief Print the records of every log dump found in a byte stream.
+ *
+ * One line per record: the time in milliseconds and the message. Lost
+ * words are reported on a line of their own.
+ *
+ * @param formats  The format strings.
+ * @param data     The byte stream.
+ * @param length   The length of the stream.
+ * @param clock_hz The clock of the cycle counts.
+ * @param out      Receives the text.
+ *
+ * @return int The number of dumps decoded, or -1 if a dump is cut short
+ *             or a record has no format string (a different build).
+ */
+int Log_Decode_Convert(const Log_Decode_Formats *formats, const uint8_t *data, size_t length,
+                       uint32_t clock_hz, FILE *out);
+
+#endif // LOG_DECODE_H_
@@ -0,0 +1,346 @@
+/**
+ * @file Profile_Symbols.c
+ *
+ * @brief Symbolizes the profiler histograms (Profiler_Dump) on the PC.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Profile_Symbols.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define PROFILE_MAGIC           "PRF1"
+#define PROFILE_HEADER_BYTES    28U
+#define PROFILE_ENTRY_BYTES     6U
+
+typedef struct {
+    const Profile_Symbols *symbols;
+    const Profile_Count *counts;
+} Profile_Sort_Context;
+
+// qsort has no context argument
+static Profile_Sort_Context sort_context;
+
+static uint32_t Profile_U16(const uint8_t *data)
+{
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8);
+}
+
+static uint32_t Profile_U32(const uint8_t *data)
+{
+    return Profile_U16(data) | (Profile_U16(data + 2) << 16);
+}
+
+static int Profile_Compare_Address(const void *a, const void *b)
+{
+    const Profile_Symbol *x = a;
+    const Profile_Symbol *y = b;
+
+    if (x->address != y->address)
+    {
+        return (x->address < y->address) ? -1 : 1;
+    }
+    return strcmp(x->name, y->name);
+}
+
+// armlink: "name  0x00000a41  Thumb Code  64  object.o(section)"
+static int Profile_Parse_Map_Line(const char *line, Profile_Symbol *symbol)
+{
+    char name[256];
+    char object[256];
+    unsigned value;
+    unsigned size;
+    int position = 0;
+
+    if (sscanf(line, "%255s 0x%x %n", name, &value, &position) != 2 || position == 0)
+    {
+        return 0;
+    }
+
+    const char *rest = line + position;
+    if (strncmp(rest, "Thumb Code", 10) == 0 || strncmp(rest, "ARM Code", 8) == 0)
+    {
+        rest = strstr(rest, "Code") + 4;
+    }
+    else
+    {
+        return 0;
+    }
+
+    if (sscanf(rest, "%u %255s", &size, object) != 2)
+    {
+        object[0] = '\0';
+        size = 0;
+    }
+
+    char *section = strchr(object, '(');
+    if (section != NULL)
+    {
+        *section = '\0';
+    }
+
+    snprintf(symbol->name, PROFILE_NAME_LENGTH, "%.*s", (int)PROFILE_NAME_LENGTH - 1, name);
+    snprintf(symbol->object, PROFILE_OBJECT_LENGTH, "%.*s", (int)PROFILE_OBJECT_LENGTH - 1, object);
+    symbol->address = value & ~1U;
+    symbol->size = size;
+    return 1;
+}
+
+// nm: "00000a40 T name", or with -S "00000a40 00000040 T name"
+static int Profile_Parse_Nm_Line(const char *line, Profile_Symbol *symbol)
+{
+    char name[256];
+    char type;
+    unsigned value;
+    unsigned size = 0;
+
+    if (sscanf(line, "%x %x %c %255s", &value, &size, &type, name) != 4)
+    {
+        size = 0;
+        if (sscanf(line, "%x %c %255s", &value, &type, name) != 3)
+        {
+            return 0;
+        }
+    }
+    if (type != 'T' && type != 't' && type != 'W' && type != 'w')
+    {
+        return 0;
+    }
+
+    snprintf(symbol->name, PROFILE_NAME_LENGTH, "%.*s", (int)PROFILE_NAME_LENGTH - 1, name);
+    symbol->object[0] = '\0';
+    symbol->address = value & ~1U;
+    symbol->size = size;
+    return 1;
+}
+
+int Profile_Load_Symbols(FILE *file, Profile_Symbols *symbols)
+{
+    char line[512];
+    uint32_t capacity = 0;
+
+    symbols->symbols = NULL;
+    symbols->count = 0;
+
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        Profile_Symbol symbol;
+
+        if (!Profile_Parse_Map_Line(line, &symbol) && !Profile_Parse_Nm_Line(line, &symbol))
+        {
+            continue;
+        }
+
+        if (symbols->count == capacity)
+        {
+            capacity = (capacity > 0) ? 2 * capacity : 256U;
+            Profile_Symbol *grown = realloc(symbols->symbols, capacity * sizeof(*grown));
+            if (grown == NULL)
+            {
+                Profile_Free_Symbols(symbols);
+                return -1;
+            }
+            symbols->symbols = grown;
+        }
+        symbols->symbols[symbols->count++] = symbol;
+    }
+
+    if (symbols->count == 0)
+    {
+        Profile_Free_Symbols(symbols);
+        return -1;
+    }
+
+    qsort(symbols->symbols, symbols->count, sizeof(symbols->symbols[0]), Profile_Compare_Address);
+
+    // A symbol without a size ends at the next one
+    for (uint32_t i = 0; i + 1 < symbols->count; i++)
+    {
+        if (symbols->symbols[i].size == 0)
+        {
+            symbols->symbols[i].size = symbols->symbols[i + 1].address - symbols->symbols[i].address;
+        }
+    }
+    return (int)symbols->count;
+}
+
+void Profile_Free_Symbols(Profile_Symbols *symbols)
+{
+    free(symbols->symbols);
+    symbols->symbols = NULL;
+    symbols->count = 0;
+}
+
+int Profile_Parse_Dump(const uint8_t *data, size_t length, Profile_Dump *dump)
+{
+    for (size_t offset = 0; offset + PROFILE_HEADER_BYTES <= length; offset++)
+    {
+        if (memcmp(data + offset, PROFILE_MAGIC, 4) != 0)
+        {
+            continue;
+        }
+
+        const uint8_t *header = data + offset + 4;
+        dump->rate_hz = Profile_U32(header);
+        dump->code_base = Profile_U32(header + 4);
+        dump->bucket_shift = Profile_U32(header + 8);
+        dump->samples = Profile_U32(header + 12);
+        dump->out_of_range = Profile_U32(header + 16);
+        dump->entry_count = Profile_U32(header + 20);
+
+        if (dump->entry_count > PROFILER_BUCKET_COUNT || dump->bucket_shift > 16U ||
+            length - offset - PROFILE_HEADER_BYTES < (size_t)dump->entry_count * PROFILE_ENTRY_BYTES)
+        {
+            return -1;
+        }
+
+        const uint8_t *entry = data + offset + PROFILE_HEADER_BYTES;
+        for (uint32_t i = 0; i < dump->entry_count; i++, entry += PROFILE_ENTRY_BYTES)
+        {
+            dump->entries[i].bucket = (uint16_t)Profile_U16(entry);
+            dump->entries[i].pc_count = (uint16_t)Profile_U16(entry + 2);
+            dump->entries[i].lr_count = (uint16_t)Profile_U16(entry + 4);
+        }
+        return 1;
+    }
+    return 0;
+}
+
+// The symbol that covers most of [start, end), or symbols->count if none
+static uint32_t Profile_Find(const Profile_Symbols *symbols, uint32_t start, uint32_t end)
+{
+    uint32_t best = symbols->count;
+    uint32_t best_overlap = 0;
+
+    for (uint32_t i = 0; i < symbols->count; i++)
+    {
+        const Profile_Symbol *symbol = &symbols->symbols[i];
+        uint32_t symbol_end = symbol->address + symbol->size;
+
+        if (symbol->address >= end)
+        {
+            break;
+        }
+
+        uint32_t low = (symbol->address > start) ? symbol->address : start;
+        uint32_t high = (symbol_end < end) ? symbol_end : end;
+
+        if (high > low && high - low > best_overlap)
+        {
+            best = i;
+            best_overlap = high - low;
+        }
+    }
+    return best;
+}
+
+void Profile_Attribute(const Profile_Symbols *symbols, const Profile_Dump *dump, Profile_Count *counts)
+{
+    memset(counts, 0, (symbols->count + 1U) * sizeof(counts[0]));
+
+    for (uint32_t i = 0; i < dump->entry_count; i++)
+    {
+        const Profile_Entry *entry = &dump->entries[i];
+        uint32_t start = dump->code_base + ((uint32_t)entry->bucket << dump->bucket_shift);
+        uint32_t index = Profile_Find(symbols, start, start + (1U << dump->bucket_shift));
+
+        counts[index].pc_samples += entry->pc_count;
+        counts[index].lr_samples += entry->lr_count;
+    }
+}
+
+static int Profile_Compare_Samples(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    const Profile_Count *counts = sort_context.counts;
+
+    if (counts[x].pc_samples != counts[y].pc_samples)
+    {
+        return (counts[x].pc_samples > counts[y].pc_samples) ? -1 : 1;
+    }
+    if (counts[x].lr_samples != counts[y].lr_samples)
+    {
+        return (counts[x].lr_samples > counts[y].lr_samples) ? -1 : 1;
+    }
+    return (x < y) ? -1 : (x > y);
+}
+
+static const char *Profile_Name(const Profile_Symbols *symbols, uint32_t index)
+{
+    return (index < symbols->count) ? symbols->symbols[index].name : "[unknown]";
+}
+
+void Profile_Print_Flat(FILE *out, const Profile_Symbols *symbols, const Profile_Dump *dump)
+{
+    Profile_Count *counts = calloc(symbols->count + 1U, sizeof(*counts));
+    uint32_t *order = calloc(symbols->count + 1U, sizeof(*order));
+    double total = (dump->samples > 0) ? (double)dump->samples : 1.0;
+
+    if (counts == NULL || order == NULL)
+    {
+        free(counts);
+        free(order);
+        return;
+    }
+
+    Profile_Attribute(symbols, dump, counts);
+    for (uint32_t i = 0; i <= symbols->count; i++)
+    {
+        order[i] = i;
+    }
+    sort_context.symbols = symbols;
+    sort_context.counts = counts;
+    qsort(order, symbols->count + 1U, sizeof(order[0]), Profile_Compare_Samples);
+
+    fprintf(out, "%u samples at %u Hz (%.2f s), %u outside the histogram\n", dump->samples, dump->rate_hz,
+            (dump->rate_hz > 0) ? (double)dump->samples / dump->rate_hz : 0.0, dump->out_of_range);
+    fprintf(out, "%8s %7s %8s %7s  %s\n", "samples", "self", "as LR", "callers", "function (object)");
+
+    for (uint32_t i = 0; i <= symbols->count; i++)
+    {
+        const Profile_Count *count = &counts[order[i]];
+        const char *object = (order[i] < symbols->count) ? symbols->symbols[order[i]].object : "";
+
+        if (count->pc_samples == 0 && count->lr_samples == 0)
+        {
+            break;
+        }
+        fprintf(out, "%8u %6.2f%% %8u %6.2f%%  %s%s%s%s\n", count->pc_samples, 100.0 * count->pc_samples / total,
+                count->lr_samples, 100.0 * count->lr_samples / total, Profile_Name(symbols, order[i]),
+                (object[0] != '\0') ? " (" : "", object, (object[0] != '\0') ? ")" : "");
+    }
+
+    free(counts);
+    free(order);
+}
+
+void Profile_Print_Folded(FILE *out, const Profile_Symbols *symbols, const Profile_Dump *dump)
+{
+    Profile_Count *counts = calloc(symbols->count + 1U, sizeof(*counts));
+
+    if (counts == NULL)
+    {
+        return;
+    }
+
+    Profile_Attribute(symbols, dump, counts);
+    for (uint32_t i = 0; i <= symbols->count; i++)
+    {
+        if (counts[i].pc_samples == 0)
+        {
+            continue;
+        }
+
+        const char *object = (i < symbols->count && symbols->symbols[i].object[0] != '\0')
+                             ? symbols->symbols[i].object : "[unknown]";
+        fprintf(out, "%s;%s %u\n", object, Profile_Name(symbols, i), counts[i].pc_samples);
+    }
+    if (dump->out_of_range > 0)
+    {
+        fprintf(out, "[outside the histogram] %u\n", dump->out_of_range);
+    }
+
+    free(counts);
+}
@@ -0,0 +1,132 @@
+/**
+ * @file Profile_Symbols.h
+ *
+ * @brief Symbolizes the profiler histograms (Profiler_Dump) on the PC.
+ *
+ * The function addresses come from the linker map file of the Keil build
+ * (Listings/ECE425_Final_SibCal.map, "Image Symbol Table"), or from the
+ * output of nm for a GNU build. Each histogram bucket is given to the
+ * function that covers most of its bytes, so a bucket shared by the end
+ * of a function and the start of the next one counts for one of them.
+ *
+ * Two reports are made from the PC and LR histograms:
+ *  - a flat profile: the samples per function, and the samples whose
+ *    return address is in the function (the time of the leaf functions,
+ *    e.g. the soft-float helpers, charged to their caller)
+ *  - folded stacks ("object;function count"), the input format of
+ *    flamegraph.pl and https://www.speedscope.app, with the object file
+ *    as the parent frame. The two histograms are not sampled as pairs,
+ *    so a deeper stack cannot be rebuilt.
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef PROFILE_SYMBOLS_H_
+#define PROFILE_SYMBOLS_H_
+
+#include "Profiler.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define PROFILE_NAME_LENGTH     64U
+#define PROFILE_OBJECT_LENGTH   32U
+
+typedef struct {
+    char name[PROFILE_NAME_LENGTH];
+    char object[PROFILE_OBJECT_LENGTH];     // Object file, "" if unknown
+    uint32_t address;
+    uint32_t size;
+} Profile_Symbol;
+
+typedef struct {
+    Profile_Symbol *symbols;        // Sorted by address
+    uint32_t count;
+} Profile_Symbols;
+
+typedef struct {
+    uint16_t bucket;
+    uint16_t pc_count;
+    uint16_t lr_count;
+} Profile_Entry;
+
+typedef struct {
+    uint32_t rate_hz;
+    uint32_t code_base;
+    uint32_t bucket_shift;
+    uint32_t samples;
+    uint32_t out_of_range;
+    uint32_t entry_count;
+    Profile_Entry entries[PROFILER_BUCKET_COUNT];
+} Profile_Dump;
+
+typedef struct {
+    uint32_t pc_samples;
+    uint32_t lr_samples;
+} Profile_Count;
+
+/**
+ * @brief Read the code symbols of a linker map file or of nm output.
+ *
+ * @param file    The file to read.
+ * @param symbols Receives the symbols (free with Profile_Free_Symbols).
+ *
+ * @return int The number of code symbols, or -1 if none is found.
+ */
+int Profile_Load_Symbols(FILE *file, Profile_Symbols *symbols);
+
+/**
+ * @brief Free the symbols read by Profile_Load_Symbols.
+ *
+ * @param symbols The symbols.
+ *
+ * @return None
+ */
+void Profile_Free_Symbols(Profile_Symbols *symbols);
+
+/**
+ * @brief Find the first profiler dump in a byte stream (e.g. a UART capture).
+ *
+ * @param data   The byte stream.
+ * @param length The length of the stream.
+ * @param dump   Receives the dump.
+ *
+ * @return int 1 if a dump was found, 0 if none, -1 if it is cut short or not valid.
+ */
+int Profile_Parse_Dump(const uint8_t *data, size_t length, Profile_Dump *dump);
+
+/**
+ * @brief Add up the histograms per function.
+ *
+ * @param symbols The symbols.
+ * @param dump    The dump.
+ * @param counts  Receives symbols->count + 1 counts; the last one holds the
+ *                samples that no symbol covers.
+ *
+ * @return None
+ */
+void Profile_Attribute(const Profile_Symbols *symbols, const Profile_Dump *dump, Profile_Count *counts);
+
+/**
+ * @brief Print the flat profile, the most sampled functions first.
+ *
+ * @param out     The file to print to.
+ * @param symbols The symbols.
+ * @param dump    The dump.
+ *
+ * @return None
+ */
+void Profile_Print_Flat(FILE *out, const Profile_Symbols *symbols, const Profile_Dump *dump);
+
+/**
+ * @brief Print the PC samples as folded stacks for a flame graph.
+ *
+ * @param out     The file to print to.
+ * @param symbols The symbols.
+ * @param dump    The dump.
+ *
+ * @return None
+ */
+void Profile_Print_Folded(FILE *out, const Profile_Symbols *symbols, const Profile_Dump *dump);
+
+#endif // PROFILE_SYMBOLS_H_
@@ -0,0 +1,144 @@
+/**
+ * @file Trace_Chrome.c
+ *
+ * @brief Converts trace dumps (Trace_Dump_Binary) to Chrome trace-event JSON.
+ *
+ * @note For the JSON output format, see "Trace Event Format".
+ * Link: https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h4I0nSsKchNAySU
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Trace_Chrome.h"
+#include "Trace.h"
+#include <string.h>
+
+#define TRACE_MAGIC         "TRC1"
+#define TRACE_HEADER_BYTES  12U
+#define TRACE_RECORD_BYTES  8U
+
+// In the order of Trace_Zone
+static const char *const Trace_Chrome_Zone_Names[TRACE_ZONE_COUNT] = {
+    "Keypad scan",
+    "Debounce",
+    "LCD command",
+    "LCD data",
+    "Key handling",
+    "Compute",
+    "SysTick ISR",
+    "Delay",
+    "State",
+    "Error",
+    "Clock"
+};
+
+static uint32_t Trace_Chrome_U32(const uint8_t *data)
+{
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+static void Trace_Chrome_Tracks(FILE *out, uint32_t pid, uint32_t clock_hz)
+{
+    fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"args\":{\"name\":\"Sib-Cal dump %u (%u Hz)\"}},\n",
+            pid, pid, clock_hz);
+
+    // One named track per zone
+    for (uint32_t zone = 0; zone < TRACE_ZONE_COUNT; zone++)
+    {
+        fprintf(out, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"%s\"}},\n",
+                pid, zone, Trace_Chrome_Zone_Names[zone]);
+    }
+}
+
+static void Trace_Chrome_Events(FILE *out, uint32_t pid, uint32_t clock_hz, const uint8_t *records, uint32_t count)
+{
+    uint8_t depth[TRACE_ZONE_COUNT] = { 0 };
+
+    // Assumes that the clock has not changed since the oldest record,
+    // until a clock change event says otherwise
+    double cycles_per_us = (double)clock_hz / 1e6;
+    double elapsed_us = 0.0;
+    uint32_t previous = (count > 0) ? Trace_Chrome_U32(records) : 0U;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const uint8_t *record = records + i * TRACE_RECORD_BYTES;
+        uint32_t timestamp = Trace_Chrome_U32(record);
+        uint32_t event = Trace_Chrome_U32(record + 4);
+        uint32_t zone = event & 0xFFU;
+        uint32_t phase = (event >> 8) & 0xFFU;
+        uint32_t payload = event >> 16;
+
+        // Signed, because Trace_Begin_At records a timestamp from the past
+        elapsed_us += (double)(int32_t)(timestamp - previous) / cycles_per_us;
+        previous = timestamp;
+
+        if (zone >= TRACE_ZONE_COUNT)
+        {
+            continue;
+        }
+
+        // The cycles after this event run at the new clock frequency (in MHz)
+        if (zone == TRACE_ZONE_CLOCK && phase == TRACE_PHASE_MARK && payload != 0)
+        {
+            cycles_per_us = payload;
+        }
+
+        // Skip ends whose beginning was overwritten
+        if (phase == TRACE_PHASE_BEGIN)
+        {
+            depth[zone]++;
+        }
+        else if (phase == TRACE_PHASE_END)
+        {
+            if (depth[zone] == 0)
+            {
+                continue;
+            }
+            depth[zone]--;
+        }
+
+        const char *phase_name = (phase == TRACE_PHASE_BEGIN) ? "B" : (phase == TRACE_PHASE_END) ? "E" : "i";
+        const char *scope = (phase == TRACE_PHASE_MARK) ? ",\"s\":\"t\"" : "";
+
+        fprintf(out, "{\"name\":\"%s\",\"ph\":\"%s\"%s,\"ts\":%.2f,\"pid\":%u,\"tid\":%u,\"args\":{\"payload\":%u}},\n",
+                Trace_Chrome_Zone_Names[zone], phase_name, scope, elapsed_us, pid, zone, payload);
+    }
+}
+
+int Trace_Chrome_Convert(const uint8_t *data, size_t length, FILE *out)
+{
+    int dumps = 0;
+    size_t offset = 0;
+
+    fprintf(out, "{\"traceEvents\":[\n");
+
+    while (offset + TRACE_HEADER_BYTES <= length)
+    {
+        if (memcmp(data + offset, TRACE_MAGIC, 4) != 0)
+        {
+            offset++;
+            continue;
+        }
+
+        uint32_t clock_hz = Trace_Chrome_U32(data + offset + 4);
+        uint32_t count = Trace_Chrome_U32(data + offset + 8);
+        const uint8_t *records = data + offset + TRACE_HEADER_BYTES;
+
+        if (count > TRACE_BUFFER_SIZE || clock_hz == 0 ||
+            length - offset - TRACE_HEADER_BYTES < (size_t)count * TRACE_RECORD_BYTES)
+        {
+            dumps = -1;
+            break;
+        }
+
+        dumps++;
+        Trace_Chrome_Tracks(out, (uint32_t)dumps, clock_hz);
+        Trace_Chrome_Events(out, (uint32_t)dumps, clock_hz, records, count);
+        offset += TRACE_HEADER_BYTES + (size_t)count * TRACE_RECORD_BYTES;
+    }
+
+    // Closing metadata event, so that every event above can end with a comma
+    fprintf(out, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"trace2chrome\"}}\n]}\n");
+    return dumps;
+}
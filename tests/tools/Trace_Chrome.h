@@ -0,0 +1,39 @@
+/**
+ * @file Trace_Chrome.h
+ *
+ * @brief Converts trace dumps (Trace_Dump_Binary) to Chrome trace-event JSON.
+ *
+ * The dumps are found in a byte stream by their "TRC1" magic, so a raw
+ * UART capture that also holds log records can be converted as it is.
+ * Each dump becomes a process with one track per trace zone, and opens
+ * in chrome://tracing or https://ui.perfetto.dev.
+ *
+ * The timestamps are DWT cycle counts. They are converted to time with
+ * the clock of the dump, updated by the clock change events, and
+ * accumulated from the differences between consecutive records so that
+ * the 32-bit counter may wrap (the SysTick interrupt records an event at
+ * least every ~4.2 s).
+ *
+ * @author Mirveys Tajik
+ */
+
+#ifndef TRACE_CHROME_H_
+#define TRACE_CHROME_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @brief Convert every trace dump found in a byte stream.
+ *
+ * @param data   The byte stream.
+ * @param length The length of the stream.
+ * @param out    Receives the JSON document.
+ *
+ * @return int The number of dumps converted (the JSON is written even if
+ *             none is found), or -1 if a dump is cut short.
+ */
+int Trace_Chrome_Convert(const uint8_t *data, size_t length, FILE *out);
+
+#endif // TRACE_CHROME_H_
@@ -0,0 +1,89 @@
+/**
+ * @file logdecode.c
+ *
+ * @brief Decodes the log records of a UART capture (Log_Decode.h).
+ *
+ *   logdecode [-c clock_hz] ECE425_Final_SibCal.axf [capture.bin]
+ *
+ * The ELF file must be the image that wrote the log (Objects/ of the
+ * Keil build); the capture is read from standard input if no file is
+ * given. The times are printed at 80 MHz unless another clock is given.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Log_Decode.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define LOGDECODE_DEFAULT_CLOCK_HZ  80000000UL
+
+int main(int argc, char **argv)
+{
+    unsigned long clock_hz = LOGDECODE_DEFAULT_CLOCK_HZ;
+    Log_Decode_Formats formats;
+    int arg = 1;
+
+    if (argc > 2 && strcmp(argv[1], "-c") == 0)
+    {
+        clock_hz = strtoul(argv[2], NULL, 0);
+        arg = 3;
+    }
+    if (argc - arg < 1 || argc - arg > 2 || clock_hz == 0 || clock_hz > 0xFFFFFFFFUL)
+    {
+        fprintf(stderr, "usage: logdecode [-c clock_hz] <ELF file> [capture]\n");
+        return 2;
+    }
+
+    FILE *elf = fopen(argv[arg], "rb");
+    if (elf == NULL || Log_Decode_Load_Elf(elf, &formats) != 0)
+    {
+        fprintf(stderr, "logdecode: no .logfmt section in %s\n", argv[arg]);
+        return 1;
+    }
+    fclose(elf);
+
+    FILE *file = (argc - arg == 2) ? fopen(argv[arg + 1], "rb") : stdin;
+    uint8_t *data = NULL;
+    size_t length = 0;
+    size_t capacity = 0;
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "logdecode: cannot open %s\n", argv[arg + 1]);
+        return 1;
+    }
+
+    for (;;)
+    {
+        if (length == capacity)
+        {
+            capacity = (capacity > 0) ? 2 * capacity : 65536U;
+            data = realloc(data, capacity);
+            if (data == NULL)
+            {
+                fprintf(stderr, "logdecode: out of memory\n");
+                return 1;
+            }
+        }
+
+        size_t read = fread(data + length, 1, capacity - length, file);
+        if (read == 0)
+        {
+            break;
+        }
+        length += read;
+    }
+
+    int dumps = Log_Decode_Convert(&formats, data, length, (uint32_t)clock_hz, stdout);
+    free(data);
+    Log_Decode_Free(&formats);
+
+    if (dumps <= 0)
+    {
+        fprintf(stderr, "logdecode: %s\n", (dumps < 0) ? "a log dump is cut short or from another build"
+                                                       : "no log dump found");
+        return 1;
+    }
+    return 0;
+}
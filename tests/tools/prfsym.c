@@ -0,0 +1,101 @@
+/**
+ * @file prfsym.c
+ *
+ * @brief Symbolizes a profiler dump (Profile_Symbols.h).
+ *
+ *   prfsym [-f] ECE425_Final_SibCal.map capture.bin
+ *
+ * The map file is the one of the Keil build (Listings/), or the output of
+ * nm for a GNU build; the capture is the raw UART output that holds the
+ * dump. The flat profile is printed, or with -f the folded stacks for
+ * flamegraph.pl or speedscope.
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Profile_Symbols.h"
+#include <stdlib.h>
+#include <string.h>
+
+static Profile_Dump dump;
+
+static uint8_t *Read_File(const char *path, size_t *length)
+{
+    FILE *file = fopen(path, "rb");
+    uint8_t *data = NULL;
+    size_t capacity = 0;
+
+    *length = 0;
+    if (file == NULL)
+    {
+        return NULL;
+    }
+
+    for (;;)
+    {
+        if (*length == capacity)
+        {
+            capacity = (capacity > 0) ? 2 * capacity : 65536U;
+            uint8_t *grown = realloc(data, capacity);
+            if (grown == NULL)
+            {
+                free(data);
+                fclose(file);
+                return NULL;
+            }
+            data = grown;
+        }
+
+        size_t read = fread(data + *length, 1, capacity - *length, file);
+        if (read == 0)
+        {
+            break;
+        }
+        *length += read;
+    }
+    fclose(file);
+    return data;
+}
+
+int main(int argc, char **argv)
+{
+    int folded = (argc > 1 && strcmp(argv[1], "-f") == 0);
+    Profile_Symbols symbols;
+    size_t length;
+
+    if (argc != 3 + folded)
+    {
+        fprintf(stderr, "usage: prfsym [-f] <map file> <capture>\n");
+        return 2;
+    }
+
+    FILE *map = fopen(argv[1 + folded], "r");
+    if (map == NULL || Profile_Load_Symbols(map, &symbols) < 0)
+    {
+        fprintf(stderr, "prfsym: no code symbols in %s\n", argv[1 + folded]);
+        return 1;
+    }
+    fclose(map);
+
+    uint8_t *data = Read_File(argv[2 + folded], &length);
+    int found = (data != NULL) ? Profile_Parse_Dump(data, length, &dump) : -1;
+    free(data);
+
+    if (found <= 0)
+    {
+        fprintf(stderr, "prfsym: %s\n", (found < 0) ? "the profiler dump is cut short" : "no profiler dump found");
+        Profile_Free_Symbols(&symbols);
+        return 1;
+    }
+
+    if (folded)
+    {
+        Profile_Print_Folded(stdout, &symbols, &dump);
+    }
+    else
+    {
+        Profile_Print_Flat(stdout, &symbols, &dump);
+    }
+    Profile_Free_Symbols(&symbols);
+    return 0;
+}
@@ -0,0 +1,60 @@
+/**
+ * @file trace2chrome.c
+ *
+ * @brief Converts trace dumps to Chrome trace-event JSON (Trace_Chrome.h).
+ *
+ *   trace2chrome [capture.bin] > trace.json
+ *
+ * The input is a raw capture of the UART output (standard input if no
+ * file is given), or the trace of a simulated session (sim_trace).
+ *
+ * @author Mirveys Tajik
+ */
+
+#include "Trace_Chrome.h"
+#include <stdlib.h>
+
+int main(int argc, char **argv)
+{
+    FILE *file = (argc > 1) ? fopen(argv[1], "rb") : stdin;
+    uint8_t *data = NULL;
+    size_t length = 0;
+    size_t capacity = 0;
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "trace2chrome: cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    for (;;)
+    {
+        if (length == capacity)
+        {
+            capacity = (capacity > 0) ? 2 * capacity : 65536U;
+            data = realloc(data, capacity);
+            if (data == NULL)
+            {
+                fprintf(stderr, "trace2chrome: out of memory\n");
+                return 1;
+            }
+        }
+
+        size_t read = fread(data + length, 1, capacity - length, file);
+        if (read == 0)
+        {
+            break;
+        }
+        length += read;
+    }
+
+    int dumps = Trace_Chrome_Convert(data, length, stdout);
+    free(data);
+
+    if (dumps <= 0)
+    {
+        fprintf(stderr, "trace2chrome: %s\n", (dumps < 0) ? "a trace dump is cut short" : "no trace dump found");
+        return 1;
+    }
+    return 0;
+}